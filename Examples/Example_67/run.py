@@ -23,3 +23,19 @@ if "OVERWRITE_SCENARIOGENERATOR_SAMPLES" in os.environ.keys():
 
 oreex.print_headline("Run ORE to produce XVA Stresstest with classic simulation")
 oreex.run("Input/ore_classic.xml")
+
+oreex.print_headline("Run ORE to produce XVA Stresstest of the counterparty credit curve with and without reuse of the base cubes")
+oreex.run("Input/ore_classic_credit.xml")
+oreex.run("Input/ore_classic_credit_no_reuse.xml")
+
+# the credit stress scenario does not affect the exposure simulation, reusing the base cubes must not change the results
+if not oreex.dry:
+    sys.path.append('../../')
+    from Tools.PythonTools.compare_files import compare_files
+    from Tools.PythonTools.merge_comparison_configs import merge_configurations
+    comp_config = merge_configurations('../../Tools/PythonTools/comparison_config.json')
+    for f in ["xva.csv", "exposure_nettingset_CPTY_A.csv"]:
+        if not compare_files(os.path.join("Output", "ClassicCredit", f),
+                             os.path.join("Output", "ClassicCreditNoReuse", f), "Example_67", comp_config):
+            print("Results with and without reuse of the base cubes differ in " + f)
+            sys.exit(1)
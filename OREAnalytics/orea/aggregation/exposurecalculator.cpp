@@ -20,12 +20,14 @@
 #include <orea/cube/inmemorycube.hpp>
 
 #include <ored/portfolio/trade.hpp>
+#include <ored/utilities/parallelfor.hpp>
 
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
 using namespace std;
 using namespace QuantLib;
+using ore::data::parallelFor;
 
 namespace ore {
 namespace analytics {
@@ -36,13 +38,14 @@ ExposureCalculator::ExposureCalculator(
     const QuantLib::ext::shared_ptr<Market>& market,
     bool exerciseNextBreak, const string& baseCurrency, const string& configuration,
     const Real quantile, const CollateralExposureHelper::CalculationType calcType, const bool multiPath,
-    const bool flipViewXVA)
+    const bool flipViewXVA, const Size nThreads)
     : portfolio_(portfolio), cube_(cube), cubeInterpretation_(cubeInterpretation),
        market_(market), exerciseNextBreak_(exerciseNextBreak),
       baseCurrency_(baseCurrency), configuration_(configuration),
       quantile_(quantile), calcType_(calcType),
       multiPath_(multiPath), dates_(cube->dates()),
-      today_(market_->asofDate()), dc_(ActualActual(ActualActual::ISDA)), flipViewXVA_(flipViewXVA) {
+      today_(market_->asofDate()), dc_(ActualActual(ActualActual::ISDA)), flipViewXVA_(flipViewXVA),
+      nThreads_(nThreads) {
 
     QL_REQUIRE(portfolio_, "portfolio is null");
 
@@ -70,20 +73,23 @@ ExposureCalculator::ExposureCalculator(
 
 void ExposureCalculator::build() {
     LOG("Compute trade exposure profiles, " << (flipViewXVA_ ? "inverted (flipViewXVA = Y)" : "regular (flipViewXVA = N)"));
-    size_t i = 0;
+
+    const Size samples = cube_->samples();
+    const Size nTrades = portfolio_->trades().size();
+
+    // Group the trades by netting set once, keeping the portfolio order within each netting set, and identify the
+    // next break date for each trade (default is trade maturity). This is the only part that touches the market and
+    // the trade objects, the aggregation below works on cube data and plain vectors only.
+    map<string, vector<Size>> nettingSetTrades;
+    vector<Date> nextBreakDates(nTrades);
+    Date today = Settings::instance().evaluationDate();
+    Size i = 0;
     for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end(); ++tradeIt, ++i) {
         auto trade = tradeIt->second;
         string tradeId = tradeIt->first;
-        string nettingSetId = trade->envelope().nettingSetId();
         LOG("Aggregate exposure for trade " << tradeId);
-        if (nettingSetDefaultValue_.find(nettingSetId) == nettingSetDefaultValue_.end()) {
-            nettingSetDefaultValue_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(cube_->samples(), 0.0));
-            nettingSetCloseOutValue_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(cube_->samples(), 0.0));
-            nettingSetMporPositiveFlow_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(cube_->samples(), 0.0));
-            nettingSetMporNegativeFlow_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(cube_->samples(), 0.0));
-        }
+        nettingSetTrades[trade->envelope().nettingSetId()].push_back(i);
 
-        // Identify the next break date if provided, default is trade maturity.
         Date nextBreakDate = trade->maturity();
         TradeActions ta = trade->tradeActions();
         if (exerciseNextBreak_ && !ta.empty()) {
@@ -97,7 +103,6 @@ void ExposureCalculator::build() {
                     QuantLib::Schedule schedule = ore::data::makeSchedule(actions[j].schedule());
                     vector<Date> dates = schedule.dates();
                     std::sort(dates.begin(), dates.end());
-                    Date today = Settings::instance().evaluationDate();
                     for (Size k = 0; k < dates.size(); ++k) {
                         if (dates[k] > today && dates[k] < nextBreakDate) {
                             nextBreakDate = dates[k];
@@ -109,76 +114,115 @@ void ExposureCalculator::build() {
                 }
             }
         }
+        nextBreakDates[i] = nextBreakDate;
+    }
+
+    Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
+    vector<Real> discounts(dates_.size());
+    for (Size j = 0; j < dates_.size(); ++j)
+        discounts[j] = curve->discount(dates_[j]);
+
+    vector<vector<Real>> epe(nTrades, vector<Real>(dates_.size() + 1, 0.0));
+    vector<vector<Real>> ene(nTrades, vector<Real>(dates_.size() + 1, 0.0));
+    vector<vector<Real>> pfe(nTrades, vector<Real>(dates_.size() + 1, 0.0));
+    for (i = 0; i < nTrades; ++i) {
+        Real npv0 = flipViewXVA_ ? -cube_->getT0(i) : cube_->getT0(i);
+        epe[i][0] = std::max(npv0, 0.0);
+        ene[i][0] = std::max(-npv0, 0.0);
+        pfe[i][0] = std::max(npv0, 0.0);
+        exposureCube_->setT0(epe[i][0], i, ExposureIndex::EPE);
+        exposureCube_->setT0(ene[i][0], i, ExposureIndex::ENE);
+    }
+
+    for (const auto& [nettingSetId, tradeIndices] : nettingSetTrades) {
+        nettingSetDefaultValue_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(samples, 0.0));
+        nettingSetCloseOutValue_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(samples, 0.0));
+        nettingSetMporPositiveFlow_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(samples, 0.0));
+        nettingSetMporNegativeFlow_[nettingSetId] = vector<vector<Real>>(dates_.size(), vector<Real>(samples, 0.0));
+    }
 
-        Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
-        Real npv0;
-        if (flipViewXVA_) {
-            npv0 = -cube_->getT0(i);
-        } else {
-            npv0 = cube_->getT0(i);
+    auto aggregate = [&](const vector<Size>& tradeIndices, const string& nettingSetId, Size j) {
+        vector<Real>& nettingSetDefaultValue = nettingSetDefaultValue_.at(nettingSetId)[j];
+        vector<Real>& nettingSetCloseOutValue = nettingSetCloseOutValue_.at(nettingSetId)[j];
+        vector<Real>& nettingSetMporPositiveFlow = nettingSetMporPositiveFlow_.at(nettingSetId)[j];
+        vector<Real>& nettingSetMporNegativeFlow = nettingSetMporNegativeFlow_.at(nettingSetId)[j];
+        vector<Real> defaultValue, closeOutValue, positiveCashFlow, negativeCashFlow;
+        vector<Real> epeRow(multiPath_ ? samples : 0), eneRow(multiPath_ ? samples : 0);
+        const Date& d = dates_[j];
+        const Size index = Size(floor(quantile_ * (samples - 1) + 0.5));
+        for (Size i : tradeIndices) {
+            // RL 2020-07-17
+            // 1) If the calculation type is set to NoLag:
+            //    Collateral balances are NOT delayed by the MPoR, but we use the close-out NPV.
+            // 2) Otherwise:
+            //    Collateral balances are delayed by the MPoR (if possible, i.e. the valuation
+            //    grid has MPoR spacing), and we use the default date NPV.
+            //    This is the treatment in the ORE releases up to June 2020).
+            bool terminated = d > nextBreakDates[i] && exerciseNextBreak_;
+            if (terminated)
+                defaultValue.assign(samples, 0.0);
+            else
+                cubeInterpretation_->getDefaultNpvs(cube_, i, j, defaultValue);
+            if (isRegularCubeStorage_ && j == dates_.size() - 1)
+                closeOutValue = defaultValue;
+            else if (terminated)
+                closeOutValue.assign(samples, 0.0);
+            else
+                cubeInterpretation_->getCloseOutNpvs(cube_, i, j, closeOutValue);
+            cubeInterpretation_->getMporPositiveFlows(cube_, i, j, positiveCashFlow);
+            cubeInterpretation_->getMporNegativeFlows(cube_, i, j, negativeCashFlow);
+
+            Real epeSum = 0.0, eneSum = 0.0;
+            for (Size k = 0; k < samples; ++k) {
+                // for single trade exposures, always default value is relevant
+                Real npv = defaultValue[k];
+                epeSum += max(npv, 0.0);
+                eneSum += max(-npv, 0.0);
+                nettingSetDefaultValue[k] += defaultValue[k];
+                nettingSetCloseOutValue[k] += closeOutValue[k];
+                nettingSetMporPositiveFlow[k] += positiveCashFlow[k];
+                nettingSetMporNegativeFlow[k] += negativeCashFlow[k];
+            }
+            epe[i][j + 1] = epeSum / samples;
+            ene[i][j + 1] = eneSum / samples;
+            if (multiPath_) {
+                for (Size k = 0; k < samples; ++k) {
+                    epeRow[k] = max(defaultValue[k], 0.0);
+                    eneRow[k] = max(-defaultValue[k], 0.0);
+                }
+                exposureCube_->setSamples(epeRow, i, j, ExposureIndex::EPE);
+                exposureCube_->setSamples(eneRow, i, j, ExposureIndex::ENE);
+            } else {
+                exposureCube_->set(epe[i][j + 1], i, j, 0, ExposureIndex::EPE);
+                exposureCube_->set(ene[i][j + 1], i, j, 0, ExposureIndex::ENE);
+            }
+            vector<Real>& distribution = defaultValue;
+            std::nth_element(distribution.begin(), distribution.begin() + index, distribution.end());
+            pfe[i][j + 1] = std::max(distribution[index], 0.0);
         }
-        vector<Real> epe(dates_.size() + 1, 0.0);
-        vector<Real> ene(dates_.size() + 1, 0.0);
+    };
+
+    // One job per netting set and date. A job owns row j of its netting set's aggregates and the date j entries of
+    // its trades' profiles and exposure cube slots, so that jobs never write to shared locations. Within a job the
+    // trades are summed in portfolio order, so the results do not depend on the number of threads.
+    vector<pair<map<string, vector<Size>>::const_iterator, Size>> jobs;
+    for (auto n = nettingSetTrades.cbegin(); n != nettingSetTrades.cend(); ++n)
+        for (Size j = 0; j < dates_.size(); ++j)
+            jobs.push_back(std::make_pair(n, j));
+    parallelFor(jobs.size(), nThreads_,
+                [&](Size k) { aggregate(jobs[k].first->second, jobs[k].first->first, jobs[k].second); });
+
+    i = 0;
+    for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end(); ++tradeIt, ++i) {
+        const string& tradeId = tradeIt->first;
         vector<Real> ee_b(dates_.size() + 1, 0.0);
         vector<Real> eee_b(dates_.size() + 1, 0.0);
-        vector<Real> pfe(dates_.size() + 1, 0.0);
-        epe[0] = std::max(npv0, 0.0);
-        ene[0] = std::max(-npv0, 0.0);
-        ee_b[0] = epe[0];
+        ee_b[0] = epe[i][0];
         eee_b[0] = ee_b[0];
-        pfe[0] = std::max(npv0, 0.0);
-        exposureCube_->setT0(epe[0], tradeId, ExposureIndex::EPE);
-        exposureCube_->setT0(ene[0], tradeId, ExposureIndex::ENE);
         for (Size j = 0; j < dates_.size(); ++j) {
-            Date d = cube_->dates()[j];
-            vector<Real> distribution(cube_->samples(), 0.0);
-            for (Size k = 0; k < cube_->samples(); ++k) {
-                // RL 2020-07-17
-                // 1) If the calculation type is set to NoLag:
-                //    Collateral balances are NOT delayed by the MPoR, but we use the close-out NPV.
-                // 2) Otherwise:
-                //    Collateral balances are delayed by the MPoR (if possible, i.e. the valuation
-                //    grid has MPoR spacing), and we use the default date NPV.
-                //    This is the treatment in the ORE releases up to June 2020).
-                Real defaultValue =
-                    d > nextBreakDate && exerciseNextBreak_ ? 0.0 : cubeInterpretation_->getDefaultNpv(cube_, i, j, k);
-                Real closeOutValue;
-                if (isRegularCubeStorage_ && j == dates_.size() - 1)
-                    closeOutValue = defaultValue;
-                else
-                    closeOutValue = d > nextBreakDate && exerciseNextBreak_
-                                        ? 0.0
-                                        : cubeInterpretation_->getCloseOutNpv(cube_, i, j, k);
-
-                Real positiveCashFlow = cubeInterpretation_->getMporPositiveFlows(cube_, i, j, k);
-                Real negativeCashFlow = cubeInterpretation_->getMporNegativeFlows(cube_, i, j, k);
-                //for single trade exposures, always default value is relevant
-                Real npv = defaultValue;
-                epe[j + 1] += max(npv, 0.0) / cube_->samples();
-                ene[j + 1] += max(-npv, 0.0) / cube_->samples();
-                nettingSetDefaultValue_[nettingSetId][j][k] += defaultValue;
-                nettingSetCloseOutValue_[nettingSetId][j][k] += closeOutValue;
-                nettingSetMporPositiveFlow_[nettingSetId][j][k] += positiveCashFlow;
-                nettingSetMporNegativeFlow_[nettingSetId][j][k] += negativeCashFlow;
-                distribution[k] = npv;
-                if (multiPath_) {
-                    exposureCube_->set(max(npv, 0.0), tradeId, d, k, ExposureIndex::EPE);
-                    exposureCube_->set(max(-npv, 0.0), tradeId, d, k, ExposureIndex::ENE);
-                }
-            }
-            if (!multiPath_) {
-                exposureCube_->set(epe[j + 1], tradeId, d, 0, ExposureIndex::EPE);
-                exposureCube_->set(ene[j + 1], tradeId, d, 0, ExposureIndex::ENE);
-            }
-            ee_b[j + 1] = epe[j + 1] / curve->discount(cube_->dates()[j]);
+            ee_b[j + 1] = epe[i][j + 1] / discounts[j];
             eee_b[j + 1] = std::max(eee_b[j], ee_b[j + 1]);
-            std::sort(distribution.begin(), distribution.end());
-            Size index = Size(floor(quantile_ * (cube_->samples() - 1) + 0.5));
-            pfe[j + 1] = std::max(distribution[index], 0.0);
         }
-        ee_b_[tradeId] = ee_b;
-        eee_b_[tradeId] = eee_b;
-        pfe_[tradeId] = pfe;
 
         Real epe_b = 0.0;
         Real eepe_b = 0.0;
@@ -190,7 +234,7 @@ void ExposureCalculator::build() {
         This one year point is actually taken to be today+1Y+4D, so that the 1Y point on the dateGrid is always
         included.
         This may effect DateGrids with daily data points*/
-        Date maturity = std::min(cal.adjust(today_ + 1 * Years + 4 * Days), trade->maturity());
+        Date maturity = std::min(cal.adjust(today_ + 1 * Years + 4 * Days), tradeIt->second->maturity());
         QuantLib::Real maturityTime = dc_.yearFraction(today_, maturity);
 
         while (t < dates_.size() && times_[t] <= maturityTime)
@@ -210,6 +254,9 @@ void ExposureCalculator::build() {
                 eepe_b += eee_b[k] * weights[k];
             }
         }
+        ee_b_[tradeId] = ee_b;
+        eee_b_[tradeId] = eee_b;
+        pfe_[tradeId] = pfe[i];
         epe_b_[tradeId] = epe_b;
         eepe_b_[tradeId] = eepe_b;
     }
@@ -217,12 +264,12 @@ void ExposureCalculator::build() {
 
 vector<Real> ExposureCalculator::getMeanExposure(const string& tid, ExposureIndex index) {
     vector<Real> exp(dates_.size() + 1, 0.0);
-    exp[0] = exposureCube_->getT0(tid, index);
+    Size tradeIdx = exposureCube_->getTradeIndex(tid);
+    exp[0] = exposureCube_->getT0(tradeIdx, index);
+    vector<Real> values;
     for (Size i = 0; i < dates_.size(); i++) {
-        for (Size k = 0; k < exposureCube_->samples(); k++) {
-            exp[i + 1] += exposureCube_->get(tid, dates_[i], k, index);
-        }
-        exp[i + 1] /= exposureCube_->samples();
+        exposureCube_->getSamples(values, tradeIdx, i, index);
+        exp[i + 1] = std::accumulate(values.begin(), values.end(), 0.0) / exposureCube_->samples();
     }
     return exp;
 }
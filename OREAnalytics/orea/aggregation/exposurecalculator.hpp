@@ -67,7 +67,9 @@ public:
 	    //! Flag to indicate exposure evaluation with dynamic credit
         const bool multiPath,
         //! Flag to indicate flipped xva calculation
-        const bool flipViewXVA
+        const bool flipViewXVA,
+        //! Number of threads used to aggregate over netting sets and dates
+        const Size nThreads = 1
     );
 
     virtual ~ExposureCalculator() {}
@@ -94,6 +96,7 @@ public:
     CollateralExposureHelper::CalculationType calcType() { return calcType_; }
     bool isRegularCubeStorage() { return isRegularCubeStorage_; }
     bool multiPath() { return multiPath_; }
+    Size nThreads() { return nThreads_; }
 
     vector<Date> dates() { return dates_; }
     Date today() { return today_; }
@@ -151,6 +154,7 @@ protected:
     map<string, Real> eepe_b_;
     vector<Real> getMeanExposure(const string& tid, ExposureIndex index);
     bool flipViewXVA_;
+    Size nThreads_;
 };
 
 } // namespace analytics
@@ -19,12 +19,14 @@
 #include <orea/aggregation/nettedexposurecalculator.hpp>
 
 #include <ored/portfolio/trade.hpp>
+#include <ored/utilities/parallelfor.hpp>
 
 #include <ql/time/date.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
 
 using namespace std;
 using namespace QuantLib;
+using ore::data::parallelFor;
 
 namespace ore {
 namespace analytics {
@@ -44,7 +46,8 @@ NettedExposureCalculator::NettedExposureCalculator(
     const QuantLib::ext::shared_ptr<DynamicInitialMarginCalculator>& dimCalculator, const bool fullInitialCollateralisation,
     const bool marginalAllocation, const Real marginalAllocationLimit,
     const QuantLib::ext::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode)
+    const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+    const Size nThreads)
     : portfolio_(portfolio), market_(market), cube_(cube), baseCurrency_(baseCurrency), configuration_(configuration),
       quantile_(quantile), calcType_(calcType), multiPath_(multiPath), nettingSetManager_(nettingSetManager),
       collateralBalances_(collateralBalances),
@@ -55,7 +58,7 @@ NettedExposureCalculator::NettedExposureCalculator(
       marginalAllocation_(marginalAllocation), marginalAllocationLimit_(marginalAllocationLimit),
       tradeExposureCube_(tradeExposureCube), allocatedEpeIndex_(allocatedEpeIndex),
       allocatedEneIndex_(allocatedEneIndex), flipViewXVA_(flipViewXVA), withMporStickyDate_(withMporStickyDate),
-      mporCashFlowMode_(mporCashFlowMode) {
+      mporCashFlowMode_(mporCashFlowMode), nThreads_(nThreads) {
 
     set<string> nettingSetIds;
     for (auto nettingSet : nettingSetDefaultValue) {
@@ -86,14 +89,16 @@ void NettedExposureCalculator::build() {
 
     const Date today = market_->asofDate();
     const DayCounter dc = ActualActual(ActualActual::ISDA);
+    const Size samples = cube_->samples();
+    const Size nDates = cube_->dates().size();
 
-    vector<Real> times = vector<Real>(cube_->dates().size(), 0.0);
-    for (Size i = 0; i < cube_->dates().size(); i++)
+    vector<Real> times = vector<Real>(nDates, 0.0);
+    for (Size i = 0; i < nDates; i++)
         times[i] = dc.yearFraction(today, cube_->dates()[i]);
     
     map<string, Real> nettingSetValueToday;
     map<string, Date> nettingSetMaturity;
-    map<string, Size> nettingSetSize;
+    map<string, vector<Size>> nettingSetTrades; // cube indices of the netting set's trades, in portfolio order
     Size cubeIndex = 0;
     for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end(); ++tradeIt, ++cubeIndex) {
         const auto& trade = tradeIt->second;
@@ -115,24 +120,53 @@ void NettedExposureCalculator::build() {
         if (nettingSetValueToday.find(nettingSetId) == nettingSetValueToday.end()) {
             nettingSetValueToday[nettingSetId] = 0.0;
             nettingSetMaturity[nettingSetId] = today;
-            nettingSetSize[nettingSetId] = 0;
         }
 
         nettingSetValueToday[nettingSetId] += npv;
 
         if (trade->maturity() > nettingSetMaturity[nettingSetId])
             nettingSetMaturity[nettingSetId] = trade->maturity();
-        nettingSetSize[nettingSetId]++;
+        nettingSetTrades[nettingSetId].push_back(cubeIndex);
     }
 
-    vector<vector<Real>> averagePositiveAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
-    vector<vector<Real>> averageNegativeAllocation(portfolio_->size(), vector<Real>(cube_->dates().size(), 0.0));
+    Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
+    vector<Real> discounts(nDates);
+    for (Size j = 0; j < nDates; ++j)
+        discounts[j] = curve->discount(cube_->dates()[j]);
+
+    vector<vector<Real>> averagePositiveAllocation(portfolio_->size(), vector<Real>(nDates, 0.0));
+    vector<vector<Real>> averageNegativeAllocation(portfolio_->size(), vector<Real>(nDates, 0.0));
+
+    // Everything that needs the market, the netting set definitions or the DIM calculator is collected per netting
+    // set first. The collateral paths and the path-wise aggregation below then run on worker threads and only read
+    // from these, the cube and the scenario data.
+    struct NettingSetData {
+        string id;
+        Size index;
+        QuantLib::ext::shared_ptr<NettingSetDefinition> netting;
+        const vector<vector<Real>>* data;
+        const vector<vector<Real>>* mporPositiveFlow;
+        const vector<vector<Real>>* mporNegativeFlow;
+        const vector<vector<Real>>* dim = nullptr;
+        const vector<Size>* trades;
+        string csaIndexName;
+        DayCounter csaDayCounter;
+        CSA::Type initialMarginType = CSA::Bilateral;
+        Real csaFxRateToday = 1.0, csaRateToday = 0.0;
+        QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral;
+        vector<Real> epe, ene, eab, pfe, colvaInc, eoniaFloorInc;
+    };
+    vector<NettingSetData> nettingSets;
 
     Size nettingSetCount = 0;
-    for (auto n : nettingSetDefaultValue_) {
-        string nettingSetId = n.first;
-        vector<vector<Real>> data = n.second;
-        QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
+    for (const auto& n : nettingSetDefaultValue_) {
+        const string& nettingSetId = n.first;
+        NettingSetData nettingSet;
+        nettingSet.id = nettingSetId;
+        nettingSet.index = nettingSetCount++;
+        nettingSet.netting = nettingSetManager_->get(nettingSetId);
+        const QuantLib::ext::shared_ptr<NettingSetDefinition>& netting = nettingSet.netting;
+        nettingSet.trades = &nettingSetTrades[nettingSetId];
 
         // retrieve collateral balances object, if possible
         QuantLib::ext::shared_ptr<CollateralBalance> balance = nullptr;
@@ -143,54 +177,50 @@ void NettedExposureCalculator::build() {
         
         //only for active CSA and calcType == NoLag close-out value is relevant
         if (netting->activeCsaFlag() && calcType_ == CollateralExposureHelper::CalculationType::NoLag) 
-            data = nettingSetCloseOutValue_[nettingSetId];
+            nettingSet.data = &nettingSetCloseOutValue_[nettingSetId];
+        else
+            nettingSet.data = &n.second;
         
-        vector<vector<Real>> nettingSetMporPositiveFlow = nettingSetMporPositiveFlow_[nettingSetId];
-        vector<vector<Real>> nettingSetMporNegativeFlow = nettingSetMporNegativeFlow_[nettingSetId];
+        nettingSet.mporPositiveFlow = &nettingSetMporPositiveFlow_[nettingSetId];
+        nettingSet.mporNegativeFlow = &nettingSetMporNegativeFlow_[nettingSetId];
 
         LOG("Aggregate exposure for netting set " << nettingSetId);
-        // Get the collateral account balance paths for the netting set.
-        // The pointer may remain empty if there is no CSA or if it is inactive.
-        QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral =
-            collateralPaths(nettingSetId,
-                            nettingSetValueToday[nettingSetId],
-                            nettingSetDefaultValue_[nettingSetId],
-                            nettingSetMaturity[nettingSetId]);
 
 	// Get the CSA index for Eonia Floor calculation below
         colva_[nettingSetId] = 0.0;
         collateralFloor_[nettingSetId] = 0.0;
-        string csaIndexName;
-        Handle<IborIndex> csaIndex;
+        nettingSet.csaDayCounter = ActualActual(ActualActual::ISDA);
         bool applyInitialMargin = false;
-        CSA::Type initialMarginType = CSA::Bilateral;
         if (netting->activeCsaFlag()) {
-            csaIndexName = netting->csaDetails()->index();
-            if (csaIndexName != "") {
-                csaIndex = market_->iborIndex(csaIndexName);
-                QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::IndexFixing, csaIndexName),
-                           "scenario data does not provide index values for " << csaIndexName);
+            nettingSet.csaIndexName = netting->csaDetails()->index();
+            if (nettingSet.csaIndexName != "") {
+                nettingSet.csaDayCounter = market_->iborIndex(nettingSet.csaIndexName)->dayCounter();
+                QL_REQUIRE(scenarioData_->has(AggregationScenarioDataType::IndexFixing, nettingSet.csaIndexName),
+                           "scenario data does not provide index values for " << nettingSet.csaIndexName);
             }
             QL_REQUIRE(netting->csaDetails(), "active CSA for netting set " << nettingSetId
                     << ", but CSA details not initialised");
             applyInitialMargin = netting->csaDetails()->applyInitialMargin() && applyInitialMargin_;
-            initialMarginType = netting->csaDetails()->initialMarginType();
+            nettingSet.initialMarginType = netting->csaDetails()->initialMarginType();
             LOG("ApplyInitialMargin=" << applyInitialMargin << " for netting set " << nettingSetId 
                 << ", CSA IM=" << netting->csaDetails()->applyInitialMargin()
-                << ", CSA IM Type=" << initialMarginType
+                << ", CSA IM Type=" << nettingSet.initialMarginType
                 << ", Analytics DIM=" << applyInitialMargin_);
             if (applyInitialMargin_ && !netting->csaDetails()->applyInitialMargin())
                 ALOG("ApplyInitialMargin deactivated at netting set level " << nettingSetId);
             if (!applyInitialMargin_ && netting->csaDetails()->applyInitialMargin())
                 ALOG("ApplyInitialMargin deactivated in analytics, but active at netting set level " << nettingSetId);
+            collateralRatesToday(nettingSetId, nettingSet.csaFxRateToday, nettingSet.csaRateToday);
         }
+        // don't apply initial margin without VM, i.e. inactive CSA
+        if (applyInitialMargin)
+            nettingSet.dim = &dimCalculator_->dynamicIM(nettingSetId);
 
         // Retrieve the constant independent amount from the CSA data and the VM balance
         // This is used below to reduce the exposure across all paths and time steps.
         // See below for the conversion to base currency.
         Real initialVM = 0, initialVMbase = 0;
         Real initialIM = 0, initialIMbase = 0;
-        string csaCurrency = "";
         if (netting->activeCsaFlag() && balance) {
             initialVM = balance->variationMargin();
             initialIM = balance->initialMargin();
@@ -206,190 +236,232 @@ void NettedExposureCalculator::build() {
             DLOG("Netting set " << nettingSetId << ", IA base = VM base = 0");
         }
         
-        Handle<YieldTermStructure> curve = market_->discountCurve(baseCurrency_, configuration_);
-        vector<Real> epe(cube_->dates().size() + 1, 0.0);
-        vector<Real> ene(cube_->dates().size() + 1, 0.0);
-        vector<Real> ee_b(cube_->dates().size() + 1, 0.0);
-        vector<Real> eee_b(cube_->dates().size() + 1, 0.0);
-        vector<Real> eee_b_kva_1(cube_->dates().size() + 1, 0.0);
-        vector<Real> eee_b_kva_2(cube_->dates().size() + 1, 0.0);
-        vector<Real> eepe_b_kva_1(cube_->dates().size() + 1, 0.0);
-        vector<Real> eepe_b_kva_2(cube_->dates().size() + 1, 0.0);
-        vector<Real> eab(cube_->dates().size() + 1, 0.0);
-        vector<Real> pfe(cube_->dates().size() + 1, 0.0);
-        vector<Real> colvaInc(cube_->dates().size() + 1, 0.0);
-        vector<Real> eoniaFloorInc(cube_->dates().size() + 1, 0.0);
+        nettingSet.epe = vector<Real>(nDates + 1, 0.0);
+        nettingSet.ene = vector<Real>(nDates + 1, 0.0);
+        nettingSet.eab = vector<Real>(nDates + 1, 0.0);
+        nettingSet.pfe = vector<Real>(nDates + 1, 0.0);
+        nettingSet.colvaInc = vector<Real>(nDates + 1, 0.0);
+        nettingSet.eoniaFloorInc = vector<Real>(nDates + 1, 0.0);
         Real npv = nettingSetValueToday[nettingSetId];
         if ((fullInitialCollateralisation_) & (netting->activeCsaFlag())) {
             // This assumes that the collateral at t=0 is the same as the npv at t=0.
-            epe[0] = 0;
-            ene[0] = 0;
-            pfe[0] = 0;
+            nettingSet.epe[0] = 0;
+            nettingSet.ene[0] = 0;
+            nettingSet.pfe[0] = 0;
         } else {
-            epe[0] = std::max(npv - initialVMbase - initialIMbase, 0.0);
-            ene[0] = std::max(-npv + initialVMbase, 0.0);
-            pfe[0] = std::max(npv - initialVMbase - initialIMbase, 0.0);
+            nettingSet.epe[0] = std::max(npv - initialVMbase - initialIMbase, 0.0);
+            nettingSet.ene[0] = std::max(-npv + initialVMbase, 0.0);
+            nettingSet.pfe[0] = std::max(npv - initialVMbase - initialIMbase, 0.0);
         }
         // The fullInitialCollateralisation flag doesn't affect the eab, which feeds into the "ExpectedCollateral"
         // column of the 'exposure_nettingset_*' reports.  We always assume the full collateral here.
-        eab[0] = npv;
-        ee_b[0] = epe[0];
-        eee_b[0] = ee_b[0];
-        nettedCube_->setT0(npv, nettingSetCount);
-        exposureCube_->setT0(epe[0], nettingSetCount, ExposureIndex::EPE);
-        exposureCube_->setT0(ene[0], nettingSetCount, ExposureIndex::ENE);
-
-        for (Size j = 0; j < cube_->dates().size(); ++j) {
-
-            Date date = cube_->dates()[j];
-            Date prevDate = j > 0 ? cube_->dates()[j - 1] : today;
-            vector<Real> distribution(cube_->samples(), 0.0);
-            for (Size k = 0; k < cube_->samples(); ++k) {
-                Real balance = 0.0;
-                if (collateral) {
-                    balance = collateral->at(k)->accountBalance(date);
-                    if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
-                        // Convert from CSACurrency to baseCurrency
-                        double fxRate = scenarioData_->get(j, k, AggregationScenarioDataType::FXSpot,
-                                                           netting->csaDetails()->csaCurrency());
-                        balance *= fxRate;
-                    }
-                }
-                
-                eab[j + 1] += balance / cube_->samples();
-                
-                Real mporCashFlow = 0;
-                // If ActualDate is active, then the cash flows over mpor can be configured.
-                // Otherwise (StickyDate is active), it is assumed that no cash flow over mpor is paid out.
-                if (!withMporStickyDate_) {
-                    if (mporCashFlowMode_ == MporCashFlowMode::BothPay) {
-                        // in cube generation -actual date- the (+/-) cashflows over mpor are
-                        // payed out, i.e. are not part of the exposure .
-                        mporCashFlow = 0;
-                    } else if (mporCashFlowMode_ == MporCashFlowMode::NonePay) {
-                        // +/- cashflows is to be incorporated in the exposure
-                        mporCashFlow = (nettingSetMporPositiveFlow[j][k] + nettingSetMporNegativeFlow[j][k]);
-                    } else if (mporCashFlowMode_ ==
-                               MporCashFlowMode::WePay) { 
-                        // only positive cash flows (i.e. cp's cashflows) is to be
-                        // incorporated in the exposure, since cp does not pay out cash
-                        // flows
-                        mporCashFlow = nettingSetMporPositiveFlow[j][k];
-                    } else if (mporCashFlowMode_ ==
-                               MporCashFlowMode::TheyPay) { // onyl negative cash flows (i.e. our cashflows)  is to be
-                        // incorporated in the exposure,  ince we do not pay out cash
-                        // flows
-                        mporCashFlow = nettingSetMporNegativeFlow[j][k];
-                    }
+        nettingSet.eab[0] = npv;
+        nettedCube_->setT0(npv, nettingSet.index);
+        exposureCube_->setT0(nettingSet.epe[0], nettingSet.index, ExposureIndex::EPE);
+        exposureCube_->setT0(nettingSet.ene[0], nettingSet.index, ExposureIndex::ENE);
+
+        nettingSets.push_back(nettingSet);
+    }
+
+    // Get the collateral account balance paths for the netting sets.
+    // The pointer may remain empty if there is no CSA or if it is inactive.
+    parallelFor(nettingSets.size(), nThreads_, [&](Size n) {
+        NettingSetData& nettingSet = nettingSets[n];
+        nettingSet.collateral = collateralPaths(nettingSet.id, nettingSetValueToday.at(nettingSet.id),
+                                                nettingSetDefaultValue_.at(nettingSet.id),
+                                                nettingSetMaturity.at(nettingSet.id), nettingSet.csaFxRateToday,
+                                                nettingSet.csaRateToday);
+    });
+
+    // One job per netting set and date. A job only writes the date j entries of its netting set's profiles, its
+    // netting set's (and trades') cube slots for date j and the date j allocations of the netting set's trades.
+    auto aggregate = [&](NettingSetData& nettingSet, Size j) {
+        const string& nettingSetId = nettingSet.id;
+        const QuantLib::ext::shared_ptr<NettingSetDefinition>& netting = nettingSet.netting;
+        const auto& collateral = nettingSet.collateral;
+        const vector<vector<Real>>& data = *nettingSet.data;
+        const vector<vector<Real>>& nettingSetMporPositiveFlow = *nettingSet.mporPositiveFlow;
+        const vector<vector<Real>>& nettingSetMporNegativeFlow = *nettingSet.mporNegativeFlow;
+        const vector<Size>& trades = *nettingSet.trades;
+
+        Date date = cube_->dates()[j];
+        Date prevDate = j > 0 ? cube_->dates()[j - 1] : today;
+        Real dcf = nettingSet.csaDayCounter.yearFraction(prevDate, date);
+        vector<Real> distribution(samples, 0.0);
+        vector<Real> nettedValues(samples, 0.0);
+        vector<Real> epeValues(multiPath_ ? samples : 0), eneValues(multiPath_ ? samples : 0);
+        vector<Real> balances(marginalAllocation_ ? samples : 0);
+        Real& epe = nettingSet.epe[j + 1];
+        Real& ene = nettingSet.ene[j + 1];
+        Real& eab = nettingSet.eab[j + 1];
+        for (Size k = 0; k < samples; ++k) {
+            Real balance = 0.0;
+            if (collateral) {
+                balance = collateral->at(k)->accountBalance(date);
+                if (netting->csaDetails()->csaCurrency() != baseCurrency_) {
+                    // Convert from CSACurrency to baseCurrency
+                    double fxRate = scenarioData_->get(j, k, AggregationScenarioDataType::FXSpot,
+                                                       netting->csaDetails()->csaCurrency());
+                    balance *= fxRate;
                 }
-                Real exposure = data[j][k] - balance + mporCashFlow;
-                Real dim = 0.0;
-                if (applyInitialMargin && collateral) { // don't apply initial margin without VM, i.e. inactive CSA
-                    // Initial Margin
-                    // Use IM to reduce exposure
-                    // Size dimIndex = j == 0 ? 0 : j - 1;
-                    Size dimIndex = j;
-                    dim = dimCalculator_->dynamicIM(nettingSetId)[dimIndex][k];
-                    QL_REQUIRE(dim >= 0, "negative DIM for set " << nettingSetId << ", date " << j << ", sample " << k
-                                                                 << ": " << dim);
+            }
+
+            eab += balance / samples;
+
+            Real mporCashFlow = 0;
+            // If ActualDate is active, then the cash flows over mpor can be configured.
+            // Otherwise (StickyDate is active), it is assumed that no cash flow over mpor is paid out.
+            if (!withMporStickyDate_) {
+                if (mporCashFlowMode_ == MporCashFlowMode::BothPay) {
+                    // in cube generation -actual date- the (+/-) cashflows over mpor are
+                    // payed out, i.e. are not part of the exposure .
+                    mporCashFlow = 0;
+                } else if (mporCashFlowMode_ == MporCashFlowMode::NonePay) {
+                    // +/- cashflows is to be incorporated in the exposure
+                    mporCashFlow = (nettingSetMporPositiveFlow[j][k] + nettingSetMporNegativeFlow[j][k]);
+                } else if (mporCashFlowMode_ ==
+                           MporCashFlowMode::WePay) { 
+                    // only positive cash flows (i.e. cp's cashflows) is to be
+                    // incorporated in the exposure, since cp does not pay out cash
+                    // flows
+                    mporCashFlow = nettingSetMporPositiveFlow[j][k];
+                } else if (mporCashFlowMode_ ==
+                           MporCashFlowMode::TheyPay) { // onyl negative cash flows (i.e. our cashflows)  is to be
+                    // incorporated in the exposure,  ince we do not pay out cash
+                    // flows
+                    mporCashFlow = nettingSetMporNegativeFlow[j][k];
                 }
-                Real dim_epe = 0;
-                Real dim_ene = 0;
-                if (initialMarginType != CSA::Type::PostOnly)
-                    dim_epe = dim;
-                if (initialMarginType != CSA::Type::CallOnly)
-                    dim_ene = dim;
-                
-                // dim here represents the held IM, and is expressed as a positive number
-                epe[j + 1] += std::max(exposure - dim_epe, 0.0) / cube_->samples(); 
-                // dim here represents the posted IM, and is expressed as a positive number
-                ene[j + 1] += std::max(-exposure - dim_ene, 0.0) / cube_->samples(); 
-                distribution[k] = exposure - dim_epe;
-                nettedCube_->set(exposure, nettingSetCount, j, k);
-                
-                Real epeIncrement = std::max(exposure - dim_epe, 0.0) / cube_->samples();
-                DLOG("sample " << k << " date " << j << fixed << showpos << setprecision(2)
-                     << ": VM "  << setw(15) << balance
-                     << ": NPV " << setw(15) << data[j][k]
-                     << ": NPV-C " << setw(15) << distribution[k]
-                     << ": EPE " << setw(15) << epeIncrement);
-                
+            }
+            Real exposure = data[j][k] - balance + mporCashFlow;
+            Real dim = 0.0;
+            if (nettingSet.dim) {
+                // Initial Margin
+                // Use IM to reduce exposure
+                // Size dimIndex = j == 0 ? 0 : j - 1;
+                Size dimIndex = j;
+                dim = (*nettingSet.dim)[dimIndex][k];
+                QL_REQUIRE(dim >= 0, "negative DIM for set " << nettingSetId << ", date " << j << ", sample " << k
+                                                             << ": " << dim);
+            }
+            Real dim_epe = 0;
+            Real dim_ene = 0;
+            if (nettingSet.initialMarginType != CSA::Type::PostOnly)
+                dim_epe = dim;
+            if (nettingSet.initialMarginType != CSA::Type::CallOnly)
+                dim_ene = dim;
+
+            // dim here represents the held IM, and is expressed as a positive number
+            epe += std::max(exposure - dim_epe, 0.0) / samples; 
+            // dim here represents the posted IM, and is expressed as a positive number
+            ene += std::max(-exposure - dim_ene, 0.0) / samples; 
+            distribution[k] = exposure - dim_epe;
+            nettedValues[k] = exposure;
+
+            Real epeIncrement = std::max(exposure - dim_epe, 0.0) / samples;
+            DLOG("sample " << k << " date " << j << fixed << showpos << setprecision(2)
+                 << ": VM "  << setw(15) << balance
+                 << ": NPV " << setw(15) << data[j][k]
+                 << ": NPV-C " << setw(15) << distribution[k]
+                 << ": EPE " << setw(15) << epeIncrement);
+
+            if (multiPath_) {
+                epeValues[k] = std::max(exposure - dim_epe, 0.0);
+                eneValues[k] = std::max(-exposure - dim_ene, 0.0);
+            }
+
+            if (netting->activeCsaFlag()) {
+                Real indexValue = 0.0;
+                if (nettingSet.csaIndexName != "")
+                    indexValue = scenarioData_->get(j, k, AggregationScenarioDataType::IndexFixing,
+                                                    nettingSet.csaIndexName);
+                Real collateralSpread = (balance >= 0.0 ? netting->csaDetails()->collatSpreadRcv() : netting->csaDetails()->collatSpreadPay());
+                Real numeraire = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
+                Real colvaDelta = -balance * collateralSpread * dcf / numeraire / samples;
+                // intuitive floorDelta including collateralSpread would be:
+                // -balance * (max(indexValue - collateralSpread,0) - (indexValue - collateralSpread)) * dcf /
+                // samples
+                Real floorDelta = -balance * std::max(-(indexValue - collateralSpread), 0.0) * dcf / numeraire / samples;
+                nettingSet.colvaInc[j + 1] += colvaDelta;
+                nettingSet.eoniaFloorInc[j + 1] += floorDelta;
+            }
+
+            if (marginalAllocation_)
+                balances[k] = balance;
+        }
+
+        if (marginalAllocation_) {
+            // allocate the netting set exposure to the netting set's trades, reading each trade's default NPVs once
+            vector<Real> npvs, epeAllocation, eneAllocation;
+            for (Size i : trades) {
+                cubeInterpretation_->getDefaultNpvs(cube_, i, j, npvs);
                 if (multiPath_) {
-                    exposureCube_->set(std::max(exposure - dim_epe, 0.0), nettingSetCount, j, k, ExposureIndex::EPE);
-                    exposureCube_->set(std::max(-exposure - dim_ene, 0.0), nettingSetCount, j, k, ExposureIndex::ENE);
+                    tradeExposureCube_->getSamples(epeAllocation, i, j, allocatedEpeIndex_);
+                    tradeExposureCube_->getSamples(eneAllocation, i, j, allocatedEneIndex_);
                 }
- 
-                if (netting->activeCsaFlag()) {
-                    Real indexValue = 0.0;
-                    DayCounter dc = ActualActual(ActualActual::ISDA);
-                    if (csaIndexName != "") {
-                        indexValue = scenarioData_->get(j, k, AggregationScenarioDataType::IndexFixing, csaIndexName);
-                        dc = csaIndex->dayCounter();
-                    }
-                    Real dcf = dc.yearFraction(prevDate, date);
-                    Real collateralSpread = (balance >= 0.0 ? netting->csaDetails()->collatSpreadRcv() : netting->csaDetails()->collatSpreadPay());
-                    Real numeraire = scenarioData_->get(j, k, AggregationScenarioDataType::Numeraire);
-                    Real colvaDelta = -balance * collateralSpread * dcf / numeraire / cube_->samples();
-                    // intuitive floorDelta including collateralSpread would be:
-                    // -balance * (max(indexValue - collateralSpread,0) - (indexValue - collateralSpread)) * dcf /
-                    // samples
-                    Real floorDelta = -balance * std::max(-(indexValue - collateralSpread), 0.0) * dcf / numeraire / cube_->samples();
-                    colvaInc[j + 1] += colvaDelta;
-                    colva_[nettingSetId] += colvaDelta;
-                    eoniaFloorInc[j + 1] += floorDelta;
-                    collateralFloor_[nettingSetId] += floorDelta;
-                }
-
-                if (marginalAllocation_) {
-                    Size i = 0;
-                    for (auto tradeIt = portfolio_->trades().begin(); tradeIt != portfolio_->trades().end();
-                         ++tradeIt, ++i) {
-                        const auto& trade = tradeIt->second;
-                        string nid = trade->envelope().nettingSetId();
-                        if (nid != nettingSetId)
-                            continue;
-                        
-                        Real allocation = 0.0;
-                        if (balance == 0.0)
-                            allocation = cubeInterpretation_->getDefaultNpv(cube_, i, j, k);
-                        // else if (data[j][k] == 0.0)
-                        else if (fabs(data[j][k]) <= marginalAllocationLimit_)
-                            allocation = exposure / nettingSetSize[nid];
+                for (Size k = 0; k < samples; ++k) {
+                    Real exposure = nettedValues[k];
+                    Real allocation = 0.0;
+                    if (balances[k] == 0.0)
+                        allocation = npvs[k];
+                    // else if (data[j][k] == 0.0)
+                    else if (fabs(data[j][k]) <= marginalAllocationLimit_)
+                        allocation = exposure / trades.size();
+                    else
+                        allocation = exposure * npvs[k] / data[j][k];
+
+                    if (multiPath_) {
+                        if (exposure > 0.0)
+                            epeAllocation[k] = allocation;
+                        else
+                            eneAllocation[k] = -allocation;
+                    } else {
+                        if (exposure > 0.0)
+                            averagePositiveAllocation[i][j] += allocation / samples;
                         else
-                            allocation = exposure * cubeInterpretation_->getDefaultNpv(cube_, i, j, k) / data[j][k];
-
-                        if (multiPath_) {
-                            if (exposure > 0.0)
-                                tradeExposureCube_->set(allocation, i, j, k, allocatedEpeIndex_);
-                            else
-                                tradeExposureCube_->set(-allocation, i, j, k, allocatedEneIndex_);
-                        } else {
-                            if (exposure > 0.0)
-                                averagePositiveAllocation[i][j] += allocation / cube_->samples();
-                            else
-                                averageNegativeAllocation[i][j] -= allocation / cube_->samples();
-                        }
+                            averageNegativeAllocation[i][j] -= allocation / samples;
                     }
                 }
+                if (multiPath_) {
+                    tradeExposureCube_->setSamples(epeAllocation, i, j, allocatedEpeIndex_);
+                    tradeExposureCube_->setSamples(eneAllocation, i, j, allocatedEneIndex_);
+                }
             }
-            if (!multiPath_) {
-                exposureCube_->set(epe[j + 1], nettingSetCount, j, 0, ExposureIndex::EPE);
-                exposureCube_->set(ene[j + 1], nettingSetCount, j, 0, ExposureIndex::ENE);
-            }
-            ee_b[j + 1] = epe[j + 1] / curve->discount(cube_->dates()[j]);
+        }
+
+        nettedCube_->setSamples(nettedValues, nettingSet.index, j);
+        if (multiPath_) {
+            exposureCube_->setSamples(epeValues, nettingSet.index, j, ExposureIndex::EPE);
+            exposureCube_->setSamples(eneValues, nettingSet.index, j, ExposureIndex::ENE);
+        } else {
+            exposureCube_->set(epe, nettingSet.index, j, 0, ExposureIndex::EPE);
+            exposureCube_->set(ene, nettingSet.index, j, 0, ExposureIndex::ENE);
+        }
+        Size index = Size(floor(quantile_ * (samples - 1) + 0.5));
+        std::nth_element(distribution.begin(), distribution.begin() + index, distribution.end());
+        nettingSet.pfe[j + 1] = std::max(distribution[index], 0.0);
+    };
+
+    parallelFor(nettingSets.size() * nDates, nThreads_,
+                [&](Size k) { aggregate(nettingSets[k / nDates], k % nDates); });
+
+    for (auto& nettingSet : nettingSets) {
+        const string& nettingSetId = nettingSet.id;
+        vector<Real> ee_b(nDates + 1, 0.0);
+        vector<Real> eee_b(nDates + 1, 0.0);
+        ee_b[0] = nettingSet.epe[0];
+        eee_b[0] = ee_b[0];
+        for (Size j = 0; j < nDates; ++j) {
+            ee_b[j + 1] = nettingSet.epe[j + 1] / discounts[j];
             eee_b[j + 1] = std::max(eee_b[j], ee_b[j + 1]);
-            std::sort(distribution.begin(), distribution.end());
-            Size index = Size(floor(quantile_ * (cube_->samples() - 1) + 0.5));
-            pfe[j + 1] = std::max(distribution[index], 0.0);
+            colva_[nettingSetId] += nettingSet.colvaInc[j + 1];
+            collateralFloor_[nettingSetId] += nettingSet.eoniaFloorInc[j + 1];
         }
         ee_b_[nettingSetId] = ee_b;
         eee_b_[nettingSetId] = eee_b;
-        pfe_[nettingSetId] = pfe;
-        expectedCollateral_[nettingSetId] = eab;
-        colvaInc_[nettingSetId] = colvaInc;
-        eoniaFloorInc_[nettingSetId] = eoniaFloorInc;
-
-        nettingSetCount++;
+        pfe_[nettingSetId] = std::move(nettingSet.pfe);
+        expectedCollateral_[nettingSetId] = std::move(nettingSet.eab);
+        colvaInc_[nettingSetId] = std::move(nettingSet.colvaInc);
+        eoniaFloorInc_[nettingSetId] = std::move(nettingSet.eoniaFloorInc);
 
         Real epe_b = 0;
         Real eepe_b = 0;
@@ -399,7 +471,7 @@ void NettedExposureCalculator::build() {
         Date maturity = std::min(cal.adjust(today + 1 * Years + 4 * Days), nettingSetMaturity[nettingSetId]);
         QuantLib::Real maturityTime = dc.yearFraction(today, maturity);
 
-        while (t < cube_->dates().size() && times[t] <= maturityTime)
+        while (t < nDates && times[t] <= maturityTime)
             ++t;
 
         if (t > 0) {
@@ -422,7 +494,7 @@ void NettedExposureCalculator::build() {
                 
     if (marginalAllocation_ && !multiPath_) {
         for (Size i = 0; i < portfolio_->trades().size(); ++i) {
-            for (Size j = 0; j < cube_->dates().size(); ++j) {
+            for (Size j = 0; j < nDates; ++j) {
                 tradeExposureCube_->set(averagePositiveAllocation[i][j], i, j, 0, allocatedEpeIndex_);
                 tradeExposureCube_->set(averageNegativeAllocation[i][j], i, j, 0, allocatedEneIndex_);
             }
@@ -430,12 +502,34 @@ void NettedExposureCalculator::build() {
     }
 }
 
+void NettedExposureCalculator::collateralRatesToday(const string& nettingSetId, Real& csaFxRateToday,
+                                                    Real& csaRateToday) {
+    QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
+    string csaFxPair = netting->csaDetails()->csaCurrency() + baseCurrency_;
+    csaFxRateToday = 1.0;
+    if (netting->csaDetails()->csaCurrency() != baseCurrency_)
+        csaFxRateToday = market_->fxRate(csaFxPair, configuration_)->value();
+    LOG("CSA FX rate for pair " << csaFxPair << " = " << csaFxRateToday);
+
+    // Don't use Settings::instance().evaluationDate() here, this has moved to simulation end date.
+    Date today = market_->asofDate();
+    string csaIndexName = netting->csaDetails()->index();
+    // avoid thrown errors of the index fixing here on holidays of the index, instead take the preceding date then.
+    if (!market_->iborIndex(csaIndexName, configuration_)->isValidFixingDate(today)) {
+        today = market_->iborIndex(csaIndexName, configuration_)->fixingCalendar().adjust(today, Preceding);
+    }
+    csaRateToday = market_->iborIndex(csaIndexName, configuration_)->fixing(today);
+    LOG("CSA compounding rate for index " << csaIndexName << " = " << setprecision(8) << csaRateToday << " as of " << today);
+}
+
 QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
 NettedExposureCalculator::collateralPaths(
     const string& nettingSetId,
     const Real& nettingSetValueToday,
     const vector<vector<Real>>& nettingSetValue,
-    const Date& nettingSetMaturity) {
+    const Date& nettingSetMaturity,
+    const Real csaFxRateToday,
+    const Real csaRateToday) {
 
     QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>> collateral;
 
@@ -454,20 +548,7 @@ NettedExposureCalculator::collateralPaths(
     LOG("Build collateral account balance paths for netting set " << nettingSetId);
     QuantLib::ext::shared_ptr<NettingSetDefinition> netting = nettingSetManager_->get(nettingSetId);
     string csaFxPair = netting->csaDetails()->csaCurrency() + baseCurrency_;
-    Real csaFxRateToday = 1.0;
-    if (netting->csaDetails()->csaCurrency() != baseCurrency_)
-        csaFxRateToday = market_->fxRate(csaFxPair, configuration_)->value();
-    LOG("CSA FX rate for pair " << csaFxPair << " = " << csaFxRateToday);
-
-    // Don't use Settings::instance().evaluationDate() here, this has moved to simulation end date.
-    Date today = market_->asofDate();
     string csaIndexName = netting->csaDetails()->index();
-    // avoid thrown errors of the index fixing here on holidays of the index, instead take the preceding date then.
-    if (!market_->iborIndex(csaIndexName, configuration_)->isValidFixingDate(today)) {
-        today = market_->iborIndex(csaIndexName, configuration_)->fixingCalendar().adjust(today, Preceding);
-    }
-    Real csaRateToday = market_->iborIndex(csaIndexName, configuration_)->fixing(today);
-    LOG("CSA compounding rate for index " << csaIndexName << " = " << setprecision(8) << csaRateToday << " as of " << today);
 
     // Copy scenario data to keep the collateral exposure helper unchanged
     vector<vector<Real>> csaScenFxRates(cube_->dates().size(), vector<Real>(cube_->samples(), 0.0));
@@ -514,17 +595,16 @@ NettedExposureCalculator::collateralPaths(
 
 vector<Real> NettedExposureCalculator::getMeanExposure(const string& tid, ExposureIndex index) {
     vector<Real> exp(cube_->dates().size() + 1, 0.0);
-    exp[0] = exposureCube_->getT0(tid, index);
+    Size nettingSetIdx = exposureCube_->getTradeIndex(tid);
+    exp[0] = exposureCube_->getT0(nettingSetIdx, index);
+    vector<Real> values;
     for (Size i = 0; i < cube_->dates().size(); i++) {
         if (multiPath_) {
-	        for (Size k = 0; k < exposureCube_->samples(); k++) {
-	            exp[i + 1] += exposureCube_->get(tid, cube_->dates()[i], k, index);
-	        }
-	        exp[i + 1] /= exposureCube_->samples();
-	    }
-	    else {
-	        exp[i + 1] = exposureCube_->get(tid, cube_->dates()[i], 0, index);
-	    }
+            exposureCube_->getSamples(values, nettingSetIdx, i, index);
+            exp[i + 1] = std::accumulate(values.begin(), values.end(), 0.0) / exposureCube_->samples();
+        } else {
+            exp[i + 1] = exposureCube_->get(nettingSetIdx, i, 0, index);
+        }
     }
     return exp;
 }
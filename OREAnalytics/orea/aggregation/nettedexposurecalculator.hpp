@@ -60,7 +60,9 @@ public:
         // Marginal Allocation
         const bool marginalAllocation, const Real marginalAllocationLimit,
         const QuantLib::ext::shared_ptr<NPVCube>& tradeExposureCube, const Size allocatedEpeIndex, const Size allocatedEneIndex,
-        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode);
+        const bool flipViewXVA, const bool withMporStickyDate, const MporCashFlowMode mporCashFlowMode,
+        // Number of threads used to build collateral paths and aggregate over netting sets and dates
+        const Size nThreads = 1);
 
     virtual ~NettedExposureCalculator() {}
     const QuantLib::ext::shared_ptr<NPVCube>& exposureCube() { return exposureCube_; }
@@ -137,14 +139,21 @@ protected:
     map<string, Real> collateralFloor_;
     vector<Real> getMeanExposure(const string& tid, ExposureIndex index);
 
+    //! Today's CSA FX rate (CSA currency to base currency) and CSA compounding rate, read from the market
+    void collateralRatesToday(const string& nettingSetId, Real& csaFxRateToday, Real& csaRateToday);
+
+    //! Collateral balance paths, does not access the market and can be called from worker threads
     QuantLib::ext::shared_ptr<vector<QuantLib::ext::shared_ptr<CollateralAccount>>>
     collateralPaths(const string& nettingSetId,
         const Real& nettingSetValueToday,
         const vector<vector<Real>>& nettingSetValue,
-        const Date& nettingSetMaturity);
+        const Date& nettingSetMaturity,
+        const Real csaFxRateToday,
+        const Real csaRateToday);
 
     bool withMporStickyDate_;
     MporCashFlowMode mporCashFlowMode_;
+    Size nThreads_;
 };
 
 } // namespace analytics
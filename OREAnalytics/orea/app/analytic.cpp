@@ -30,6 +30,7 @@
 #include <orea/aggregation/dimregressioncalculator.hpp>
 
 #include <ored/marketdata/compositeloader.hpp>
+#include <ored/marketdata/curvecache.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 #include <ored/marketdata/bondspreadimply.hpp>
 #include <ored/portfolio/builders/currencyswap.hpp>
@@ -196,11 +197,14 @@ void Analytic::buildMarket(const QuantLib::ext::shared_ptr<ore::data::InMemoryLo
             // Check that the loader has quotes
             QL_REQUIRE(loader_->hasQuotes(configurations().asofDate),
                        "There are no quotes available for date " << configurations().asofDate);
-            // Build the market
+            // Build the market, using the curve cache if configured
+            QuantLib::ext::shared_ptr<CurveCache> curveCache;
+            if (!inputs()->curveCacheDirectory().empty())
+                curveCache = QuantLib::ext::make_shared<CurveCache>(inputs()->curveCacheDirectory());
             market_ = QuantLib::ext::make_shared<TodaysMarket>(
                 configurations().asofDate, configurations().todaysMarketParams, loader_, configurations().curveConfig,
                 inputs()->continueOnError(), true, inputs()->lazyMarketBuilding(), inputs()->refDataManager(), false,
-                *inputs()->iborFallbackConfig());
+                *inputs()->iborFallbackConfig(), true, true, inputs()->nThreads(), curveCache);
         } catch (const std::exception& e) {
             if (marketRequired)
                 QL_FAIL("Failed to build market: " << e.what());
@@ -78,7 +78,11 @@ void SimmAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::In
                                                    inputs_->simmResultCurrency(),
                                                    analytic()->market(),
                                                    simmAnalytic->determineWinningRegulations(),
-                                                   inputs_->enforceIMRegulations());
+                                                   inputs_->enforceIMRegulations(),
+                                                   false,
+                                                   std::map<SimmCalculator::SimmSide, std::set<NettingSetDetails>>(),
+                                                   std::map<SimmCalculator::SimmSide, std::set<NettingSetDetails>>(),
+                                                   inputs_->simmThreads());
 
     Real fxSpot = 1.0;
     if (!inputs_->simmReportingCurrency().empty()) {
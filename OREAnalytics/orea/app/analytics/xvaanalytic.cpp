@@ -35,6 +35,11 @@
 
 #include <ored/model/crossassetmodelbuilder.hpp>
 #include <ored/portfolio/structuredtradeerror.hpp>
+#include <ored/utilities/parallelfor.hpp>
+#include <ored/utilities/xmlutils.hpp>
+
+#include <ql/math/comparison.hpp>
+#include <ql/settings.hpp>
 
 using namespace ore::data;
 using namespace boost::filesystem;
@@ -147,11 +152,7 @@ void XvaAnalyticImpl::buildScenarioSimMarket() {
             *analytic()->configurations().todaysMarketParams, inputs_->continueOnError(), true, true, false,
             *inputs_->iborFallbackConfig(), false, offsetScenario_);
 
-        // Create a third market used for AMC and Postprocessor, holds a larger simmarket, e.g. default curves
-        offsetSimMarket_ = QuantLib::ext::make_shared<ScenarioSimMarket>(
-            analytic()->market(), offsetSimMarketParams_, QuantLib::ext::make_shared<FixingManager>(inputs_->asof()),
-            configuration, *inputs_->curveConfigs().get(), *analytic()->configurations().todaysMarketParams,
-            inputs_->continueOnError(), true, true, false, *inputs_->iborFallbackConfig(), false, offsetScenario_);
+        buildOffsetSimMarket();
 
         TLOG("XvaAnalytic: Offset Scenario used in building SimMarket");
         TLOG("XvaAnalytic: Offset scenario is absolute = " << offsetScenario_->isAbsolute());
@@ -174,6 +175,15 @@ void XvaAnalyticImpl::buildScenarioSimMarket() {
     }
 }
 
+void XvaAnalyticImpl::buildOffsetSimMarket() {
+    // A third market used for AMC and Postprocessor, holds a larger simmarket, e.g. default curves
+    offsetSimMarket_ = QuantLib::ext::make_shared<ScenarioSimMarket>(
+        analytic()->market(), offsetSimMarketParams_, QuantLib::ext::make_shared<FixingManager>(inputs_->asof()),
+        inputs_->marketConfig("simulation"), *inputs_->curveConfigs().get(),
+        *analytic()->configurations().todaysMarketParams, inputs_->continueOnError(), true, true, false,
+        *inputs_->iborFallbackConfig(), false, offsetScenario_);
+}
+
 void XvaAnalyticImpl::buildScenarioGenerator(const bool continueOnCalibrationError) {
     if (!model_)
         buildCrossAssetModel(continueOnCalibrationError);
@@ -652,7 +662,8 @@ void XvaAnalyticImpl::runPostProcessor() {
         kvaTheirPdFloor, kvaOurCvaRiskWeight, kvaTheirCvaRiskWeight, cptyCube_, flipViewBorrowingCurvePostfix,
         flipViewLendingCurvePostfix, inputs_->creditSimulationParameters(), inputs_->creditMigrationDistributionGrid(),
         inputs_->creditMigrationTimeSteps(), creditStateCorrelationMatrix(),
-        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode());
+        analytic()->configurations().scenarioGeneratorData->withMporStickyDate(), inputs_->mporCashFlowMode(),
+        inputs_->nThreads());
     LOG("post done");
 }
 
@@ -811,6 +822,9 @@ void XvaAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InM
             nettingSetCube_ = inputs_->nettingSetCube();
         if (inputs_->cptyCube())
             cptyCube_ = inputs_->cptyCube();
+        // the post processor runs under the offset scenario, if given, the cubes are used as they are
+        if (offsetScenario_ != nullptr)
+            buildOffsetSimMarket();
         CONSOLE("OK");
         ProgressMessage(msg, 1, 1).log();
     }
@@ -987,5 +1001,181 @@ Matrix XvaAnalyticImpl::creditStateCorrelationMatrix() const {
     return cmb.correlationMatrix(processInfo);
 }
 
+/*****************************************************
+ * XVA under offset scenarios: XVA_SENSITIVITY, XVA_STRESS
+ *****************************************************/
+
+namespace {
+
+// Risk factors that are not part of the simulation market can not change the npv, market or counterparty cubes nor
+// the model calibration. We only identify counterparty credit and funding curves as such, i.e. risk factors that
+// typically only enter the post processing. Everything else is considered to affect the simulation.
+bool affectsSimulation(const RiskFactorKey& key, const ScenarioSimMarketParameters& simMarketParams) {
+    using KeyType = RiskFactorKey::KeyType;
+    switch (key.keytype) {
+    case KeyType::SurvivalProbability:
+    case KeyType::RecoveryRate:
+    case KeyType::CDSVolatility:
+        return simMarketParams.hasParamsName(KeyType::SurvivalProbability, key.name) ||
+               simMarketParams.hasParamsName(key.keytype, key.name);
+    case KeyType::YieldCurve:
+        return simMarketParams.hasParamsName(key.keytype, key.name);
+    default:
+        return true;
+    }
+}
+
+bool affectsSimulation(const Scenario& scenario, const Scenario& baseScenario,
+                       const ScenarioSimMarketParameters& simMarketParams) {
+    for (auto const& key : scenario.keys()) {
+        if ((!baseScenario.has(key) || !QuantLib::close_enough(scenario.get(key), baseScenario.get(key))) &&
+            affectsSimulation(key, simMarketParams))
+            return true;
+    }
+    return false;
+}
+
+// call job(worker, i) for all i in indices on nThreads worker threads, each running in its own session
+void runOnWorkers(const std::vector<Size>& indices, Size nThreads, const std::function<void(Size, Size)>& job) {
+    Date today = Settings::instance().evaluationDate();
+    ObservationMode::Mode obsMode = ObservationMode::instance().mode();
+    parallelFor(
+        indices.size(), nThreads, [&job, &indices](Size w, Size k) { job(w, indices[k]); },
+        [today, obsMode]() {
+            Settings::instance().evaluationDate() = today;
+            ObservationMode::instance().setMode(obsMode);
+        });
+}
+
+} // namespace
+
+void runXvaAnalyticUnderScenarios(
+    const QuantLib::ext::shared_ptr<InputParameters>& inputs,
+    const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
+    const std::vector<QuantLib::ext::shared_ptr<Scenario>>& scenarios,
+    const QuantLib::ext::shared_ptr<Scenario>& baseScenario,
+    const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& offsetSimMarketParams, const std::string& label,
+    const std::function<void(Size, const QuantLib::ext::shared_ptr<XvaAnalytic>&)>& process) {
+
+    // Split the scenarios into those requiring a full simulation and those that can reuse the base run's cubes.
+    // The latter is not possible for amc runs, since the amc engine prices on the offset sim market, and can be
+    // switched off to check that it does not change the results.
+
+    Size baseIndex = Null<Size>();
+    for (Size i = 0; i < scenarios.size() && baseIndex == Null<Size>(); ++i)
+        if (scenarios[i] != nullptr && scenarios[i]->label() == "BASE")
+            baseIndex = i;
+
+    bool reuseCubes = inputs->xvaReuseBaseCubes() && baseIndex != Null<Size>() && baseScenario != nullptr &&
+                      !inputs->amc() && !inputs->amcCg();
+    std::vector<Size> fullRuns, postProcessingRuns;
+    for (Size i = 0; i < scenarios.size(); ++i) {
+        if (reuseCubes && i != baseIndex && scenarios[i] != nullptr &&
+            !affectsSimulation(*scenarios[i], *baseScenario, *inputs->exposureSimMarketParams()))
+            postProcessingRuns.push_back(i);
+        else
+            fullRuns.push_back(i);
+    }
+
+    Size nThreads = std::max<Size>(
+        1, std::min(inputs->analyticsThreads(), std::max(fullRuns.size(), postProcessingRuns.size())));
+#ifndef QL_ENABLE_SESSIONS
+    if (nThreads > 1) {
+        WLOG(label << ": analyticsThreads = " << inputs->analyticsThreads()
+                   << " requires a build with QL_ENABLE_SESSIONS = ON, run scenarios sequentially.");
+        nThreads = 1;
+    }
+#endif
+
+    LOG(label << ": " << fullRuns.size() << " scenarios require a simulation, " << postProcessingRuns.size()
+              << " scenarios reuse the cubes of the base run, using " << nThreads << " threads");
+
+    // Each worker thread gets its own copy of the inputs and the portfolio, since building the portfolio modifies
+    // the trades. A single worker uses the inputs as they are, as in a sequential run.
+
+    std::vector<QuantLib::ext::shared_ptr<InputParameters>> workerInputs(nThreads, inputs);
+    if (nThreads > 1) {
+        for (auto& w : workerInputs) {
+            w = QuantLib::ext::make_shared<InputParameters>(*inputs);
+            if (inputs->portfolio()) {
+                auto portfolio = QuantLib::ext::make_shared<Portfolio>(inputs->buildFailedTrades());
+                ore::data::XMLDocument doc;
+                portfolio->fromXML(inputs->portfolio()->toXML(doc));
+                w->setPortfolio(portfolio);
+            }
+        }
+    }
+    std::vector<QuantLib::ext::shared_ptr<Portfolio>> workerPortfolios;
+    for (auto const& w : workerInputs)
+        workerPortfolios.push_back(w->portfolio());
+
+    QuantLib::ext::shared_ptr<NPVCube> baseCube, baseNettingSetCube, baseCptyCube;
+    QuantLib::ext::shared_ptr<AggregationScenarioData> baseScenarioData;
+
+    auto runScenario = [&](Size w, Size i, bool postProcessingOnly) {
+        const auto& scenario = scenarios[i];
+        const std::string scenarioLabel = scenario != nullptr ? scenario->label() : std::string();
+        bool isBase = scenarioLabel == "BASE";
+        try {
+            DLOG("Calculate XVA for scenario " << scenarioLabel);
+            CONSOLE(label << ": Apply scenario " << scenarioLabel);
+            auto analytic = QuantLib::ext::make_shared<XvaAnalytic>(workerInputs[w], isBase ? nullptr : scenario,
+                                                                    isBase ? nullptr : offsetSimMarketParams);
+            if (postProcessingOnly) {
+                CONSOLE(label << ": Calculate XVA on the exposure of the base scenario");
+                analytic->runAnalytic(loader, {"XVA"});
+            } else {
+                CONSOLE(label << ": Calculate Exposure and XVA");
+                analytic->runAnalytic(loader, {"EXPOSURE", "XVA"});
+            }
+            if (i == baseIndex) {
+                auto impl = static_cast<XvaAnalyticImpl*>(analytic->impl().get());
+                baseCube = impl->cube();
+                baseNettingSetCube = impl->nettingSetCube();
+                baseCptyCube = impl->cptyCube();
+                baseScenarioData = impl->scenarioData();
+            }
+            process(i, analytic);
+        } catch (const std::exception& e) {
+            StructuredAnalyticsErrorMessage(label, "XVACalc",
+                                            "Error during XVA calc under scenario " + scenarioLabel + ", got " +
+                                                e.what() + ". Skip it")
+                .log();
+        }
+    };
+
+    runOnWorkers(fullRuns, nThreads, [&runScenario](Size w, Size i) { runScenario(w, i, false); });
+
+    if (!postProcessingRuns.empty()) {
+        if (baseCube != nullptr && baseScenarioData != nullptr) {
+            for (auto& w : workerInputs) {
+                w = QuantLib::ext::make_shared<InputParameters>(*w);
+                w->setCube(baseCube);
+                w->setMarketCube(baseScenarioData);
+                w->setNettingSetCube(baseNettingSetCube);
+                w->setCptyCube(baseCptyCube);
+            }
+            runOnWorkers(postProcessingRuns, nThreads, [&runScenario](Size w, Size i) { runScenario(w, i, true); });
+        } else {
+            WLOG(label << ": base scenario run did not produce cubes, run remaining scenarios with full simulation");
+            runOnWorkers(postProcessingRuns, nThreads, [&runScenario](Size w, Size i) { runScenario(w, i, false); });
+        }
+    }
+
+    // accumulate the pricing stats of the portfolio copies on the original trades
+
+    if (nThreads > 1 && inputs->portfolio()) {
+        for (auto const& p : workerPortfolios) {
+            if (p == nullptr)
+                continue;
+            for (auto const& [tid, t] : inputs->portfolio()->trades()) {
+                if (auto c = p->trades().find(tid); c != p->trades().end())
+                    t->resetPricingStats(t->getNumberOfPricings() + c->second->getNumberOfPricings(),
+                                         t->getCumulativePricingTime() + c->second->getCumulativePricingTime());
+            }
+        }
+    }
+}
+
 } // namespace analytics
 } // namespace ore
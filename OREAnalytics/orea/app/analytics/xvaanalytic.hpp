@@ -24,6 +24,8 @@
 
 #include <orea/app/analytic.hpp>
 
+#include <functional>
+
 namespace ore {
 namespace analytics {
 
@@ -46,9 +48,20 @@ public:
 
     void checkConfigurations(const QuantLib::ext::shared_ptr<Portfolio>& portfolio);
 
+    //! \name Cubes generated or loaded by the last run
+    //@{
+    const QuantLib::ext::shared_ptr<NPVCube>& cube() const { return cube_; }
+    const QuantLib::ext::shared_ptr<NPVCube>& nettingSetCube() const { return nettingSetCube_; }
+    const QuantLib::ext::shared_ptr<NPVCube>& cptyCube() const { return cptyCube_; }
+    QuantLib::ext::shared_ptr<AggregationScenarioData> scenarioData() const {
+        return scenarioData_.empty() ? nullptr : *scenarioData_;
+    }
+    //@}
+
 protected:
     QuantLib::ext::shared_ptr<ore::data::EngineFactory> engineFactory() override;
     void buildScenarioSimMarket();
+    void buildOffsetSimMarket();
     void buildCrossAssetModel(bool continueOnError);
     void buildScenarioGenerator(bool continueOnError);
 
@@ -101,5 +114,23 @@ public:
                    xvaAnalyticSubAnalytics, inputs, false, false, false, false) {}
 };
 
+//! Run the xva analytic under a set of offset scenarios, used by the xva sensitivity and xva stress analytics
+/*! The scenario labelled BASE is run without offset scenario. Scenarios which only shift risk factors that are not
+    part of the simulation market (e.g. counterparty credit or funding curves) reuse the npv, market, netting set and
+    counterparty cubes of the base run and only rerun the post processing under the shifted market. All other
+    scenarios rerun the simulation with the same scenario generator data, i.e. with the same random numbers. The reuse
+    of the base cubes can be switched off with inputs->setXvaReuseBaseCubes(false).
+
+    If inputs->analyticsThreads() > 1 and sessions are enabled, the scenarios are run concurrently, each worker thread
+    on its own copy of the inputs and the portfolio. process(i, analytic) is called for each successful run of
+    scenarios[i], possibly concurrently from several worker threads. Failed runs are logged and skipped. */
+void runXvaAnalyticUnderScenarios(
+    const QuantLib::ext::shared_ptr<InputParameters>& inputs,
+    const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader,
+    const std::vector<QuantLib::ext::shared_ptr<Scenario>>& scenarios,
+    const QuantLib::ext::shared_ptr<Scenario>& baseScenario,
+    const QuantLib::ext::shared_ptr<ScenarioSimMarketParameters>& offsetSimMarketParams, const std::string& label,
+    const std::function<void(Size, const QuantLib::ext::shared_ptr<XvaAnalytic>&)>& process);
+
 } // namespace analytics
 } // namespace ore
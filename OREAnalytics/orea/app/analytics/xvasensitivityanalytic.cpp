@@ -89,11 +89,11 @@ void XvaSensitivityAnalyticImpl::runSensitivity(
     const QuantLib::ext::shared_ptr<SensitivityScenarioGenerator>& scenarioGenerator,
     const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader) {
 
-    std::map<std::string, std::vector<QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> xvaReports;
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios;
+    std::vector<QuantLib::ext::shared_ptr<ore::data::InMemoryReport>> descReports;
     for (size_t i = 0; i < scenarioGenerator->samples(); ++i) {
         auto scenario = scenarioGenerator->next(inputs_->asof());
         auto desc = scenarioGenerator->scenarioDescriptions()[i];
-        const auto label = scenario->label();
         QuantLib::ext::shared_ptr<ore::data::InMemoryReport> descReport =
             QuantLib::ext::make_shared<ore::data::InMemoryReport>();
 
@@ -123,31 +123,31 @@ void XvaSensitivityAnalyticImpl::runSensitivity(
         descReport->add(shiftSize2);
         descReport->add(inputs_->baseCurrency());
         descReport->end();
-        
-        try {
-            DLOG("Calculate XVA for scenario " << label);
-            CONSOLE("XVA_SENSITIVITY: Apply scenario " << label);
-            auto newAnalytic = ext::make_shared<XvaAnalytic>(
-                inputs_, (label == "BASE" ? nullptr : scenario),
-                (label == "BASE" ? nullptr : analytic()->configurations().simMarketParams));
-            CONSOLE("XVA_SENSITIVITY: Calculate Exposure and XVA")
-            newAnalytic->runAnalytic(loader, {"EXPOSURE", "XVA"});
+
+        scenarios.push_back(scenario);
+        descReports.push_back(descReport);
+    }
+
+    // the exposure and xva reports per scenario, concatenated in scenario order below
+    std::vector<std::map<std::string, QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> scenarioReports(
+        scenarios.size());
+    runXvaAnalyticUnderScenarios(
+        inputs_, loader, scenarios, scenarioGenerator->baseScenario(), analytic()->configurations().simMarketParams,
+        label(), [&scenarioReports, &descReports](Size i, const QuantLib::ext::shared_ptr<XvaAnalytic>& newAnalytic) {
             // Collect exposure and xva reports
             for (auto& [name, rpt] : newAnalytic->reports()["XVA"]) {
                 // add scenario column to report and copy it, concat it later
                 if (boost::starts_with(name, "exposure") || boost::starts_with(name, "xva")) {
                     DLOG("Save and extend report " << name);
-                    xvaReports[name].push_back(addColumnsToExisitingReport(descReport, rpt));
+                    scenarioReports[i][name] = addColumnsToExisitingReport(descReports[i], rpt);
                 }
             }
-            // writeCubes(label, newAnalytic);
-        } catch (const std::exception& e) {
-            StructuredAnalyticsErrorMessage("XvaSensitivity", "XVACalc",
-                                            "Error during XVA calc under scenario " + label + ", got " + e.what() +
-                                                ". Skip it")
-                .log();
-        }
-    }
+        });
+
+    std::map<std::string, std::vector<QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> xvaReports;
+    for (auto const& reports : scenarioReports)
+        for (auto const& [name, rpt] : reports)
+            xvaReports[name].push_back(rpt);
     for (auto& [name, reports] : xvaReports) {
         auto report = concatenateReports(reports);
         if (report != nullptr) {
@@ -36,18 +36,19 @@ void XvaStressAnalyticImpl::writeCubes(const std::string& label,
         return;
     }
 
-    if (inputs_->rawCubeOutput()) {
+    // runs reusing the base cubes do not generate a scenario report, see runXvaAnalyticUnderScenarios()
+    const auto& reports = xvaAnalytic->reports()["XVA"];
+
+    if (inputs_->rawCubeOutput() && reports.count("rawcube") > 0) {
         DLOG("Write raw cube under scenario " << label);
         // analytic()->reports()["XVA_STRESS"]["rawcube_" + label] = xvaAnalytic->reports()["XVA"]["rawcube"];
-        xvaAnalytic->reports()["XVA"]["rawcube"]->toFile(inputs_->resultsPath().string() + "/rawcube_" + label +
-                                                         ".csv");
+        reports.at("rawcube")->toFile(inputs_->resultsPath().string() + "/rawcube_" + label + ".csv");
     }
 
-    if (inputs_->netCubeOutput()) {
+    if (inputs_->netCubeOutput() && reports.count("netcube") > 0) {
         DLOG("Write raw cube under scenario " << label);
         // analytic()->reports()["XVA_STRESS"]["netcube_" + label] = xvaAnalytic->reports()["XVA"]["netcube"];
-        xvaAnalytic->reports()["XVA"]["netcube"]->toFile(inputs_->resultsPath().string() + "/netcube_" + label +
-                                                         ".csv");
+        reports.at("netcube")->toFile(inputs_->resultsPath().string() + "/netcube_" + label + ".csv");
     }
 
     if (inputs_->writeCube()) {
@@ -67,11 +68,10 @@ void XvaStressAnalyticImpl::writeCubes(const std::string& label,
         }
     }
 
-    if (inputs_->writeScenarios()) {
+    if (inputs_->writeScenarios() && reports.count("scenario") > 0) {
         DLOG("Write scenario report under scenario " << label);
         // analytic()->reports()["XVA_STRESS"]["scenario" + label] = xvaAnalytic->reports()["XVA"]["scenario"];
-        xvaAnalytic->reports()["XVA"]["scenario"]->toFile(inputs_->resultsPath().string() + "/scenario" + label +
-                                                          ".csv");
+        reports.at("scenario")->toFile(inputs_->resultsPath().string() + "/scenario" + label + ".csv");
     }
 }
 
@@ -147,34 +147,33 @@ void XvaStressAnalyticImpl::runAnalytic(const QuantLib::ext::shared_ptr<ore::dat
 void XvaStressAnalyticImpl::runStressTest(const QuantLib::ext::shared_ptr<StressScenarioGenerator>& scenarioGenerator,
                                           const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>& loader) {
 
-    std::map<std::string, std::vector<QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> xvaReports;
-    for (size_t i = 0; i < scenarioGenerator->samples(); ++i) {
-        auto scenario = scenarioGenerator->next(inputs_->asof());
-        const std::string& label = scenario != nullptr ? scenario->label() : std::string();
-        try {
-            DLOG("Calculate XVA for scenario " << label);
-            CONSOLE("XVA_STRESS: Apply scenario " << label);
-            auto newAnalytic = ext::make_shared<XvaAnalytic>(
-                inputs_, (label == "BASE" ? nullptr : scenario),
-                (label == "BASE" ? nullptr : analytic()->configurations().simMarketParams));
-            CONSOLE("XVA_STRESS: Calculate Exposure and XVA")
-            newAnalytic->runAnalytic(loader, {"EXPOSURE", "XVA"});
+    std::vector<QuantLib::ext::shared_ptr<Scenario>> scenarios;
+    for (size_t i = 0; i < scenarioGenerator->samples(); ++i)
+        scenarios.push_back(scenarioGenerator->next(inputs_->asof()));
+
+    // the exposure and xva reports per scenario, concatenated in scenario order below
+    std::vector<std::map<std::string, QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> scenarioReports(
+        scenarios.size());
+    runXvaAnalyticUnderScenarios(
+        inputs_, loader, scenarios, scenarioGenerator->baseScenario(), analytic()->configurations().simMarketParams,
+        label(),
+        [this, &scenarios, &scenarioReports](Size i, const QuantLib::ext::shared_ptr<XvaAnalytic>& newAnalytic) {
+            const std::string& label = scenarios[i]->label();
             // Collect exposure and xva reports
             for (auto& [name, rpt] : newAnalytic->reports()["XVA"]) {
                 // add scenario column to report and copy it, concat it later
                 if (boost::starts_with(name, "exposure") || boost::starts_with(name, "xva")) {
                     DLOG("Save and extend report " << name);
-                    xvaReports[name].push_back(addColumnToExisitingReport("Scenario", label, rpt));
+                    scenarioReports[i][name] = addColumnToExisitingReport("Scenario", label, rpt);
                 }
             }
             writeCubes(label, newAnalytic);
-        } catch (const std::exception& e) {
-            StructuredAnalyticsErrorMessage("XvaStress", "XVACalc",
-                                            "Error during XVA calc under scenario " + label + ", got " + e.what() +
-                                                ". Skip it")
-                .log();
-        }
-    }
+        });
+
+    std::map<std::string, std::vector<QuantLib::ext::shared_ptr<ore::data::InMemoryReport>>> xvaReports;
+    for (auto const& reports : scenarioReports)
+        for (auto const& [name, rpt] : reports)
+            xvaReports[name].push_back(rpt);
     concatReports(xvaReports);
 }
 
@@ -33,15 +33,24 @@
 #include <orea/app/analyticsmanager.hpp>
 #include <orea/app/reportwriter.hpp>
 #include <orea/app/structuredanalyticserror.hpp>
+#include <orea/engine/observationmode.hpp>
 
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/parallelfor.hpp>
 #include <ored/utilities/to_string.hpp>
 
 #include <ql/errors.hpp>
+#include <ql/settings.hpp>
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
 
 using namespace std;
 using namespace boost::filesystem;
 using ore::data::InMemoryReport;
+using ore::data::parallelFor;
 
 namespace ore {
 namespace analytics {
@@ -154,14 +163,27 @@ void AnalyticsManager::runAnalytics(const QuantLib::ext::shared_ptr<MarketCalibr
         reports_["DIVIDENDS"]["dividends"] = dividendReport;
     }
 
-    // run requested analytics
-    for (auto a : analytics_) {
-        LOG("run analytic with label '" << a.first << "'");
-        a.second->runAnalytic(marketDataLoader_->loader(), inputs_->analytics());
-        LOG("run analytic with label '" << a.first << "' finished.");
-        // then populate the market calibration report if required
-        if (marketCalibrationReport)
-            a.second->marketCalibration(marketCalibrationReport);
+    // run requested analytics, concurrently if requested and supported by the build
+    bool parallel = inputs_->analyticsThreads() > 1 && analytics_.size() > 1;
+#ifndef QL_ENABLE_SESSIONS
+    if (parallel) {
+        WLOG("AnalyticsManager: analyticsThreads = " << inputs_->analyticsThreads()
+                                                     << " requires a build with QL_ENABLE_SESSIONS = ON, run analytics "
+                                                        "sequentially.");
+        parallel = false;
+    }
+#endif
+    if (parallel) {
+        runAnalyticsInParallel(marketCalibrationReport);
+    } else {
+        for (auto a : analytics_) {
+            LOG("run analytic with label '" << a.first << "'");
+            a.second->runAnalytic(marketDataLoader_->loader(), inputs_->analytics());
+            LOG("run analytic with label '" << a.first << "' finished.");
+            // then populate the market calibration report if required
+            if (marketCalibrationReport)
+                a.second->marketCalibration(marketCalibrationReport);
+        }
     }
 
     if (inputs_->portfolio()) {
@@ -182,6 +204,166 @@ void AnalyticsManager::runAnalytics(const QuantLib::ext::shared_ptr<MarketCalibr
     inputs_->writeOutParameters();
 }
 
+namespace {
+// replace the inputs of an analytic and its dependent analytics, if they are currently set to oldInputs
+void replaceInputs(const QuantLib::ext::shared_ptr<Analytic>& analytic,
+                   const QuantLib::ext::shared_ptr<InputParameters>& oldInputs,
+                   const QuantLib::ext::shared_ptr<InputParameters>& newInputs) {
+    if (analytic->inputs() != oldInputs)
+        return;
+    analytic->setInputs(newInputs);
+    if (analytic->impl()) {
+        analytic->impl()->setInputs(newInputs);
+        for (auto const& [_, d] : analytic->impl()->dependentAnalytics())
+            replaceInputs(d, oldInputs, newInputs);
+    }
+}
+} // namespace
+
+std::vector<std::set<Size>> analyticDependencies(const std::vector<QuantLib::ext::shared_ptr<Analytic>>& analytics) {
+    std::vector<std::set<Size>> dependencies(analytics.size());
+    for (Size i = 0; i < analytics.size(); ++i) {
+        for (auto const& d : analytics[i]->allDependentAnalytics()) {
+            for (Size j = 0; j < analytics.size(); ++j) {
+                if (j == i)
+                    continue;
+                const auto& types = analytics[j]->analyticTypes();
+                if ((!d->label().empty() && d->label() == analytics[j]->label()) ||
+                    std::any_of(d->analyticTypes().begin(), d->analyticTypes().end(),
+                                [&types](const std::string& t) { return types.count(t) > 0; }))
+                    dependencies[i].insert(j);
+            }
+        }
+    }
+    return dependencies;
+}
+
+void AnalyticsManager::runAnalyticsInParallel(
+    const QuantLib::ext::shared_ptr<MarketCalibrationReportBase>& marketCalibrationReport) {
+
+    // Build the dependency graph: analytic i has to wait for analytic j, if one of the (transitive) dependent
+    // analytics of i is of the same kind as j, see analyticDependencies(). Otherwise distinct analytic instances only
+    // share the loader and the input parameters, the latter are copied per analytic below, so they can run
+    // concurrently.
+
+    std::vector<std::string> labels;
+    std::vector<QuantLib::ext::shared_ptr<Analytic>> analytics;
+    for (auto const& [label, a] : analytics_) {
+        labels.push_back(label);
+        analytics.push_back(a);
+    }
+
+    Size n = analytics.size();
+    std::vector<std::vector<Size>> successors(n);
+    std::vector<Size> pending(n, 0);
+    auto dependencies = analyticDependencies(analytics);
+    for (Size i = 0; i < n; ++i) {
+        for (auto j : dependencies[i]) {
+            successors[j].push_back(i);
+            ++pending[i];
+            DLOG("analytic '" << labels[i] << "' depends on analytic '" << labels[j] << "'");
+        }
+    }
+
+    // Give each analytic its own copy of the input parameters and the portfolio, since building the portfolio
+    // modifies the trades. The copies are set up here in the main thread.
+
+    std::vector<QuantLib::ext::shared_ptr<InputParameters>> inputs(n);
+    for (Size i = 0; i < n; ++i) {
+        inputs[i] = QuantLib::ext::make_shared<InputParameters>(*inputs_);
+        if (inputs_->portfolio()) {
+            auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>(inputs_->buildFailedTrades());
+            ore::data::XMLDocument doc;
+            portfolio->fromXML(inputs_->portfolio()->toXML(doc));
+            inputs[i]->setPortfolio(portfolio);
+        }
+        replaceInputs(analytics[i], inputs_, inputs[i]);
+    }
+
+    // Run the analytics whose dependencies are finished on a pool of worker threads, each in its own session
+
+    Size nThreads = std::min(n, inputs_->analyticsThreads());
+    LOG("AnalyticsManager: run " << n << " analytics on " << nThreads << " threads");
+
+    std::mutex mutex, marketCalibrationMutex;
+    std::condition_variable cv;
+    std::queue<Size> ready;
+    for (Size i = 0; i < n; ++i)
+        if (pending[i] == 0)
+            ready.push(i);
+    Size running = 0, finished = 0;
+    std::exception_ptr error;
+
+    ore::analytics::ObservationMode::Mode obsMode = ore::analytics::ObservationMode::instance().mode();
+    Date asof = inputs_->asof();
+
+    auto job = [&]() {
+        while (true) {
+            Size i;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                // stop if nothing is ready and nothing is running that could make further analytics ready
+                cv.wait(lock, [&]() { return !ready.empty() || running == 0 || error; });
+                if (ready.empty())
+                    return;
+                i = ready.front();
+                ready.pop();
+                ++running;
+            }
+            try {
+                LOG("run analytic with label '" << labels[i] << "'");
+                analytics[i]->runAnalytic(marketDataLoader_->loader(), inputs_->analytics());
+                LOG("run analytic with label '" << labels[i] << "' finished.");
+                if (marketCalibrationReport) {
+                    std::lock_guard<std::mutex> lock(marketCalibrationMutex);
+                    analytics[i]->marketCalibration(marketCalibrationReport);
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+                // do not start any further analytics
+                std::queue<Size>().swap(ready);
+                cv.notify_all();
+                return;
+            }
+            std::lock_guard<std::mutex> lock(mutex);
+            --running;
+            ++finished;
+            for (auto s : successors[i])
+                if (--pending[s] == 0)
+                    ready.push(s);
+            cv.notify_all();
+        }
+    };
+
+    parallelFor(
+        nThreads, nThreads, [&job](Size) { job(); },
+        [asof, obsMode]() {
+            QuantLib::Settings::instance().evaluationDate() = asof;
+            ore::analytics::ObservationMode::instance().setMode(obsMode);
+        });
+
+    // Restore the original inputs and accumulate the pricing stats of the portfolio copies on the original trades
+
+    for (Size i = 0; i < n; ++i) {
+        replaceInputs(analytics[i], inputs[i], inputs_);
+        if (inputs_->portfolio() && inputs[i]->portfolio()) {
+            for (auto const& [tid, t] : inputs_->portfolio()->trades()) {
+                if (auto c = inputs[i]->portfolio()->trades().find(tid); c != inputs[i]->portfolio()->trades().end())
+                    t->resetPricingStats(t->getNumberOfPricings() + c->second->getNumberOfPricings(),
+                                         t->getCumulativePricingTime() + c->second->getCumulativePricingTime());
+            }
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+    QL_REQUIRE(finished == n, "AnalyticsManager: only " << finished << " out of " << n
+                                                        << " analytics were run, check for cyclic dependencies.");
+}
+
 Analytic::analytic_reports const AnalyticsManager::reports() {
     Analytic::analytic_reports reports = reports_;
     for (auto a : analytics_) {
@@ -28,6 +28,8 @@
 #include <orea/app/inputparameters.hpp>
 
 #include <iostream>
+#include <set>
+#include <vector>
 
 namespace ore {
 namespace analytics {
@@ -68,6 +70,9 @@ public:
                 const std::set<std::string>& lowerHeaderReportNames = {});
 
 private:
+    //! run the analytics concurrently on inputs()->analyticsThreads() threads, respecting their dependencies
+    void runAnalyticsInParallel(const QuantLib::ext::shared_ptr<MarketCalibrationReportBase>& marketCalibrationReport);
+
     std::map<std::string, QuantLib::ext::shared_ptr<Analytic>> analytics_;
     QuantLib::ext::shared_ptr<InputParameters> inputs_;
     QuantLib::ext::shared_ptr<MarketDataLoader> marketDataLoader_;
@@ -75,6 +80,14 @@ private:
     std::set<std::string> validAnalytics_;
 };
 
+/*! Return for each of the given \p analytics the indices of the analytics that have to finish before it can start in
+    a concurrent run. Analytic i waits for analytic j if one of the (transitive) dependent analytics of i has the same
+    label as j or shares an analytic type with j. The dependent analytics are separate instances, so they are matched
+    by label and type, not by identity.
+*/
+std::vector<std::set<QuantLib::Size>>
+analyticDependencies(const std::vector<QuantLib::ext::shared_ptr<Analytic>>& analytics);
+
 QuantLib::ext::shared_ptr<AnalyticsManager> parseAnalytics(const std::string& s,
     const QuantLib::ext::shared_ptr<InputParameters>& inputs,
     const QuantLib::ext::shared_ptr<MarketDataLoader>& marketDataLoader);
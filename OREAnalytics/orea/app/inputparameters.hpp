@@ -95,8 +95,11 @@ public:
     void setTodaysMarketParamsFromFile(const std::string& fileName);
     void setPortfolio(const std::string& xml); 
     void setPortfolioFromFile(const std::string& fileNameString, const std::filesystem::path& inputPath); 
+    void setPortfolio(const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio) { portfolio_ = portfolio; }
     void setMarketConfigs(const std::map<std::string, std::string>& m);
     void setThreads(int i) { nThreads_ = i; }
+    void setAnalyticsThreads(int i) { analyticsThreads_ = i; }
+    void setCurveCacheDirectory(const std::string& s) { curveCacheDirectory_ = s; }
     void setEntireMarket(bool b) { entireMarket_ = b; }
     void setAllFixings(bool b) { allFixings_ = b; }
     void setEomInflationFixings(bool b) { eomInflationFixings_ = b; }
@@ -134,6 +137,7 @@ public:
     void setUseSensiSpreadedTermStructures(bool b) { useSensiSpreadedTermStructures_ = b; }
     void setSensiThreshold(Real r) { sensiThreshold_ = r; }
     void setSensiRecalibrateModels(bool b) { sensiRecalibrateModels_ = b; }
+    void setSensiSkipUnaffectedTrades(bool b) { sensiSkipUnaffectedTrades_ = b; }
     void setSensiSimMarketParams(const std::string& xml);
     void setSensiSimMarketParamsFromFile(const std::string& fileName);
     void setSensiScenarioData(const std::string& xml);
@@ -243,7 +247,9 @@ public:
     void setCubeFromFile(const std::string& file);
     void setCube(const QuantLib::ext::shared_ptr<NPVCube>& cube);
     void setNettingSetCubeFromFile(const std::string& file);
+    void setNettingSetCube(const QuantLib::ext::shared_ptr<NPVCube>& cube) { nettingSetCube_ = cube; }
     void setCptyCubeFromFile(const std::string& file);
+    void setCptyCube(const QuantLib::ext::shared_ptr<NPVCube>& cube) { cptyCube_ = cube; }
     void setMarketCubeFromFile(const std::string& file);
     void setMarketCube(const QuantLib::ext::shared_ptr<AggregationScenarioData>& cube);
     // QuantLib::ext::shared_ptr<AggregationScenarioData> mktCube();
@@ -324,6 +330,8 @@ public:
     void setXvaStressSensitivityScenarioData(const std::string& xml);
     void setXvaStressSensitivityScenarioDataFromFile(const std::string& fileName);
     void setXvaStressWriteCubes(const bool writeCubes) { xvaStressWriteCubes_ = writeCubes; }
+    // xvaStress and xvaSensitivity
+    void setXvaReuseBaseCubes(const bool reuseBaseCubes) { xvaReuseBaseCubes_ = reuseBaseCubes; }
 
     // Setters for xvaStress
     void setXvaSensiSimMarketParams(const std::string& xml);
@@ -359,6 +367,7 @@ public:
     void setSimmReportingCurrency(const std::string& s) { simmReportingCurrency_ = s; }
     void setEnforceIMRegulations(bool b) { enforceIMRegulations_= b; }
     void setWriteSimmIntermediateReports(bool b) { writeSimmIntermediateReports_ = b; }
+    void setSimmThreads(int i) { simmThreads_ = i; }
 
     // Setters for ZeroToParSensiConversion
     void setParConversionXbsParConversion(bool b) { parConversionXbsParConversion_ = b; }
@@ -451,6 +460,8 @@ public:
 
     QuantLib::Size maxRetries() const { return maxRetries_; }
     QuantLib::Size nThreads() const { return nThreads_; }
+    QuantLib::Size analyticsThreads() const { return analyticsThreads_; }
+    const std::string& curveCacheDirectory() const { return curveCacheDirectory_; }
     bool entireMarket() const { return entireMarket_; }
     bool allFixings() const { return allFixings_; }
     bool eomInflationFixings() const { return eomInflationFixings_; }
@@ -505,6 +516,7 @@ public:
     bool useSensiSpreadedTermStructures() const { return useSensiSpreadedTermStructures_; }
     QuantLib::Real sensiThreshold() const { return sensiThreshold_; }
     bool sensiRecalibrateModels() const { return sensiRecalibrateModels_; }
+    bool sensiSkipUnaffectedTrades() const { return sensiSkipUnaffectedTrades_; }
     const QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters>& sensiSimMarketParams() const { return sensiSimMarketParams_; }
     const QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData>& sensiScenarioData() const { return sensiScenarioData_; }
     const QuantLib::ext::shared_ptr<ore::data::EngineData>& sensiPricingEngine() const { return sensiPricingEngine_; }
@@ -672,6 +684,7 @@ public:
         return xvaStressSensitivityScenarioData_;
     }
     bool xvaStressWriteCubes() const { return xvaStressWriteCubes_; }
+    bool xvaReuseBaseCubes() const { return xvaReuseBaseCubes_; }
     /**************************************************
      * Getters for cashflow npv and dynamic backtesting
      **************************************************/
@@ -694,6 +707,7 @@ public:
     bool enforceIMRegulations() const { return enforceIMRegulations_; }
     QuantLib::ext::shared_ptr<SimmConfiguration> getSimmConfiguration();
     bool writeSimmIntermediateReports() const { return writeSimmIntermediateReports_; }
+    QuantLib::Size simmThreads() const { return simmThreads_; }
 
     /**************************************************
      * Getters for Zero to Par Sensi conversion
@@ -810,6 +824,8 @@ protected:
     QuantLib::ext::shared_ptr<ore::data::Portfolio> portfolio_, useCounterpartyOriginalPortfolio_;
     QuantLib::Size maxRetries_ = 7;
     QuantLib::Size nThreads_ = 1;
+    QuantLib::Size analyticsThreads_ = 1;
+    std::string curveCacheDirectory_;
    
     bool entireMarket_ = false; 
     bool allFixings_ = false; 
@@ -857,6 +873,7 @@ protected:
     bool useSensiSpreadedTermStructures_ = true;
     QuantLib::Real sensiThreshold_ = 1e-6;
     bool sensiRecalibrateModels_ = true;
+    bool sensiSkipUnaffectedTrades_ = false;
     QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarketParameters> sensiSimMarketParams_;
     QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData> sensiScenarioData_;
     QuantLib::ext::shared_ptr<ore::data::EngineData> sensiPricingEngine_;
@@ -1006,6 +1023,7 @@ protected:
     QuantLib::ext::shared_ptr<ore::analytics::StressTestScenarioData> xvaStressScenarioData_;
     QuantLib::ext::shared_ptr<ore::analytics::SensitivityScenarioData> xvaStressSensitivityScenarioData_;
     bool xvaStressWriteCubes_ = false;
+    bool xvaReuseBaseCubes_ = true;
     /***************
      * SIMM analytic
      ***************/
@@ -1021,6 +1039,7 @@ protected:
     bool enforceIMRegulations_ = false;
     bool useSimmParameters_ = true;
     bool writeSimmIntermediateReports_ = true;
+    QuantLib::Size simmThreads_ = 1;
 
     /***************
      * Zero to Par Conversion analytic
@@ -210,7 +210,23 @@ QuantLib::ext::shared_ptr<CSVLoader> OREApp::buildCsvLoader(const QuantLib::ext:
         WLOG("fixing cutoff date not set");
     }
     
-    auto loader = boost::make_shared<CSVLoader>(marketFiles, fixingFiles, dividendFiles, implyTodaysFixings, cutoff);
+    // Optionally restrict the market data to the quotes required by the curve configurations
+    std::set<std::string> quoteNames;
+    tmp = params->get("setup", "loadRequiredQuotesOnly", false);
+    if (tmp != "" && parseBool(tmp) && inputs_ && !inputs_->entireMarket() && inputs_->todaysMarketParams()) {
+        std::set<std::string> configurations;
+        for (const auto& c : inputs_->todaysMarketParams()->configurations())
+            configurations.insert(c.first);
+        for (const auto& [_, curveConfig] : inputs_->curveConfigs().curveConfigurations()) {
+            auto qs = curveConfig->quotes(inputs_->todaysMarketParams(), configurations);
+            quoteNames.insert(qs.begin(), qs.end());
+        }
+        LOG("Loading " << quoteNames.size() << " required quotes only");
+    }
+
+    Size nThreads = inputs_ ? inputs_->nThreads() : 1;
+    auto loader = boost::make_shared<CSVLoader>(marketFiles, fixingFiles, dividendFiles, implyTodaysFixings, cutoff,
+                                                nThreads, quoteNames);
 
     return loader;
 }
@@ -357,6 +373,10 @@ void OREApp::initFromParams() {
         if (!tmp.empty()) {
             structuredLogRotationSize_ = static_cast<Size>(parseInteger(tmp));
         }
+        tmp = params_->get("logging", "asynchronous", false);
+        if (!tmp.empty()) {
+            asynchronousLog_ = ore::data::parseBool(tmp);
+        }
     }
     
     setupLog(outputPath_, logFile_, logMask_, logRootPath_, progressLogFile_, progressLogRotationSize_, progressLogToConsole_,
@@ -538,6 +558,7 @@ void OREApp::setupLog(const std::string& path, const std::string& file, Size mas
                             : logRootPath;
     Log::instance().setRootPath(oreRootPath);
     Log::instance().setMask(mask);
+    Log::instance().setAsynchronous(asynchronousLog_);
     Log::instance().switchOn();
 
     // Progress logger
@@ -637,6 +658,14 @@ void OREAppInputParameters::loadParameters() {
     if (tmp != "")
         setThreads(parseInteger(tmp));
 
+    tmp = params_->get("setup", "analyticsThreads", false);
+    if (tmp != "")
+        setAnalyticsThreads(parseInteger(tmp));
+
+    tmp = params_->get("setup", "curveCacheDirectory", false);
+    if (tmp != "")
+        setCurveCacheDirectory(tmp);
+
     tmp = params_->get("setup", "entireMarket", false);
     if (tmp != "")
         setEntireMarket(parseBool(tmp));
@@ -902,6 +931,10 @@ void OREAppInputParameters::loadParameters() {
         tmp = params_->get("sensitivity", "recalibrateModels", false);
         if (tmp != "")
             setSensiRecalibrateModels(parseBool(tmp));
+
+        tmp = params_->get("sensitivity", "skipUnaffectedTrades", false);
+        if (tmp != "")
+            setSensiSkipUnaffectedTrades(parseBool(tmp));
     }
 
     /************
@@ -1333,6 +1366,10 @@ void OREAppInputParameters::loadParameters() {
         tmp = params_->get("simm", "writeIntermediateReports", false);
         if (tmp != "")
             setWriteSimmIntermediateReports(parseBool(tmp));
+
+        tmp = params_->get("simm", "nThreads", false);
+        if (tmp != "")
+            setSimmThreads(parseInteger(tmp));
     }
 
     LOG("IM SCHEDULE");
@@ -1878,6 +1915,10 @@ void OREAppInputParameters::loadParameters() {
             }
         }
 
+        tmp = params_->get("xvaStress", "reuseBaseCubes", false);
+        if (!tmp.empty())
+            setXvaReuseBaseCubes(parseBool(tmp));
+
         tmp = params_->get("xvaStress", "sensitivityConfigFile", false);
         if (tmp != "") {
             string file = (inputPath / tmp).generic_string();
@@ -1910,6 +1951,10 @@ void OREAppInputParameters::loadParameters() {
         } else {
             WLOG("Xva sensitivity scenario data not loaded");
         }
+
+        tmp = params_->get("xvaSensitivity", "reuseBaseCubes", false);
+        if (!tmp.empty())
+            setXvaReuseBaseCubes(parseBool(tmp));
     }
 
     /*************
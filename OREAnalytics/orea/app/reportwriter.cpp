@@ -1198,23 +1198,37 @@ void ReportWriter::writeSensitivityReport(Report& report, const QuantLib::ext::s
 
     // Make sure that we are starting from the start
     ss->reset();
-    while (SensitivityRecord sr = ss->next()) {
-        if ((outputThreshold == Null<Real>()) || (fabs(sr.delta) > outputThreshold ||
-            (sr.gamma != Null<Real>() && fabs(sr.gamma) > outputThreshold))) {
-            report.next();
-            report.add(sr.tradeId);
-            report.add(ore::data::to_string(sr.isPar));
-            report.add(prettyPrintInternalCurveName(reconstructFactor(sr.key_1, sr.desc_1)));
-            report.add(sr.shift_1);
-            report.add(prettyPrintInternalCurveName(reconstructFactor(sr.key_2, sr.desc_2)));
-            report.add(sr.shift_2);
-            report.add(sr.currency);
-            report.add(sr.baseNpv);
-            report.add(sr.delta);
-            report.add(sr.gamma);
-        } else if (!std::isfinite(sr.delta) || !std::isfinite(sr.gamma)) {
-            // TODO: Again, is this needed?
-            ALOG("sensitivity record has infinite values: " << sr);
+
+    // the factor strings are built once per risk factor of the stream's dictionary
+    std::vector<std::string> factorStrings;
+    const std::string noFactor = prettyPrintInternalCurveName(reconstructFactor(RiskFactorKey(), ""));
+
+    SensitivityBatch batch;
+    while (ss->nextBatch(batch)) {
+        const auto& dict = *batch.dictionary;
+        for (Size f = factorStrings.size(); f < dict.numberOfFactors(); ++f)
+            factorStrings.push_back(
+                prettyPrintInternalCurveName(reconstructFactor(dict.factor(f).key, dict.factor(f).desc)));
+        for (Size i = 0; i < batch.size(); ++i) {
+            Real delta = batch.delta[i], gamma = batch.gamma[i];
+            if ((outputThreshold == Null<Real>()) ||
+                (fabs(delta) > outputThreshold || (gamma != Null<Real>() && fabs(gamma) > outputThreshold))) {
+                bool isCrossGamma = batch.isCrossGamma(i);
+                report.next();
+                report.add(dict.tradeId(batch.trade[i]));
+                report.add(ore::data::to_string(static_cast<bool>(batch.isPar[i])));
+                report.add(factorStrings[batch.factor1[i]]);
+                report.add(dict.factor(batch.factor1[i]).shift);
+                report.add(isCrossGamma ? factorStrings[batch.factor2[i]] : noFactor);
+                report.add(isCrossGamma ? dict.factor(batch.factor2[i]).shift : 0.0);
+                report.add(dict.currency(batch.currency[i]));
+                report.add(batch.baseNpv[i]);
+                report.add(delta);
+                report.add(gamma);
+            } else if (!std::isfinite(delta) || !std::isfinite(gamma)) {
+                // TODO: Again, is this needed?
+                ALOG("sensitivity record has infinite values: " << batch.record(i));
+            }
         }
     }
 
@@ -99,10 +99,9 @@ void XvaRunner::bufferSimulationPaths() {
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(stateProcess)) {
         tmp->resetCache(scenarioGeneratorData_->getGrid()->timeGrid().size() - 1);
     }
-    auto pathGen = MultiPathGeneratorFactory().build(scenarioGeneratorData_->sequenceType(), stateProcess,
-                                                     scenarioGeneratorData_->getGrid()->timeGrid(),
-                                                     scenarioGeneratorData_->seed(), scenarioGeneratorData_->ordering(),
-                                                     scenarioGeneratorData_->directionIntegers());
+    auto pathGen = CrossAssetBatchMultiPathGeneratorFactory().build(
+        scenarioGeneratorData_->sequenceType(), stateProcess, scenarioGeneratorData_->getGrid()->timeGrid(),
+        scenarioGeneratorData_->seed(), scenarioGeneratorData_->ordering(), scenarioGeneratorData_->directionIntegers());
 
     if (!bufferedPaths_) {
         bufferedPaths_ = QuantLib::ext::make_shared<std::vector<std::vector<Path>>>(
@@ -18,16 +18,21 @@
 
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/mappednpvcube.hpp>
 
 #include <ored/utilities/to_string.hpp>
 
 #include <boost/filesystem.hpp>
 #include <boost/iostreams/device/file_descriptor.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #ifdef ORE_USE_ZLIB
 #include <boost/iostreams/filter/gzip.hpp>
 #endif
 #include <boost/iostreams/filtering_stream.hpp>
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iomanip>
 #include <regex>
 
@@ -47,6 +52,331 @@ bool use_compression(const std::string& filename) {
 #endif
 }
 
+/* Binary format, used for files with extension .bin, all numbers in native byte order:
+
+   char[8]  magic ("ORECUBE" or "OREASD")
+   uint32   format version
+   uint32   byte order mark 0x01020304
+   uint32   size of a value in bytes (4 or 8)
+   uint32   reserved
+   ...      header specific to npv cube / aggregation scenario data
+   ...      zero padding to a multiple of binaryAlignment bytes
+   ...      data block(s), each padded to a multiple of binaryAlignment bytes
+
+   The data blocks are laid out as in InMemoryCube, so that they can be memory mapped and read without copying. */
+
+constexpr char binaryCubeMagic[8] = {'O', 'R', 'E', 'C', 'U', 'B', 'E', '\0'};
+constexpr char binaryAggScenDataMagic[8] = {'O', 'R', 'E', 'A', 'S', 'D', '\0', '\0'};
+constexpr std::uint32_t binaryFormatVersion = 1;
+constexpr std::uint32_t binaryByteOrderMark = 0x01020304;
+constexpr Size binaryAlignment = 64;
+
+bool use_binary_format(const std::string& filename) {
+    return boost::filesystem::path(filename).extension().string() == ".bin";
+}
+
+bool has_magic(const std::string& filename, const char* magic) {
+    char buffer[8];
+    std::ifstream in(filename, std::ios::binary | std::ios::in);
+    return in.read(buffer, 8) && std::memcmp(buffer, magic, 8) == 0;
+}
+
+Size padding(Size pos) { return (binaryAlignment - pos % binaryAlignment) % binaryAlignment; }
+
+class BinaryWriter {
+public:
+    explicit BinaryWriter(const std::string& filename) : out_(filename, std::ios::binary | std::ios::out) {
+        QL_REQUIRE(out_, "BinaryWriter: could not open file '" << filename << "'");
+    }
+    template <typename V> void write(const V& v) { write(&v, sizeof(V)); }
+    void write(const std::string& s) {
+        write<std::uint64_t>(s.size());
+        write(s.data(), s.size());
+    }
+    void write(const void* data, Size size) {
+        out_.write(reinterpret_cast<const char*>(data), size);
+        pos_ += size;
+    }
+    void align() {
+        static const char zeros[binaryAlignment] = {};
+        write(zeros, padding(pos_));
+    }
+    Size pos() const { return pos_; }
+
+private:
+    std::ofstream out_;
+    Size pos_ = 0;
+};
+
+class BinaryReader {
+public:
+    explicit BinaryReader(const boost::iostreams::mapped_file_source& file) : file_(file) {}
+    template <typename V> V read() {
+        V v;
+        read(&v, sizeof(V));
+        return v;
+    }
+    std::string readString() {
+        Size size = read<std::uint64_t>();
+        check(size);
+        std::string s(file_.data() + pos_, size);
+        pos_ += size;
+        return s;
+    }
+    void read(void* data, Size size) {
+        check(size);
+        std::memcpy(data, file_.data() + pos_, size);
+        pos_ += size;
+    }
+    void align() { pos_ += padding(pos_); }
+    Size pos() const { return pos_; }
+
+private:
+    void check(Size size) const {
+        QL_REQUIRE(pos_ + size <= file_.size(), "BinaryReader: unexpected end of file at position "
+                                                    << pos_ << " reading " << size << " bytes, file size is "
+                                                    << file_.size());
+    }
+    const boost::iostreams::mapped_file_source& file_;
+    Size pos_ = 0;
+};
+
+void writeBinaryPreamble(BinaryWriter& out, const char* magic, const std::uint32_t valueSize) {
+    out.write(magic, 8);
+    out.write(binaryFormatVersion);
+    out.write(binaryByteOrderMark);
+    out.write(valueSize);
+    out.write<std::uint32_t>(0);
+}
+
+std::uint32_t readBinaryPreamble(BinaryReader& in, const char* magic, const std::string& filename) {
+    char buffer[8];
+    in.read(buffer, 8);
+    QL_REQUIRE(std::memcmp(buffer, magic, 8) == 0, "file '" << filename << "' is not in the expected binary format");
+    std::uint32_t version = in.read<std::uint32_t>();
+    QL_REQUIRE(version == binaryFormatVersion, "file '" << filename << "' has binary format version " << version
+                                                        << ", expected " << binaryFormatVersion);
+    QL_REQUIRE(in.read<std::uint32_t>() == binaryByteOrderMark,
+               "file '" << filename << "' was written on a platform with different byte order");
+    std::uint32_t valueSize = in.read<std::uint32_t>();
+    in.read<std::uint32_t>();
+    return valueSize;
+}
+
+void writeBinaryDate(BinaryWriter& out, const QuantLib::Date& d) { out.write<std::int64_t>(d.serialNumber()); }
+
+QuantLib::Date readBinaryDate(BinaryReader& in) {
+    std::int64_t serial = in.read<std::int64_t>();
+    return serial == 0 ? QuantLib::Date() : QuantLib::Date(static_cast<QuantLib::Date::serial_type>(serial));
+}
+
+NPVCubeWithMetaData loadCubeBinary(const std::string& filename) {
+
+    NPVCubeWithMetaData result;
+
+    auto file = QuantLib::ext::make_shared<boost::iostreams::mapped_file_source>(filename);
+    BinaryReader in(*file);
+
+    std::uint32_t valueSize = readBinaryPreamble(in, binaryCubeMagic, filename);
+    QL_REQUIRE(valueSize == sizeof(float) || valueSize == sizeof(double),
+               "loadCube(): unsupported value size " << valueSize << " in file '" << filename << "'");
+
+    QuantLib::Date asof = readBinaryDate(in);
+    Size numIds = in.read<std::uint64_t>();
+    Size numDates = in.read<std::uint64_t>();
+    Size samples = in.read<std::uint64_t>();
+    Size depth = in.read<std::uint64_t>();
+
+    std::vector<QuantLib::Date> dates;
+    for (Size i = 0; i < numDates; ++i)
+        dates.push_back(readBinaryDate(in));
+
+    std::map<std::string, Size> ids;
+    for (Size i = 0; i < numIds; ++i)
+        ids[in.readString()] = i;
+    QL_REQUIRE(ids.size() == numIds, "loadCube(): duplicate ids in file '" << filename << "'");
+
+    if (std::string md = in.readString(); !md.empty()) {
+        result.scenarioGeneratorData = QuantLib::ext::make_shared<ScenarioGeneratorData>();
+        result.scenarioGeneratorData->fromXMLString(md);
+        DLOG("overwrite scenario generator data with meta data from cube: " << md);
+    }
+
+    if (std::int32_t md = in.read<std::int32_t>(); md >= 0) {
+        result.storeFlows = md == 1;
+        DLOG("overwrite storeFlows with meta data from cube: " << std::boolalpha << *result.storeFlows);
+    }
+
+    if (std::int64_t md = in.read<std::int64_t>(); md >= 0) {
+        result.storeCreditStateNPVs = static_cast<Size>(md);
+        DLOG("overwrite storeCreditStateNPVs with meta data from cube: " << md);
+    }
+
+    in.align();
+    Size t0Offset = in.pos();
+    Size dataOffset = t0Offset + numIds * depth * valueSize;
+    dataOffset += padding(dataOffset);
+
+    if (valueSize == sizeof(double))
+        result.cube = QuantLib::ext::make_shared<MappedNpvCube<double>>(file, t0Offset, dataOffset, asof, ids, dates,
+                                                                       samples, depth);
+    else
+        result.cube = QuantLib::ext::make_shared<MappedNpvCube<float>>(file, t0Offset, dataOffset, asof, ids, dates,
+                                                                      samples, depth);
+
+    LOG("mapped binary cube from " << filename << ": asof = " << asof << ", dim = " << numIds << " x " << numDates
+                                   << " x " << samples << " x " << depth << ", value size " << valueSize);
+
+    return result;
+}
+
+template <typename T> void writeCubeBinaryData(BinaryWriter& out, const NPVCube& cube) {
+    std::vector<T> buffer(cube.numIds() * cube.depth());
+    for (Size i = 0; i < cube.numIds(); ++i)
+        for (Size d = 0; d < cube.depth(); ++d)
+            buffer[i * cube.depth() + d] = static_cast<T>(cube.getT0(i, d));
+    out.write(buffer.data(), buffer.size() * sizeof(T));
+    out.align();
+    std::vector<Real> values;
+    buffer.resize(cube.samples());
+    for (Size i = 0; i < cube.numIds(); ++i) {
+        for (Size j = 0; j < cube.numDates(); ++j) {
+            for (Size d = 0; d < cube.depth(); ++d) {
+                cube.getSamples(values, i, j, d);
+                std::transform(values.begin(), values.end(), buffer.begin(), [](Real v) { return static_cast<T>(v); });
+                out.write(buffer.data(), buffer.size() * sizeof(T));
+            }
+        }
+    }
+}
+
+void saveCubeBinary(const std::string& filename, const NPVCubeWithMetaData& cube, const bool doublePrecision) {
+
+    BinaryWriter out(filename);
+    writeBinaryPreamble(out, binaryCubeMagic, doublePrecision ? sizeof(double) : sizeof(float));
+
+    writeBinaryDate(out, cube.cube->asof());
+    out.write<std::uint64_t>(cube.cube->numIds());
+    out.write<std::uint64_t>(cube.cube->numDates());
+    out.write<std::uint64_t>(cube.cube->samples());
+    out.write<std::uint64_t>(cube.cube->depth());
+
+    for (auto const& d : cube.cube->dates())
+        writeBinaryDate(out, d);
+
+    std::vector<std::string> ids(cube.cube->numIds());
+    for (auto const& [id, pos] : cube.cube->idsAndIndexes())
+        ids[pos] = id;
+    for (auto const& id : ids)
+        out.write(id);
+
+    out.write(cube.scenarioGeneratorData ? cube.scenarioGeneratorData->toXMLString() : std::string());
+    out.write<std::int32_t>(cube.storeFlows ? (*cube.storeFlows ? 1 : 0) : -1);
+    out.write<std::int64_t>(cube.storeCreditStateNPVs ? static_cast<std::int64_t>(*cube.storeCreditStateNPVs) : -1);
+    out.align();
+
+    if (doublePrecision)
+        writeCubeBinaryData<double>(out, *cube.cube);
+    else
+        writeCubeBinaryData<float>(out, *cube.cube);
+}
+
+//! read-only aggregation scenario data on top of a mapped binary file
+class MappedAggregationScenarioData : public AggregationScenarioData {
+public:
+    MappedAggregationScenarioData(const QuantLib::ext::shared_ptr<boost::iostreams::mapped_file_source>& file,
+                                  Size dataOffset, Size dimDates, Size dimSamples,
+                                  const std::vector<std::pair<AggregationScenarioDataType, std::string>>& keys)
+        : file_(file), dimDates_(dimDates), dimSamples_(dimSamples), keys_(keys) {
+        QL_REQUIRE(dataOffset + keys_.size() * dimDates_ * dimSamples_ * sizeof(double) <= file_->size(),
+                   "MappedAggregationScenarioData: file size (" << file_->size() << ") is too small");
+        for (Size i = 0; i < keys_.size(); ++i)
+            keyIndex_[keys_[i]] = i;
+        data_ = reinterpret_cast<const double*>(file_->data() + dataOffset);
+    }
+
+    Size dimDates() const override { return dimDates_; }
+    Size dimSamples() const override { return dimSamples_; }
+
+    bool has(const AggregationScenarioDataType& type, const string& qualifier = "") const override {
+        return keyIndex_.find(std::make_pair(type, qualifier)) != keyIndex_.end();
+    }
+
+    Real get(Size dateIndex, Size sampleIndex, const AggregationScenarioDataType& type,
+             const string& qualifier = "") const override {
+        QL_REQUIRE(dateIndex < dimDates_, "dateIndex (" << dateIndex << ") out of range 0..." << dimDates_ - 1);
+        QL_REQUIRE(sampleIndex < dimSamples_,
+                   "sampleIndex (" << sampleIndex << ") out of range 0..." << dimSamples_ - 1);
+        auto k = keyIndex_.find(std::make_pair(type, qualifier));
+        QL_REQUIRE(k != keyIndex_.end(),
+                   "MappedAggregationScenarioData: no data for type " << type << ", qualifier '" << qualifier << "'");
+        return data_[(k->second * dimDates_ + dateIndex) * dimSamples_ + sampleIndex];
+    }
+
+    void set(Size, Size, Real, const AggregationScenarioDataType&, const string& = "") override {
+        QL_FAIL("MappedAggregationScenarioData::set(): data is read-only");
+    }
+
+    std::vector<std::pair<AggregationScenarioDataType, std::string>> keys() const override { return keys_; }
+
+private:
+    QuantLib::ext::shared_ptr<boost::iostreams::mapped_file_source> file_;
+    Size dimDates_, dimSamples_;
+    std::vector<std::pair<AggregationScenarioDataType, std::string>> keys_;
+    std::map<std::pair<AggregationScenarioDataType, std::string>, Size> keyIndex_;
+    const double* data_;
+};
+
+QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioDataBinary(const std::string& filename) {
+
+    auto file = QuantLib::ext::make_shared<boost::iostreams::mapped_file_source>(filename);
+    BinaryReader in(*file);
+
+    std::uint32_t valueSize = readBinaryPreamble(in, binaryAggScenDataMagic, filename);
+    QL_REQUIRE(valueSize == sizeof(double), "loadAggregationScenarioData(): unsupported value size "
+                                                << valueSize << " in file '" << filename << "'");
+
+    Size dimDates = in.read<std::uint64_t>();
+    Size dimSamples = in.read<std::uint64_t>();
+    Size numKeys = in.read<std::uint64_t>();
+    std::vector<std::pair<AggregationScenarioDataType, std::string>> keys;
+    for (Size i = 0; i < numKeys; ++i) {
+        auto type = AggregationScenarioDataType(in.read<std::uint32_t>());
+        keys.push_back(std::make_pair(type, in.readString()));
+    }
+    in.align();
+
+    LOG("mapped binary aggregation scenario data from " << filename << ": dimDates = " << dimDates
+                                                        << ", dimSamples = " << dimSamples << ", keys = " << numKeys);
+
+    return QuantLib::ext::make_shared<MappedAggregationScenarioData>(file, in.pos(), dimDates, dimSamples, keys);
+}
+
+void saveAggregationScenarioDataBinary(const std::string& filename, const AggregationScenarioData& cube) {
+
+    BinaryWriter out(filename);
+    writeBinaryPreamble(out, binaryAggScenDataMagic, sizeof(double));
+
+    auto keys = cube.keys();
+    out.write<std::uint64_t>(cube.dimDates());
+    out.write<std::uint64_t>(cube.dimSamples());
+    out.write<std::uint64_t>(keys.size());
+    for (auto const& k : keys) {
+        out.write<std::uint32_t>(static_cast<std::uint32_t>(k.first));
+        out.write(k.second);
+    }
+    out.align();
+
+    std::vector<double> buffer(cube.dimSamples());
+    for (auto const& k : keys) {
+        for (Size i = 0; i < cube.dimDates(); ++i) {
+            for (Size j = 0; j < cube.dimSamples(); ++j)
+                buffer[j] = cube.get(i, j, k.first, k.second);
+            out.write(buffer.data(), buffer.size() * sizeof(double));
+        }
+    }
+}
+
 std::string getMetaData(const std::string& line, const std::string& tag, const bool mandatory = true) {
 
     // assuming a fixed width format "# tag        : <value>"
@@ -62,6 +392,9 @@ std::string getMetaData(const std::string& line, const std::string& tag, const b
 
 NPVCubeWithMetaData loadCube(const std::string& filename, const bool doublePrecision) {
 
+    if (has_magic(filename, binaryCubeMagic))
+        return loadCubeBinary(filename);
+
     NPVCubeWithMetaData result;
 
     // open file
@@ -166,6 +499,11 @@ NPVCubeWithMetaData loadCube(const std::string& filename, const bool doublePreci
 
 void saveCube(const std::string& filename, const NPVCubeWithMetaData& cube, const bool doublePrecision) {
 
+    if (use_binary_format(filename)) {
+        saveCubeBinary(filename, cube, doublePrecision);
+        return;
+    }
+
     // open file
 
     bool gzip = use_compression(filename);
@@ -233,6 +571,9 @@ void saveCube(const std::string& filename, const NPVCubeWithMetaData& cube, cons
 
 QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioData(const std::string& filename) {
 
+    if (has_magic(filename, binaryAggScenDataMagic))
+        return loadAggregationScenarioDataBinary(filename);
+
     // open file
 
     bool gzip = use_compression(filename);
@@ -301,6 +642,11 @@ QuantLib::ext::shared_ptr<AggregationScenarioData> loadAggregationScenarioData(c
 
 void saveAggregationScenarioData(const std::string& filename, const AggregationScenarioData& cube) {
 
+    if (use_binary_format(filename)) {
+        saveAggregationScenarioDataBinary(filename, cube);
+        return;
+    }
+
     // open file
 
     bool gzip = use_compression(filename);
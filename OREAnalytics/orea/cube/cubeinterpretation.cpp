@@ -128,6 +128,59 @@ Real CubeInterpretation::getMporFlows(const QuantLib::ext::shared_ptr<NPVCube>&
     return getMporPositiveFlows(cube, tradeIdx, dateIdx, sampleIdx) + getMporNegativeFlows(cube, tradeIdx, dateIdx, sampleIdx) ;
 }
 
+void CubeInterpretation::getGenericValues(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                                          Size depth, std::vector<Real>& values) const {
+    cube->getSamples(values, tradeIdx, dateIdx, depth);
+    if (flipViewXVA_) {
+        for (auto& v : values)
+            v = -v;
+    }
+}
+
+void CubeInterpretation::getDefaultNpvs(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                                        std::vector<Real>& values) const {
+    getGenericValues(cube, tradeIdx, dateIdx, defaultDateNpvIndex_, values);
+}
+
+void CubeInterpretation::getCloseOutNpvs(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                                         std::vector<Real>& values) const {
+    if (withCloseOutLag_) {
+        getGenericValues(cube, tradeIdx, dateIdx, closeOutDateNpvIndex_, values);
+        for (Size k = 0; k < values.size(); ++k)
+            values[k] /= getCloseOutAggregationScenarioData(AggregationScenarioDataType::Numeraire, dateIdx, k);
+    } else {
+        getGenericValues(cube, tradeIdx, dateIdx + 1, defaultDateNpvIndex_, values);
+    }
+}
+
+void CubeInterpretation::getMporPositiveFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx,
+                                              Size dateIdx, std::vector<Real>& values) const {
+    if (mporFlowsIndex_ == QuantLib::Null<Size>()) {
+        values.assign(cube->samples(), 0.0);
+        return;
+    }
+    try {
+        getGenericValues(cube, tradeIdx, dateIdx, mporFlowsIndex_, values);
+    } catch (std::exception& e) {
+        DLOG("Unable to retrieve MPOR flows for trade " << tradeIdx << ", date " << dateIdx << "; " << e.what());
+        values.assign(cube->samples(), 0.0);
+    }
+}
+
+void CubeInterpretation::getMporNegativeFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx,
+                                              Size dateIdx, std::vector<Real>& values) const {
+    if (mporFlowsIndex_ == QuantLib::Null<Size>()) {
+        values.assign(cube->samples(), 0.0);
+        return;
+    }
+    try {
+        getGenericValues(cube, tradeIdx, dateIdx, mporFlowsIndex_ + 1, values);
+    } catch (std::exception& e) {
+        DLOG("Unable to retrieve MPOR flows for trade " << tradeIdx << ", date " << dateIdx << "; " << e.what());
+        values.assign(cube->samples(), 0.0);
+    }
+}
+
 Real CubeInterpretation::getDefaultAggregationScenarioData(const AggregationScenarioDataType& dataType, Size dateIdx,
                                                            Size sampleIdx, const std::string& qualifier) const {
     QL_REQUIRE(!aggregationScenarioData_.empty(),
@@ -33,6 +33,7 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace ore {
 using namespace data;
@@ -86,6 +87,26 @@ public:
     //! Retrieve the aggregate value of Margin Period of Risk cashflows from the Cube
     Real getMporFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx, Size sampleIdx) const;
 
+    //! Retrieve arbitrary values for all samples from the Cube
+    void getGenericValues(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx, Size depth,
+                          std::vector<Real>& values) const;
+
+    //! Retrieve the default date NPVs for all samples from the Cube
+    void getDefaultNpvs(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                        std::vector<Real>& values) const;
+
+    //! Retrieve the close-out date NPVs for all samples from the Cube
+    void getCloseOutNpvs(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                         std::vector<Real>& values) const;
+
+    //! Retrieve the aggregate values of Margin Period of Risk positive cashflows for all samples from the Cube
+    void getMporPositiveFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                              std::vector<Real>& values) const;
+
+    //! Retrieve the aggregate values of Margin Period of Risk negative cashflows for all samples from the Cube
+    void getMporNegativeFlows(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size tradeIdx, Size dateIdx,
+                              std::vector<Real>& values) const;
+
     //! Retrieve a (default date) simulated risk factor value from AggregationScenarioData
     Real getDefaultAggregationScenarioData(const AggregationScenarioDataType& dataType, Size dateIdx, Size sampleIdx,
                                            const std::string& qualifier = "") const;
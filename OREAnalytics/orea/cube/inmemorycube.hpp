@@ -15,7 +15,6 @@
  ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
-
 /*! \file orea/cube/inmemorycube.hpp
     \brief A cube implementation that stores the cube in memory
     \ingroup cube
@@ -23,11 +22,13 @@
 
 #pragma once
 
-#include <fstream>
+#include <algorithm>
+#include <limits>
 #include <vector>
 
 #include <ql/errors.hpp>
 
+#include <boost/align/aligned_allocator.hpp>
 #include <boost/make_shared.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <set>
@@ -39,38 +40,54 @@ using QuantLib::Real;
 using QuantLib::Size;
 using std::vector;
 
-//! InMemoryCube stores the cube in memory using nested STL vectors
-/*! InMemoryCube stores the cube in memory using nested STL vectors, this class is a template
+//! InMemoryCube stores the cube in memory using a single contiguous buffer
+/*! InMemoryCube stores the cube in memory in one aligned contiguous buffer, this class is a template
  *  to allow both single and double precision implementations.
  *
- *  The use of nested STL vectors is adds a small memory overhead (~ 1 to 2%)
+ *  The layout is ids x dates x depth x samples with samples innermost, i.e. all samples for a given
+ *  (id, date, depth) are adjacent in memory and can be accessed as one row via row(), getSamples()
+ *  and setSamples().
 
  \ingroup cube
  */
 template <typename T> class InMemoryCubeBase : public NPVCube {
 public:
+    //! alignment of the data buffer in bytes (cache line size)
+    static constexpr Size alignment = 64;
+    using storage_type = vector<T, boost::alignment::aligned_allocator<T, alignment>>;
+
     //! default ctor
     InMemoryCubeBase(const Date& asof, const std::set<std::string>& ids, const vector<Date>& dates, Size samples,
-                     const T& t = T())
-        : asof_(asof), dates_(dates), samples_(samples), t0Data_(ids.size(), t),
-          data_(ids.size(), vector<vector<T>>(dates.size(), vector<T>(samples, t))) {
+                     Size depth, const T& t = T())
+        : asof_(asof), dates_(dates), samples_(samples), depth_(depth) {
         QL_REQUIRE(ids.size() > 0, "InMemoryCube::InMemoryCube no ids specified");
         QL_REQUIRE(dates.size() > 0, "InMemoryCube::InMemoryCube no dates specified");
         QL_REQUIRE(samples > 0, "InMemoryCube::InMemoryCube samples must be > 0");
+        QL_REQUIRE(depth > 0, "InMemoryCube::InMemoryCube depth must be > 0");
+        Size check = std::numeric_limits<Size>::max();
+        check /= ids.size();
+        check /= dates.size();
+        check /= depth;
+        check /= samples;
+        QL_REQUIRE(check >= 1, "InMemoryCube::InMemoryCube: total size exceeded: ids ("
+                                   << ids.size() << ") * dates (" << dates.size() << ") * depth (" << depth
+                                   << ") * samples (" << samples << ") > " << std::numeric_limits<Size>::max());
+        t0Data_.assign(ids.size() * depth, t);
+        data_.assign(ids.size() * dates.size() * depth * samples, t);
         size_t pos = 0;
         for (const auto& id : ids) {
             idIdx_[id] = pos++;
         }
-        
     }
 
     //! default constructor
-    InMemoryCubeBase() {}
+    InMemoryCubeBase() : samples_(0), depth_(0) {}
 
     //! Return the length of each dimension
     Size numIds() const override { return idIdx_.size(); }
     Size numDates() const override { return dates_.size(); }
     virtual Size samples() const override { return samples_; }
+    Size depth() const override { return depth_; }
 
     //! Return a map of all ids and their position in the cube
     const std::map<std::string, Size>& idsAndIndexes() const override { return idIdx_; }
@@ -80,6 +97,67 @@ public:
     //! Return the asof date (T0 date)
     QuantLib::Date asof() const override { return asof_; }
 
+    //! Get a T0 value from the cube
+    Real getT0(Size i, Size d) const override {
+        this->check(i, 0, 0, d);
+        return t0Data_[i * depth_ + d];
+    }
+
+    //! Set a value in the cube
+    void setT0(Real value, Size i, Size d) override {
+        this->check(i, 0, 0, d);
+        t0Data_[i * depth_ + d] = static_cast<T>(value);
+    }
+
+    //! Get a value from the cube
+    Real get(Size i, Size j, Size k, Size d) const override {
+        this->check(i, j, k, d);
+        return data_[offset(i, j, d) + k];
+    }
+
+    //! Set a value in the cube
+    void set(Real value, Size i, Size j, Size k, Size d) override {
+        this->check(i, j, k, d);
+        data_[offset(i, j, d) + k] = static_cast<T>(value);
+    }
+
+    //! Get all samples for (i, j, d) from the cube
+    void getSamples(std::vector<Real>& values, Size i, Size j, Size d) const override {
+        this->check(i, j, 0, d);
+        const T* r = row(i, j, d);
+        values.resize(samples_);
+        std::copy(r, r + samples_, values.begin());
+    }
+
+    //! Set all samples for (i, j, d) in the cube
+    void setSamples(const std::vector<Real>& values, Size i, Size j, Size d) override {
+        this->check(i, j, 0, d);
+        QL_REQUIRE(values.size() == samples_, "InMemoryCube::setSamples(): values size (" << values.size()
+                                                                                          << ") does not match samples ("
+                                                                                          << samples_ << ")");
+        std::transform(values.begin(), values.end(), row(i, j, d), [](Real v) { return static_cast<T>(v); });
+    }
+
+    //! Remove all values for an id, the block for an id is contiguous
+    void remove(Size i) override {
+        this->check(i, 0, 0, 0);
+        std::fill(t0Data_.begin() + i * depth_, t0Data_.begin() + (i + 1) * depth_, T());
+        std::fill(data_.begin() + offset(i, 0, 0), data_.begin() + offset(i + 1, 0, 0), T());
+    }
+
+    //! Remove all values for an id and a sample, keep T0 values
+    void remove(Size i, Size k) override {
+        this->check(i, 0, k, 0);
+        for (Size j = 0; j < numDates(); ++j)
+            for (Size d = 0; d < depth_; ++d)
+                data_[offset(i, j, d) + k] = T();
+    }
+
+    /*! Direct access to the contiguous samples for (i, j, d), the row has length samples(). No bounds checks are
+        performed, the pointer is invalidated when the cube is destroyed. */
+    const T* row(Size i, Size j, Size d = 0) const { return data_.data() + offset(i, j, d); }
+    T* row(Size i, Size j, Size d = 0) { return data_.data() + offset(i, j, d); }
+
 protected:
     void check(Size i, Size j, Size k, Size d) const {
         QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
@@ -88,96 +166,40 @@ protected:
         QL_REQUIRE(d < depth(), "Out of bounds on depth (d=" << d << ", depth=" << depth() << ")");
     }
 
+    Size offset(Size i, Size j, Size d) const { return ((i * dates_.size() + j) * depth_ + d) * samples_; }
+
     QuantLib::Date asof_;
     vector<QuantLib::Date> dates_;
     Size samples_;
-    vector<T> t0Data_;
-    vector<vector<vector<T>>> data_;
+    Size depth_;
+    storage_type t0Data_;
+    storage_type data_;
 
     std::map<std::string, Size> idIdx_;
 };
 
 //! InMemoryCube of fixed depth 1
-/*! This implementation stores the type directly in an InMemoryCubeBase to avoid us having
- *  nested vectors all of length 1
- */
 template <typename T> class InMemoryCube1 : public InMemoryCubeBase<T> {
 public:
     //! ctor
     InMemoryCube1(const Date& asof, const std::set<std::string>& ids, const vector<Date>& dates, Size samples,
                   const T& t = T())
-        : InMemoryCubeBase<T>(asof, ids, dates, samples, t) {}
+        : InMemoryCubeBase<T>(asof, ids, dates, samples, 1, t) {}
 
     //! default
     InMemoryCube1() {}
-
-    //! Fixed depth
-    Size depth() const override { return 1; }
-
-    //! Get a T0 value from the cube
-    virtual Real getT0(Size i, Size d) const override {
-        this->check(i, 0, 0, d);
-        return this->t0Data_[i];
-    }
-
-    //! Set a value in the cube
-    virtual void setT0(Real value, Size i, Size d) override {
-        this->check(i, 0, 0, d);
-        this->t0Data_[i] = static_cast<T>(value);
-    }
-
-    //! Get a value from the cube
-    Real get(Size i, Size j, Size k, Size d) const override {
-        this->check(i, j, k, d);
-        return this->data_[i][j][k];
-    }
-
-    //! Set a value in the cube
-    void set(Real value, Size i, Size j, Size k, Size d) override {
-        this->check(i, j, k, d);
-        this->data_[i][j][k] = static_cast<T>(value);
-    }
 };
 
 //! InMemoryCube of variable depth
-/*! This implementation stores a vector an InMemoryCubeBase
- */
-template <typename T> class InMemoryCubeN : public InMemoryCubeBase<vector<T>> {
+template <typename T> class InMemoryCubeN : public InMemoryCubeBase<T> {
 public:
     //! ctor
     InMemoryCubeN(const Date& asof, const std::set<std::string>& ids, const vector<Date>& dates, Size samples, Size depth,
                   const T& t = T())
-        : InMemoryCubeBase<vector<T>>(asof, ids, dates, samples, vector<T>(depth, t)) {}
+        : InMemoryCubeBase<T>(asof, ids, dates, samples, depth, t) {}
 
     //! default
     InMemoryCubeN() {}
-
-    //! Depth
-    Size depth() const override { return this->data_[0][0][0].size(); } // we don't want any members in this class
-
-    //! Get a T0 value from the cube
-    virtual Real getT0(Size i, Size d) const override {
-        this->check(i, 0, 0, d);
-        return this->t0Data_[i][d];
-    }
-
-    //! Set a value in the cube
-    virtual void setT0(Real value, Size i, Size d) override {
-        this->check(i, 0, 0, d);
-        this->t0Data_[i][d] = static_cast<T>(value);
-    }
-
-    //! Get a value from the cube
-    Real get(Size i, Size j, Size k, Size d) const override {
-        this->check(i, j, k, d);
-        return this->data_[i][j][k][d];
-    }
-
-    //! Set a value in the cube
-    void set(Real value, Size i, Size j, Size k, Size d) override {
-        this->check(i, j, k, d);
-        this->data_[i][j][k][d] = static_cast<T>(value);
-    }
 };
 
 //! InMemoryCube of depth 1 with single precision floating point numbers.
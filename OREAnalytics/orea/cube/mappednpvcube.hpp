@@ -0,0 +1,128 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/mappednpvcube.hpp
+    \brief A read-only cube backed by a memory mapped binary cube file
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include <algorithm>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! Read-only cube on top of a memory mapped binary cube file
+/*! The data is not copied, get() reads directly from the mapped file. The layout of the data block is the same as for
+    InMemoryCube, i.e. T0 values as ids x depth and the future values as ids x dates x depth x samples with samples
+    innermost. The cube is created by loadCube() for files written in the binary cube format, see cube_io.hpp.
+
+    \ingroup cube
+ */
+template <typename T> class MappedNpvCube : public NPVCube {
+public:
+    /*! t0Offset and dataOffset are the byte offsets of the T0 block and the data block within the mapped file,
+        both must be aligned to sizeof(T) */
+    MappedNpvCube(const QuantLib::ext::shared_ptr<boost::iostreams::mapped_file_source>& file, Size t0Offset,
+                  Size dataOffset, const Date& asof, const std::map<std::string, Size>& ids,
+                  const std::vector<Date>& dates, Size samples, Size depth)
+        : file_(file), asof_(asof), idIdx_(ids), dates_(dates), samples_(samples), depth_(depth) {
+        QL_REQUIRE(file_ && file_->is_open(), "MappedNpvCube: file is not open");
+        QL_REQUIRE(t0Offset % sizeof(T) == 0 && dataOffset % sizeof(T) == 0,
+                   "MappedNpvCube: offsets (" << t0Offset << ", " << dataOffset << ") are not aligned");
+        QL_REQUIRE(t0Offset + idIdx_.size() * depth_ * sizeof(T) <= dataOffset,
+                   "MappedNpvCube: T0 block overlaps data block");
+        QL_REQUIRE(dataOffset + idIdx_.size() * dates_.size() * depth_ * samples_ * sizeof(T) <= file_->size(),
+                   "MappedNpvCube: file size (" << file_->size() << ") is too small for cube of dimension "
+                                                << idIdx_.size() << " x " << dates_.size() << " x " << samples_
+                                                << " x " << depth_);
+        t0Data_ = reinterpret_cast<const T*>(file_->data() + t0Offset);
+        data_ = reinterpret_cast<const T*>(file_->data() + dataOffset);
+    }
+
+    Size numIds() const override { return idIdx_.size(); }
+    Size numDates() const override { return dates_.size(); }
+    Size samples() const override { return samples_; }
+    Size depth() const override { return depth_; }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return idIdx_; }
+    const std::vector<QuantLib::Date>& dates() const override { return dates_; }
+    QuantLib::Date asof() const override { return asof_; }
+
+    Real getT0(Size i, Size d) const override {
+        check(i, 0, 0, d);
+        return t0Data_[i * depth_ + d];
+    }
+
+    Real get(Size i, Size j, Size k, Size d) const override {
+        check(i, j, k, d);
+        return data_[offset(i, j, d) + k];
+    }
+
+    void getSamples(std::vector<Real>& values, Size i, Size j, Size d) const override {
+        check(i, j, 0, d);
+        const T* r = row(i, j, d);
+        values.resize(samples_);
+        std::copy(r, r + samples_, values.begin());
+    }
+
+    //! Direct access to the contiguous samples for (i, j, d), no bounds checks are performed
+    const T* row(Size i, Size j, Size d = 0) const { return data_ + offset(i, j, d); }
+
+    //! \name the cube is read-only
+    //@{
+    void setT0(Real, Size, Size) override { QL_FAIL("MappedNpvCube::setT0(): cube is read-only"); }
+    void set(Real, Size, Size, Size, Size) override { QL_FAIL("MappedNpvCube::set(): cube is read-only"); }
+    void setSamples(const std::vector<Real>&, Size, Size, Size) override {
+        QL_FAIL("MappedNpvCube::setSamples(): cube is read-only");
+    }
+    void remove(Size) override { QL_FAIL("MappedNpvCube::remove(): cube is read-only"); }
+    void remove(Size, Size) override { QL_FAIL("MappedNpvCube::remove(): cube is read-only"); }
+    //@}
+
+private:
+    void check(Size i, Size j, Size k, Size d) const {
+        QL_REQUIRE(i < numIds(), "Out of bounds on ids (i=" << i << ", numIds=" << numIds() << ")");
+        QL_REQUIRE(j < numDates(), "Out of bounds on dates (j=" << j << ", numDates=" << numDates() << ")");
+        QL_REQUIRE(k < samples(), "Out of bounds on samples (k=" << k << ", samples=" << samples() << ")");
+        QL_REQUIRE(d < depth(), "Out of bounds on depth (d=" << d << ", depth=" << depth() << ")");
+    }
+
+    Size offset(Size i, Size j, Size d) const { return ((i * dates_.size() + j) * depth_ + d) * samples_; }
+
+    QuantLib::ext::shared_ptr<boost::iostreams::mapped_file_source> file_;
+    QuantLib::Date asof_;
+    std::map<std::string, Size> idIdx_;
+    std::vector<QuantLib::Date> dates_;
+    Size samples_;
+    Size depth_;
+    const T* t0Data_;
+    const T* data_;
+};
+
+} // namespace analytics
+} // namespace ore
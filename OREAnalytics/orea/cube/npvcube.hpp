@@ -108,6 +108,14 @@ public:
         set(value, index(id), index(date), sample, depth);
     }
 
+    /*! Get all samples for a given (id, date, depth) in one go, values is resized to samples(). The default
+        implementation loops over get(), cubes with contiguous sample storage should override this. */
+    virtual void getSamples(std::vector<Real>& values, Size id, Size date, Size depth = 0) const;
+
+    /*! Set all samples for a given (id, date, depth) in one go, values must have size samples(). The default
+        implementation loops over set(), cubes with contiguous sample storage should override this. */
+    virtual void setSamples(const std::vector<Real>& values, Size id, Size date, Size depth = 0);
+
     /*! remove all values for a given id, i.e. change the state as if setT0() and set() has never been called for the id
         the default implementation has generelly to be overriden in derived classes depending on how values are stored */
     virtual void remove(Size id);
@@ -134,6 +142,19 @@ protected:
 
 // impl
 
+inline void NPVCube::getSamples(std::vector<Real>& values, Size id, Size date, Size depth) const {
+    values.resize(samples());
+    for (Size sample = 0; sample < values.size(); ++sample)
+        values[sample] = get(id, date, sample, depth);
+}
+
+inline void NPVCube::setSamples(const std::vector<Real>& values, Size id, Size date, Size depth) {
+    QL_REQUIRE(values.size() == samples(),
+               "NPVCube::setSamples(): values size (" << values.size() << ") does not match samples (" << samples() << ")");
+    for (Size sample = 0; sample < values.size(); ++sample)
+        set(values[sample], id, date, sample, depth);
+}
+
 inline void NPVCube::remove(Size id) {
     for (Size date = 0; date < this->numDates(); ++date) {
         for (Size depth = 0; depth < this->depth(); ++depth) {
@@ -21,6 +21,8 @@
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <ql/utilities/null.hpp>
+
 #include <boost/range/adaptor/indexed.hpp>
 
 using namespace QuantLib;
@@ -142,6 +144,40 @@ void SensitivityCube::initialise() {
         FactorData id_2 = index(cf.first.second, upFactors_);
         crossFactors_[cf.first] = make_tuple(id_1, id_2, cf.second);
     }
+
+    // Populate the flat key data lookup by risk factor key registry id
+    auto& registry = RiskFactorKeyRegistry::instance();
+    auto getKeyData = [this, &registry](const RiskFactorKey& key) -> KeyData& {
+        Size id = registry.id(key);
+        if (id >= keyDataIndex_.size())
+            keyDataIndex_.resize(id + 1, Null<Size>());
+        if (keyDataIndex_[id] == Null<Size>()) {
+            keyDataIndex_[id] = keyData_.size();
+            keyData_.push_back(KeyData());
+            if (auto s = shiftSchemes_.find(key); s != shiftSchemes_.end()) {
+                keyData_.back().hasShiftScheme = true;
+                keyData_.back().shiftScheme = s->second;
+            }
+        }
+        return keyData_[keyDataIndex_[id]];
+    };
+    for (auto const& [key, fd] : upFactors_) {
+        auto& kd = getKeyData(key);
+        kd.hasUp = true;
+        kd.up = fd;
+    }
+    for (auto const& [key, fd] : downFactors_) {
+        auto& kd = getKeyData(key);
+        kd.hasDown = true;
+        kd.down = fd;
+    }
+}
+
+const SensitivityCube::KeyData* SensitivityCube::keyData(const RiskFactorKey& riskFactorKey) const {
+    Size id = RiskFactorKeyRegistry::instance().find(riskFactorKey);
+    if (id >= keyDataIndex_.size() || keyDataIndex_[id] == Null<Size>())
+        return nullptr;
+    return &keyData_[keyDataIndex_[id]];
 }
 
 bool SensitivityCube::hasTrade(const string& tradeId) const { return tradeIdx_.count(tradeId) > 0; }
@@ -227,22 +263,21 @@ Real scaling(const SensitivityCube::FactorData& fd) {
 } // namespace
 
 Real SensitivityCube::delta(const Size tradeIdx, const RiskFactorKey& riskFactorKey) const {
-    auto s = shiftSchemes_.find(riskFactorKey);
-    QL_REQUIRE(s != shiftSchemes_.end(),
+    const KeyData* kd = keyData(riskFactorKey);
+    QL_REQUIRE(kd != nullptr && kd->hasShiftScheme,
                "SensitivityCube::delta(" << tradeIdx << ", " << riskFactorKey << "): no shift scheme stored.");
-    if (s->second == ShiftScheme::Forward) {
-        auto fd = index(riskFactorKey, upFactors_);
-        return (cube_->get(tradeIdx, fd.index) - cube_->getT0(tradeIdx, 0)) * scaling(fd);
-    } else if (s->second == ShiftScheme::Backward) {
-        auto fd = index(riskFactorKey, downFactors_);
-        return (cube_->getT0(tradeIdx, 0) - cube_->get(tradeIdx, fd.index)) * scaling(fd);
-    } else if (s->second == ShiftScheme::Central) {
-        auto fdup = index(riskFactorKey, upFactors_);
-        auto fddown = index(riskFactorKey, downFactors_);
-        return (cube_->get(tradeIdx, fdup.index) - cube_->get(tradeIdx, fddown.index)) / 2.0 * scaling(fdup);
+    if (kd->shiftScheme == ShiftScheme::Forward) {
+        QL_REQUIRE(kd->hasUp, "Key, " << riskFactorKey << ", was not found in the sensitivity cube.");
+        return (cube_->get(tradeIdx, kd->up.index) - cube_->getT0(tradeIdx, 0)) * scaling(kd->up);
+    } else if (kd->shiftScheme == ShiftScheme::Backward) {
+        QL_REQUIRE(kd->hasDown, "Key, " << riskFactorKey << ", was not found in the sensitivity cube.");
+        return (cube_->getT0(tradeIdx, 0) - cube_->get(tradeIdx, kd->down.index)) * scaling(kd->down);
+    } else if (kd->shiftScheme == ShiftScheme::Central) {
+        QL_REQUIRE(kd->hasUp && kd->hasDown, "Key, " << riskFactorKey << ", was not found in the sensitivity cube.");
+        return (cube_->get(tradeIdx, kd->up.index) - cube_->get(tradeIdx, kd->down.index)) / 2.0 * scaling(kd->up);
     } else {
         QL_FAIL("SensitivityCube::delta(" << tradeIdx << ", " << riskFactorKey << "): unknown shift scheme '"
-                                          << s->second << "'");
+                                          << kd->shiftScheme << "'");
     }
 }
 
@@ -251,12 +286,13 @@ Real SensitivityCube::delta(const string& tradeId, const RiskFactorKey& riskFact
 }
 
 Real SensitivityCube::gamma(const Size tradeIdx, const RiskFactorKey& riskFactorKey) const {
-    auto fdup = index(riskFactorKey, upFactors_);
-    auto fddown = index(riskFactorKey, downFactors_);
+    const KeyData* kd = keyData(riskFactorKey);
+    QL_REQUIRE(kd != nullptr && kd->hasUp && kd->hasDown,
+               "Key, " << riskFactorKey << ", was not found in the sensitivity cube.");
     Real baseNpv = cube_->getT0(tradeIdx, 0);
-    Real upNpv = cube_->get(tradeIdx, fdup.index);
-    Real downNpv = cube_->get(tradeIdx, fddown.index);
-    return (upNpv - 2.0 * baseNpv + downNpv) * std::pow(scaling(fdup), 2);
+    Real upNpv = cube_->get(tradeIdx, kd->up.index);
+    Real downNpv = cube_->get(tradeIdx, kd->down.index);
+    return (upNpv - 2.0 * baseNpv + downNpv) * std::pow(scaling(kd->up), 2);
 }
 
 Real SensitivityCube::gamma(const string& tradeId, const RiskFactorKey& riskFactorKey) const {
@@ -154,6 +154,16 @@ private:
     //! Initialise method used by the constructors
     void initialise();
 
+    //! Up / down factor data and shift scheme of a risk factor, used by delta() and gamma()
+    struct KeyData {
+        bool hasUp = false, hasDown = false, hasShiftScheme = false;
+        FactorData up, down;
+        ShiftScheme shiftScheme = ShiftScheme::Forward;
+    };
+
+    //! Return the key data for \p riskFactorKey or nullptr if there is none
+    const KeyData* keyData(const RiskFactorKey& riskFactorKey) const;
+
     QuantLib::ext::shared_ptr<NPVSensiCube> cube_;
     std::vector<ShiftScenarioDescription> scenarioDescriptions_;
     std::map<RiskFactorKey, QuantLib::Real> targetShiftSizes_;
@@ -179,6 +189,11 @@ private:
     std::map<QuantLib::Size, RiskFactorKey> downIndexToKey_;
     std::map<QuantLib::Size, crossPair> crossIndexToKey_;
 
+    // flat lookup of the up / down factor data by RiskFactorKeyRegistry id, avoids the map lookups and
+    // FactorData copies in delta() and gamma()
+    std::vector<KeyData> keyData_;
+    std::vector<QuantLib::Size> keyDataIndex_;
+
 };
 
 std::ostream& operator<<(std::ostream& out, const SensitivityCube::crossPair& cp);
@@ -0,0 +1,87 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/cube/stridednpvcube.hpp
+    \brief A view on every n-th sample of a cube
+    \ingroup cube
+*/
+
+#pragma once
+
+#include <orea/cube/npvcube.hpp>
+
+#include <ql/errors.hpp>
+
+namespace ore {
+namespace analytics {
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+//! View on the samples offset, offset + stride, offset + 2 * stride, ... of an underlying cube
+/*! The data is not copied, sample k of this cube is sample offset + k * stride of the underlying cube. The T0 values,
+    ids, dates and depth are those of the underlying cube. This is used to split a cube that was generated on
+    interleaved scenario sets, see HistoricalPnlGenerator::generateCubes().
+
+    \ingroup cube
+ */
+class StridedNpvCube : public NPVCube {
+public:
+    StridedNpvCube(const QuantLib::ext::shared_ptr<NPVCube>& cube, Size offset, Size stride)
+        : cube_(cube), offset_(offset), stride_(stride) {
+        QL_REQUIRE(cube_, "StridedNpvCube: no underlying cube given");
+        QL_REQUIRE(stride_ > 0, "StridedNpvCube: stride must be positive");
+        QL_REQUIRE(offset_ < stride_, "StridedNpvCube: offset (" << offset_ << ") must be less than stride ("
+                                                                 << stride_ << ")");
+        QL_REQUIRE(cube_->samples() % stride_ == 0, "StridedNpvCube: underlying cube samples ("
+                                                        << cube_->samples() << ") must be a multiple of stride ("
+                                                        << stride_ << ")");
+        samples_ = cube_->samples() / stride_;
+    }
+
+    Size numIds() const override { return cube_->numIds(); }
+    Size numDates() const override { return cube_->numDates(); }
+    Size samples() const override { return samples_; }
+    Size depth() const override { return cube_->depth(); }
+    const std::map<std::string, Size>& idsAndIndexes() const override { return cube_->idsAndIndexes(); }
+    const std::vector<QuantLib::Date>& dates() const override { return cube_->dates(); }
+    QuantLib::Date asof() const override { return cube_->asof(); }
+
+    Real getT0(Size i, Size d) const override { return cube_->getT0(i, d); }
+    void setT0(Real value, Size i, Size d) override { cube_->setT0(value, i, d); }
+
+    Real get(Size i, Size j, Size k, Size d) const override { return cube_->get(i, j, sample(k), d); }
+    void set(Real value, Size i, Size j, Size k, Size d) override { cube_->set(value, i, j, sample(k), d); }
+
+    //! The underlying cube
+    const QuantLib::ext::shared_ptr<NPVCube>& underlyingCube() const { return cube_; }
+
+private:
+    Size sample(Size k) const {
+        QL_REQUIRE(k < samples_, "Out of bounds on samples (k=" << k << ", samples=" << samples_ << ")");
+        return offset_ + k * stride_;
+    }
+
+    QuantLib::ext::shared_ptr<NPVCube> cube_;
+    Size offset_;
+    Size stride_;
+    Size samples_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -18,26 +18,49 @@
 
 #include <orea/engine/bufferedsensitivitystream.hpp>
 
+#include <algorithm>
+
 namespace ore {
 namespace analytics {
 
 BufferedSensitivityStream::BufferedSensitivityStream(const QuantLib::ext::shared_ptr<SensitivityStream>& stream)
-    : stream_(stream) {}
+    : stream_(stream) {
+    buffer_.dictionary = stream_->dictionary();
+}
 
 SensitivityRecord BufferedSensitivityStream::next() {
     if (index_ == QuantLib::Null<Size>()) {
-        buffer_.push_back(stream_->next());
-        return buffer_.back();
+        read_ = true;
+        SensitivityRecord sr = stream_->next();
+        if (sr)
+            buffer_.add(sr);
+        return sr;
     }
     if (index_ < buffer_.size()) {
-        return buffer_[index_++];
+        return buffer_.record(index_++);
     }
     return {};
 }
 
+bool BufferedSensitivityStream::nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize) {
+    if (index_ == QuantLib::Null<Size>()) {
+        read_ = true;
+        if (!stream_->nextBatch(batch, maxSize))
+            return false;
+        buffer_.append(batch, 0, batch.size());
+        return true;
+    }
+    batch.clear();
+    batch.dictionary = buffer_.dictionary;
+    Size end = std::min(buffer_.size(), index_ + maxSize);
+    batch.append(buffer_, index_, end);
+    index_ = end;
+    return !batch.empty();
+}
+
 void BufferedSensitivityStream::reset() {
     // if next() was never called, we do not switch to the buffered mode
-    if (!buffer_.empty())
+    if (read_)
         index_ = 0;
 }
 
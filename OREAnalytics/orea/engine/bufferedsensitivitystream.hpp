@@ -27,15 +27,20 @@
 namespace ore {
 namespace analytics {
 
+/*! Reads the wrapped stream once and replays the buffered records after a reset. The records are buffered in
+    columnar form referring to the dictionary of the wrapped stream. */
 class BufferedSensitivityStream : public SensitivityStream {
 public:
     explicit BufferedSensitivityStream(const QuantLib::ext::shared_ptr<SensitivityStream>& stream);
     SensitivityRecord next() override;
     void reset() override;
+    bool nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize = 4096) override;
+    QuantLib::ext::shared_ptr<SensitivityDictionary> dictionary() const override { return stream_->dictionary(); }
 
 private:
     QuantLib::ext::shared_ptr<SensitivityStream> stream_;
-    std::vector<SensitivityRecord> buffer_;
+    SensitivityBatch buffer_;
+    bool read_ = false;
     QuantLib::Size index_ = QuantLib::Null<QuantLib::Size>();
 };
 
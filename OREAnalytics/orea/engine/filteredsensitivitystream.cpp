@@ -20,6 +20,7 @@
 #include <orea/engine/filteredsensitivitystream.hpp>
 
 using QuantLib::Real;
+using QuantLib::Size;
 using std::fabs;
 
 namespace ore {
@@ -30,10 +31,12 @@ FilteredSensitivityStream::FilteredSensitivityStream(const QuantLib::ext::shared
     : ss_(ss), deltaThreshold_(deltaThreshold), gammaThreshold_(gammaThreshold) {
     // Reset the underlying stream in case
     ss_->reset();
-    while (SensitivityRecord sr = ss_->next()) {
-        if (sr.isCrossGamma() && fabs(sr.gamma) > gammaThreshold_) {
-            deltaKeys_.insert(sr.key_1);
-            deltaKeys_.insert(sr.key_2);
+    while (ss_->nextBatch(buffer_)) {
+        for (Size i = 0; i < buffer_.size(); ++i) {
+            if (buffer_.isCrossGamma(i) && fabs(buffer_.gamma[i]) > gammaThreshold_) {
+                deltaKeys_.insert(buffer_.dictionary->factor(buffer_.factor1[i]).key);
+                deltaKeys_.insert(buffer_.dictionary->factor(buffer_.factor2[i]).key);
+            }
         }
     }
     ss_->reset();
@@ -57,6 +60,29 @@ SensitivityRecord FilteredSensitivityStream::next() {
     return SensitivityRecord();
 }
 
+bool FilteredSensitivityStream::isDeltaKey(Size factor) {
+    if (factor >= isDeltaKey_.size())
+        isDeltaKey_.resize(ss_->dictionary()->numberOfFactors(), 0);
+    if (isDeltaKey_[factor] == 0)
+        isDeltaKey_[factor] = deltaKeys_.count(ss_->dictionary()->factor(factor).key) > 0 ? 2 : 1;
+    return isDeltaKey_[factor] == 2;
+}
+
+bool FilteredSensitivityStream::nextBatch(SensitivityBatch& batch, Size maxSize) {
+    // Collect the records in the underlying stream that satisfy the threshold conditions
+    batch.clear();
+    batch.dictionary = ss_->dictionary();
+    while (batch.size() < maxSize && ss_->nextBatch(buffer_, maxSize - batch.size())) {
+        for (Size i = 0; i < buffer_.size(); ++i) {
+            if (fabs(buffer_.delta[i]) > deltaThreshold_ || fabs(buffer_.gamma[i]) > gammaThreshold_ ||
+                (!buffer_.isCrossGamma(i) && isDeltaKey(buffer_.factor1[i]))) {
+                batch.append(buffer_, i, i + 1);
+            }
+        }
+    }
+    return !batch.empty();
+}
+
 void FilteredSensitivityStream::reset() {
     // Reset the underlying stream
     ss_->reset();
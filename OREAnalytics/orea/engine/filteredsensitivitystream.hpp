@@ -27,6 +27,7 @@
 #include <fstream>
 #include <set>
 #include <string>
+#include <vector>
 
 namespace ore {
 namespace analytics {
@@ -46,8 +47,15 @@ public:
     SensitivityRecord next() override;
     //! Resets the stream so that SensitivityRecord objects can be streamed again
     void reset() override;
+    //! Returns the next batch of records in the underlying stream after filtering
+    bool nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize = 4096) override;
+    //! The dictionary of the underlying stream
+    QuantLib::ext::shared_ptr<SensitivityDictionary> dictionary() const override { return ss_->dictionary(); }
 
 private:
+    //! Whether the delta record with the given risk factor is kept, cached by dictionary index
+    bool isDeltaKey(QuantLib::Size factor);
+
     //! The underlying sensitivity stream that has been wrapped
     QuantLib::ext::shared_ptr<SensitivityStream> ss_;
     //! The delta threshold
@@ -56,6 +64,10 @@ private:
     QuantLib::Real gammaThreshold_;
     //! Set to hold Delta Keys appearing in CrossGammas
     std::set<RiskFactorKey> deltaKeys_;
+    //! Cache for isDeltaKey(), 0 = not yet determined, 1 = no delta key, 2 = delta key
+    std::vector<char> isDeltaKey_;
+    //! Buffer for the batches read from the underlying stream
+    SensitivityBatch buffer_;
 };
 
 } // namespace analytics
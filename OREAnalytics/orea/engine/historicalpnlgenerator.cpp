@@ -23,6 +23,8 @@
 
 #include <orea/cube/jointnpvcube.hpp>
 #include <orea/cube/inmemorycube.hpp>
+#include <orea/cube/stridednpvcube.hpp>
+#include <orea/scenario/multifilterscenariogenerator.hpp>
 
 #include <boost/range/adaptor/indexed.hpp>
 
@@ -48,7 +50,7 @@ HistoricalPnlGenerator::HistoricalPnlGenerator(
     const QuantLib::ext::shared_ptr<HistoricalScenarioGenerator>& hisScenGen, const QuantLib::ext::shared_ptr<NPVCube>& cube,
     const set<std::pair<string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>& modelBuilders, bool dryRun)
     : useSingleThreadedEngine_(true), portfolio_(portfolio), simMarket_(simMarket), hisScenGen_(hisScenGen),
-      cube_(cube), dryRun_(dryRun),
+      cube_(cube), valuationCube_(cube), dryRun_(dryRun),
       npvCalculator_([&baseCurrency]() -> std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>> {
           return {QuantLib::ext::make_shared<NPVCalculator>(baseCurrency)};
       }) {
@@ -111,6 +113,7 @@ void HistoricalPnlGenerator::generateCube(const QuantLib::ext::shared_ptr<Scenar
         simMarket_->reset();
         simMarket_->scenarioGenerator() = hisScenGen_;
         hisScenGen_->baseScenario() = simMarket_->baseScenario();
+        cube_ = valuationCube_;
         valuationEngine_->buildCube(portfolio_, cube_, npvCalculator_(), true, nullptr, nullptr, {}, dryRun_);
 
     } else {
@@ -126,31 +129,94 @@ void HistoricalPnlGenerator::generateCube(const QuantLib::ext::shared_ptr<Scenar
         cube_ = QuantLib::ext::make_shared<JointNPVCube>(engine.outputCubes(), portfolio_->ids(), true);
     }
 
+    cubes_ = {cube_};
+    clearPnlStore();
+
     DLOG("Historical P&L cube generated");
 }
 
-vector<Real> HistoricalPnlGenerator::pnl(const TimePeriod& period, const set<pair<string, Size>>& tradeIds) const {
+void HistoricalPnlGenerator::generateCubes(const vector<QuantLib::ext::shared_ptr<ScenarioFilter>>& filters) {
 
-    // Create result with enough space
-    vector<Real> pnls;
-    pnls.reserve(cube_->samples());
+    QL_REQUIRE(!filters.empty(), "HistoricalPnlGenerator::generateCubes(): no filters given");
 
-    // Look up the date index once
-    Size dateIdx = indexAsof();
+    Size nFilters = filters.size();
+    Size nScenarios = hisScenGen_->numScenarios();
 
-    for (Size s = 0; s < cube_->samples(); ++s) {
-        // Start and end of period relating to current sample
-        Date start = hisScenGen_->startDates()[s];
-        Date end = hisScenGen_->endDates()[s];
+    DLOG("Filling historical P&L cubes for " << portfolio_->size() << " trades, " << nScenarios << " scenarios and "
+                                             << nFilters << " filters.");
 
-        if (period.contains(start) && period.contains(end)) {
-            Real pnl = 0.0;
-            for (const auto& tradeId : tradeIds) {
-                pnl -= cube_->getT0(tradeId.second);
-                pnl += cube_->get(tradeId.second, dateIdx, s);
-            }
-            pnls.push_back(pnl);
+    // the filters are applied by the scenario generator, sample s * nFilters + g is scenario s under filter g
+
+    QuantLib::ext::shared_ptr<NPVCube> cube;
+
+    if (useSingleThreadedEngine_) {
+
+        valuationEngine_->unregisterAllProgressIndicators();
+        for (auto const& i : this->progressIndicators()) {
+            i->reset();
+            valuationEngine_->registerProgressIndicator(i);
         }
+
+        simMarket_->filter() = QuantLib::ext::make_shared<ScenarioFilter>();
+        simMarket_->reset();
+        hisScenGen_->baseScenario() = simMarket_->baseScenario();
+        auto scenGen =
+            QuantLib::ext::make_shared<MultiFilterScenarioGenerator>(hisScenGen_, simMarket_->baseScenario(), filters);
+        scenGen->reset();
+        simMarket_->scenarioGenerator() = scenGen;
+        cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
+            valuationCube_->asof(), portfolio_->ids(), valuationCube_->dates(), nScenarios * nFilters);
+        valuationEngine_->buildCube(portfolio_, cube, npvCalculator_(), true, nullptr, nullptr, {}, dryRun_);
+        simMarket_->scenarioGenerator() = hisScenGen_;
+
+    } else {
+        // the engine clones the historical scenarios only, each thread applies the filters to them on the fly
+        MultiThreadedValuationEngine engine(
+            nThreads_, today_, QuantLib::ext::make_shared<ore::analytics::DateGrid>(), nScenarios * nFilters, loader_,
+            hisScenGen_, engineData_, curveConfigs_, todaysMarketParams_, configuration_, simMarketData_, false, false,
+            nullptr, referenceData_, iborFallbackConfig_, true, true, true, {}, {}, {}, context_);
+        auto baseScenario = hisScenGen_->baseScenario();
+        engine.setScenarioGeneratorWrapper(
+            [baseScenario, &filters](const QuantLib::ext::shared_ptr<ScenarioGenerator>& scenGen) {
+                return QuantLib::ext::make_shared<MultiFilterScenarioGenerator>(scenGen, baseScenario, filters);
+            },
+            nFilters);
+        for (auto const& i : this->progressIndicators()) {
+            i->reset();
+            engine.registerProgressIndicator(i);
+        }
+        engine.buildCube(portfolio_, npvCalculator_, {}, true, dryRun_);
+        cube = QuantLib::ext::make_shared<JointNPVCube>(engine.outputCubes(), portfolio_->ids(), true);
+    }
+
+    cubes_.clear();
+    for (Size g = 0; g < nFilters; ++g)
+        cubes_.push_back(QuantLib::ext::make_shared<StridedNpvCube>(cube, g, nFilters));
+    cube_ = cubes_.front();
+    clearPnlStore();
+
+    DLOG("Historical P&L cubes generated");
+}
+
+void HistoricalPnlGenerator::useCube(Size i) {
+    QL_REQUIRE(i < cubes_.size(), "HistoricalPnlGenerator::useCube(): index " << i << " out of range, there are "
+                                                                              << cubes_.size() << " cubes");
+    if (cube_ != cubes_[i]) {
+        cube_ = cubes_[i];
+        clearPnlStore();
+    }
+}
+
+vector<Real> HistoricalPnlGenerator::pnl(const TimePeriod& period, const set<pair<string, Size>>& tradeIds) const {
+
+    const vector<Real>& allPnls = aggregatedPnl(tradeIds);
+    vector<bool> inPeriod = samplesInPeriod(period);
+
+    vector<Real> pnls;
+    pnls.reserve(allPnls.size());
+    for (Size s = 0; s < allPnls.size(); ++s) {
+        if (inPeriod[s])
+            pnls.push_back(allPnls[s]);
     }
 
     pnls.shrink_to_fit();
@@ -171,39 +237,20 @@ using TradePnlStore = HistoricalPnlGenerator::TradePnlStore;
 TradePnlStore HistoricalPnlGenerator::tradeLevelPnl(const TimePeriod& period,
                                                     const set<pair<string, Size>>& tradeIds) const {
 
+    populatePnlStore();
+    Size samples = cube_->samples();
+    vector<bool> inPeriod = samplesInPeriod(period);
+
     // Create result with enough space
     TradePnlStore pnls;
-    pnls.reserve(cube_->samples());
-
-    // Look up the date index once
-    Size dateIdx = indexAsof();
-
-    // Store t0 npvs on first pass
-    vector<Real> t0Npvs;
-    t0Npvs.reserve(tradeIds.size());
-
-    for (Size s = 0; s < cube_->samples(); ++s) {
+    pnls.reserve(samples);
 
-        // Start and end of period relating to current sample
-        Date start = hisScenGen_->startDates()[s];
-        Date end = hisScenGen_->endDates()[s];
-
-        if (period.contains(start) && period.contains(end)) {
-
-            // Store the t0 NPVs on first pass.
-            if (t0Npvs.empty()) {
-                for (const auto& p : tradeIds) {
-                    t0Npvs.push_back(cube_->getT0(p.second));
-                }
-            }
-
-            // Add vector to hold the trade level P&Ls
+    for (Size s = 0; s < samples; ++s) {
+        if (inPeriod[s]) {
+            // Add vector to hold the trade level P&Ls and populate it
             pnls.push_back(vector<Real>(tradeIds.size(), 0.0));
-
-            // Populate the trade level P&L vector
             for (const auto elem : tradeIds | boost::adaptors::indexed(0)) {
-                auto idx = elem.index();
-                pnls.back()[idx] = cube_->get(elem.value().second, dateIdx, s) - t0Npvs[idx];
+                pnls.back()[elem.index()] = tradePnls_[elem.value().second * samples + s];
             }
         }
     }
@@ -238,6 +285,65 @@ TimePeriod HistoricalPnlGenerator::timePeriod() const {
     return TimePeriod(dates);
 }
 
+void HistoricalPnlGenerator::populatePnlStore() const {
+
+    if (pnlStorePopulated_)
+        return;
+
+    Size samples = cube_->samples();
+    Size dateIdx = indexAsof();
+
+    DLOG("Populating trade level P&L store for " << cube_->numIds() << " trades and " << samples << " samples.");
+
+    tradePnls_.resize(cube_->numIds() * samples);
+    vector<Real> values;
+    for (Size i = 0; i < cube_->numIds(); ++i) {
+        Real t0 = cube_->getT0(i);
+        cube_->getSamples(values, i, dateIdx);
+        Real* row = &tradePnls_[i * samples];
+        for (Size s = 0; s < samples; ++s)
+            row[s] = values[s] - t0;
+    }
+
+    pnlStorePopulated_ = true;
+}
+
+void HistoricalPnlGenerator::clearPnlStore() {
+    pnlStorePopulated_ = false;
+    tradePnls_.clear();
+    tradePnls_.shrink_to_fit();
+    aggregatedPnls_.clear();
+}
+
+const vector<Real>& HistoricalPnlGenerator::aggregatedPnl(const set<pair<string, Size>>& tradeIds) const {
+
+    auto it = aggregatedPnls_.find(tradeIds);
+    if (it != aggregatedPnls_.end())
+        return it->second;
+
+    populatePnlStore();
+    Size samples = cube_->samples();
+
+    vector<Real> pnls(samples, 0.0);
+    for (const auto& tradeId : tradeIds) {
+        QL_REQUIRE(tradeId.second < cube_->numIds(), "HistoricalPnlGenerator: trade index "
+                                                         << tradeId.second << " for trade '" << tradeId.first
+                                                         << "' out of range, cube has " << cube_->numIds() << " ids");
+        const Real* row = &tradePnls_[tradeId.second * samples];
+        for (Size s = 0; s < samples; ++s)
+            pnls[s] += row[s];
+    }
+
+    return aggregatedPnls_.emplace(tradeIds, std::move(pnls)).first->second;
+}
+
+vector<bool> HistoricalPnlGenerator::samplesInPeriod(const TimePeriod& period) const {
+    vector<bool> result(cube_->samples());
+    for (Size s = 0; s < result.size(); ++s)
+        result[s] = period.contains(hisScenGen_->startDates()[s]) && period.contains(hisScenGen_->endDates()[s]);
+    return result;
+}
+
 Size HistoricalPnlGenerator::indexAsof() const {
     Date asof = useSingleThreadedEngine_ ? simMarket_->asofDate() : today_;
     const auto& dates = cube_->dates();
@@ -30,6 +30,9 @@
 #include <ored/utilities/timeperiod.hpp>
 #include <orea/scenario/historicalscenariogenerator.hpp>
 #include <ql/types.hpp>
+
+#include <map>
+#include <set>
 #include <vector>
 
 namespace ore {
@@ -86,6 +89,21 @@ public:
     */
     void generateCube(const QuantLib::ext::shared_ptr<ScenarioFilter>& filter);
 
+    /*! Generate one "cube" of P&L values per given scenario filter in a single run of the valuation engine. Each
+        historical scenario is generated once and applied with each of the \p filters in turn, the T0 valuation is
+        shared between the filters. After this call the cube for the first filter is used for the P&L calculations,
+        use useCube() to select another one. A null filter allows all risk factors.
+    */
+    void generateCubes(const std::vector<QuantLib::ext::shared_ptr<ScenarioFilter>>& filters);
+
+    //! Number of cubes generated by the last call to generateCube or generateCubes
+    QuantLib::Size numCubes() const { return cubes_.size(); }
+
+    /*! Use the cube for the filter with index \p i in the last call to generateCubes for the P&L calculations, the
+        cube generated by generateCube has index 0.
+    */
+    void useCube(QuantLib::Size i);
+
     /*! Return a vector of historical portfolio P&L values restricted to scenarios
         falling in \p period and restricted to the given \p tradeIds. The P&L values
         are calculated from the last cube generated by generateCube.
@@ -136,7 +154,7 @@ public:
     */
     TradePnlStore tradeLevelPnl() const;
 
-    /*! Return the last cube generated by generateCube.
+    /*! Return the last cube generated by generateCube or the cube selected by useCube.
      */
     const QuantLib::ext::shared_ptr<NPVCube>& cube() const;
 
@@ -153,6 +171,10 @@ private:
     QuantLib::ext::shared_ptr<ScenarioSimMarket> simMarket_;
     QuantLib::ext::shared_ptr<HistoricalScenarioGenerator> hisScenGen_;
     QuantLib::ext::shared_ptr<NPVCube> cube_;
+    // the cube given in the single-threaded ctor, populated by generateCube
+    QuantLib::ext::shared_ptr<NPVCube> valuationCube_;
+    // the cubes generated by the last call to generateCube or generateCubes
+    std::vector<QuantLib::ext::shared_ptr<NPVCube>> cubes_;
     QuantLib::ext::shared_ptr<ValuationEngine> valuationEngine_;
 
     // additional parameters needed for multi-threaded ctor
@@ -174,6 +196,23 @@ private:
 
     //! Get the index of the as of date in the cube.
     QuantLib::Size indexAsof() const;
+
+    //! Populate the trade level P&L store from the current cube, if not done yet
+    void populatePnlStore() const;
+    //! Clear the P&L store, to be called when the current cube changes
+    void clearPnlStore();
+    //! P&L over all samples of the current cube aggregated over the given trades
+    const std::vector<QuantLib::Real>&
+    aggregatedPnl(const std::set<std::pair<std::string, QuantLib::Size>>& tradeIds) const;
+    //! Flags the samples whose scenario start and end dates lie in the given period
+    std::vector<bool> samplesInPeriod(const ore::data::TimePeriod& period) const;
+
+    /* trade level P&Ls of the current cube, ids x samples with samples innermost, and the P&Ls aggregated over the
+       trade sets requested so far, so that repeated requests for overlapping trade groups and different periods do
+       not need to go through the cube again */
+    mutable bool pnlStorePopulated_ = false;
+    mutable std::vector<QuantLib::Real> tradePnls_;
+    mutable std::map<std::set<std::pair<std::string, QuantLib::Size>>, std::vector<QuantLib::Real>> aggregatedPnls_;
 };
 
 } // namespace analytics
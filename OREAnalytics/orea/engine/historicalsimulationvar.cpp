@@ -21,11 +21,10 @@
 #include <orea/cube/inmemorycube.hpp>
 #include <ored/utilities/to_string.hpp>
 
-#include <boost/accumulators/accumulators.hpp>
-#include <boost/accumulators/statistics.hpp>
-#include <boost/accumulators/statistics/tail_quantile.hpp>
+#include <algorithm>
+#include <functional>
+#include <limits>
 
-using namespace boost::accumulators;
 using namespace ore::data;
 using namespace QuantLib;
 
@@ -54,17 +53,17 @@ void HistoricalSimulationVarReport::handleFullRevalResults(const ext::shared_ptr
 Real HistoricalSimulationVarCalculator::var(Real confidence, const bool isCall, 
     const set<pair<string, Size>>& tradeIds) {
 
-    // Use boost to calculate the quantile based on confidence_
-    Size c = static_cast<Size>(std::floor(pnls_.size() * (1.0 - confidence) + 0.5)) + 2;
-    typedef accumulator_set<double, stats<boost::accumulators::tag::tail_quantile<boost::accumulators::right>>>
-        accumulator;
-    accumulator acc(boost::accumulators::tag::tail<boost::accumulators::right>::cache_size = c);
+    /* The quantile is the n-th largest of the (sign adjusted) P&Ls with n = ceil(#pnls * (1 - confidence)), i.e. the
+       same order statistic as the boost right tail_quantile. A partial sort is sufficient to find it. */
+    Size n = static_cast<Size>(std::ceil(pnls_.size() * (1.0 - confidence)));
+    if (n == 0 || n > pnls_.size())
+        return std::numeric_limits<Real>::quiet_NaN();
 
-    for (const auto& pnl : pnls_) {
-        acc(isCall ? pnl : -pnl);
-    }
+    std::vector<Real> pnls(pnls_.size());
+    std::transform(pnls_.begin(), pnls_.end(), pnls.begin(), [isCall](const Real pnl) { return isCall ? pnl : -pnl; });
+    std::nth_element(pnls.begin(), pnls.begin() + (n - 1), pnls.end(), std::greater<Real>());
 
-    return quantile(acc, quantile_probability = confidence);
+    return pnls[n - 1];
 }
 
 } // namespace analytics
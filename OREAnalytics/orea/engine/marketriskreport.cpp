@@ -264,6 +264,37 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
     bool runDetailTrd = runTradeDetail(reports);
     addPnlCalculators(reports);
 
+    // Set up the scenario filters for all risk groups, a null filter means that the risk group is skipped
+    vector<ext::shared_ptr<ScenarioFilter>> filters;
+    riskGroups_->reset();
+    while (ext::shared_ptr<MarketRiskGroupBase> riskGroup = riskGroups_->next()) {
+        ext::shared_ptr<ScenarioFilter> filter = createScenarioFilter(riskGroup);
+        // If this filter disables all risk factors, the risk group is skipped
+        if (disablesAll(filter)) {
+            filters.push_back(nullptr);
+            continue;
+        }
+        updateFilter(riskGroup, filter);
+        filters.push_back(filter);
+    }
+
+    // If doing a full revaluation backtest, generate the cubes for all risk groups in one run over the scenarios
+    map<Size, Size> cubeIndex;
+    if (fullReval_) {
+        vector<ext::shared_ptr<ScenarioFilter>> cubeFilters;
+        riskGroups_->reset();
+        for (Size i = 0; ext::shared_ptr<MarketRiskGroupBase> riskGroup = riskGroups_->next(); ++i) {
+            if (filters[i] && generateCube(riskGroup)) {
+                cubeIndex[i] = cubeFilters.size();
+                cubeFilters.push_back(filters[i]);
+            }
+        }
+        if (!cubeFilters.empty()) {
+            LOG("Generating historical P&L cubes for " << cubeFilters.size() << " risk groups");
+            histPnlGen_->generateCubes(cubeFilters);
+        }
+    }
+
     // Loop over all the risk groups
     riskGroups_->reset();
     Size currentRiskGroup = 0;
@@ -271,21 +302,20 @@ void MarketRiskReport::calculate(const ext::shared_ptr<MarketRiskReport::Reports
         LOG("[progress] Processing RiskGroup " << ++currentRiskGroup << " out of " << riskGroups_->size()
                                                   << ") = " << riskGroup);
 
-        ext::shared_ptr<ScenarioFilter> filter = createScenarioFilter(riskGroup);
+        ext::shared_ptr<ScenarioFilter> filter = filters[currentRiskGroup - 1];
 
         // If this filter disables all risk factors, move to next risk group
-        if (disablesAll(filter))
+        if (!filter)
             continue;
 
-        updateFilter(riskGroup, filter);
-
         if (sensiBased_)
             sensiAgg->aggregate(*sensiArgs_->sensitivityStream_, filter);
 
-        // If doing a full revaluation backtest, generate the cube under this filter
+        // If doing a full revaluation backtest, select the cube generated under this filter
         if (fullReval_) {
-            if (generateCube(riskGroup)) {
-                histPnlGen_->generateCube(filter);
+            auto c = cubeIndex.find(currentRiskGroup - 1);
+            if (c != cubeIndex.end()) {
+                histPnlGen_->useCube(c->second);
                 if (fullRevalArgs_->writeCube_) {
                     CubeWriter writer(cubeFilePath(riskGroup));
                     writer.write(histPnlGen_->cube(), {});
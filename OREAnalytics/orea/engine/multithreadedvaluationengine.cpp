@@ -23,14 +23,19 @@
 #include <orea/scenario/clonedscenariogenerator.hpp>
 
 #include <ored/marketdata/clonedloader.hpp>
+#include <ored/marketdata/curvecache.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 #include <ored/portfolio/enginefactory.hpp>
 #include <ored/portfolio/trade.hpp>
 #include <ored/utilities/dategrid.hpp>
+#include <ored/utilities/xmlutils.hpp>
 
 #include <boost/timer/timer.hpp>
 
+#include <atomic>
 #include <future>
+#include <mutex>
+#include <numeric>
 
 // #include <ctpl_stl.h>
 
@@ -39,6 +44,48 @@ namespace analytics {
 
 using QuantLib::Size;
 
+namespace {
+
+/* Consolidates the progress of the chunks processed by the worker threads. The totals of all chunks are known
+   upfront, so that the reported progress is monotonic although a worker thread processes several chunks. */
+class ChunkProgress {
+public:
+    ChunkProgress(const std::set<QuantLib::ext::shared_ptr<ore::data::ProgressIndicator>>& indicators,
+                  const std::vector<unsigned long>& totals)
+        : indicators_(indicators), progress_(totals.size(), 0), totals_(totals) {}
+    void update(const Size chunk, const unsigned long progress, const unsigned long total, const std::string& detail) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        progress_[chunk] = progress;
+        totals_[chunk] = total;
+        unsigned long p = std::accumulate(progress_.begin(), progress_.end(), 0UL);
+        unsigned long t = std::accumulate(totals_.begin(), totals_.end(), 0UL);
+        for (auto const& i : indicators_)
+            i->updateProgress(p, t, detail);
+    }
+
+private:
+    std::mutex mutex_;
+    std::set<QuantLib::ext::shared_ptr<ore::data::ProgressIndicator>> indicators_;
+    std::vector<unsigned long> progress_, totals_;
+};
+
+// progress indicator registered with the valuation engine processing a single chunk
+class ChunkProgressIndicator : public ore::data::ProgressIndicator {
+public:
+    ChunkProgressIndicator(const QuantLib::ext::shared_ptr<ChunkProgress>& progress, const Size chunk)
+        : progress_(progress), chunk_(chunk) {}
+    void updateProgress(const unsigned long progress, const unsigned long total, const std::string& detail) override {
+        progress_->update(chunk_, progress, total, detail);
+    }
+    void reset() override {}
+
+private:
+    QuantLib::ext::shared_ptr<ChunkProgress> progress_;
+    Size chunk_;
+};
+
+} // namespace
+
 MultiThreadedValuationEngine::MultiThreadedValuationEngine(
     const Size nThreads, const QuantLib::Date& today, const QuantLib::ext::shared_ptr<ore::data::DateGrid>& dateGrid,
     const Size nSamples, const QuantLib::ext::shared_ptr<ore::data::Loader>& loader,
@@ -60,7 +107,8 @@ MultiThreadedValuationEngine::MultiThreadedValuationEngine(
     const std::function<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>(const QuantLib::Date&, const std::set<std::string>&,
                                                                    const std::vector<QuantLib::Date>&,
                                                                    const QuantLib::Size)>& cptyCubeFactory,
-    const std::string& context, const QuantLib::ext::shared_ptr<ore::analytics::Scenario>& offSetScenario)
+    const std::string& context, const QuantLib::ext::shared_ptr<ore::analytics::Scenario>& offSetScenario,
+    const Size chunksPerThread)
     : nThreads_(nThreads), today_(today), dateGrid_(dateGrid), nSamples_(nSamples), loader_(loader),
       scenarioGenerator_(scenarioGenerator), engineData_(engineData), curveConfigs_(curveConfigs),
       todaysMarketParams_(todaysMarketParams), configuration_(configuration), simMarketData_(simMarketData),
@@ -69,9 +117,10 @@ MultiThreadedValuationEngine::MultiThreadedValuationEngine(
       handlePseudoCurrenciesTodaysMarket_(handlePseudoCurrenciesTodaysMarket),
       handlePseudoCurrenciesSimMarket_(handlePseudoCurrenciesSimMarket), recalibrateModels_(recalibrateModels),
       cubeFactory_(cubeFactory), nettingSetCubeFactory_(nettingSetCubeFactory), cptyCubeFactory_(cptyCubeFactory),
-      context_(context), offsetScenario_(offSetScenario){
+      context_(context), offsetScenario_(offSetScenario), chunksPerThread_(chunksPerThread) {
 
     QL_REQUIRE(nThreads_ != 0, "MultiThreadedValuationEngine: nThreads must be > 0");
+    QL_REQUIRE(chunksPerThread_ != 0, "MultiThreadedValuationEngine: chunksPerThread must be > 0");
 
     // check whether sessions are enabled, if not exit with an error
 
@@ -101,6 +150,18 @@ void MultiThreadedValuationEngine::setAggregationScenarioData(
     aggregationScenarioData_ = aggregationScenarioData;
 }
 
+void MultiThreadedValuationEngine::setScenarioGeneratorWrapper(
+    const std::function<QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>(
+        const QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>&)>& wrapper,
+    const Size samplesPerScenario) {
+    QL_REQUIRE(samplesPerScenario > 0 && nSamples_ % samplesPerScenario == 0,
+               "MultiThreadedValuationEngine::setScenarioGeneratorWrapper(): samplesPerScenario ("
+                   << samplesPerScenario << ") must be positive and divide the number of samples (" << nSamples_
+                   << ")");
+    scenarioGeneratorWrapper_ = wrapper;
+    samplesPerScenario_ = samplesPerScenario;
+}
+
 void MultiThreadedValuationEngine::buildCube(
     const QuantLib::ext::shared_ptr<ore::data::Portfolio>& portfolio,
     const std::function<std::vector<QuantLib::ext::shared_ptr<ore::analytics::ValuationCalculator>>()>& calculators,
@@ -125,9 +186,14 @@ void MultiThreadedValuationEngine::buildCube(
         "configuration '"
         << configuration_ << "'.");
 
+    // the curves bootstrapped for the init market are stored in memory, the worker threads rebuild their todays
+    // market curves from there
+
+    auto curveCache = QuantLib::ext::make_shared<ore::data::CurveCache>();
+
     QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
         today_, todaysMarketParams_, loader_, curveConfigs_, true, true, true, referenceData_, false,
-        iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
+        iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_, 1, curveCache);
 
     auto engineFactory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
         engineData_, initMarket,
@@ -141,20 +207,35 @@ void MultiThreadedValuationEngine::buildCube(
                             << t->npvCurrency());
     }
 
-    // split portfolio into nThreads parts such that each part has an approximately similar total avg pricing time
+    // the init market is built lazily, build a sim market on top of it to bootstrap the remaining curves required by
+    // the sim markets of the worker threads
+
+    LOG("Bootstrap the curves required by the sim market on the main thread.");
+    {
+        ore::analytics::ScenarioSimMarket simMarket(initMarket, simMarketData_, configuration_, *curveConfigs_,
+                                                    *todaysMarketParams_, true, useSpreadedTermStructures_, false,
+                                                    false, iborFallbackConfig_, handlePseudoCurrenciesSimMarket_,
+                                                    offsetScenario_);
+    }
+    LOG("Curve cache misses: " << curveCache->misses() << ", hits: " << curveCache->hits());
+
+    // split portfolio into nChunks parts such that each part has an approximately similar total avg pricing time
 
     Size eff_nThreads = std::min(portfolio->size(), nThreads_);
+    Size nChunks = std::min(portfolio->size(), eff_nThreads * chunksPerThread_);
 
     LOG("Splitting portfolio.");
 
-    LOG("portfolio size = " << portfolio->size());
-    LOG("nThreads       = " << nThreads_);
-    LOG("eff nThreads   = " << eff_nThreads);
+    LOG("portfolio size    = " << portfolio->size());
+    LOG("nThreads          = " << nThreads_);
+    LOG("eff nThreads      = " << eff_nThreads);
+    LOG("chunks per thread = " << chunksPerThread_);
+    LOG("number of chunks  = " << nChunks);
 
     QL_REQUIRE(eff_nThreads > 0, "effective threads are zero, this is not allowed.");
 
     std::vector<QuantLib::ext::shared_ptr<ore::data::Portfolio>> portfolios;
-    for (Size i = 0; i < eff_nThreads; ++i)
+    for (Size i = 0; i < nChunks; ++i)
         portfolios.push_back(QuantLib::ext::make_shared<ore::data::Portfolio>());
 
     double totalAvgPricingTime = 0.0;
@@ -178,42 +259,55 @@ void MultiThreadedValuationEngine::buildCube(
                       return p1.second > p2.second;
               });
 
+    // assign the trades in descending order of their avg pricing time to the chunk with the smallest total avg pricing
+    // time so far, on ties to the chunk with the fewest trades, so that trades without timings are spread evenly, too
+
     std::vector<double> portfolioTotalAvgPricingTime(portfolios.size());
-    Size portfolioIndex = 0;
     for (auto const& t : timings) {
+        Size portfolioIndex = 0;
+        for (Size i = 1; i < nChunks; ++i) {
+            if (portfolioTotalAvgPricingTime[i] < portfolioTotalAvgPricingTime[portfolioIndex] ||
+                (portfolioTotalAvgPricingTime[i] == portfolioTotalAvgPricingTime[portfolioIndex] &&
+                 portfolios[i]->size() < portfolios[portfolioIndex]->size()))
+                portfolioIndex = i;
+        }
         portfolios[portfolioIndex]->add(portfolio->get(t.first));
         portfolioTotalAvgPricingTime[portfolioIndex] += t.second;
-        if (++portfolioIndex >= eff_nThreads)
-            portfolioIndex = 0;
     }
 
-    // output the portfolios into strings so that the worker threads can load them from there
+    // the chunks are processed in the order of descending total avg pricing time, the cheap chunks at the end of the
+    // queue fill the gaps when the actual pricing times deviate from the estimates
 
-    std::vector<std::string> portfoliosAsString;
-    for (auto const& p : portfolios) {
-        portfoliosAsString.emplace_back(p->toXMLString());
-    }
+    std::vector<Size> chunkOrder(nChunks);
+    std::iota(chunkOrder.begin(), chunkOrder.end(), 0);
+    std::stable_sort(chunkOrder.begin(), chunkOrder.end(), [&portfolioTotalAvgPricingTime](const Size i, const Size j) {
+        return portfolioTotalAvgPricingTime[i] > portfolioTotalAvgPricingTime[j];
+    });
 
     // log info on the portfolio split
 
     LOG("Total avg pricing time     : " << totalAvgPricingTime / 1E6 << " ms");
-    for (Size i = 0; i < eff_nThreads; ++i) {
-        LOG("Portfolio #" << i << " number of trades       : " << portfolios[i]->size());
-        LOG("Portfolio #" << i << " total avg pricing time : " << portfolioTotalAvgPricingTime[i] / 1E6 << " ms");
+    for (Size i = 0; i < nChunks; ++i) {
+        DLOG("Portfolio #" << i << " number of trades       : " << portfolios[i]->size());
+        DLOG("Portfolio #" << i << " total avg pricing time : " << portfolioTotalAvgPricingTime[i] / 1E6 << " ms");
     }
 
     // build scenario generators for each thread as clones of the original one
 
     LOG("Cloning scenario generators for " << eff_nThreads << " threads...");
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>> scenarioGenerators;
-    auto tmp =
-        QuantLib::ext::make_shared<ore::analytics::ClonedScenarioGenerator>(scenarioGenerator_, dateGrid_->dates(), nSamples_);
+    auto tmp = QuantLib::ext::make_shared<ore::analytics::ClonedScenarioGenerator>(
+        scenarioGenerator_, dateGrid_->dates(), nSamples_ / samplesPerScenario_);
     scenarioGenerators.push_back(tmp);
     DLOG("generator for thread 1 cloned.");
     for (Size i = 1; i < eff_nThreads; ++i) {
         scenarioGenerators.push_back(QuantLib::ext::make_shared<ore::analytics::ClonedScenarioGenerator>(*tmp));
         DLOG("generator for thread " << (i + 1) << " cloned.");
     }
+    if (scenarioGeneratorWrapper_) {
+        for (auto& g : scenarioGenerators)
+            g = scenarioGeneratorWrapper_(g);
+    }
 
     // build loaders for each thread as clones of the original one
 
@@ -222,13 +316,13 @@ void MultiThreadedValuationEngine::buildCube(
     for (Size i = 0; i < eff_nThreads; ++i)
         loaders.push_back(QuantLib::ext::make_shared<ore::data::ClonedLoader>(today_, loader_));
 
-    // build nThreads mini-cubes to which each thread writes its results
+    // build nChunks mini-cubes to which the threads write the results of the chunks
 
-    LOG("Build " << eff_nThreads << " mini result cubes...");
+    LOG("Build " << nChunks << " mini result cubes...");
     miniCubes_.clear();
     miniNettingSetCubes_.clear();
     miniCptyCubes_.clear();
-    for (Size i = 0; i < eff_nThreads; ++i) {
+    for (Size i = 0; i < nChunks; ++i) {
         miniCubes_.push_back(cubeFactory_(today_, portfolios[i]->ids(), dateGrid_->valuationDates(), nSamples_));
         miniNettingSetCubes_.push_back(nettingSetCubeFactory_(today_, dateGrid_->valuationDates(), nSamples_));
         miniCptyCubes_.push_back(
@@ -237,8 +331,14 @@ void MultiThreadedValuationEngine::buildCube(
 
     // build progress indicator consolidating the results from the threads
 
-    auto progressIndicator =
-        QuantLib::ext::make_shared<ore::analytics::MultiThreadedProgressIndicator>(this->progressIndicators());
+    std::vector<unsigned long> progressTotals;
+    for (auto const& p : portfolios)
+        progressTotals.push_back(static_cast<unsigned long>(nSamples_ * p->size()));
+    auto progress = QuantLib::ext::make_shared<ChunkProgress>(this->progressIndicators(), progressTotals);
+
+    // the queue of chunks, the workers pull the next chunk from here when they are done with their current one
+
+    std::atomic<Size> nextChunk(0);
 
     // create the thread pool with eff_nThreads and queue size = eff_nThreads as well
 
@@ -261,8 +361,9 @@ void MultiThreadedValuationEngine::buildCube(
 
     for (Size i = 0; i < eff_nThreads; ++i) {
 
-        auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfoliosAsString,
-                    &scenarioGenerators, &loaders, &workerPricingStats, &progressIndicator](int id) -> resultType {
+        auto job = [this, obsMode, dryRun, &calculators, &cptyCalculators, mporStickyDate, &portfolios,
+                    &chunkOrder, &nextChunk, &scenarioGenerators, &loaders, &curveCache, &workerPricingStats,
+                    &progress](int id) -> resultType {
             // set thread local singletons
 
             QuantLib::Settings::instance().evaluationDate() = today_;
@@ -274,24 +375,23 @@ void MultiThreadedValuationEngine::buildCube(
 
             try {
 
-                // build todays market using cloned market data
-
-                QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<ore::data::TodaysMarket>(
-                    today_, todaysMarketParams_, loaders[id], curveConfigs_, true, true, true, referenceData_, false,
-                    iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_);
-
-                // build sim market
-
-                QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket> simMarket =
-                    QuantLib::ext::make_shared<ore::analytics::ScenarioSimMarket>(
+                // build todays market using cloned market data and the sim market on top of it, the yield and
+                // default curves bootstrapped on the main thread are rebuilt from the curve cache, the todays market
+                // and the cloned market data are released once the sim market is built, the sim market only keeps
+                // the parts of the todays market it links to
+
+                QuantLib::ext::shared_ptr<ore::analytics::ScenarioSimMarket> simMarket;
+                {
+                    QuantLib::ext::shared_ptr<ore::data::Market> initMarket =
+                        QuantLib::ext::make_shared<ore::data::TodaysMarket>(
+                            today_, todaysMarketParams_, loaders[id], curveConfigs_, true, true, true, referenceData_,
+                            false, iborFallbackConfig_, false, handlePseudoCurrenciesTodaysMarket_, 1, curveCache);
+                    loaders[id].reset();
+                    simMarket = QuantLib::ext::make_shared<ore::analytics::ScenarioSimMarket>(
                         initMarket, simMarketData_, configuration_, *curveConfigs_, *todaysMarketParams_, true,
                         useSpreadedTermStructures_, cacheSimData_, false, iborFallbackConfig_,
                         handlePseudoCurrenciesSimMarket_, offsetScenario_);
-
-                // set aggregation scenario data, but only in one of the sim markets, that's sufficient to populate it
-
-                if (id == 0 && aggregationScenarioData_ != nullptr)
-                    simMarket->aggregationScenarioData() = aggregationScenarioData_;
+                }
 
                 // link scenario generator to sim market
 
@@ -302,37 +402,63 @@ void MultiThreadedValuationEngine::buildCube(
                 if (scenarioFilter_)
                     simMarket->filter() = scenarioFilter_;
 
-                // build portfolio against sim market
+                // process chunks until the queue is exhausted
+
+                for (Size n = nextChunk++; n < chunkOrder.size(); n = nextChunk++) {
 
-                auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
-                portfolio->fromXMLString(portfoliosAsString[id]);
-                auto engineFactory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
-                    engineData_, simMarket, std::map<ore::data::MarketContext, string>(), referenceData_,
-                    iborFallbackConfig_);
+                    Size chunk = chunkOrder[n];
+                    DLOG("Thread " << id << " processes chunk " << chunk << " (" << n + 1 << " of "
+                                   << chunkOrder.size() << ")");
 
-                portfolio->build(engineFactory, context_, true);
+                    // the valuation engine resets the sim market after each run, but not the scenario generator
 
-                // build valuation engine
+                    scenarioGenerators[id]->reset();
 
-                auto valEngine = QuantLib::ext::make_shared<ore::analytics::ValuationEngine>(
-                    today_, dateGrid_, simMarket,
-                    recalibrateModels_ ? engineFactory->modelBuilders()
-                                       : std::set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>());
-                valEngine->registerProgressIndicator(progressIndicator);
+                    // set aggregation scenario data for the first chunk only, that's sufficient to populate it
 
-                // build mini-cube
+                    simMarket->aggregationScenarioData() = n == 0 ? aggregationScenarioData_ : nullptr;
 
-                valEngine->buildCube(portfolio, miniCubes_[id], calculators(), mporStickyDate, miniNettingSetCubes_[id],
-                                     miniCptyCubes_[id],
-                                     cptyCalculators ? cptyCalculators()
-                                                     : std::vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>>(),
-                                     dryRun);
+                    // deep copy the trades of the chunk via their in-memory xml representation, no string
+                    // serialisation and parsing is involved, and build the copies against the sim market
 
-                // set pricing stats for val engine run
+                    auto portfolio = QuantLib::ext::make_shared<ore::data::Portfolio>();
+                    {
+                        ore::data::XMLDocument doc;
+                        portfolio->fromXML(portfolios[chunk]->toXML(doc));
+                    }
+                    auto engineFactory = QuantLib::ext::make_shared<ore::data::EngineFactory>(
+                        engineData_, simMarket, std::map<ore::data::MarketContext, string>(), referenceData_,
+                        iborFallbackConfig_);
 
-                for (auto const& [tid, t] : portfolio->trades())
-                    workerPricingStats[id][tid] =
-                        std::make_pair(t->getNumberOfPricings(), t->getCumulativePricingTime());
+                    portfolio->build(engineFactory, context_, true);
+
+                    // build valuation engine
+
+                    auto valEngine = QuantLib::ext::make_shared<ore::analytics::ValuationEngine>(
+                        today_, dateGrid_, simMarket,
+                        recalibrateModels_
+                            ? engineFactory->modelBuilders()
+                            : std::set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>(),
+                        skipUnaffectedTrades_);
+                    valEngine->registerProgressIndicator(QuantLib::ext::make_shared<ChunkProgressIndicator>(progress, chunk));
+
+                    // build mini-cube
+
+                    valEngine->buildCube(portfolio, miniCubes_[chunk], calculators(), mporStickyDate,
+                                         miniNettingSetCubes_[chunk], miniCptyCubes_[chunk],
+                                         cptyCalculators
+                                             ? cptyCalculators()
+                                             : std::vector<QuantLib::ext::shared_ptr<CounterpartyCalculator>>(),
+                                         dryRun);
+
+                    // set pricing stats for val engine run
+
+                    for (auto const& [tid, t] : portfolio->trades())
+                        workerPricingStats[id][tid] =
+                            std::make_pair(t->getNumberOfPricings(), t->getCumulativePricingTime());
+                }
+
+                simMarket->aggregationScenarioData() = nullptr;
 
                 // return code 0 = ok
 
@@ -346,6 +472,10 @@ void MultiThreadedValuationEngine::buildCube(
 
                 ore::analytics::StructuredAnalyticsErrorMessage("Multithreaded Valuation Engine", "", e.what()).log();
                 rc = 1;
+
+                // drain the queue, the other threads do not need to process the remaining chunks
+
+                nextChunk = chunkOrder.size();
             }
 
             // exit
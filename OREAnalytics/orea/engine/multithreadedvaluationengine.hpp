@@ -34,6 +34,19 @@
 namespace ore {
 namespace analytics {
 
+/*! The portfolio is split into chunks of trades with approximately equal total T0 pricing time, there are
+    chunksPerThread chunks per thread. The chunks are processed in the order of descending estimated pricing time
+    by nThreads workers, each worker builds its market once and then pulls the next unprocessed chunk from a shared
+    queue when it is done with its current one. This balances the load dynamically when the pricing times under the
+    simulated scenarios diverge from the T0 estimate. The default chunksPerThread = 1 gives a static split with one
+    chunk per thread. Each additional chunk resets the sim market of the worker and replays all scenarios, so finer
+    chunks only pay off if the pricing times are very unevenly distributed.
+
+    The trades of a chunk are deep copied from their in-memory xml representation by the worker processing the
+    chunk. Each worker builds its own todays market and sim market, since the QuantLib term structures are bound
+    to the session (evaluation date, observers) they are built in, but releases the todays market and its cloned
+    market data as soon as the sim market is built. The yield and default curves are bootstrapped once on the main
+    thread, the workers rebuild them from the pillars kept in an in memory CurveCache. */
 class MultiThreadedValuationEngine : public ore::data::ProgressReporter {
 public:
     /* if no cube factories are given, we create default ones as follows
@@ -67,11 +80,24 @@ public:
             const QuantLib::Date&, const std::set<std::string>&, const std::vector<QuantLib::Date>&,
             const QuantLib::Size)>& cptyCubeFactory = {},
         const std::string& context = "unspecified",
-        const QuantLib::ext::shared_ptr<ore::analytics::Scenario>& offSetScenario = nullptr);
+        const QuantLib::ext::shared_ptr<ore::analytics::Scenario>& offSetScenario = nullptr,
+        const QuantLib::Size chunksPerThread = 1);
 
     // can be optionally called to set the agg scen data (which is done in the ssm for single-threaded runs)
     void setAggregationScenarioData(const QuantLib::ext::shared_ptr<AggregationScenarioData>& aggregationScenarioData);
 
+    // can be optionally called to skip the valuation of trades not affected by a scenario, see ValuationEngine
+    void setSkipUnaffectedTrades(const bool skipUnaffectedTrades) { skipUnaffectedTrades_ = skipUnaffectedTrades; }
+
+    /* can be optionally called to wrap the scenario generator of each thread, e.g. to apply several filters to each
+       scenario on the fly. The generators passed to the wrapper are clones of the original scenario generator holding
+       nSamples / samplesPerScenario scenarios, the wrapped generators must produce samplesPerScenario samples per
+       scenario. The wrapper is called in the main thread before the worker threads are started. */
+    void setScenarioGeneratorWrapper(
+        const std::function<QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>(
+            const QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>&)>& wrapper,
+        const QuantLib::Size samplesPerScenario);
+
     /* analoguous to buildCube() in the single-threaded engine, results are retrieved using below constructors
        if no cptyCalculators is given a function returning an empty vector of calculators will be returned */
     void
@@ -81,7 +107,7 @@ public:
                   cptyCalculators = {},
               bool mporStickyDate = true, bool dryRun = false);
 
-    // result output cubes (mini-cubes, one per thread)
+    // result output cubes (mini-cubes, one per chunk)
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> outputCubes() const { return miniCubes_; }
 
     // result netting cubes (might be null, if nettingSetCubeFactory is returning null)
@@ -123,8 +149,14 @@ private:
         cptyCubeFactory_;
     std::string context_;
     QuantLib::ext::shared_ptr<ore::analytics::Scenario> offsetScenario_;
+    QuantLib::Size chunksPerThread_;
     QuantLib::ext::shared_ptr<AggregationScenarioData>
             aggregationScenarioData_;
+    std::function<QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>(
+        const QuantLib::ext::shared_ptr<ore::analytics::ScenarioGenerator>&)>
+        scenarioGeneratorWrapper_;
+    QuantLib::Size samplesPerScenario_ = 1;
+    bool skipUnaffectedTrades_ = false;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniCubes_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniNettingSetCubes_;
     std::vector<QuantLib::ext::shared_ptr<ore::analytics::NPVCube>> miniCptyCubes_;
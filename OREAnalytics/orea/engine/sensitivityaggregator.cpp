@@ -21,6 +21,9 @@
 #include <ored/utilities/log.hpp>
 #include <ql/errors.hpp>
 
+#include <iterator>
+#include <vector>
+
 using ore::analytics::ScenarioFilter;
 using std::function;
 using std::map;
@@ -53,24 +56,65 @@ void SensitivityAggregator::aggregate(SensitivityStream& ss, const QuantLib::ext
     // Ensure at start of stream
     ss.reset();
 
-    // Loop over stream's records
-    while (SensitivityRecord sr = ss.next()) {
-        // Skip this record if the risk factor is not in the filter
-        if (!sr.isCrossGamma() && !filter->allow(sr.key_1))
-            continue;
-        if (sr.isCrossGamma() && (!filter->allow(sr.key_1) || !filter->allow(sr.key_2)))
-            continue;
-
-        // "Blank out" trade ID before adding
-        string tradeId = sr.tradeId;
-        sr.tradeId = "";
-
-        // Update aggRecords_ for each category
-        for (const auto& kv : categories_) {
-            // Check if the sensitivity record's trade ID is in the category
-            if (kv.second(tradeId)) {
-                DLOG("Updating aggregated sensitivities for category " << kv.first << " with record: " << sr);
-                add(sr, aggRecords_[kv.first]);
+    // The stream is read in batches. The filter is evaluated once per risk factor and the categories once per trade
+    // id of the stream's dictionary, and the aggregated record is looked up once per category and risk factor pair.
+
+    std::vector<std::pair<const function<bool(string)>*, set<SensitivityRecord>*>> categories;
+    for (const auto& kv : categories_)
+        categories.push_back(std::make_pair(&kv.second, &aggRecords_[kv.first]));
+
+    std::vector<map<std::pair<Size, Size>, set<SensitivityRecord>::iterator>> aggregated(categories.size());
+    std::vector<char> allowed; // 0 = not yet determined, 1 = not allowed, 2 = allowed
+    std::vector<std::vector<Size>> tradeCategories;
+    std::vector<char> tradeCategoriesDetermined;
+
+    SensitivityBatch batch;
+    while (ss.nextBatch(batch)) {
+        const auto& dict = *batch.dictionary;
+        allowed.resize(dict.numberOfFactors(), 0);
+        tradeCategories.resize(dict.numberOfTradeIds());
+        tradeCategoriesDetermined.resize(dict.numberOfTradeIds(), 0);
+
+        auto isAllowed = [&allowed, &dict, &filter](Size f) {
+            if (allowed[f] == 0)
+                allowed[f] = filter->allow(dict.factor(f).key) ? 2 : 1;
+            return allowed[f] == 2;
+        };
+
+        for (Size i = 0; i < batch.size(); ++i) {
+            // Skip this record if the risk factor is not in the filter
+            if (!isAllowed(batch.factor1[i]) || (batch.isCrossGamma(i) && !isAllowed(batch.factor2[i])))
+                continue;
+
+            Size t = batch.trade[i];
+            if (!tradeCategoriesDetermined[t]) {
+                for (Size c = 0; c < categories.size(); ++c) {
+                    // Check if the sensitivity record's trade ID is in the category
+                    if ((*categories[c].first)(dict.tradeId(t)))
+                        tradeCategories[t].push_back(c);
+                }
+                tradeCategoriesDetermined[t] = 1;
+            }
+
+            // Update aggRecords_ for each category
+            for (auto c : tradeCategories[t]) {
+                DLOG("Updating aggregated sensitivities for category " << std::next(categories_.begin(), c)->first
+                                                                       << " with record: " << batch.record(i));
+                auto factors = std::make_pair(batch.factor1[i], batch.factor2[i]);
+                auto a = aggregated[c].find(factors);
+                if (a == aggregated[c].end()) {
+                    // "Blank out" trade ID before adding
+                    SensitivityRecord sr = batch.record(i);
+                    sr.tradeId = "";
+                    auto p = categories[c].second->insert(sr);
+                    a = aggregated[c].emplace(factors, p.first).first;
+                    if (p.second)
+                        continue;
+                }
+                // If the record is already in the set, update it
+                a->second->baseNpv += batch.baseNpv[i];
+                a->second->delta += batch.delta[i];
+                a->second->gamma += batch.gamma[i];
             }
         }
     }
@@ -128,17 +172,6 @@ void SensitivityAggregator::init() {
     }
 }
 
-void SensitivityAggregator::add(SensitivityRecord& sr, set<SensitivityRecord>& records) {
-    // Try to insert sr. This will only pass if sr is not there already.
-    auto p = records.insert(sr);
-    if (!p.second) {
-        // If sr is already in the set, update it.
-        p.first->baseNpv += sr.baseNpv;
-        p.first->delta += sr.delta;
-        p.first->gamma += sr.gamma;
-    }
-}
-
 bool SensitivityAggregator::inCategory(const string& tradeId, const string& category) const {
     QL_REQUIRE(setCategories_.count(category), "The category " << category << " is not valid");
     auto tradeIds = setCategories_.at(category);
@@ -88,8 +88,6 @@ private:
 
     //! Initialise the container of aggregated records
     void init();
-    //! Add a sensitivity record to the set of aggregated \p records
-    void add(SensitivityRecord& sr, std::set<SensitivityRecord>& records);
     //! Determine if the \p tradeId is in the given \p category
     bool inCategory(const std::string& tradeId, const std::string& category) const;
 };
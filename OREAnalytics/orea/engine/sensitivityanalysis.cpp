@@ -188,7 +188,7 @@ void SensitivityAnalysis::generateSensitivities() {
                 modelBuilders_ = factory->modelBuilders();
             else
                 modelBuilders_.clear();
-            ValuationEngine engine(asof_, dg, simMarket_, modelBuilders_);
+            ValuationEngine engine(asof_, dg, simMarket_, modelBuilders_, skipUnaffectedTrades_);
             for (auto const& i : this->progressIndicators())
                 engine.registerProgressIndicator(i);
             engine.buildCube(pf, cube, calculators, true, nullptr, nullptr, {}, dryRun_);
@@ -245,6 +245,7 @@ void SensitivityAnalysis::generateSensitivities() {
                     return QuantLib::ext::make_shared<ore::analytics::DoublePrecisionSensiCube>(ids, asof, samples);
                 },
                 {}, {}, context_);
+            engine.setSkipUnaffectedTrades(skipUnaffectedTrades_);
             for (auto const& i : this->progressIndicators())
                 engine.registerProgressIndicator(i);
 
@@ -117,6 +117,9 @@ public:
     //! override shift tenors with sim market tenors
     void overrideTenors(const bool b) { overrideTenors_ = b; }
 
+    //! skip the valuation of trades not affected by a scenario, see ValuationEngine
+    void skipUnaffectedTrades(const bool b) { skipUnaffectedTrades_ = b; }
+
     //! the portfolio of trades
     QuantLib::ext::shared_ptr<Portfolio> portfolio() const { return portfolio_; }
 
@@ -144,6 +147,7 @@ private:
     //! Optional todays market parameters. Used in building the scenario sim market.
     QuantLib::ext::shared_ptr<ore::data::TodaysMarketParameters> todaysMarketParams_;
     bool overrideTenors_;
+    bool skipUnaffectedTrades_ = false;
 
     // if true, convert sensis to base currency using the original (non-shifted) FX rate
     bool nonShiftedBaseCurrencyConversion_;
@@ -0,0 +1,123 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/engine/sensitivitybatch.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
+
+namespace ore {
+namespace analytics {
+
+using QuantLib::Null;
+using QuantLib::Real;
+using QuantLib::Size;
+
+Size SensitivityDictionary::addTradeId(const std::string& tradeId) {
+    auto [it, inserted] = tradeIdIndex_.emplace(tradeId, tradeIds_.size());
+    if (inserted)
+        tradeIds_.push_back(tradeId);
+    return it->second;
+}
+
+Size SensitivityDictionary::addFactor(const RiskFactorKey& key, const std::string& desc, Real shift) {
+    auto& candidates = factorIndex_[key];
+    for (auto i : candidates) {
+        if (factors_[i].desc == desc && QuantLib::close_enough(factors_[i].shift, shift))
+            return i;
+    }
+    candidates.push_back(factors_.size());
+    factors_.push_back(Factor{key, desc, shift});
+    return factors_.size() - 1;
+}
+
+Size SensitivityDictionary::addCurrency(const std::string& currency) {
+    auto [it, inserted] = currencyIndex_.emplace(currency, currencies_.size());
+    if (inserted)
+        currencies_.push_back(currency);
+    return it->second;
+}
+
+void SensitivityBatch::clear() {
+    trade.clear();
+    isPar.clear();
+    factor1.clear();
+    factor2.clear();
+    currency.clear();
+    baseNpv.clear();
+    delta.clear();
+    gamma.clear();
+}
+
+void SensitivityBatch::add(Size trade, bool isPar, Size factor1, Size factor2, Size currency, Real baseNpv,
+                           Real delta, Real gamma) {
+    this->trade.push_back(trade);
+    this->isPar.push_back(isPar);
+    this->factor1.push_back(factor1);
+    this->factor2.push_back(factor2);
+    this->currency.push_back(currency);
+    this->baseNpv.push_back(baseNpv);
+    this->delta.push_back(delta);
+    this->gamma.push_back(gamma);
+}
+
+void SensitivityBatch::add(const SensitivityRecord& sr) {
+    QL_REQUIRE(dictionary, "SensitivityBatch::add(): no dictionary set");
+    add(dictionary->addTradeId(sr.tradeId), sr.isPar, dictionary->addFactor(sr.key_1, sr.desc_1, sr.shift_1),
+        sr.isCrossGamma() ? dictionary->addFactor(sr.key_2, sr.desc_2, sr.shift_2) : Null<Size>(),
+        dictionary->addCurrency(sr.currency), sr.baseNpv, sr.delta, sr.gamma);
+}
+
+void SensitivityBatch::append(const SensitivityBatch& batch, Size from, Size to) {
+    QL_REQUIRE(dictionary == batch.dictionary, "SensitivityBatch::append(): batches refer to different dictionaries");
+    QL_REQUIRE(from <= to && to <= batch.size(),
+               "SensitivityBatch::append(): invalid range [" << from << "," << to << ") for batch size "
+                                                             << batch.size());
+    trade.insert(trade.end(), batch.trade.begin() + from, batch.trade.begin() + to);
+    isPar.insert(isPar.end(), batch.isPar.begin() + from, batch.isPar.begin() + to);
+    factor1.insert(factor1.end(), batch.factor1.begin() + from, batch.factor1.begin() + to);
+    factor2.insert(factor2.end(), batch.factor2.begin() + from, batch.factor2.begin() + to);
+    currency.insert(currency.end(), batch.currency.begin() + from, batch.currency.begin() + to);
+    baseNpv.insert(baseNpv.end(), batch.baseNpv.begin() + from, batch.baseNpv.begin() + to);
+    delta.insert(delta.end(), batch.delta.begin() + from, batch.delta.begin() + to);
+    gamma.insert(gamma.end(), batch.gamma.begin() + from, batch.gamma.begin() + to);
+}
+
+SensitivityRecord SensitivityBatch::record(Size i) const {
+    SensitivityRecord sr;
+    sr.tradeId = dictionary->tradeId(trade[i]);
+    sr.isPar = isPar[i];
+    const auto& f1 = dictionary->factor(factor1[i]);
+    sr.key_1 = f1.key;
+    sr.desc_1 = f1.desc;
+    sr.shift_1 = f1.shift;
+    if (isCrossGamma(i)) {
+        const auto& f2 = dictionary->factor(factor2[i]);
+        sr.key_2 = f2.key;
+        sr.desc_2 = f2.desc;
+        sr.shift_2 = f2.shift;
+    }
+    sr.currency = dictionary->currency(currency[i]);
+    sr.baseNpv = baseNpv[i];
+    sr.delta = delta[i];
+    sr.gamma = gamma[i];
+    return sr;
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,112 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/engine/sensitivitybatch.hpp
+    \brief Columnar representation of a batch of sensitivity records
+*/
+
+#pragma once
+
+#include <orea/engine/sensitivityrecord.hpp>
+
+#include <ql/shared_ptr.hpp>
+#include <ql/utilities/null.hpp>
+
+#include <boost/functional/hash.hpp>
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ore {
+namespace analytics {
+
+//! Dictionary of the trade ids, risk factors and currencies referenced by the entries of a SensitivityBatch
+/*! Each distinct value is stored once and identified by its index in order of insertion. The dictionary only grows,
+    i.e. an index remains valid for the lifetime of the dictionary, while references to its values are invalidated
+    by subsequent additions.
+*/
+class SensitivityDictionary {
+public:
+    //! A risk factor key with its description and shift size as in the SensitivityRecord
+    struct Factor {
+        RiskFactorKey key;
+        std::string desc;
+        QuantLib::Real shift;
+    };
+
+    //! Returns the index of the given value, adding it if not yet present
+    QuantLib::Size addTradeId(const std::string& tradeId);
+    QuantLib::Size addFactor(const RiskFactorKey& key, const std::string& desc, QuantLib::Real shift);
+    QuantLib::Size addCurrency(const std::string& currency);
+
+    const std::string& tradeId(QuantLib::Size i) const { return tradeIds_[i]; }
+    const Factor& factor(QuantLib::Size i) const { return factors_[i]; }
+    const std::string& currency(QuantLib::Size i) const { return currencies_[i]; }
+
+    QuantLib::Size numberOfTradeIds() const { return tradeIds_.size(); }
+    QuantLib::Size numberOfFactors() const { return factors_.size(); }
+    QuantLib::Size numberOfCurrencies() const { return currencies_.size(); }
+
+private:
+    std::vector<std::string> tradeIds_;
+    std::unordered_map<std::string, QuantLib::Size> tradeIdIndex_;
+    std::vector<Factor> factors_;
+    // a key can appear with several descriptions or shift sizes, so we map to all factors with that key
+    std::unordered_map<RiskFactorKey, std::vector<QuantLib::Size>, boost::hash<RiskFactorKey>> factorIndex_;
+    std::vector<std::string> currencies_;
+    std::unordered_map<std::string, QuantLib::Size> currencyIndex_;
+};
+
+/*! A batch of sensitivity records in columnar layout.
+
+    The trade, factor and currency columns hold indices into the dictionary shared by all batches of a stream, so
+    that streaming a batch does not copy any strings. factor2 is Null<Size>() except for cross gamma entries.
+*/
+struct SensitivityBatch {
+    QuantLib::ext::shared_ptr<SensitivityDictionary> dictionary;
+
+    std::vector<QuantLib::Size> trade;
+    std::vector<char> isPar;
+    std::vector<QuantLib::Size> factor1;
+    std::vector<QuantLib::Size> factor2;
+    std::vector<QuantLib::Size> currency;
+    std::vector<QuantLib::Real> baseNpv;
+    std::vector<QuantLib::Real> delta;
+    std::vector<QuantLib::Real> gamma;
+
+    QuantLib::Size size() const { return trade.size(); }
+    bool empty() const { return trade.empty(); }
+    bool isCrossGamma(QuantLib::Size i) const { return factor2[i] != QuantLib::Null<QuantLib::Size>(); }
+
+    //! Removes all entries, the dictionary is kept
+    void clear();
+    //! Adds an entry given by dictionary indices
+    void add(QuantLib::Size trade, bool isPar, QuantLib::Size factor1, QuantLib::Size factor2, QuantLib::Size currency,
+             QuantLib::Real baseNpv, QuantLib::Real delta, QuantLib::Real gamma);
+    //! Adds a record, its trade id, factors and currency are added to the dictionary if required
+    void add(const SensitivityRecord& sr);
+    //! Adds the entries [from, to) of another batch referring to the same dictionary
+    void append(const SensitivityBatch& batch, QuantLib::Size from, QuantLib::Size to);
+
+    //! Returns the entry i as a SensitivityRecord
+    SensitivityRecord record(QuantLib::Size i) const;
+};
+
+} // namespace analytics
+} // namespace ore
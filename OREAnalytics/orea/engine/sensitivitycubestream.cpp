@@ -35,7 +35,8 @@ SensitivityCubeStream::SensitivityCubeStream(const QuantLib::ext::shared_ptr<Sen
 
 SensitivityCubeStream::SensitivityCubeStream(const std::vector<QuantLib::ext::shared_ptr<SensitivityCube>>& cubes,
                                              const string& currency)
-    : cubes_(cubes), currency_(currency), canComputeGamma_(false) {
+    : cubes_(cubes), currency_(currency), canComputeGamma_(false), currencyIdx_(dictionary_->addCurrency(currency)),
+      deltaFactorIdx_(cubes.size()), crossFactorIdx_(cubes.size()) {
 
     // Set the value of canComputeGamma_ based on up and down risk factors.
 
@@ -54,27 +55,31 @@ SensitivityCubeStream::SensitivityCubeStream(const std::vector<QuantLib::ext::sh
     reset();
 }
 
-SensitivityRecord SensitivityCubeStream::next() {
+bool SensitivityCubeStream::nextPosition() {
 
     if (cubes_.size() == 0)
-        return SensitivityRecord();
-
-    while (tradeIdx_ != cubes_[currentCubeIdx_]->tradeIdx().end() && currentDeltaKey_ == currentDeltaKeys_.end() &&
-           currentCrossGammaKey_ == currentCrossGammaKeys_.end()) {
-        ++tradeIdx_;
-        updateForNewTrade();
-    }
+        return false;
 
-    if (tradeIdx_ == cubes_[currentCubeIdx_]->tradeIdx().end()) {
-        if (currentCubeIdx_ < cubes_.size() - 1) {
-            ++currentCubeIdx_;
-            tradeIdx_ = cubes_[currentCubeIdx_]->tradeIdx().begin();
+    while (true) {
+        while (tradeIdx_ != cubes_[currentCubeIdx_]->tradeIdx().end() &&
+               currentDeltaKey_ == currentDeltaKeys_.end() && currentCrossGammaKey_ == currentCrossGammaKeys_.end()) {
+            ++tradeIdx_;
             updateForNewTrade();
-            return next();
-        } else {
-            return SensitivityRecord();
         }
+        if (tradeIdx_ != cubes_[currentCubeIdx_]->tradeIdx().end())
+            return true;
+        if (currentCubeIdx_ == cubes_.size() - 1)
+            return false;
+        ++currentCubeIdx_;
+        tradeIdx_ = cubes_[currentCubeIdx_]->tradeIdx().begin();
+        updateForNewTrade();
     }
+}
+
+SensitivityRecord SensitivityCubeStream::next() {
+
+    if (!nextPosition())
+        return SensitivityRecord();
 
     SensitivityRecord sr;
     Size tradeIdx = tradeIdx_->second;
@@ -110,6 +115,56 @@ SensitivityRecord SensitivityCubeStream::next() {
     return sr;
 }
 
+bool SensitivityCubeStream::nextBatch(SensitivityBatch& batch, Size maxSize) {
+    batch.clear();
+    batch.dictionary = dictionary_;
+
+    while (batch.size() < maxSize && nextPosition()) {
+        const auto& cube = cubes_[currentCubeIdx_];
+        Size tradeIdx = tradeIdx_->second;
+        Size trade = dictionary_->addTradeId(tradeIdx_->first);
+        Real baseNpv = cube->npv(tradeIdx);
+
+        // emit the records of the current trade, the factor data is looked up once per cube and risk factor
+
+        for (; batch.size() < maxSize && currentDeltaKey_ != currentDeltaKeys_.end(); ++currentDeltaKey_) {
+            auto f = deltaFactorIdx_[currentCubeIdx_].find(*currentDeltaKey_);
+            if (f == deltaFactorIdx_[currentCubeIdx_].end()) {
+                auto const& fd = cube->upThenDownFactorData(*currentDeltaKey_);
+                f = deltaFactorIdx_[currentCubeIdx_]
+                        .emplace(*currentDeltaKey_,
+                                 dictionary_->addFactor(*currentDeltaKey_, fd.factorDesc, fd.targetShiftSize))
+                        .first;
+            }
+            batch.add(trade, false, f->second, Null<Size>(), currencyIdx_, baseNpv,
+                      cube->delta(tradeIdx_->first, *currentDeltaKey_),
+                      canComputeGamma_ ? cube->gamma(tradeIdx_->first, *currentDeltaKey_) : Null<Real>());
+        }
+
+        for (; batch.size() < maxSize && currentDeltaKey_ == currentDeltaKeys_.end() &&
+               currentCrossGammaKey_ != currentCrossGammaKeys_.end();
+             ++currentCrossGammaKey_) {
+            auto f = crossFactorIdx_[currentCubeIdx_].find(*currentCrossGammaKey_);
+            if (f == crossFactorIdx_[currentCubeIdx_].end()) {
+                auto const& fd = cube->crossFactors().at(*currentCrossGammaKey_);
+                f = crossFactorIdx_[currentCubeIdx_]
+                        .emplace(*currentCrossGammaKey_,
+                                 std::make_pair(dictionary_->addFactor(currentCrossGammaKey_->first,
+                                                                       std::get<0>(fd).factorDesc,
+                                                                       std::get<0>(fd).targetShiftSize),
+                                                dictionary_->addFactor(currentCrossGammaKey_->second,
+                                                                       std::get<1>(fd).factorDesc,
+                                                                       std::get<1>(fd).targetShiftSize)))
+                        .first;
+            }
+            batch.add(trade, false, f->second.first, f->second.second, currencyIdx_, baseNpv, 0.0,
+                      cube->crossGamma(tradeIdx_->first, *currentCrossGammaKey_));
+        }
+    }
+
+    return !batch.empty();
+}
+
 void SensitivityCubeStream::updateForNewTrade() {
     currentDeltaKeys_.clear();
     currentCrossGammaKeys_.clear();
@@ -50,8 +50,13 @@ public:
     //! Resets the stream so that SensitivityRecord objects can be streamed again
     void reset() override;
 
+    //! Returns the next records in the stream without converting them to SensitivityRecords
+    bool nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize = 4096) override;
+
 private:
     void updateForNewTrade();
+    //! Moves to the next trade with records if required, returns false if there are no more records
+    bool nextPosition();
 
     //! Handle on the SensitivityCubes
     std::vector<QuantLib::ext::shared_ptr<SensitivityCube>> cubes_;
@@ -73,6 +78,11 @@ private:
 
     //! Can only compute gamma if the up and down risk factors align
     bool canComputeGamma_;
+
+    //! Dictionary indices of the currency and, per cube, of the risk factors seen so far
+    Size currencyIdx_;
+    std::vector<std::map<RiskFactorKey, Size>> deltaFactorIdx_;
+    std::vector<std::map<std::pair<RiskFactorKey, RiskFactorKey>, std::pair<Size, Size>>> crossFactorIdx_;
 };
 
 } // namespace analytics
@@ -21,6 +21,7 @@
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
 
 #include <boost/algorithm/string.hpp>
 
@@ -38,8 +39,7 @@ void SensitivityInputStream::setStream(std::istream* stream) {
     stream_ = stream; 
 }
 
-SensitivityRecord SensitivityInputStream::next() {
-    // Get the next valid SensitivityRecord
+bool SensitivityInputStream::nextEntries(vector<string>& entries) {
     string line;
     while (getline(*stream_, line)) {
         // Update the current line number
@@ -52,18 +52,33 @@ SensitivityRecord SensitivityInputStream::next() {
         if (line.empty() || boost::starts_with(line, comment_))
             continue;
 
-        // Try to parse line in to a SensitivityRecord
         DLOG("Processing line number " << lineNo_ << ": " << line);
-        vector<string> entries;
         boost::split(
             entries, line, [this](char c) { return c == delim_; }, boost::token_compress_off);
-        return processRecord(entries);
+        return true;
     }
+    return false;
+}
+
+SensitivityRecord SensitivityInputStream::next() {
+    // Get the next valid SensitivityRecord
+    vector<string> entries;
+    if (nextEntries(entries))
+        return processRecord(entries);
 
     // If we get to here, no more lines to process so return empty record
     return SensitivityRecord();
 }
 
+bool SensitivityInputStream::nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize) {
+    batch.clear();
+    batch.dictionary = dictionary_;
+    vector<string> entries;
+    while (batch.size() < maxSize && nextEntries(entries))
+        processRecord(entries, batch);
+    return !batch.empty();
+}
+
 void SensitivityInputStream::reset() {
     // Reset to beginning of file and line number
     stream_->clear();
@@ -97,6 +112,38 @@ SensitivityRecord SensitivityInputStream::processRecord(const vector<string>& en
     return sr;
 }
 
+QuantLib::Size SensitivityInputStream::factorIndex(const string& factor, const string& shift) {
+    Real shiftSize = 0.0;
+    tryParseReal(shift, shiftSize);
+    auto& candidates = factorIdx_[factor];
+    for (auto const& [s, idx] : candidates) {
+        if (QuantLib::close_enough(s, shiftSize))
+            return idx;
+    }
+    auto p = deconstructFactor(factor);
+    candidates.emplace_back(shiftSize, dictionary_->addFactor(p.first, p.second, shiftSize));
+    return candidates.back().second;
+}
+
+void SensitivityInputStream::processRecord(const vector<string>& entries, SensitivityBatch& batch) {
+
+    QL_REQUIRE(entries.size() == 10, "On line number " << lineNo_ << ": A sensitivity record needs 10 entries");
+
+    Size factor1 = factorIndex(entries[2], entries[3]);
+    Size factor2 = Null<Size>();
+    if (!entries[4].empty()) {
+        factor2 = factorIndex(entries[4], entries[5]);
+        if (dictionary_->factor(factor2).key == RiskFactorKey())
+            factor2 = Null<Size>();
+    }
+
+    Real gamma = 0.0;
+    tryParseReal(entries[9], gamma); // might be #N/A, if not computed
+
+    batch.add(dictionary_->addTradeId(entries[0]), parseBool(entries[1]), factor1, factor2,
+              dictionary_->addCurrency(entries[6]), parseReal(entries[7]), parseReal(entries[8]), gamma);
+}
+
 SensitivityFileStream::SensitivityFileStream(const string& fileName, char delim, const string& comment)
     : SensitivityInputStream(delim, comment) {
 
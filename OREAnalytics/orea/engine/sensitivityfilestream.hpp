@@ -26,6 +26,8 @@
 
 #include <fstream>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace ore {
 namespace analytics {
@@ -44,6 +46,9 @@ public:
     SensitivityRecord next() override;
     //! Resets the stream so that SensitivityRecord objects can be streamed again
     void reset() override;
+    /*! Returns the next records in the stream without creating SensitivityRecords, each distinct risk factor string
+        is parsed only once */
+    bool nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize = 4096) override;
 
 private:
     //! Handle on the stram
@@ -55,8 +60,17 @@ private:
     //! Keep track of line number for messages
     QuantLib::Size lineNo_;
 
+    //! Reads the next non-empty, non-comment line and splits it into entries, returns false at the end of the stream
+    bool nextEntries(std::vector<std::string>& entries);
     //! Create a record from a collection of strings
     SensitivityRecord processRecord(const std::vector<std::string>& entries) const;
+    //! Add a collection of strings to the batch
+    void processRecord(const std::vector<std::string>& entries, SensitivityBatch& batch);
+    //! Dictionary index of a risk factor string and shift size
+    QuantLib::Size factorIndex(const std::string& factor, const std::string& shift);
+
+    //! Dictionary indices of the risk factor strings parsed so far, by shift size
+    std::unordered_map<std::string, std::vector<std::pair<QuantLib::Real, QuantLib::Size>>> factorIdx_;
 };
 
 class SensitivityFileStream : public SensitivityInputStream {
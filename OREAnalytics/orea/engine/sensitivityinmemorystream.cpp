@@ -19,32 +19,43 @@
 #include <orea/engine/sensitivityinmemorystream.hpp>
 #include <ored/utilities/log.hpp>
 
+#include <algorithm>
+
 using std::set;
 
 namespace ore {
 namespace analytics {
 
-SensitivityInMemoryStream::SensitivityInMemoryStream() : itCurrent_(records_.begin()) {}
+SensitivityInMemoryStream::SensitivityInMemoryStream() : current_(0) { records_.dictionary = dictionary_; }
 
 SensitivityRecord SensitivityInMemoryStream::next() {
     // If there are no more records, return the empty record
-    if (itCurrent_ == records_.end())
+    if (current_ == records_.size())
         return SensitivityRecord();
 
-    // If there are more, return the current record and advance the iterator
-    return *(itCurrent_++);
+    // If there are more, return the current record and advance the index
+    return records_.record(current_++);
 }
 
 void SensitivityInMemoryStream::reset() {
-    // Reset iterator to start of container
-    itCurrent_ = records_.begin();
+    // Reset index to start of container
+    current_ = 0;
+}
+
+bool SensitivityInMemoryStream::nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize) {
+    batch.clear();
+    batch.dictionary = dictionary_;
+    QuantLib::Size end = std::min(records_.size(), current_ + maxSize);
+    batch.append(records_, current_, end);
+    current_ = end;
+    return !batch.empty();
 }
 
 void SensitivityInMemoryStream::add(const SensitivityRecord& sr) {
     // Insert the record
-    records_.push_back(sr);
+    records_.add(sr);
 
-    // Reset because itCurrent_ possibly invalidated by the insert
+    // Reset, as documented
     reset();
 }
 
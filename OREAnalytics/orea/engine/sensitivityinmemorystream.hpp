@@ -29,7 +29,8 @@
 namespace ore {
 namespace analytics {
 
-//! Class for streaming SensitivityRecords from csv file
+//! Class for streaming SensitivityRecords from in-memory container
+/*! The records are stored in columnar form, see SensitivityBatch. */
 class SensitivityInMemoryStream : public SensitivityStream {
 public:
     //! Default constructor
@@ -41,6 +42,8 @@ public:
     SensitivityRecord next() override;
     //! Resets the stream so that SensitivityRecords can be streamed again
     void reset() override;
+    //! Returns the next records in the stream without converting them to SensitivityRecords
+    bool nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize = 4096) override;
     /*! Add a record to the in-memory collection.
 
         \warning this causes reset() to be called. In other words, after any call
@@ -50,13 +53,16 @@ public:
 
 private:
     //! Container of records
-    std::vector<SensitivityRecord> records_;
-    //! Iterator to current element
-    std::vector<SensitivityRecord>::iterator itCurrent_;
+    SensitivityBatch records_;
+    //! Index of current element
+    QuantLib::Size current_;
 };
 
-template <class Iter> 
-SensitivityInMemoryStream::SensitivityInMemoryStream(Iter begin, Iter end) : records_(begin, end) {}
+template <class Iter> SensitivityInMemoryStream::SensitivityInMemoryStream(Iter begin, Iter end) : current_(0) {
+    records_.dictionary = dictionary_;
+    for (; begin != end; ++begin)
+        records_.add(*begin);
+}
 
 } // namespace analytics
 } // namespace ore
@@ -22,12 +22,18 @@
 
 #pragma once
 
+#include <orea/engine/sensitivitybatch.hpp>
 #include <orea/engine/sensitivityrecord.hpp>
 
 namespace ore {
 namespace analytics {
 
 //! Base Class for streaming SensitivityRecords
+/*! Besides record by record via next(), a stream can be read in batches via nextBatch(). The batches are in columnar
+    layout and refer to the stream's dictionary for trade ids, risk factors and currencies. The default
+    implementation of nextBatch() adapts next(), streams with a more efficient native representation override it.
+    A stream should be read either via next() or via nextBatch() between two calls to reset().
+*/
 class SensitivityStream {
 public:
     //! Destructor
@@ -36,6 +42,14 @@ public:
     virtual SensitivityRecord next() = 0;
     //! Resets the stream so that SensitivityRecord objects can be streamed again
     virtual void reset() = 0;
+    /*! Replaces the contents of \p batch by the next records in the stream, at most \p maxSize. Returns false if
+        there are no more records, in which case the batch is empty. */
+    virtual bool nextBatch(SensitivityBatch& batch, QuantLib::Size maxSize = 4096);
+    //! The dictionary the batches returned by nextBatch() refer to
+    virtual QuantLib::ext::shared_ptr<SensitivityDictionary> dictionary() const { return dictionary_; }
+
+protected:
+    QuantLib::ext::shared_ptr<SensitivityDictionary> dictionary_ = QuantLib::ext::make_shared<SensitivityDictionary>();
 };
 
 } // namespace analytics
@@ -52,6 +52,12 @@ void NPVCalculator::initScenario() {
         fxRates_[i] = ccyQuotes_[i]->value();
 }
 
+bool NPVCalculator::observables(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex,
+                                std::vector<QuantLib::ext::shared_ptr<QuantLib::Observable>>& result) const {
+    result.push_back(ccyQuotes_[tradeCcyIndex_[tradeIndex]]);
+    return true;
+}
+
 void NPVCalculator::calculate(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex,
                               const QuantLib::ext::shared_ptr<SimMarket>& simMarket, QuantLib::ext::shared_ptr<NPVCube>& outputCube,
                               QuantLib::ext::shared_ptr<NPVCube>& outputCubeNettingSet, const Date& date, Size dateIndex,
@@ -77,6 +77,14 @@ public:
 
     // called after each scenario update before the calculators are run
     virtual void initScenario() = 0;
+
+    /*! Adds the observables (in addition to the trade's instruments) the results for the given trade depend on and
+        returns true. If the results are not fully determined by these, false is returned, which is the default.
+        The valuation engine uses this to skip trades that are not affected by a scenario. Called after init(). */
+    virtual bool observables(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex,
+                             std::vector<QuantLib::ext::shared_ptr<QuantLib::Observable>>& result) const {
+        return false;
+    }
 };
 
 //! NPVCalculator
@@ -104,6 +112,10 @@ public:
     void init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<SimMarket>& simMarket) override;
     void initScenario() override;
 
+    //! the fx rate from the trade's npv currency to the base ccy
+    bool observables(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex,
+                     std::vector<QuantLib::ext::shared_ptr<QuantLib::Observable>>& result) const override;
+
 protected:
     std::string baseCcyCode_;
     Size index_;
@@ -175,6 +187,12 @@ public:
     void init(const QuantLib::ext::shared_ptr<Portfolio>& portfolio, const QuantLib::ext::shared_ptr<SimMarket>& simMarket) override;
     void initScenario() override {}
 
+    //! no observables, the fx rates are taken from the t0 market
+    bool observables(const QuantLib::ext::shared_ptr<Trade>& trade, Size tradeIndex,
+                     std::vector<QuantLib::ext::shared_ptr<QuantLib::Observable>>& result) const override {
+        return true;
+    }
+
 private:
     std::string baseCcyCode_;
     QuantLib::ext::shared_ptr<Market> t0Market_;
@@ -36,6 +36,8 @@
 
 #include <boost/timer/timer.hpp>
 
+#include <algorithm>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -48,8 +50,10 @@ namespace analytics {
 
 ValuationEngine::ValuationEngine(const Date& today, const QuantLib::ext::shared_ptr<DateGrid>& dg,
                                  const QuantLib::ext::shared_ptr<SimMarket>& simMarket,
-                                 const set<std::pair<string, QuantLib::ext::shared_ptr<ModelBuilder>>>& modelBuilders)
-    : today_(today), dg_(dg), simMarket_(simMarket), modelBuilders_(modelBuilders) {
+                                 const set<std::pair<string, QuantLib::ext::shared_ptr<ModelBuilder>>>& modelBuilders,
+                                 const bool skipUnaffectedTrades)
+    : today_(today), dg_(dg), simMarket_(simMarket), modelBuilders_(modelBuilders),
+      skipUnaffectedTrades_(skipUnaffectedTrades) {
 
     QL_REQUIRE(dg_->size() > 0, "Error, DateGrid size must be > 0");
     QL_REQUIRE(today <= dg_->dates().front(), "ValuationEngine: Error today ("
@@ -58,6 +62,38 @@ ValuationEngine::ValuationEngine(const Date& today, const QuantLib::ext::shared_
     QL_REQUIRE(simMarket_, "ValuationEngine: Error, Null SimMarket");
 }
 
+//! flags a trade as affected by a scenario when one of the observables its valuation depends on notifies
+class ValuationEngine::TradeObserver : public QuantLib::Observer {
+public:
+    void update() override { notified_ = true; }
+    bool notified_ = false;
+};
+
+void ValuationEngine::initTradeObservers(const QuantLib::ext::shared_ptr<Trade>& trade, const Size tradeIndex,
+                                         const std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>>& calculators) {
+    std::vector<QuantLib::ext::shared_ptr<Observable>> observables;
+    for (auto const& c : calculators) {
+        if (!c->observables(trade, tradeIndex, observables))
+            return;
+    }
+    auto instrument = trade->instrument();
+    if (instrument == nullptr || instrument->qlInstrument() == nullptr)
+        return;
+    observables.push_back(instrument->qlInstrument());
+    for (auto const& i : instrument->additionalInstruments())
+        observables.push_back(i);
+    if (auto ow = QuantLib::ext::dynamic_pointer_cast<OptionWrapper>(instrument)) {
+        for (auto const& i : ow->underlyingInstruments())
+            observables.push_back(i);
+    }
+    auto observer = QuantLib::ext::make_shared<TradeObserver>();
+    for (auto const& o : observables) {
+        if (o != nullptr)
+            observer->registerWith(o);
+    }
+    tradeObservers_[tradeIndex] = observer;
+}
+
 void ValuationEngine::recalibrateModels() {
     ObservationMode::Mode om = ObservationMode::instance().mode();
     for (auto const& b : modelBuilders_) {
@@ -124,6 +160,21 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
     const auto& trades = portfolio->trades();
     auto& counterparties = outputCptyCube ? outputCptyCube->idsAndIndexes() : std::map<string, Size>();
     std::vector<bool> tradeHasError(portfolio->size(), false);
+
+    // we can skip the valuation of trades not affected by a scenario, if there is no date dependency (sensi or
+    // stress test runs) and we get notified on changes of the trade's inputs, see the class documentation
+
+    trackTradeDependencies_ =
+        skipUnaffectedTrades_ && (om == ObservationMode::Mode::None || om == ObservationMode::Mode::Defer) &&
+        dates.size() == 1 && dates.front() == simMarket_->asofDate() && dg_->closeOutDates().empty() &&
+        outputCubeNettingSet == nullptr && outputCptyCube == nullptr && !dryRun;
+    tradeObservers_.assign(trackTradeDependencies_ ? portfolio->size() : 0, nullptr);
+    lastValuedSample_.assign(portfolio->size(), Null<Size>());
+    lastValuedNumeraire_.assign(portfolio->size(), simMarket_->numeraire());
+    skippedValuations_ = 0;
+    LOG("Track trade dependencies to skip valuations of unaffected trades: " << std::boolalpha
+                                                                             << trackTradeDependencies_);
+
     LOG("Initialise state objects...");
     // initialise state objects for each trade (required for path-dependent derivatives in particular)
     size_t i = 0;
@@ -135,6 +186,9 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
 
         recalibrateModels();
 
+        if (trackTradeDependencies_)
+            initTradeObservers(trade, i, calculators);
+
         // T0 values
         try {
             for (auto& calc : calculators)
@@ -259,15 +313,20 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
 
     if (dryRun) {
         LOG("Doing a dry run - fill remaining cube with random values.");
-        for (Size sample = 1; sample < outputCube->samples(); ++sample) {
-            for (Size i = 0; i < dates.size(); ++i) {
-                for (Size j = 0; j < trades.size(); ++j) {
-                    for (Size d = 0; d < outputCube->depth(); ++d) {
+        std::vector<Real> values;
+        for (Size i = 0; i < outputCube->numDates(); ++i) {
+            for (Size j = 0; j < trades.size(); ++j) {
+                for (Size d = 0; d < outputCube->depth(); ++d) {
+                    // fill whole sample rows, sample 0 keeps the value from the dry run pricing
+                    outputCube->getSamples(values, j, i, d);
+                    Real t0 = outputCube->getT0(j, d);
+                    for (Size sample = 1; sample < values.size(); ++sample) {
                         // add some noise, but only for the first few samples, so that e.g.
                         // a sensi run is not polluted with too many sensis for each trade
                         Real noise = sample < 10 ? static_cast<Real>(i + j + d + sample) : 0.0;
-                        outputCube->set(outputCube->getT0(j, d) + noise, j, i, sample, d);
+                        values[sample] = t0 + noise;
                     }
+                    outputCube->setSamples(values, j, i, d);
                 }
             }
         }
@@ -282,6 +341,12 @@ void ValuationEngine::buildCube(const QuantLib::ext::shared_ptr<data::Portfolio>
                                            << "pricing " << pricingTime << " sec, "
                                            << "update " << updateTime << " sec "
                                            << "fixing " << fixingTime);
+    if (trackTradeDependencies_) {
+        Size nTracked = std::count_if(tradeObservers_.begin(), tradeObservers_.end(),
+                                      [](const QuantLib::ext::shared_ptr<TradeObserver>& o) { return o != nullptr; });
+        LOG("ValuationEngine skipped " << skippedValuations_ << " trade valuations not affected by the scenario, "
+                                       << nTracked << " out of " << nTrades << " trades were tracked.");
+    }
 
     // for trades with errors set all output cube values to zero
     i = 0;
@@ -312,6 +377,22 @@ void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::st
             continue;
         }
 
+        // skip trades which were not notified since their last valuation and copy their last results
+
+        if (trackTradeDependencies_ && tradeObservers_[j] != nullptr) {
+            if (!tradeObservers_[j]->notified_ && lastValuedNumeraire_[j] == simMarket_->numeraire()) {
+                for (Size k = 0; k < outputCube->depth(); ++k) {
+                    outputCube->set(lastValuedSample_[j] == Null<Size>()
+                                        ? outputCube->getT0(j, k)
+                                        : outputCube->get(j, cubeDateIndex, lastValuedSample_[j], k),
+                                    j, cubeDateIndex, sample, k);
+                }
+                ++skippedValuations_;
+                continue;
+            }
+            tradeObservers_[j]->notified_ = false;
+        }
+
         // We can avoid checking mode here and always call updateQlInstruments()
         if (om == ObservationMode::Mode::Disable || om == ObservationMode::Mode::Unregister)
             trade->instrument()->updateQlInstruments();
@@ -325,6 +406,8 @@ void ValuationEngine::runCalculators(bool isCloseOutDate, const std::map<std::st
             StructuredTradeErrorMessage(trade->id(), trade->tradeType(), "ScenarioValuation", expMsg.c_str()).log();
             tradeHasError[j] = true;
         }
+        lastValuedSample_[j] = sample;
+        lastValuedNumeraire_[j] = simMarket_->numeraire();
     }
 }
 
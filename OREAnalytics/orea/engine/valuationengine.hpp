@@ -29,6 +29,7 @@
 
 #include <map>
 #include <set>
+#include <vector>
 
 namespace ore::data {
 class DateGrid;
@@ -64,6 +65,13 @@ using std::set;
   In addition to storing the resulting NPVs it can be given any number of calculators
   that can store additional values in the cube.
 
+  If skipUnaffectedTrades is set in the constructor, there is a single valuation date equal to the sim market's asof
+  date (e.g. in a sensitivity or stress test run) and the observation mode is None or Defer, the engine registers an
+  observer per trade with the trade's instruments and the market observables reported by the calculators. Trades that
+  did not receive a notification since their last valuation are not revalued under a scenario, instead their last
+  results are copied in the cube. This gives wrong results for trades whose instrument does not observe all market
+  data it depends on, therefore it is switched off by default.
+
   \ingroup simulation
 */
 class ValuationEngine : public ore::data::ProgressReporter {
@@ -78,7 +86,9 @@ public:
         const QuantLib::ext::shared_ptr<analytics::SimMarket>& simMarket,
         //! model builders to be updated
         const set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>& modelBuilders =
-            set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>());
+            set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>(),
+        //! Skip the valuation of trades not affected by a scenario, see above
+        const bool skipUnaffectedTrades = false);
 
     //! Build NPV cube
     void buildCube(
@@ -99,6 +109,9 @@ public:
         //! Limit samples to one and fill the rest of the cube with random values
         bool dryRun = false);
 
+    //! Number of trade valuations skipped in the last buildCube() call
+    QuantLib::Size skippedValuations() const { return skippedValuations_; }
+
 private:
     void recalibrateModels();
     std::pair<double, double> populateCube(const QuantLib::Date& d, size_t cubeDateIndex, size_t sample,
@@ -122,10 +135,21 @@ private:
                         QuantLib::ext::shared_ptr<analytics::NPVCube>& cptyCube, const QuantLib::Date& d,
                         const QuantLib::Size cubeDateIndex, const QuantLib::Size sample);
     void tradeExercisable(bool enable, const std::map<std::string, QuantLib::ext::shared_ptr<ore::data::Trade>>& trades);
+    void initTradeObservers(const QuantLib::ext::shared_ptr<ore::data::Trade>& trade, const QuantLib::Size tradeIndex,
+                            const std::vector<QuantLib::ext::shared_ptr<ValuationCalculator>>& calculators);
     QuantLib::Date today_;
     QuantLib::ext::shared_ptr<ore::data::DateGrid> dg_;
     QuantLib::ext::shared_ptr<ore::analytics::SimMarket> simMarket_;
     set<std::pair<std::string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
+    bool skipUnaffectedTrades_;
+
+    // trade dependency tracking, null observer = trade is always revalued
+    class TradeObserver;
+    bool trackTradeDependencies_ = false;
+    std::vector<QuantLib::ext::shared_ptr<TradeObserver>> tradeObservers_;
+    std::vector<QuantLib::Size> lastValuedSample_;
+    std::vector<QuantLib::Real> lastValuedNumeraire_;
+    QuantLib::Size skippedValuations_ = 0;
 };
 } // namespace analytics
 } // namespace ore
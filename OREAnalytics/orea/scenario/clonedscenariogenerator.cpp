@@ -56,5 +56,12 @@ void ClonedScenarioGenerator::reset() {
     nSim_ = 0;
 }
 
+void ClonedScenarioGenerator::skipTo(const Size sample) {
+    QL_REQUIRE(sample * dates_.size() <= scenarios_.size(),
+               "ClonedScenarioGenerator::skipTo(" << sample << "): only " << scenarios_.size() / dates_.size()
+                                                  << " samples stored.");
+    nSim_ = sample;
+}
+
 } // namespace analytics
 } // namespace ore
@@ -34,6 +34,7 @@ public:
                             const std::vector<Date>& dates, const Size nSamples);
     QuantLib::ext::shared_ptr<Scenario> next(const Date& d) override;
     virtual void reset() override;
+    virtual void skipTo(const Size sample) override;
 
 private:
     std::map<Date, size_t> dates_;
@@ -57,6 +57,12 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
     n_indices_ = simMarketConfig_->indices().size();
     n_curves_ = simMarketConfig_->yieldCurveNames().size();
 
+    // the cached keys are stored by their registry ids
+
+    auto keyId = [](const RiskFactorKey::KeyType keyType, const std::string& name, const Size index = 0) {
+        return RiskFactorKeyRegistry::instance().id(RiskFactorKey(keyType, name, index));
+    };
+
     // Cache yield curve keys
     discountCurveKeys_.reserve(n_ccy_ * simMarketConfig_->yieldCurveTenors("").size());
     for (Size j = 0; j < model_->components(CrossAssetModel::AssetType::IR); j++) {
@@ -64,7 +70,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
         ten_dsc_.push_back(simMarketConfig_->yieldCurveTenors(ccy));
         Size n_ten = ten_dsc_.back().size();
         for (Size k = 0; k < n_ten; k++)
-            discountCurveKeys_.emplace_back(RiskFactorKey::KeyType::DiscountCurve, ccy, k); // j * n_ten + k
+            discountCurveKeys_.push_back(keyId(RiskFactorKey::KeyType::DiscountCurve, ccy, k)); // j * n_ten + k
     }
 
     // Cache index curve keys
@@ -73,7 +79,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
         ten_idx_.push_back(simMarketConfig_->yieldCurveTenors(simMarketConfig_->indices()[j]));
         Size n_ten = ten_idx_.back().size();
         for (Size k = 0; k < n_ten; ++k) {
-            indexCurveKeys_.emplace_back(RiskFactorKey::KeyType::IndexCurve, simMarketConfig_->indices()[j], k);
+            indexCurveKeys_.push_back(keyId(RiskFactorKey::KeyType::IndexCurve, simMarketConfig_->indices()[j], k));
         }
     }
 
@@ -84,7 +90,8 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
         ten_yc_.push_back(simMarketConfig_->yieldCurveTenors(simMarketConfig_->yieldCurveNames()[j]));
         Size n_ten = ten_yc_.back().size();
         for (Size k = 0; k < n_ten; ++k) {
-            yieldCurveKeys_.emplace_back(RiskFactorKey::KeyType::YieldCurve, simMarketConfig_->yieldCurveNames()[j], k);
+            yieldCurveKeys_.push_back(
+                keyId(RiskFactorKey::KeyType::YieldCurve, simMarketConfig_->yieldCurveNames()[j], k));
         }
     }
 
@@ -96,7 +103,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
             ten_com_.push_back(simMarketConfig_->commodityCurveTenors(name));
             Size n_ten = ten_com_.back().size();
             for (Size k = 0; k < n_ten; k++)
-                commodityCurveKeys_.emplace_back(RiskFactorKey::KeyType::CommodityCurve, name, k); // j * n_ten + k
+                commodityCurveKeys_.push_back(keyId(RiskFactorKey::KeyType::CommodityCurve, name, k)); // j * n_ten + k
         }
     }
     
@@ -105,7 +112,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
     for (Size k = 0; k < n_ccy_ - 1; k++) {
         const string& foreign = model_->parametrizations()[k + 1]->currency().code();
         const string& domestic = model_->parametrizations()[0]->currency().code();
-        fxKeys_.emplace_back(RiskFactorKey::KeyType::FXSpot, foreign + domestic); // k
+        fxKeys_.push_back(keyId(RiskFactorKey::KeyType::FXSpot, foreign + domestic)); // k
     }
 
     // set up CrossAssetModelImpliedFxVolTermStructures
@@ -136,7 +143,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
     eqKeys_.reserve(n_eq);
     for (Size k = 0; k < n_eq; k++) {
         const string& eqName = model_->eqbs(k)->name();
-        eqKeys_.emplace_back(RiskFactorKey::KeyType::EquitySpot, eqName);
+        eqKeys_.push_back(keyId(RiskFactorKey::KeyType::EquitySpot, eqName));
     }
 
     // equity vols
@@ -162,7 +169,7 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
     if (n_inf > 0) {
         cpiKeys_.reserve(n_inf);
         for (Size j = 0; j < n_inf; ++j) {
-            cpiKeys_.emplace_back(RiskFactorKey::KeyType::CPIIndex, model->inf(j)->name());
+            cpiKeys_.push_back(keyId(RiskFactorKey::KeyType::CPIIndex, model->inf(j)->name()));
         }
 
         Size n_zeroinf = simMarketConfig_->zeroInflationIndices().size();
@@ -172,8 +179,8 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
                 ten_zinf_.push_back(simMarketConfig_->zeroInflationTenors(simMarketConfig_->zeroInflationIndices()[j]));
                 Size n_ten = ten_zinf_.back().size();
                 for (Size k = 0; k < n_ten; ++k) {
-                    zeroInflationKeys_.emplace_back(RiskFactorKey::KeyType::ZeroInflationCurve,
-                                                    simMarketConfig_->zeroInflationIndices()[j], k);
+                    zeroInflationKeys_.push_back(keyId(RiskFactorKey::KeyType::ZeroInflationCurve,
+                                                       simMarketConfig_->zeroInflationIndices()[j], k));
                 }
             }
         }
@@ -185,8 +192,8 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
                 ten_yinf_.push_back(simMarketConfig_->yoyInflationTenors(simMarketConfig_->yoyInflationIndices()[j]));
                 Size n_ten = ten_yinf_.back().size();
                 for (Size k = 0; k < n_ten; ++k) {
-                    yoyInflationKeys_.emplace_back(RiskFactorKey::KeyType::YoYInflationCurve,
-                                                   simMarketConfig_->yoyInflationIndices()[j], k);
+                    yoyInflationKeys_.push_back(keyId(RiskFactorKey::KeyType::YoYInflationCurve,
+                                                      simMarketConfig_->yoyInflationIndices()[j], k));
                 }
             }
         }
@@ -200,7 +207,8 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
         ten_dfc_.push_back(simMarketConfig_->defaultTenors(cr_name));
         Size n_ten = ten_dfc_.back().size();
         for (Size k = 0; k < n_ten; k++) {
-            defaultCurveKeys_.emplace_back(RiskFactorKey::KeyType::SurvivalProbability, cr_name, k); // j * n_ten + k
+            defaultCurveKeys_.push_back(
+                keyId(RiskFactorKey::KeyType::SurvivalProbability, cr_name, k)); // j * n_ten + k
         }
     }
 
@@ -209,14 +217,14 @@ CrossAssetModelScenarioGenerator::CrossAssetModelScenarioGenerator(
     for (Size j = 0; j < n_crstates_; ++j) {
         ostringstream numStr;
         numStr << j;
-        crStateKeys_.emplace_back(RiskFactorKey::KeyType::CreditState, numStr.str());
+        crStateKeys_.push_back(keyId(RiskFactorKey::KeyType::CreditState, numStr.str()));
     }
 
     survivalWeightKeys_.reserve(n_survivalweights_);
     for (Size j = 0; j < n_survivalweights_; ++j) {
         string name = simMarketConfig_->additionalScenarioDataSurvivalWeights()[j];
-        survivalWeightKeys_.emplace_back(RiskFactorKey::KeyType::SurvivalWeight, name);
-        recoveryRateKeys_.emplace_back(RiskFactorKey::KeyType::RecoveryRate, name);
+        survivalWeightKeys_.push_back(keyId(RiskFactorKey::KeyType::SurvivalWeight, name));
+        recoveryRateKeys_.push_back(keyId(RiskFactorKey::KeyType::RecoveryRate, name));
         survivalWeightsDefaultCurves_.push_back(*initMarket_->defaultCurve(name, configuration_));
     }
 
@@ -362,7 +370,7 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                 Date d = dates_[i] + ten_dsc_[j][k];
                 Time T = dc.yearFraction(dates_[i], d);
                 Real discount = std::max(curves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(discountCurveKeys_[j * ten_dsc_[j].size() + k], discount);
+                scenarios[i]->addById(discountCurveKeys_[j * ten_dsc_[j].size() + k], discount);
             }
         }
 
@@ -373,7 +381,7 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                 Date d = dates_[i] + ten_idx_[j][k];
                 Time T = dc.yearFraction(dates_[i], d);
                 Real discount = std::max(fwdCurves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(indexCurveKeys_[j * ten_idx_[j].size() + k], discount);
+                scenarios[i]->addById(indexCurveKeys_[j * ten_idx_[j].size() + k], discount);
             }
         }
 
@@ -384,14 +392,14 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                 Date d = dates_[i] + ten_yc_[j][k];
                 Time T = dc.yearFraction(dates_[i], d);
                 Real discount = std::max(yieldCurves_[j]->discount(T), 0.00001);
-                scenarios[i]->add(yieldCurveKeys_[j * ten_yc_[j].size() + k], discount);
+                scenarios[i]->addById(yieldCurveKeys_[j * ten_yc_[j].size() + k], discount);
             }
         }
 
         // FX rates
         for (Size k = 0; k < n_ccy_ - 1; k++) {
             Real fx = std::exp(sample.value[model_->pIdx(CrossAssetModel::AssetType::FX, k)][i + 1]);
-            scenarios[i]->add(fxKeys_[k], fx);
+            scenarios[i]->addById(fxKeys_[k], fx);
         }
 
         // FX vols
@@ -415,7 +423,7 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
         // Equity spots
         for (Size k = 0; k < n_eq_; k++) {
             Real eqSpot = std::exp(sample.value[model_->pIdx(CrossAssetModel::AssetType::EQ, k)][i + 1]);
-            scenarios[i]->add(eqKeys_[k], eqSpot);
+            scenarios[i]->addById(eqKeys_[k], eqSpot);
         }
 
         // Equity vols
@@ -461,7 +469,7 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                 QL_FAIL("CrossAssetModelScenarioGenerator: expected inflation model to be JY or DK.");
             }
 
-            scenarios[i]->add(cpiKeys_[j], cpi);
+            scenarios[i]->addById(cpiKeys_[j], cpi);
         }
 
         // Zero inflation curves
@@ -487,7 +495,7 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
             // Populate the zero inflation scenario values based on the current date and state.
             for (Size k = 0; k < ten_zinf_[j].size(); k++) {
                 Time T = dc.yearFraction(dates_[i], dates_[i] + ten_zinf_[j][k]);
-                scenarios[i]->add(zeroInflationKeys_[j * ten_zinf_[j].size() + k], ts->zeroRate(T));
+                scenarios[i]->addById(zeroInflationKeys_[j * ten_zinf_[j].size() + k], ts->zeroRate(T));
             }
         }
 
@@ -515,7 +523,7 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
             // Use the YoY term structure's YoY rates to populate the scenarios.
             auto yoyRates = ts->yoyRates(pillarDates);
             for (Size k = 0; k < pillarDates.size(); ++k) {
-                scenarios[i]->add(yoyInflationKeys_[j * ten_yinf_[j].size() + k], yoyRates.at(pillarDates[k]));
+                scenarios[i]->addById(yoyInflationKeys_[j * ten_yinf_[j].size() + k], yoyRates.at(pillarDates[k]));
             }
         }
 
@@ -529,7 +537,7 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                     Date d = dates_[i] + ten_dfc_[j][k];
                     Time T = dc.yearFraction(dates_[i], d);
                     Real survProb = std::max(lgmDefaultCurves_[j]->survivalProbability(T), 0.00001);
-                    scenarios[i]->add(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
+                    scenarios[i]->addById(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
                 }
             } else if (model_->modelType(CrossAssetModel::AssetType::CR, j) == CrossAssetModel::ModelType::CIRPP) {
                 Real y = sample.value[model_->pIdx(CrossAssetModel::AssetType::CR, j, 0)][i + 1];
@@ -538,7 +546,7 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                     Date d = dates_[i] + ten_dfc_[j][k];
                     Time T = dc.yearFraction(dates_[i], d);
                     Real survProb = std::max(cirppDefaultCurves_[j]->survivalProbability(T), 0.00001);
-                    scenarios[i]->add(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
+                    scenarios[i]->addById(defaultCurveKeys_[j * ten_dfc_[j].size() + k], survProb);
                 }
             }
         }
@@ -552,14 +560,14 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
                 Date d = dates_[i] + ten_com_[j][k];
                 Time T = dc.yearFraction(dates_[i], d);
                 Real price = std::max(comCurves_[j]->price(T), 0.00001);
-                scenarios[i]->add(commodityCurveKeys_[j * ten_com_[j].size() + k], price);
+                scenarios[i]->addById(commodityCurveKeys_[j * ten_com_[j].size() + k], price);
             }
         }
 
         // Credit States
         for (Size k = 0; k < n_crstates_; ++k) {
             Real z = sample.value[model_->pIdx(CrossAssetModel::AssetType::CrState, k)][i + 1];
-            scenarios[i]->add(crStateKeys_[k], z);
+            scenarios[i]->addById(crStateKeys_[k], z);
         }
 
         // Survival Weights, stochastic cumulative survival probability, Recovery Rates
@@ -568,9 +576,9 @@ std::vector<QuantLib::ext::shared_ptr<Scenario>> CrossAssetModelScenarioGenerato
             Real rr = survivalWeightsDefaultCurves_[k]->recovery().empty()
                           ? 0.0
                           : survivalWeightsDefaultCurves_[k]->recovery()->value();
-            scenarios[i]->add(survivalWeightKeys_[k],
+            scenarios[i]->addById(survivalWeightKeys_[k],
                               survivalWeightsDefaultCurves_[k]->curve()->survivalProbability(dates_[i]));
-            scenarios[i]->add(recoveryRateKeys_[k], rr);
+            scenarios[i]->addById(recoveryRateKeys_[k], rr);
         }
     }
     return scenarios;
@@ -76,6 +76,7 @@ public:
     ~CrossAssetModelScenarioGenerator(){};
     std::vector<QuantLib::ext::shared_ptr<Scenario>> nextPath() override;
     void reset() override { pathGenerator_->reset(); }
+    void skipTo(const Size sample) override { pathGenerator_->skipTo(sample); }
 
 private:
     QuantLib::ext::shared_ptr<QuantExt::CrossAssetModel> model_;
@@ -85,10 +86,11 @@ private:
     QuantLib::ext::shared_ptr<ore::data::Market> initMarket_;
     const std::string configuration_;
     // generated data
-    std::vector<RiskFactorKey> discountCurveKeys_, indexCurveKeys_, yieldCurveKeys_, zeroInflationKeys_,
-        yoyInflationKeys_, defaultCurveKeys_, commodityCurveKeys_;
-    std::vector<RiskFactorKey> fxKeys_, eqKeys_, cpiKeys_;
-    std::vector<RiskFactorKey> crStateKeys_, survivalWeightKeys_, recoveryRateKeys_;
+    // cached keys, stored as RiskFactorKeyRegistry ids
+    std::vector<Size> discountCurveKeys_, indexCurveKeys_, yieldCurveKeys_, zeroInflationKeys_, yoyInflationKeys_,
+        defaultCurveKeys_, commodityCurveKeys_;
+    std::vector<Size> fxKeys_, eqKeys_, cpiKeys_;
+    std::vector<Size> crStateKeys_, survivalWeightKeys_, recoveryRateKeys_;
     std::vector<QuantLib::ext::shared_ptr<QuantExt::CrossAssetModelImpliedFxVolTermStructure>> fxVols_;
     std::vector<QuantLib::ext::shared_ptr<QuantExt::CrossAssetModelImpliedEqVolTermStructure>> eqVols_;
     std::vector<std::vector<Period>> ten_dsc_, ten_idx_, ten_yc_, ten_efc_, ten_zinf_, ten_yinf_, ten_dfc_, ten_com_;
@@ -48,6 +48,20 @@ Real DeltaScenario::get(const ore::analytics::RiskFactorKey& key) const {
     }
 }
 
+void DeltaScenario::addById(const Size keyId, Real value) {
+    QL_REQUIRE(baseScenario_->hasById(keyId), "base scenario must also possess key");
+    if (baseScenario_->getById(keyId) != value)
+        delta_->addById(keyId, value);
+}
+
+Real DeltaScenario::getById(const Size keyId) const {
+    if (delta_->hasById(keyId)) {
+        return delta_->getById(keyId);
+    } else {
+        return baseScenario_->getById(keyId);
+    }
+}
+
 QuantLib::ext::shared_ptr<ore::analytics::Scenario> DeltaScenario::clone() const {
     // NOTE - we are not cloning the base here (is this appropriate?)
     QuantLib::ext::shared_ptr<Scenario> newDelta = delta_->clone();
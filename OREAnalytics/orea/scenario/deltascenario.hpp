@@ -65,6 +65,10 @@ public:
     void add(const ore::analytics::RiskFactorKey& key, Real value) override;
     Real get(const ore::analytics::RiskFactorKey& key) const override;
 
+    bool hasById(const Size keyId) const override { return baseScenario_->hasById(keyId); }
+    void addById(const Size keyId, Real value) override;
+    Real getById(const Size keyId) const override;
+
     bool isAbsolute() const override { return baseScenario_->isAbsolute(); }
     void setAbsolute(const bool b) override { baseScenario_->setAbsolute(b); }
 
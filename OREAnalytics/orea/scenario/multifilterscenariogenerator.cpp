@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <orea/scenario/multifilterscenariogenerator.hpp>
+
+#include <ored/utilities/log.hpp>
+
+namespace ore {
+namespace analytics {
+
+MultiFilterScenarioGenerator::MultiFilterScenarioGenerator(
+    const QuantLib::ext::shared_ptr<ScenarioGenerator>& scenarioGenerator,
+    const QuantLib::ext::shared_ptr<Scenario>& baseScenario,
+    const std::vector<QuantLib::ext::shared_ptr<ScenarioFilter>>& filters)
+    : scenarioGenerator_(scenarioGenerator), baseScenario_(baseScenario), filters_(filters) {
+    QL_REQUIRE(scenarioGenerator_, "MultiFilterScenarioGenerator: no scenario generator given");
+    QL_REQUIRE(baseScenario_, "MultiFilterScenarioGenerator: no base scenario given");
+    QL_REQUIRE(!filters_.empty(), "MultiFilterScenarioGenerator: no filters given");
+}
+
+void MultiFilterScenarioGenerator::updateResetKeys(const std::vector<RiskFactorKey>& keys) {
+    if (!resetKeys_.empty() && keys == keys_)
+        return;
+    keys_ = keys;
+    resetKeys_.assign(filters_.size(), {});
+    for (Size g = 0; g < filters_.size(); ++g) {
+        if (!filters_[g])
+            continue;
+        for (auto const& k : keys_) {
+            if (filters_[g]->allow(k))
+                continue;
+            QL_REQUIRE(baseScenario_->has(k),
+                       "MultiFilterScenarioGenerator: base scenario does not contain key " << k);
+            resetKeys_[g].push_back(std::make_pair(k, baseScenario_->get(k)));
+        }
+    }
+    DLOG("MultiFilterScenarioGenerator: determined keys to reset for " << filters_.size() << " filters and "
+                                                                        << keys_.size() << " scenario keys");
+}
+
+QuantLib::ext::shared_ptr<Scenario> MultiFilterScenarioGenerator::next(const Date& d) {
+    Size g = sample_++ % filters_.size();
+    if (g == 0 || !scenario_) {
+        scenario_ = scenarioGenerator_->next(d);
+        updateResetKeys(scenario_->keys());
+    }
+    if (resetKeys_[g].empty())
+        return scenario_;
+    auto filtered = scenario_->clone();
+    for (auto const& [key, value] : resetKeys_[g])
+        filtered->add(key, value);
+    return filtered;
+}
+
+void MultiFilterScenarioGenerator::reset() {
+    scenarioGenerator_->reset();
+    sample_ = 0;
+    scenario_ = nullptr;
+}
+
+void MultiFilterScenarioGenerator::skipTo(const Size sample) {
+    scenarioGenerator_->skipTo(sample / filters_.size());
+    sample_ = sample;
+    scenario_ = nullptr;
+}
+
+} // namespace analytics
+} // namespace ore
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file orea/scenario/multifilterscenariogenerator.hpp
+    \brief Scenario generator that applies several scenario filters to each scenario of an underlying generator
+    \ingroup scenario
+*/
+
+#pragma once
+
+#include <orea/scenario/scenariogenerator.hpp>
+#include <orea/scenario/scenariosimmarket.hpp>
+
+namespace ore {
+namespace analytics {
+
+//! Scenario generator that applies several scenario filters to each scenario of an underlying generator
+/*! For each scenario of the underlying generator this generator returns one scenario per filter, i.e. sample
+    s * n + g is scenario s of the underlying generator with filter g applied, where n is the number of filters. A filtered
+    scenario has the values of the keys that are not allowed by the filter replaced by the base scenario values, this
+    is equivalent to setting the filter on a ScenarioSimMarket.
+
+    Each scenario of the underlying generator is generated once only. Consecutive filtered scenarios only differ in the
+    keys on which the filters disagree. If the ValuationEngine skips the trades that are not affected by a scenario
+    (see the ValuationEngine constructor), only the trades depending on these keys are repriced, otherwise all trades
+    are repriced for each sample. In a multi-threaded run each thread wraps its own clone of the underlying generator,
+    see MultiThreadedValuationEngine::setScenarioGeneratorWrapper().
+
+    The generator is meant to be used with underlying generators that produce one scenario per sample, like the
+    HistoricalScenarioGenerator.
+
+    \ingroup scenario
+ */
+class MultiFilterScenarioGenerator : public ScenarioGenerator {
+public:
+    /*! A null filter allows all keys. The base scenario must contain all keys that are not allowed by one of the
+        filters. */
+    MultiFilterScenarioGenerator(const QuantLib::ext::shared_ptr<ScenarioGenerator>& scenarioGenerator,
+                                 const QuantLib::ext::shared_ptr<Scenario>& baseScenario,
+                                 const std::vector<QuantLib::ext::shared_ptr<ScenarioFilter>>& filters);
+
+    QuantLib::ext::shared_ptr<Scenario> next(const Date& d) override;
+    void reset() override;
+    void skipTo(const Size sample) override;
+
+    //! Number of filtered scenarios per scenario of the underlying generator
+    Size numFilters() const { return filters_.size(); }
+
+private:
+    void updateResetKeys(const std::vector<RiskFactorKey>& keys);
+
+    QuantLib::ext::shared_ptr<ScenarioGenerator> scenarioGenerator_;
+    QuantLib::ext::shared_ptr<Scenario> baseScenario_;
+    std::vector<QuantLib::ext::shared_ptr<ScenarioFilter>> filters_;
+
+    Size sample_ = 0;
+    QuantLib::ext::shared_ptr<Scenario> scenario_;
+
+    // the scenario keys for which the reset keys were determined
+    std::vector<RiskFactorKey> keys_;
+    // per filter the keys that are not allowed and their base scenario values
+    std::vector<std::vector<std::pair<RiskFactorKey, Real>>> resetKeys_;
+};
+
+} // namespace analytics
+} // namespace ore
@@ -20,6 +20,7 @@
 #include <orea/scenario/scenario.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ql/errors.hpp>
+#include <ql/utilities/null.hpp>
 #include <vector>
 
 using namespace ore::data;
@@ -35,6 +36,69 @@ std::size_t hash_value(const RiskFactorKey& k) {
     return seed;
 }
 
+namespace {
+// Per thread copies of the registry entries looked up so far. Keys are never removed or renumbered, so that an entry
+// never becomes stale, and lookups of keys already seen by a thread do not take the registry lock.
+struct RegistryCache {
+    std::unordered_map<RiskFactorKey, Size, boost::hash<RiskFactorKey>> ids;
+    std::vector<const RiskFactorKey*> keys;
+};
+thread_local RegistryCache registryCache;
+} // namespace
+
+Size RiskFactorKeyRegistry::id(const RiskFactorKey& key) {
+    auto& cache = registryCache.ids;
+    if (auto c = cache.find(key); c != cache.end())
+        return c->second;
+    Size result = QuantLib::Null<Size>();
+    {
+        boost::shared_lock<boost::shared_mutex> lock(mutex_);
+        if (auto i = ids_.find(key); i != ids_.end())
+            result = i->second;
+    }
+    if (result == QuantLib::Null<Size>()) {
+        boost::unique_lock<boost::shared_mutex> lock(mutex_);
+        auto [i, inserted] = ids_.insert(std::make_pair(key, keys_.size()));
+        if (inserted)
+            keys_.push_back(key);
+        result = i->second;
+    }
+    cache.emplace(key, result);
+    return result;
+}
+
+Size RiskFactorKeyRegistry::find(const RiskFactorKey& key) const {
+    auto& cache = registryCache.ids;
+    if (auto c = cache.find(key); c != cache.end())
+        return c->second;
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    auto i = ids_.find(key);
+    if (i == ids_.end())
+        // not cached, the key might be registered later
+        return QuantLib::Null<Size>();
+    cache.emplace(key, i->second);
+    return i->second;
+}
+
+const RiskFactorKey& RiskFactorKeyRegistry::key(const Size id) const {
+    auto& cache = registryCache.keys;
+    if (id < cache.size() && cache[id] != nullptr)
+        return *cache[id];
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    QL_REQUIRE(id < keys_.size(), "RiskFactorKeyRegistry::key(): id " << id << " out of range, there are "
+                                                                       << keys_.size() << " registered keys.");
+    if (id >= cache.size())
+        cache.resize(id + 1, nullptr);
+    // the deque does not move its elements on push_back, so the address stays valid
+    cache[id] = &keys_[id];
+    return keys_[id];
+}
+
+Size RiskFactorKeyRegistry::size() const {
+    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    return keys_.size();
+}
+
 bool Scenario::isCloseEnough(const QuantLib::ext::shared_ptr<Scenario>& s) const {
     return asof() == s->asof() && label() == s->label() && QuantLib::close_enough(getNumeraire(), s->getNumeraire()) &&
            keys() == s->keys() && std::all_of(keys().begin(), keys().end(), [this, s](const RiskFactorKey& k) {
@@ -27,10 +27,13 @@
 
 #include <ql/shared_ptr.hpp>
 #include <ql/math/array.hpp>
+#include <ql/patterns/singleton.hpp>
 #include <ql/time/date.hpp>
 #include <ql/types.hpp>
 
 #include <boost/functional/hash.hpp>
+#include <boost/thread/shared_mutex.hpp>
+#include <deque>
 #include <map>
 #include <unordered_map>
 #include <vector>
@@ -122,6 +125,39 @@ inline bool operator!=(const RiskFactorKey& lhs, const RiskFactorKey& rhs) { ret
 std::ostream& operator<<(std::ostream& out, const RiskFactorKey::KeyType& type);
 std::ostream& operator<<(std::ostream& out, const RiskFactorKey& key);
 
+//! Registry assigning dense integer ids to risk factor keys
+/*! The ids are process wide and stable, i.e. a key gets the same id in all threads for the lifetime of the
+    registry. This allows scenarios, the sim market and the sensitivity cube to store data in flat arrays indexed by
+    the key id instead of in maps ordered by key, and to resolve a key to its id once (e.g. when the keys of a
+    scenario generator are set up) rather than on every access.
+
+    Each thread keeps a cache of the ids and keys it has looked up, so that repeated lookups do not take the registry
+    lock. This relies on keys never being removed from the registry: it is a global singleton that lives until the
+    end of the process and its size is bounded by the number of distinct keys used in the process, typically the keys
+    of the simulation market configurations. The cache of a thread is released when the thread ends.
+
+    \ingroup scenario
+*/
+class RiskFactorKeyRegistry : public QuantLib::Singleton<RiskFactorKeyRegistry, std::integral_constant<bool, true>> {
+    friend class QuantLib::Singleton<RiskFactorKeyRegistry, std::integral_constant<bool, true>>;
+    RiskFactorKeyRegistry() = default;
+
+public:
+    //! Return the id of the key, the key is registered if it is not known yet
+    Size id(const RiskFactorKey& key);
+    //! Return the id of the key or QuantLib::Null<Size>() if the key is not registered
+    Size find(const RiskFactorKey& key) const;
+    //! Return the key with the given id
+    const RiskFactorKey& key(const Size id) const;
+    //! Number of registered keys, all ids are smaller than this
+    Size size() const;
+
+private:
+    mutable boost::shared_mutex mutex_;
+    std::unordered_map<RiskFactorKey, Size, boost::hash<RiskFactorKey>> ids_;
+    std::deque<RiskFactorKey> keys_;
+};
+
 RiskFactorKey::KeyType parseRiskFactorKeyType(const string& str);
 RiskFactorKey parseRiskFactorKey(const string& str);
 
@@ -164,6 +200,12 @@ public:
     //! Get an element from the scenario
     virtual Real get(const RiskFactorKey& key) const = 0;
 
+    /*! Check, add and get an element by the key id from the RiskFactorKeyRegistry. The default implementations
+        forward to the key based methods, derived classes with id based storage should override these. */
+    virtual bool hasById(const Size keyId) const { return has(RiskFactorKeyRegistry::instance().key(keyId)); }
+    virtual void addById(const Size keyId, Real value) { add(RiskFactorKeyRegistry::instance().key(keyId), value); }
+    virtual Real getById(const Size keyId) const { return get(RiskFactorKeyRegistry::instance().key(keyId)); }
+
     //! Is this an absolute or difference scenario?
     virtual bool isAbsolute() const = 0;
     //! Set if this is an absolute scenario
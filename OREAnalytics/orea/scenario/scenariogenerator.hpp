@@ -50,6 +50,14 @@ public:
     //! Reset the generator so calls to next() return the first scenario.
     /*! This allows re-generation of scenarios if required. */
     virtual void reset() = 0;
+
+    //! Position the generator such that the next path is the one with the given (zero based) sample index.
+    /*! This allows to generate a range of samples on a separate generator instance. The default implementation only
+        supports sample 0, i.e. a reset. */
+    virtual void skipTo(const Size sample) {
+        QL_REQUIRE(sample == 0, "ScenarioGenerator::skipTo(" << sample << "): not supported by this generator");
+        reset();
+    }
 };
 
 //! Scenario generator that generates an entire path
@@ -85,6 +93,13 @@ public:
         }
     }
 
+    //! Resets the generator and generates the preceding paths, derived classes may provide a faster skip-ahead
+    virtual void skipTo(const Size sample) override {
+        reset();
+        for (Size i = 0; i < sample; ++i)
+            nextPath();
+    }
+
 protected:
     virtual std::vector<QuantLib::ext::shared_ptr<Scenario>> nextPath() = 0;
 
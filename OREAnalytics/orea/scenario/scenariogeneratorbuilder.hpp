@@ -28,7 +28,7 @@
 #include <ql/types.hpp>
 
 #include <qle/models/crossassetmodel.hpp>
-#include <qle/methods/pathgeneratorfactory.hpp>
+#include <qle/methods/crossassetbatchmultipathgeneratorfactory.hpp>
 
 #include <orea/scenario/crossassetmodelscenariogenerator.hpp>
 #include <orea/scenario/scenariofactory.hpp>
@@ -65,7 +65,8 @@ public:
           QuantLib::ext::shared_ptr<ScenarioSimMarketParameters> marketConfig, Date asof,
           QuantLib::ext::shared_ptr<ore::data::Market> initMarket,
           const std::string& configuration = ore::data::Market::defaultConfiguration,
-          const QuantLib::ext::shared_ptr<PathGeneratorFactory>& pf = QuantLib::ext::make_shared<MultiPathGeneratorFactory>());
+          const QuantLib::ext::shared_ptr<PathGeneratorFactory>& pf =
+              QuantLib::ext::make_shared<CrossAssetBatchMultiPathGeneratorFactory>());
 
 private:
     QuantLib::ext::shared_ptr<ScenarioGeneratorData> data_;
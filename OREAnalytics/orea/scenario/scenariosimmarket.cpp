@@ -239,7 +239,14 @@ void ScenarioSimMarket::writeSimData(std::map<RiskFactorKey, QuantLib::ext::shar
                                      std::map<RiskFactorKey, Real>& absoluteSimDataTmp,
                                      const RiskFactorKey::KeyType keyType, const std::string& name,
                                      const std::vector<std::vector<Real>>& coordinates) {
-    simData_.insert(simDataTmp.begin(), simDataTmp.end());
+    for (auto const& [key, quote] : simDataTmp) {
+        if (simData_.insert(std::make_pair(key, quote)).second) {
+            Size keyId = RiskFactorKeyRegistry::instance().id(key);
+            if (simDataById_.size() <= keyId)
+                simDataById_.resize(keyId + 1);
+            simDataById_[keyId] = quote;
+        }
+    }
     absoluteSimData_.insert(absoluteSimDataTmp.begin(), absoluteSimDataTmp.end());
     coordinatesData_.insert(std::make_tuple(keyType, name, coordinates));
     simDataTmp.clear();
@@ -2963,7 +2970,7 @@ void ScenarioSimMarket::reset() {
     // reset term structures
     applyScenario(baseScenario_);
     // clear delta scenario keys
-    diffToBaseKeys_.clear();
+    diffToBaseKeyIds_.clear();
     // see the comment in update() for why this is necessary...
     if (ObservationMode::instance().mode() == ObservationMode::Mode::Unregister) {
         QuantLib::ext::shared_ptr<QuantLib::Observable> obs = QuantLib::Settings::instance().evaluationDate();
@@ -2977,6 +2984,28 @@ void ScenarioSimMarket::reset() {
 
 void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>& scenario) {
 
+    // write all quote values first and notify the observers of the changed quotes once afterwards, unless the
+    // updates are disabled or deferred already (see ObservationMode)
+
+    bool batch = ObservableSettings::instance().updatesEnabled();
+    if (batch)
+        ObservableSettings::instance().disableUpdates(true);
+    try {
+        applyScenarioImpl(scenario);
+    } catch (...) {
+        if (batch)
+            ObservableSettings::instance().enableUpdates();
+        throw;
+    }
+    if (batch) {
+        ObservableSettings::instance().enableUpdates();
+        ++updateStatistics_.batches;
+    }
+    ++updateStatistics_.scenarios;
+}
+
+void ScenarioSimMarket::applyScenarioImpl(const QuantLib::ext::shared_ptr<Scenario>& scenario) {
+
     currentScenario_ = scenario;
 
     // 1 handle delta scenario
@@ -2987,24 +3016,23 @@ void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>&
         delta scenarios or the base scenario */
 
     if (deltaScenario != nullptr) {
-        for (auto const& key : diffToBaseKeys_) {
-            auto it = simData_.find(key);
-            if (it != simData_.end()) {
-                it->second->setValue(baseScenario_->get(key));
-            }
+        for (auto const keyId : diffToBaseKeyIds_) {
+            setSimDataValue(simDataById_[keyId], baseScenario_->getById(keyId));
         }
-        diffToBaseKeys_.clear();
+        diffToBaseKeyIds_.clear();
         auto delta = deltaScenario->delta();
+        auto simpleDelta = QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(delta);
         bool missingPoint = false;
-        for (auto const& key : delta->keys()) {
-            auto it = simData_.find(key);
-            if (it == simData_.end()) {
+        for (Size i = 0; i < delta->keys().size(); ++i) {
+            auto const& key = delta->keys()[i];
+            Size keyId = simpleDelta ? simpleDelta->keyIds()[i] : RiskFactorKeyRegistry::instance().find(key);
+            if (keyId >= simDataById_.size() || simDataById_[keyId] == nullptr) {
                 ALOG("simulation data point missing for key " << key);
                 missingPoint = true;
             } else {
                 if (filter_->allow(key)) {
-                    it->second->setValue(delta->get(key));
-                    diffToBaseKeys_.insert(key);
+                    setSimDataValue(simDataById_[keyId], simpleDelta ? simpleDelta->data()[i] : delta->getById(keyId));
+                    diffToBaseKeyIds_.push_back(keyId);
                 }
             }
         }
@@ -3052,7 +3080,7 @@ void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>&
             Size i = 0;
             for (auto const& q : s->data()) {
                 if (cachedSimDataActive_[i])
-                    cachedSimData_[i]->setValue(q);
+                    setSimDataValue(cachedSimData_[i], q);
                 ++i;
             }
 
@@ -3063,20 +3091,22 @@ void ScenarioSimMarket::applyScenario(const QuantLib::ext::shared_ptr<Scenario>&
     // 3 all other cases
 
     const vector<RiskFactorKey>& keys = scenario->keys();
+    auto simpleScenario = QuantLib::ext::dynamic_pointer_cast<SimpleScenario>(scenario);
 
     Size count = 0;
-    for (const auto& key : keys) {
+    for (Size i = 0; i < keys.size(); ++i) {
         // Loop through the scenario keys and check which keys are present in simData_,
         // adding to the count when a match is identified
         // Then check that the count=simData_.size - this ensures that simData_ is a valid
         // subset of the scenario - fails is a member of simData is not present in the
         // scenario
-        auto it = simData_.find(key);
-        if (it == simData_.end()) {
-            WLOG("simulation data point missing for key " << key);
+        Size keyId = simpleScenario ? simpleScenario->keyIds()[i] : RiskFactorKeyRegistry::instance().find(keys[i]);
+        if (keyId >= simDataById_.size() || simDataById_[keyId] == nullptr) {
+            WLOG("simulation data point missing for key " << keys[i]);
         } else {
-            if (filter_->allow(key)) {
-                it->second->setValue(scenario->get(key));
+            if (filter_->allow(keys[i])) {
+                setSimDataValue(simDataById_[keyId],
+                                simpleScenario ? simpleScenario->data()[i] : scenario->getById(keyId));
             }
             count++;
         }
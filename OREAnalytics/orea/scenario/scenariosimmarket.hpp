@@ -64,6 +64,10 @@ public:
   instances with identical key structure in their data.
 
   If allowPartialScenarios is true, the check that all simData_ is touched by a scenario is disabled.
+
+  The quotes of a scenario are written with deferred observer notifications, i.e. all quote values are set first and
+  then each observer of the changed quotes is notified once, unless the updates are disabled or deferred already, see
+  ObservationMode. Statistics on the scenario application are available via updateStatistics().
  */
 class ScenarioSimMarket : public analytics::SimMarket {
 public:
@@ -141,8 +145,34 @@ public:
 
     void applyScenario(const QuantLib::ext::shared_ptr<Scenario>& scenario);
 
+    //! Statistics on the scenario application
+    struct UpdateStatistics {
+        //! number of applied scenarios
+        Size scenarios = 0;
+        //! number of applied scenarios, for which the observer notifications were deferred by this instance
+        Size batches = 0;
+        //! number of quote values written
+        Size quoteUpdates = 0;
+        //! number of quote values that changed, each of these notifies the quote's observers
+        Size quoteNotifications = 0;
+    };
+
+    //! Return the statistics on the scenario application since construction or the last resetUpdateStatistics()
+    const UpdateStatistics& updateStatistics() const { return updateStatistics_; }
+    //! Reset the statistics on the scenario application
+    void resetUpdateStatistics() { updateStatistics_ = UpdateStatistics(); }
+
 protected:
-    
+    void applyScenarioImpl(const QuantLib::ext::shared_ptr<Scenario>& scenario);
+
+    // write a value to a sim data quote and update the statistics
+    void setSimDataValue(const QuantLib::ext::shared_ptr<SimpleQuote>& quote, const Real value) {
+        ++updateStatistics_.quoteUpdates;
+        if (!quote->isValid() || quote->value() != value)
+            ++updateStatistics_.quoteNotifications;
+        quote->setValue(value);
+    }
+
 
     void writeSimData(std::map<RiskFactorKey, QuantLib::ext::shared_ptr<SimpleQuote>>& simDataTmp,
                       std::map<RiskFactorKey, Real>& absoluteSimDataTmp, const RiskFactorKey::KeyType keyType,
@@ -170,6 +200,8 @@ protected:
     QuantLib::ext::shared_ptr<ScenarioFilter> filter_;
 
     std::map<RiskFactorKey, QuantLib::ext::shared_ptr<SimpleQuote>> simData_;
+    // the simData_ quotes indexed by RiskFactorKeyRegistry id, null if there is no quote for an id
+    std::vector<QuantLib::ext::shared_ptr<SimpleQuote>> simDataById_;
     QuantLib::ext::shared_ptr<Scenario> baseScenario_;
     QuantLib::ext::shared_ptr<Scenario> baseScenarioAbsolute_;
 
@@ -191,11 +223,13 @@ protected:
     bool allowPartialScenarios_;
     IborFallbackConfig iborFallbackConfig_;
 
-    // for delta scenario application
-    std::set<ore::analytics::RiskFactorKey> diffToBaseKeys_;
+    // for delta scenario application, registry ids of the keys that differ from the base scenario
+    std::vector<Size> diffToBaseKeyIds_;
 
     mutable QuantLib::ext::shared_ptr<Scenario> currentScenario_;
     QuantLib::ext::shared_ptr<Scenario> offsetScenario_;
+
+    UpdateStatistics updateStatistics_;
 };
 } // namespace analytics
 } // namespace ore
@@ -33,16 +33,34 @@ SimpleScenario::SimpleScenario(Date asof, const std::string& label, Real numerai
       label_(label), numeraire_(numeraire) {}
 
 bool SimpleScenario::has(const RiskFactorKey& key) const {
-    return sharedData_->keyIndex.find(key) != sharedData_->keyIndex.end();
+    Size keyId = RiskFactorKeyRegistry::instance().find(key);
+    return keyId != QuantLib::Null<Size>() && hasById(keyId);
 }
 
 void SimpleScenario::add(const RiskFactorKey& key, Real value) {
+    addById(RiskFactorKeyRegistry::instance().id(key), value);
+}
+
+Real SimpleScenario::get(const RiskFactorKey& key) const {
+    Size keyId = RiskFactorKeyRegistry::instance().find(key);
+    auto i = keyId == QuantLib::Null<Size>() ? sharedData_->keyIndex.end() : sharedData_->keyIndex.find(keyId);
+    QL_REQUIRE(i != sharedData_->keyIndex.end(), "SimpleScenario does not provide data for key " << key);
+    return data_[i->second];
+}
+
+bool SimpleScenario::hasById(const Size keyId) const {
+    return sharedData_->keyIndex.find(keyId) != sharedData_->keyIndex.end();
+}
+
+void SimpleScenario::addById(const Size keyId, Real value) {
     Size dataIndex;
-    if (auto i = sharedData_->keyIndex.find(key); i != sharedData_->keyIndex.end()) {
+    if (auto i = sharedData_->keyIndex.find(keyId); i != sharedData_->keyIndex.end()) {
         dataIndex = i->second;
     } else {
-        dataIndex = sharedData_->keyIndex[key] = sharedData_->keys.size();
+        const RiskFactorKey& key = RiskFactorKeyRegistry::instance().key(keyId);
+        dataIndex = sharedData_->keyIndex[keyId] = sharedData_->keys.size();
         sharedData_->keys.push_back(key);
+        sharedData_->keyIds.push_back(keyId);
         boost::hash_combine(sharedData_->keysHash, key);
     }
 
@@ -52,9 +70,10 @@ void SimpleScenario::add(const RiskFactorKey& key, Real value) {
     data_[dataIndex] = value;
 }
 
-Real SimpleScenario::get(const RiskFactorKey& key) const {
-    auto i = sharedData_->keyIndex.find(key);
-    QL_REQUIRE(i != sharedData_->keyIndex.end(), "SimpleScenario does not provide data for key " << key);
+Real SimpleScenario::getById(const Size keyId) const {
+    auto i = sharedData_->keyIndex.find(keyId);
+    QL_REQUIRE(i != sharedData_->keyIndex.end(),
+               "SimpleScenario does not provide data for key " << RiskFactorKeyRegistry::instance().key(keyId));
     return data_[i->second];
 }
 
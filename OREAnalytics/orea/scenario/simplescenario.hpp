@@ -35,7 +35,10 @@ class SimpleScenario : public Scenario {
 public:
     struct SharedData {
         std::vector<RiskFactorKey> keys;
-        std::map<RiskFactorKey, std::size_t> keyIndex;
+        //! the registry ids of the keys, same order as keys
+        std::vector<std::size_t> keyIds;
+        //! the position of a key in keys by its registry id, a hash map since scenarios often hold few keys only
+        std::unordered_map<std::size_t, std::size_t> keyIndex;
         std::map<std::pair<RiskFactorKey::KeyType, std::string>, std::vector<std::vector<Real>>> coordinates;
         std::size_t keysHash = 0;
     };
@@ -67,6 +70,13 @@ public:
     void add(const RiskFactorKey& key, Real value) override;
     Real get(const RiskFactorKey& key) const override;
 
+    bool hasById(const Size keyId) const override;
+    void addById(const Size keyId, Real value) override;
+    Real getById(const Size keyId) const override;
+
+    //! the registry ids of the keys, order is the same as in keys()
+    const std::vector<std::size_t>& keyIds() const { return sharedData_->keyIds; }
+
     //! This does _not_ close the shared data
     QuantLib::ext::shared_ptr<Scenario> clone() const override;
 
@@ -83,6 +83,7 @@ void Crif::insertCrifRecord(const CrifRecord& record, bool aggregateDifferentAmo
 
     if (it == records_.end() && itDiffAmountCcy == diffAmountCurrenciesIndex_.end()) {
         auto recordIt = records_.insert(record);
+        indexCache_.reset();
         diffAmountCurrenciesIndex_[record.getSimmAmountCcyKey()] = &(*(recordIt.first));
         portfolioIds_.insert(record.portfolioId);
         nettingSetDetails_.insert(record.nettingSetDetails);
@@ -98,6 +99,7 @@ void Crif::addSimmParameterRecord(const CrifRecord& record) {
     if (it == records_.end()) {
         CrifRecord newRecord = record;
         records_.insert(newRecord);
+        indexCache_.reset();
         diffAmountCurrenciesIndex_[record.getSimmAmountCcyKey()] = &newRecord;
     } else if (it->riskType == CrifRecord::RiskType::AddOnFixedAmount) {
         updateAmountExistingRecord(it, record);
@@ -151,12 +153,64 @@ void Crif::updateAmountExistingRecord(std::map<CrifRecord::SimmAmountCcyKey, con
         DLOG("Updated net CRIF records: " << *(it->second))
 }
 
+void Crif::clear() {
+    records_.clear();
+    indexCache_.reset();
+}
+
 void Crif::addRecords(const Crif& crif, bool aggregateDifferentAmountCurrencies, bool sortFxVolQualifer) {
     for (const auto& r : crif.records_) {
         addRecord(r, aggregateDifferentAmountCurrencies, sortFxVolQualifer);
     }
 }
 
+void Crif::removeRecord(const CrifRecord& record) {
+    auto it = records_.find(record);
+    QL_REQUIRE(it != records_.end(), "Crif::removeRecord(): record not found: " << record);
+
+    bool erase = record.isSimmParameter() && it->riskType != CrifRecord::RiskType::AddOnFixedAmount;
+    if (!erase) {
+        // an amount is used up if what is left is negligible compared to the amount removed
+        bool subtracted = false, usedUp = true;
+        auto subtract = [&subtracted, &usedUp](QuantLib::Real& amount, QuantLib::Real removed) {
+            amount -= removed;
+            subtracted = true;
+            usedUp = usedUp && QuantLib::close_enough(amount + removed, removed);
+        };
+        if (record.hasAmountUsd() && it->hasAmountUsd())
+            subtract(it->amountUsd, record.amountUsd);
+        if (record.hasAmount() && record.hasAmountCcy() && it->amountCurrency == record.amountCurrency)
+            subtract(it->amount, record.amount);
+        if (record.hasAmountResultCcy() && record.hasResultCcy() && it->resultCurrency == record.resultCurrency)
+            subtract(it->amountResultCcy, record.amountResultCcy);
+        // nothing was changed in this case, so we can fail without leaving the crif in an inconsistent state
+        QL_REQUIRE(subtracted, "Crif::removeRecord(): no amount of record " << record
+                                                                            << " matches the existing record " << *it);
+        erase = usedUp;
+    }
+
+    if (erase) {
+        auto d = diffAmountCurrenciesIndex_.find(it->getSimmAmountCcyKey());
+        if (d != diffAmountCurrenciesIndex_.end() && d->second == &(*it))
+            diffAmountCurrenciesIndex_.erase(d);
+        std::string portfolioId = it->portfolioId;
+        ore::data::NettingSetDetails nettingSetDetails = it->nettingSetDetails;
+        records_.erase(it);
+        indexCache_.reset();
+        // keep the portfolio ids and netting sets consistent with the remaining records
+        if (std::none_of(records_.begin(), records_.end(), [&portfolioId](const CrifRecord& r) {
+                return !r.isSimmParameter() && r.portfolioId == portfolioId;
+            }))
+            portfolioIds_.erase(portfolioId);
+        if (std::none_of(records_.begin(), records_.end(), [&nettingSetDetails](const CrifRecord& r) {
+                return !r.isSimmParameter() && r.nettingSetDetails == nettingSetDetails;
+            }))
+            nettingSetDetails_.erase(nettingSetDetails);
+    } else {
+        DLOG("Updated net CRIF records: " << *it)
+    }
+}
+
 Crif Crif::aggregate() const {
     Crif result;
     for (auto cr : records_) {
@@ -195,10 +249,8 @@ Crif Crif::simmParameters() const {
 //! Find first element
 std::set<CrifRecord>::const_iterator Crif::findBy(const NettingSetDetails nsd, CrifRecord::ProductClass pc,
                                                   const CrifRecord::RiskType rt, const std::string& qualifier) const {
-    return std::find_if(records_.begin(), records_.end(), [&nsd, &pc, &rt, &qualifier](const CrifRecord& record) {
-        return record.nettingSetDetails == nsd && record.productClass == pc && record.riskType == rt &&
-               record.qualifier == qualifier;
-    });
+    auto records = filterByQualifier(nsd, pc, rt, qualifier);
+    return records.empty() ? records_.end() : records_.find(records.front());
 };
 
 Crif Crif::filterNonZeroAmount(double threshold, std::string alwaysIncludeFxRiskCcy) const {
@@ -224,51 +276,83 @@ Crif Crif::filterNonZeroAmount(double threshold, std::string alwaysIncludeFxRisk
     return results;
 }
 
+const Crif::Index& Crif::index() const {
+    std::lock_guard<std::mutex> lock(indexCache_.mutex);
+    if (!indexCache_.index) {
+        auto index = QuantLib::ext::make_shared<Index>();
+        for (const auto& record : records_) {
+            auto& nettingSetIndex = (*index)[record.nettingSetDetails];
+            nettingSetIndex.productClasses.insert(record.productClass);
+            auto& group = nettingSetIndex.groups[std::make_pair(record.productClass, record.riskType)];
+            group.records.push_back(&record);
+            group.byQualifier[record.qualifier].push_back(&record);
+            group.byBucket[record.bucket].push_back(&record);
+            group.byBucketAndQualifier[record.bucket][record.qualifier].push_back(&record);
+        }
+        indexCache_.index = index;
+    }
+    return *indexCache_.index;
+}
+
+const Crif::RecordGroup* Crif::group(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                                     const CrifRecord::RiskType rt) const {
+    const Index& idx = index();
+    auto n = idx.find(nsd);
+    if (n == idx.end())
+        return nullptr;
+    auto g = n->second.groups.find(std::make_pair(pc, rt));
+    return g == n->second.groups.end() ? nullptr : &g->second;
+}
+
 std::set<std::string> Crif::qualifiersBy(const NettingSetDetails nsd, CrifRecord::ProductClass pc,
                                          const CrifRecord::RiskType rt) const {
-    auto res = records_ | boost::adaptors::filtered([&nsd, &pc, &rt](const CrifRecord& record) {
-                   return record.nettingSetDetails == nsd && record.productClass == pc && record.riskType == rt;
-               }) |
-               boost::adaptors::transformed([](const CrifRecord& record) { return record.qualifier; });
-    return boost::copy_range<std::set<std::string>>(res);
+    std::set<std::string> qualifiers;
+    if (auto g = group(nsd, pc, rt)) {
+        for (const auto& [qualifier, _] : g->byQualifier)
+            qualifiers.insert(qualifiers.end(), qualifier);
+    }
+    return qualifiers;
 }
 
-std::vector<CrifRecord> Crif::filterByQualifierAndBucket(const NettingSetDetails& nsd,
-                                                         const CrifRecord::ProductClass pc,
-                                                         const CrifRecord::RiskType rt, const std::string& qualifier,
-                                                         const std::string& bucket) const {
-    return boost::copy_range<std::vector<CrifRecord>>(
-        records_ | boost::adaptors::filtered([&nsd, &pc, &rt, &qualifier, &bucket](const CrifRecord& record) {
-            return record.nettingSetDetails == nsd && record.productClass == pc && record.riskType == rt &&
-                   record.qualifier == qualifier && record.bucket == bucket;
-        }));
+CrifRecordView Crif::filterByQualifierAndBucket(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                                                const CrifRecord::RiskType rt, const std::string& qualifier,
+                                                const std::string& bucket) const {
+    if (auto g = group(nsd, pc, rt)) {
+        auto b = g->byBucketAndQualifier.find(bucket);
+        if (b != g->byBucketAndQualifier.end()) {
+            auto q = b->second.find(qualifier);
+            if (q != b->second.end())
+                return CrifRecordView(q->second);
+        }
+    }
+    return CrifRecordView();
 }
 
-std::vector<CrifRecord> Crif::filterByQualifier(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
-                                                const CrifRecord::RiskType rt, const std::string& qualifier) const {
-
-    return boost::copy_range<std::vector<CrifRecord>>(
-        records_ | boost::adaptors::filtered([&nsd, &pc, &rt, &qualifier](const CrifRecord& record) {
-            return record.nettingSetDetails == nsd && record.productClass == pc && record.riskType == rt &&
-                   record.qualifier == qualifier;
-        }));
+CrifRecordView Crif::filterByQualifier(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                                       const CrifRecord::RiskType rt, const std::string& qualifier) const {
+    if (auto g = group(nsd, pc, rt)) {
+        auto q = g->byQualifier.find(qualifier);
+        if (q != g->byQualifier.end())
+            return CrifRecordView(q->second);
+    }
+    return CrifRecordView();
 }
 
-std::vector<CrifRecord> Crif::filterByBucket(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
-                                             const CrifRecord::RiskType rt, const std::string& bucket) const {
-    return boost::copy_range<std::vector<CrifRecord>>(
-        records_ | boost::adaptors::filtered([&nsd, &pc, &rt, &bucket](const CrifRecord& record) {
-            return record.nettingSetDetails == nsd && record.productClass == pc && record.riskType == rt &&
-                   record.bucket == bucket;
-        }));
+CrifRecordView Crif::filterByBucket(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                                    const CrifRecord::RiskType rt, const std::string& bucket) const {
+    if (auto g = group(nsd, pc, rt)) {
+        auto b = g->byBucket.find(bucket);
+        if (b != g->byBucket.end())
+            return CrifRecordView(b->second);
+    }
+    return CrifRecordView();
 }
 
-std::vector<CrifRecord> Crif::filterBy(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
-                                       const CrifRecord::RiskType rt) const {
-    return boost::copy_range<std::vector<CrifRecord>>(
-        records_ | boost::adaptors::filtered([&nsd, &pc, &rt](const CrifRecord& record) {
-            return record.nettingSetDetails == nsd && record.productClass == pc && record.riskType == rt;
-        }));
+CrifRecordView Crif::filterBy(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                              const CrifRecord::RiskType rt) const {
+    if (auto g = group(nsd, pc, rt))
+        return CrifRecordView(g->records);
+    return CrifRecordView();
 }
 
 std::vector<CrifRecord> Crif::filterBy(const CrifRecord::RiskType rt) const {
@@ -289,7 +373,7 @@ std::set<std::string> Crif::tradeIds() const {
 //! deletes all existing simmParameter and replaces them with the new one
 void Crif::setSimmParameters(const Crif& crif) {
     auto backup = records_;
-    records_.clear();
+    clear();
     for (auto& r : backup) {
         if (!r.isSimmParameter()) {
             addRecord(r);
@@ -304,7 +388,7 @@ void Crif::setSimmParameters(const Crif& crif) {
 
 void Crif::setCrifRecords(const Crif& crif) {
     auto backup = records_;
-    records_.clear();
+    clear();
     for (auto& r : backup) {
         if (r.isSimmParameter()) {
             addRecord(r);
@@ -322,21 +406,14 @@ const std::set<std::string>& Crif::portfolioIds() const { return portfolioIds_;
 const std::set<NettingSetDetails>& Crif::nettingSetDetails() const { return nettingSetDetails_; }
 
 std::set<CrifRecord::ProductClass> Crif::ProductClassesByNettingSetDetails(const NettingSetDetails nsd) const {
-    std::set<CrifRecord::ProductClass> keys;
-    for (const auto& record : records_) {
-        if (record.nettingSetDetails == nsd) {
-            keys.insert(record.productClass);
-        }
-    }
-    return keys;
+    const Index& idx = index();
+    auto n = idx.find(nsd);
+    return n == idx.end() ? std::set<CrifRecord::ProductClass>() : n->second.productClasses;
 }
 
 size_t Crif::countMatching(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
                            const CrifRecord::RiskType rt, const std::string& qualifier) const {
-    return std::count_if(records_.begin(), records_.end(), [&nsd, &pc, &rt, &qualifier](const CrifRecord& record) {
-        return record.nettingSetDetails == nsd && record.productClass == pc && record.riskType == rt &&
-               record.qualifier == qualifier;
-    });
+    return filterByQualifier(nsd, pc, rt, qualifier).size();
 }
 
 bool Crif::hasNettingSetDetails() const {
@@ -375,6 +452,7 @@ void Crif::fillAmountUsd(const QuantLib::ext::shared_ptr<ore::data::Market> mark
         results.insert(cr);
     }
     records_ = results;
+    indexCache_.reset();
 }
 
 } // namespace analytics
@@ -25,6 +25,10 @@
 #include <ored/report/report.hpp>
 #include <ored/marketdata/market.hpp>
 
+#include <boost/iterator/indirect_iterator.hpp>
+
+#include <mutex>
+
 namespace ore {
 namespace analytics {
 
@@ -32,6 +36,29 @@ struct crifRecordIsSimmParameter {
     bool operator()(const CrifRecord& x) { return x.isSimmParameter(); }
 };
 
+//! Read-only view on a group of records held by a Crif
+/*! The view iterates over the records in the order of the underlying Crif. It is invalidated by any change to the
+    set of records in the Crif it was obtained from.
+*/
+class CrifRecordView {
+public:
+    typedef std::vector<const CrifRecord*>::const_iterator pointer_iterator;
+    typedef boost::indirect_iterator<pointer_iterator> const_iterator;
+
+    CrifRecordView() = default;
+    explicit CrifRecordView(const std::vector<const CrifRecord*>& records)
+        : begin_(records.begin()), end_(records.end()) {}
+
+    const_iterator begin() const { return const_iterator(begin_); }
+    const_iterator end() const { return const_iterator(end_); }
+    size_t size() const { return end_ - begin_; }
+    bool empty() const { return begin_ == end_; }
+    const CrifRecord& front() const { return **begin_; }
+
+private:
+    pointer_iterator begin_, end_;
+};
+
 class Crif {
 public:
     enum class CrifType { Empty, Frtb, Simm };
@@ -42,7 +69,13 @@ public:
     void addRecord(const CrifRecord& record, bool aggregateDifferentAmountCurrencies = false, bool sortFxVolQualifer = true);
     void addRecords(const Crif& crif, bool aggregateDifferentAmountCurrencies = false, bool sortFxVolQualfier = true);
 
-    void clear() { records_.clear(); }
+    /*! Remove a record that was added before, i.e. subtract its amounts from the matching record and erase that once
+        nothing is left. SIMM parameters other than fixed amount add-ons are erased directly. Throws if the record is
+        not found or none of its amounts matches the amounts of the existing record.
+    */
+    void removeRecord(const CrifRecord& record);
+
+    void clear();
 
     std::set<CrifRecord>::const_iterator begin() const { return records_.cbegin(); }
     std::set<CrifRecord>::const_iterator end() const { return records_.cend(); }
@@ -97,23 +130,68 @@ public:
     std::set<std::string> qualifiersBy(const NettingSetDetails nsd, CrifRecord::ProductClass pc,
                                        const CrifRecord::RiskType rt) const;
 
-    std::vector<CrifRecord> filterByQualifierAndBucket(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
-                                                       const CrifRecord::RiskType rt, const std::string& qualifier,
-                                                       const std::string& bucket) const;
-    
-    std::vector<CrifRecord> filterByQualifier(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
-                                              const CrifRecord::RiskType rt, const std::string& qualifier) const;
+    /*! The grouped lookups below are served from an index by netting set details, product class, risk type, bucket
+        and qualifier which is built on first use and dropped whenever records are added or removed. They return views
+        on the records held by this Crif, in the same order as iterating over the Crif itself.
+
+        The string fields of the records are not interned. CrifRecord keeps its std::string members, since loaders,
+        reports and the SIMM calculator use them directly, and the index compares the strings only while it is built.
+    */
+    CrifRecordView filterByQualifierAndBucket(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                                              const CrifRecord::RiskType rt, const std::string& qualifier,
+                                              const std::string& bucket) const;
+
+    CrifRecordView filterByQualifier(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                                     const CrifRecord::RiskType rt, const std::string& qualifier) const;
 
-    std::vector<CrifRecord> filterByBucket(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
-                                           const CrifRecord::RiskType rt, const std::string& bucket) const;
+    CrifRecordView filterByBucket(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                                  const CrifRecord::RiskType rt, const std::string& bucket) const;
+
+    CrifRecordView filterBy(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                            const CrifRecord::RiskType rt) const;
 
-    std::vector<CrifRecord> filterBy(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
-                                     const CrifRecord::RiskType rt) const;
     std::vector<CrifRecord> filterBy(const CrifRecord::RiskType rt) const;
     std::vector<CrifRecord> filterByTradeId(const std::string& id) const;
     std::set<std::string> tradeIds() const;
 
 private:
+    typedef std::vector<const CrifRecord*> RecordPointers;
+
+    //! Records for one netting set details, product class and risk type
+    struct RecordGroup {
+        RecordPointers records;
+        std::map<std::string, RecordPointers> byQualifier;
+        std::map<std::string, RecordPointers> byBucket;
+        std::map<std::string, std::map<std::string, RecordPointers>> byBucketAndQualifier;
+    };
+
+    struct NettingSetIndex {
+        std::set<CrifRecord::ProductClass> productClasses;
+        std::map<std::pair<CrifRecord::ProductClass, CrifRecord::RiskType>, RecordGroup> groups;
+    };
+
+    typedef std::map<ore::data::NettingSetDetails, NettingSetIndex> Index;
+
+    //! Lazily built index, a copy of a Crif starts without one since the index points into the records
+    struct IndexCache {
+        IndexCache() = default;
+        IndexCache(const IndexCache&) {}
+        IndexCache& operator=(const IndexCache&) {
+            reset();
+            return *this;
+        }
+        void reset() {
+            std::lock_guard<std::mutex> lock(mutex);
+            index.reset();
+        }
+        std::mutex mutex;
+        QuantLib::ext::shared_ptr<const Index> index;
+    };
+
+    const Index& index() const;
+    const RecordGroup* group(const NettingSetDetails& nsd, const CrifRecord::ProductClass pc,
+                             const CrifRecord::RiskType rt) const;
+
     void insertCrifRecord(const CrifRecord& record, bool aggregateDifferentAmountCurrencies = false);
     void addFrtbCrifRecord(const CrifRecord& record, bool aggregateDifferentAmountCurrencies = false, bool sortFxVolQualifer =true);
     void addSimmCrifRecord(const CrifRecord& record, bool aggregateDifferentAmountCurrencies = false, bool sortFxVolQualifer =true);
@@ -130,7 +208,8 @@ private:
     //! Set of portfolio IDs that have been loaded
     std::set<std::string> portfolioIds_;
     std::set<ore::data::NettingSetDetails> nettingSetDetails_;
-    
+
+    mutable IndexCache indexCache_;
 };
 
 
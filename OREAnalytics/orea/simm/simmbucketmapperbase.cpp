@@ -87,8 +87,11 @@ QuantLib::Date BucketMapping::validFromDate() const {
 string SimmBucketMapperBase::bucket(const RiskType& riskType, const string& qualifier) const {
 
     auto key = std::make_pair(riskType, qualifier);
-    if (auto b = cache_.find(key); b != cache_.end())
-        return b->second;
+    {
+        std::shared_lock<std::shared_mutex> lock(cacheMutex_);
+        if (auto b = cache_.find(key); b != cache_.end())
+            return b->second;
+    }
 
     QL_REQUIRE(hasBuckets(riskType), "The risk type " << riskType << " does not have buckets");
 
@@ -102,7 +105,7 @@ string SimmBucketMapperBase::bucket(const RiskType& riskType, const string& qual
     // Deal with RiskType::IRCurve
     if (lookupRiskType == RiskType::IRCurve || lookupRiskType == RiskType::GIRR_DELTA) {
         auto tmp = irBucket(qualifier);
-        cache_[key] = tmp;
+        cacheBucket(key, tmp);
         return tmp;
     }
 
@@ -167,7 +170,10 @@ string SimmBucketMapperBase::bucket(const RiskType& riskType, const string& qual
         fm.lookupName = lookupName;
         fm.riskType = riskType;
         fm.lookupRiskType = lookupRiskType;
-        failedMappings_.insert(fm);
+        {
+            std::unique_lock<std::shared_mutex> lock(cacheMutex_);
+            failedMappings_.insert(fm);
+        }
 
     } else {
         // We may have several mappings per qualifier, pick the first valid one that matches the fallback flag
@@ -175,7 +181,7 @@ string SimmBucketMapperBase::bucket(const RiskType& riskType, const string& qual
         for (auto m : bucketMapping_.at(lookupRiskType).at(lookupName)) {
             if (m.validToDate() >= today && m.validFromDate() <= today && m.fallback() == !haveMapping) {
                 bucket = m.bucket();
-                cache_[key] = bucket;
+                cacheBucket(key, bucket);
                 return bucket;
             }
         }
@@ -183,10 +189,15 @@ string SimmBucketMapperBase::bucket(const RiskType& riskType, const string& qual
         bucket = "Residual";
     }
 
-    cache_[key] = bucket;
+    cacheBucket(key, bucket);
     return bucket;
 }
 
+void SimmBucketMapperBase::cacheBucket(const std::pair<RiskType, string>& key, const string& bucket) const {
+    std::unique_lock<std::shared_mutex> lock(cacheMutex_);
+    cache_[key] = bucket;
+}
+
 bool SimmBucketMapperBase::hasBuckets(const RiskType& riskType) const { return rtWithBuckets_.count(riskType) > 0; }
 
 bool SimmBucketMapperBase::has(const RiskType& riskType, const string& qualifier,
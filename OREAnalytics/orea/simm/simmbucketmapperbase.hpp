@@ -30,6 +30,7 @@
 
 #include <map>
 #include <set>
+#include <shared_mutex>
 #include <string>
 
 namespace ore {
@@ -117,6 +118,12 @@ protected:
 private:
     mutable std::map<std::pair<CrifRecord::RiskType, std::string>, std::string> cache_;
 
+    //! Guards cache_ and failedMappings_, bucket() may be called concurrently by the SIMM calculator
+    mutable std::shared_mutex cacheMutex_;
+
+    //! Store the bucket for the given key in the cache
+    void cacheBucket(const std::pair<CrifRecord::RiskType, std::string>& key, const std::string& bucket) const;
+
     //! Reset the SIMM bucket mapper i.e. clears all mappings and adds the initial hard-coded commodity mappings
     void reset();
 
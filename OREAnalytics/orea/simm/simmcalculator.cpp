@@ -26,10 +26,12 @@
 #include <numeric>
 #include <ored/portfolio/structuredtradewarning.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/parallelfor.hpp>
 #include <ored/utilities/to_string.hpp>
 #include <ored/utilities/parsers.hpp>
 #include <ql/math/comparison.hpp>
 #include <ql/quote.hpp>
+#include <ql/settings.hpp>
 
 using std::abs;
 using std::accumulate;
@@ -49,7 +51,11 @@ using ore::data::Market;
 using ore::data::to_string;
 using ore::data::parseBool;
 using QuantLib::close_enough;
+using QuantLib::Date;
+using QuantLib::Null;
 using QuantLib::Real;
+using QuantLib::Settings;
+using QuantLib::Size;
 
 namespace ore {
 namespace analytics {
@@ -68,10 +74,11 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
                                const string& resultCcy, const QuantLib::ext::shared_ptr<Market> market,
                                const bool determineWinningRegulations, const bool enforceIMRegulations,
                                const bool quiet, const map<SimmSide, set<NettingSetDetails>>& hasSEC,
-                               const map<SimmSide, set<NettingSetDetails>>& hasCFTC)
+                               const map<SimmSide, set<NettingSetDetails>>& hasCFTC, const Size nThreads)
     : simmConfiguration_(simmConfiguration), calculationCcyCall_(calculationCcyCall),
       calculationCcyPost_(calculationCcyPost), resultCcy_(resultCcy.empty() ? calculationCcyCall_ : resultCcy),
-      market_(market), quiet_(quiet), hasSEC_(hasSEC), hasCFTC_(hasCFTC) {
+      market_(market), quiet_(quiet), hasSEC_(hasSEC), hasCFTC_(hasCFTC), nThreads_(std::max<Size>(nThreads, 1)),
+      determineWinningRegulations_(determineWinningRegulations), enforceIMRegulations_(enforceIMRegulations) {
 
     QL_REQUIRE(checkCurrency(calculationCcyCall_), "SIMM Calculator: The Call side calculation currency ("
                                                    << calculationCcyCall_ << ") must be a valid ISO currency code");
@@ -81,63 +88,136 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
                "SIMM Calculator: The result currency (" << resultCcy_ << ") must be a valid ISO currency code");
 
     for (const CrifRecord& cr : crif) {
-        // Remove empty
-        if (cr.riskType == CrifRecord::RiskType::Empty) {
+        CrifRecord newCrifRecord;
+        if (prepareCrifRecord(cr, newCrifRecord))
+            crifs_[newCrifRecord.nettingSetDetails].addRecord(newCrifRecord);
+    }
+
+    // If there are no CRIF records to process
+    if (crifs_.empty())
+        return;
+
+    set<NettingSetDetails> nettingSets;
+    for (const auto& [nsd, _] : crifs_)
+        nettingSets.insert(nettingSets.end(), nsd);
+    calculate(nettingSets);
+}
+
+void SimmCalculator::update(const Crif& added, const Crif& removed) {
+
+    // Apply the delta to the CRIF records of the netting sets it touches
+    set<NettingSetDetails> nettingSets;
+    for (const CrifRecord& cr : removed) {
+        CrifRecord newCrifRecord;
+        if (!prepareCrifRecord(cr, newCrifRecord))
             continue;
-        }
-        // Remove Schedule-only CRIF records
-        const bool isSchedule = cr.imModel == "Schedule";
-        if (isSchedule) {
-            if (!quiet_ && determineWinningRegulations) {
-                ore::data::StructuredTradeWarningMessage(cr.tradeId, cr.tradeType, "SIMM calculator", "Skipping over Schedule CRIF record").log();
-            } 
+        auto c = crifs_.find(newCrifRecord.nettingSetDetails);
+        QL_REQUIRE(c != crifs_.end(), "SimmCalculator::update(): Can not remove CRIF record, netting set ["
+                                          << newCrifRecord.nettingSetDetails << "] not found: " << cr);
+        c->second.removeRecord(newCrifRecord);
+        nettingSets.insert(newCrifRecord.nettingSetDetails);
+    }
+    for (const CrifRecord& cr : added) {
+        CrifRecord newCrifRecord;
+        if (!prepareCrifRecord(cr, newCrifRecord))
             continue;
-        }
-
+        crifs_[newCrifRecord.nettingSetDetails].addRecord(newCrifRecord);
+        nettingSets.insert(newCrifRecord.nettingSetDetails);
+    }
 
+    if (!quiet_) {
+        LOG("SimmCalculator: Updating SIMM for " << nettingSets.size() << " out of " << crifs_.size()
+                                                 << " netting sets");
+    }
 
-        // Check for each netting set whether post/collect regs are populated at all
-        if (collectRegsIsEmpty_.find(cr.nettingSetDetails) == collectRegsIsEmpty_.end()) {
-            collectRegsIsEmpty_[cr.nettingSetDetails] = cr.collectRegulations.empty();
-        } else if (collectRegsIsEmpty_.at(cr.nettingSetDetails) && !cr.collectRegulations.empty()) {
-            collectRegsIsEmpty_.at(cr.nettingSetDetails) = false;
-        }
-        if (postRegsIsEmpty_.find(cr.nettingSetDetails) == postRegsIsEmpty_.end()) {
-            postRegsIsEmpty_[cr.nettingSetDetails] = cr.postRegulations.empty();
-        } else if (postRegsIsEmpty_.at(cr.nettingSetDetails) && !cr.postRegulations.empty()) {
-            postRegsIsEmpty_.at(cr.nettingSetDetails) = false;
+    // If the winning regulations are not determined here, they were given to populateFinalResults() by the caller,
+    // in this case we keep them and repopulate the final results after the recalculation
+    bool repopulateFinalResults = !determineWinningRegulations_ && !winningRegulations_.empty();
+
+    // Drop everything we derived for these netting sets before, and netting sets without any records left
+    for (const auto& nsd : nettingSets) {
+        for (auto side : {SimmSide::Call, SimmSide::Post}) {
+            regSensitivities_[side].erase(nsd);
+            regSimmParameters_[side].erase(nsd);
+            tradeIds_[side].erase(nsd);
+            simmResults_[side].erase(nsd);
+            if (determineWinningRegulations_)
+                winningRegulations_[side].erase(nsd);
+            finalSimmResults_[side].erase(nsd);
         }
+        collectRegsIsEmpty_.erase(nsd);
+        postRegsIsEmpty_.erase(nsd);
+        if (auto c = crifs_.find(nsd); c != crifs_.end() && c->second.empty())
+            crifs_.erase(c);
+    }
+    for (auto it = nettingSets.begin(); it != nettingSets.end();) {
+        if (crifs_.find(*it) == crifs_.end())
+            it = nettingSets.erase(it);
+        else
+            ++it;
+    }
 
-        // Make sure we have CRIF amount denominated in the result ccy
-        CrifRecord newCrifRecord = cr;
-        
-        if (cr.requiresAmountUsd() && resultCcy_ == "USD" && cr.hasAmountUsd()) {
-            newCrifRecord.amountResultCcy = newCrifRecord.amountUsd;
-        } else if(cr.requiresAmountUsd()) {
-            // ProductClassMultiplier and AddOnNotionalFactor  don't have a currency and dont need to be converted,
-            // we use the amount
-            const Real fxSpot = market_->fxRate(newCrifRecord.amountCurrency + resultCcy_)->value();
-            newCrifRecord.amountResultCcy = fxSpot * newCrifRecord.amount;
-        }
-        newCrifRecord.resultCurrency = resultCcy_;
+    calculate(nettingSets);
+
+    if (repopulateFinalResults)
+        populateFinalResults();
+}
 
-        crif_.addRecord(newCrifRecord);
+bool SimmCalculator::prepareCrifRecord(const CrifRecord& cr, CrifRecord& newCrifRecord) const {
+    // Remove empty
+    if (cr.riskType == CrifRecord::RiskType::Empty) {
+        return false;
+    }
+    // Remove Schedule-only CRIF records
+    const bool isSchedule = cr.imModel == "Schedule";
+    if (isSchedule) {
+        if (!quiet_ && determineWinningRegulations_) {
+            ore::data::StructuredTradeWarningMessage(cr.tradeId, cr.tradeType, "SIMM calculator", "Skipping over Schedule CRIF record").log();
+        } 
+        return false;
     }
 
-    // If there are no CRIF records to process
-    if (crif_.empty())
-        return;
+    // Make sure we have CRIF amount denominated in the result ccy
+    newCrifRecord = cr;
+    
+    if (cr.requiresAmountUsd() && resultCcy_ == "USD" && cr.hasAmountUsd()) {
+        newCrifRecord.amountResultCcy = newCrifRecord.amountUsd;
+    } else if(cr.requiresAmountUsd()) {
+        // ProductClassMultiplier and AddOnNotionalFactor  don't have a currency and dont need to be converted,
+        // we use the amount
+        const Real fxSpot = market_->fxRate(newCrifRecord.amountCurrency + resultCcy_)->value();
+        newCrifRecord.amountResultCcy = fxSpot * newCrifRecord.amount;
+    }
+    newCrifRecord.resultCurrency = resultCcy_;
+    return true;
+}
+
+void SimmCalculator::calculate(const set<NettingSetDetails>& nettingSets) {
+
+    // Check for each netting set whether post/collect regs are populated at all
+    for (const auto& nsd : nettingSets) {
+        bool collectRegsIsEmpty = true, postRegsIsEmpty = true;
+        for (const auto& cr : crifs_.at(nsd)) {
+            collectRegsIsEmpty = collectRegsIsEmpty && cr.collectRegulations.empty();
+            postRegsIsEmpty = postRegsIsEmpty && cr.postRegulations.empty();
+        }
+        collectRegsIsEmpty_[nsd] = collectRegsIsEmpty;
+        postRegsIsEmpty_[nsd] = postRegsIsEmpty;
+    }
 
     // Add CRIF records to each regulation under each netting set
     if (!quiet_) {
         LOG("SimmCalculator: Splitting up original CRIF records into their respective collect/post regulations");
     }
     
-    splitCrifByRegulationsAndPortfolios(crif_, enforceIMRegulations);
+    for (const auto& nsd : nettingSets)
+        splitCrifByRegulationsAndPortfolios(crifs_.at(nsd), enforceIMRegulations_);
 
     // Some additional processing depending on the regulations applicable to each netting set
     for (auto& [side, nettingsSetCrifMap] : regSensitivities_) {
         for (auto& [nettingDetails, regulationCrifMap] : nettingsSetCrifMap) {
+            if (nettingSets.find(nettingDetails) == nettingSets.end())
+                continue;
             // Where there is SEC and CFTC in the portfolio, we add the CFTC trades to SEC,
             // but still continue with CFTC calculations
             const bool hasCFTCGlobal = hasCFTC_[side].find(nettingDetails) != hasCFTC_[side].end();
@@ -185,10 +265,19 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
         }
     }
 
-    // Calculate SIMM call and post for each regulation under each netting set
+    // Collect the side-nettingSet-regulation combinations for which SIMM is calculated
+    struct RegulationSimmJob {
+        SimmSide side;
+        const NettingSetDetails* nsd;
+        const string* regulation;
+        const Crif* crif;
+        std::vector<CrifRecord>* simmParameters;
+    };
+    std::vector<RegulationSimmJob> jobs;
     for (const auto& [side, nettingSetRegulationCrifMap] : regSensitivities_) {
         for (const auto& [nsd, regulationCrifMap] : nettingSetRegulationCrifMap) {
-            // Calculate SIMM for particular side-nettingSet-regulation combination
+            if (nettingSets.find(nsd) == nettingSets.end())
+                continue;
             for (const auto& [regulation, crif] : regulationCrifMap) {
                 bool hasFixedAddOn = false;
                 for (const auto& sp : crif) {
@@ -198,22 +287,76 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
                     }
                 }
                 if (crif.hasCrifRecords() || hasFixedAddOn)
-                    calculateRegulationSimm(crif, nsd, regulation, side);
+                    jobs.push_back({side, &nsd, &regulation, &crif, &regSimmParameters_[side][nsd][regulation]});
+            }
+        }
+    }
+
+    // Calculate SIMM call and post for each regulation under each netting set. The combinations are independent, so
+    // they can be calculated concurrently. Each job writes to its own results container, created up front, and
+    // collects the SIMM parameters it uses. These are added to simmParameters_ in a fixed order afterwards, so that
+    // the results do not depend on the number of threads.
+    Size nThreads = std::min(nThreads_, jobs.size());
+#ifndef QL_ENABLE_SESSIONS
+    // without sessions the worker threads would share the global evaluation date, so we run sequentially
+    if (nThreads > 1) {
+        if (!quiet_) {
+            WLOG("SimmCalculator: nThreads = " << nThreads_
+                                               << " requires a build with QL_ENABLE_SESSIONS = ON, calculate SIMM "
+                                                  "sequentially.");
+        }
+        nThreads = 1;
+    }
+#endif
+    if (nThreads > 1) {
+        if (!quiet_) {
+            LOG("SimmCalculator: Calculating SIMM for " << jobs.size() << " side-nettingSet-regulation combinations on "
+                                                        << nThreads << " threads");
+        }
+        for (const auto& job : jobs)
+            simmResults_[job.side][*job.nsd][*job.regulation];
+        if (resultCcy_ != "USD")
+            usdSpot_ = market_->fxRate("USD" + resultCcy_)->value();
+        // each worker thread has its own session, set the evaluation date of the calling thread there
+        std::function<void()> initWorker;
+#ifdef QL_ENABLE_SESSIONS
+        Date today = Settings::instance().evaluationDate();
+        initWorker = [today]() { Settings::instance().evaluationDate() = today; };
+#endif
+        ore::data::parallelFor(
+            jobs.size(), nThreads,
+            [this, &jobs](Size k) {
+                auto& job = jobs[k];
+                calculateRegulationSimm(*job.crif, *job.nsd, *job.regulation, job.side, *job.simmParameters);
+            },
+            initWorker);
+    } else {
+        for (auto& job : jobs)
+            calculateRegulationSimm(*job.crif, *job.nsd, *job.regulation, job.side, *job.simmParameters);
+    }
+    simmParameters_.clear();
+    for (const auto& [side, nettingSetParameters] : regSimmParameters_) {
+        for (const auto& [nsd, regulationParameters] : nettingSetParameters) {
+            for (const auto& [regulation, parameters] : regulationParameters) {
+                for (const auto& sp : parameters)
+                    simmParameters_.addRecord(sp);
             }
         }
     }
 
     // Determine winning call and post regulations
-    if (determineWinningRegulations) {
+    if (determineWinningRegulations_) {
         if (!quiet_) {
             LOG("SimmCalculator: Determining winning regulations");
         }
 
-        for (auto sv : simmResults_) {
+        for (const auto& sv : simmResults_) {
             const SimmSide side = sv.first;
 
             // Determine winning (call and post) regulation for each netting set
             for (const auto& kv : sv.second) {
+                if (nettingSets.find(kv.first) == nettingSets.end())
+                    continue;
 
                 // Collect margin amounts and determine the highest margin amount
                 Real winningMargin = std::numeric_limits<Real>::min();
@@ -251,6 +394,16 @@ SimmCalculator::SimmCalculator(const ore::analytics::Crif& crif,
 const void SimmCalculator::calculateRegulationSimm(const Crif& crif,
                                                    const NettingSetDetails& nettingSetDetails, const string& regulation,
                                                    const SimmSide& side) {
+    auto& simmParameters = regSimmParameters_[side][nettingSetDetails][regulation];
+    Size n = simmParameters.size();
+    calculateRegulationSimm(crif, nettingSetDetails, regulation, side, simmParameters);
+    for (Size i = n; i < simmParameters.size(); ++i)
+        simmParameters_.addRecord(simmParameters[i]);
+}
+
+void SimmCalculator::calculateRegulationSimm(const Crif& crif, const NettingSetDetails& nettingSetDetails,
+                                             const string& regulation, const SimmSide& side,
+                                             std::vector<CrifRecord>& simmParameters) {
 
     if (!quiet_) {
         LOG("SimmCalculator: Calculating SIMM " << side << " for portfolio [" << nettingSetDetails << "], regulation "
@@ -373,7 +526,7 @@ const void SimmCalculator::calculateRegulationSimm(const Crif& crif,
     populateResults(side, nettingSetDetails, regulation);
 
     // For each portfolio, calculate the additional margin
-    calcAddMargin(side, nettingSetDetails, regulation, crif);
+    calcAddMargin(side, nettingSetDetails, regulation, crif, simmParameters);
 }
 
 const string& SimmCalculator::winningRegulations(const SimmSide& side, const NettingSetDetails& nettingSetDetails) const {
@@ -473,19 +626,19 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
         auto pIrQualifier =
             crif.filterByQualifier(nettingSetDetails, pc, RiskType::IRCurve, qualifier);
 
-        // Iterator to Xccy basis element with current qualifier (expect zero or one element)
-        auto XccyCount = crif.countMatching(nettingSetDetails, pc, RiskType::XCcyBasis, qualifier);
-        QL_REQUIRE(XccyCount < 2, "SIMM Calcuator: Expected either 0 or 1 elements for risk type "
-                                      << RiskType::XCcyBasis << " and qualifier " << qualifier << " but got "
-                                      << XccyCount);
-        auto itXccy = crif.findBy(nettingSetDetails, pc, RiskType::XCcyBasis, qualifier);
+        // Xccy basis element with current qualifier (expect zero or one element)
+        auto pXccy = crif.filterByQualifier(nettingSetDetails, pc, RiskType::XCcyBasis, qualifier);
+        QL_REQUIRE(pXccy.size() < 2, "SIMM Calcuator: Expected either 0 or 1 elements for risk type "
+                                         << RiskType::XCcyBasis << " and qualifier " << qualifier << " but got "
+                                         << pXccy.size());
+        const CrifRecord* itXccy = pXccy.empty() ? nullptr : &pXccy.front();
 
-        // Iterator to inflation element with current qualifier (expect zero or one element)
-        auto inflationCount = crif.countMatching(nettingSetDetails, pc, RiskType::Inflation, qualifier);
-        QL_REQUIRE(inflationCount < 2, "SIMM Calculator: Expected either 0 or 1 elements for risk type "
-                                           << RiskType::Inflation << " and qualifier " << qualifier << " but got "
-                                           << inflationCount);
-        auto itInflation = crif.findBy(nettingSetDetails, pc, RiskType::Inflation, qualifier);
+        // Inflation element with current qualifier (expect zero or one element)
+        auto pInflation = crif.filterByQualifier(nettingSetDetails, pc, RiskType::Inflation, qualifier);
+        QL_REQUIRE(pInflation.size() < 2, "SIMM Calculator: Expected either 0 or 1 elements for risk type "
+                                              << RiskType::Inflation << " and qualifier " << qualifier << " but got "
+                                              << pInflation.size());
+        const CrifRecord* itInflation = pInflation.empty() ? nullptr : &pInflation.front();
 
         // One pass to get the concentration risk for this qualifier
         // Note: XccyBasis is not included in the calculation of concentration risk and the XccyBasis sensitivity
@@ -494,13 +647,13 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
             concentrationRisk[qualifier] += it.amountResultCcy;
         }
         // Add inflation sensitivity to the concentration risk
-        if (itInflation != crif.end()){
+        if (itInflation){
             concentrationRisk[qualifier] += itInflation->amountResultCcy;
         }
         // Divide by the concentration risk threshold
         Real concThreshold = simmConfiguration_->concentrationThreshold(RiskType::IRCurve, qualifier);
         if (resultCcy_ != "USD")
-            concThreshold *= market_->fxRate("USD" + resultCcy_)->value();
+            concThreshold *= usdSpot();
         concentrationRisk[qualifier] /= concThreshold;
         // Final concentration risk amount
         concentrationRisk[qualifier] = max(1.0, sqrt(std::abs(concentrationRisk[qualifier])));
@@ -532,7 +685,7 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
 
         // Add the Inflation component, if any
         Real wsInflation = 0.0;
-        if (itInflation != crif.end()) {
+        if (itInflation) {
             // Risk weight
             Real rwInflation = simmConfiguration_->weight(RiskType::Inflation, qualifier, itInflation->label1);
             // Weighted sensitivity
@@ -554,7 +707,7 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
         }
 
         // Add the XccyBasis component, if any
-        if (itXccy != crif.end()) {
+        if (itXccy) {
             // Risk weight
             Real rwXccy = simmConfiguration_->weight(RiskType::XCcyBasis, qualifier, itXccy->label1);
             // Weighted sensitivity (no concentration risk here)
@@ -575,7 +728,7 @@ pair<map<string, Real>, bool> SimmCalculator::irDeltaMargin(const NettingSetDeta
             }
 
             // Inflation vs. XccyBasis cross component if any
-            if (itInflation != crif.end()) {
+            if (itInflation) {
                 // Correlation (know that Label1 and Label2 do not matter)
                 Real corr = simmConfiguration_->correlation(RiskType::Inflation, qualifier, "", "", RiskType::XCcyBasis,
                                                             qualifier, "", "");
@@ -655,7 +808,7 @@ pair<map<string, Real>, bool> SimmCalculator::irVegaMargin(const NettingSetDetai
         // Divide by the concentration risk threshold
         Real concThreshold = simmConfiguration_->concentrationThreshold(RiskType::IRVol, qualifier);
         if (resultCcy_ != "USD")
-            concThreshold *= market_->fxRate("USD" + resultCcy_)->value();
+            concThreshold *= usdSpot();
         concentrationRisk[qualifier] /= concThreshold;
 
         // Final concentration risk amount
@@ -897,16 +1050,10 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
 
     bool riskClassIsFX = rt == RiskType::FX || rt == RiskType::FXVol;
 
-    // precomputed
-    map<std::pair<std::string,std::string>, std::vector<CrifRecord>> crifByQualifierAndBucket;
-    map<std::string, std::vector<CrifRecord>> crifByBucket;
-
     // Find the set of buckets and associated qualifiers for the netting set details, product class and risk type
     map<string, set<string>> buckets;
     for(const auto& it : crif.filterBy(nettingSetDetails, pc, rt)) {
         buckets[it.bucket].insert(it.qualifier);
-        crifByQualifierAndBucket[std::make_pair(it.qualifier,it.bucket)].push_back(it);
-        crifByBucket[it.bucket].push_back(it);
     }
 
     // If there are no buckets, return early and set bool to false to indicate margin does not apply
@@ -945,7 +1092,7 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
             }
 
             // Pair of iterators to start and end of sensitivities with current qualifier
-            auto pQualifier = crifByQualifierAndBucket[std::make_pair(qualifier,bucket)];
+            auto pQualifier = crif.filterByQualifierAndBucket(nettingSetDetails, pc, rt, qualifier, bucket);
 
             // One pass to get the concentration risk for this qualifier
             for (auto it = pQualifier.begin(); it != pQualifier.end(); ++it) {
@@ -956,7 +1103,7 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
             // Divide by the concentration risk threshold
             Real concThreshold = simmConfiguration_->concentrationThreshold(rt, qualifier);
             if (resultCcy_ != "USD")
-                concThreshold *= market_->fxRate("USD" + resultCcy_)->value();
+                concThreshold *= usdSpot();
             concentrationRisk[qualifier] /= concThreshold;
             // Final concentration risk amount
             concentrationRisk[qualifier] = max(1.0, sqrt(std::abs(concentrationRisk[qualifier])));
@@ -965,7 +1112,7 @@ pair<map<string, Real>, bool> SimmCalculator::margin(const NettingSetDetails& ne
 
         // Calculate the margin component for the current bucket
         // Pair of iterators to start and end of sensitivities within current bucket
-        auto pBucket = crifByBucket[bucket];
+        auto pBucket = crif.filterByBucket(nettingSetDetails, pc, rt, bucket);
         for (auto itOuter = pBucket.begin(); itOuter != pBucket.end(); ++itOuter) {
             // Do not include Risk_FX components in the calculation currency in the SIMM calculation
             if (rt == RiskType::FX && itOuter->qualifier == calcCcy) {
@@ -1234,10 +1381,11 @@ SimmCalculator::curvatureMargin(const NettingSetDetails& nettingSetDetails, cons
 }
 
 void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails& nettingSetDetails,
-                                   const string& regulation, const Crif& crif) {
+                                   const string& regulation, const Crif& crif,
+                                   std::vector<CrifRecord>& simmParameters) {
 
     // Reference to SIMM results for this portfolio
-    auto& results = simmResults_[side][nettingSetDetails][regulation];
+    auto& results = resultsContainer(side, nettingSetDetails, regulation);
 
     const bool overwrite = false;
 
@@ -1277,7 +1425,7 @@ void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails
                 spRecord.collectRegulations = regulation;
             else
                 spRecord.postRegulations = regulation;
-            simmParameters_.addRecord(spRecord);
+            simmParameters.push_back(spRecord);
         }
     }
 
@@ -1303,7 +1451,7 @@ void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails
             spRecord.collectRegulations = regulation;
         else
             spRecord.postRegulations = regulation;
-        simmParameters_.addRecord(spRecord);
+        simmParameters.push_back(spRecord);
     }
 
     // Third, add percentage of notional amounts IM, using "AddOnNotionalFactor"
@@ -1343,7 +1491,7 @@ void SimmCalculator::calcAddMargin(const SimmSide& side, const NettingSetDetails
                 spRecord.collectRegulations = regulation;
             else
                 spRecord.postRegulations = regulation;
-            simmParameters_.addRecord(spRecord);
+            simmParameters.push_back(spRecord);
         }
     }
 }
@@ -1363,7 +1511,7 @@ void SimmCalculator::populateResults(const SimmSide& side, const NettingSetDetai
     // Populate netting set level results for each portfolio
 
     // Reference to SIMM results for this portfolio
-    auto& results = simmResults_[side][nettingSetDetails][regulation];
+    auto& results = resultsContainer(side, nettingSetDetails, regulation);
 
     // Fill in the margin within each (product class, risk class) combination
     for (const auto& pc : pcs) {
@@ -1606,7 +1754,8 @@ void SimmCalculator::add(const NettingSetDetails& nettingSetDetails, const strin
     }
 
     const string& calculationCcy = side == SimmSide::Call ? calculationCcyCall_ : calculationCcyPost_;
-    simmResults_[side][nettingSetDetails][regulation].add(pc, rc, mt, b, margin, resultCcy_, calculationCcy, overwrite);
+    resultsContainer(side, nettingSetDetails, regulation)
+        .add(pc, rc, mt, b, margin, resultCcy_, calculationCcy, overwrite);
 }
 
 void SimmCalculator::add(const NettingSetDetails& nettingSetDetails, const string& regulation, const ProductClass& pc,
@@ -1617,6 +1766,21 @@ void SimmCalculator::add(const NettingSetDetails& nettingSetDetails, const strin
         add(nettingSetDetails, regulation, pc, rc, mt, kv.first, kv.second, side, overwrite);
 }
 
+SimmResults& SimmCalculator::resultsContainer(const SimmSide& side, const NettingSetDetails& nettingSetDetails,
+                                              const string& regulation) {
+    if (auto s = simmResults_.find(side); s != simmResults_.end()) {
+        if (auto n = s->second.find(nettingSetDetails); n != s->second.end()) {
+            if (auto r = n->second.find(regulation); r != n->second.end())
+                return r->second;
+        }
+    }
+    return simmResults_[side][nettingSetDetails][regulation];
+}
+
+Real SimmCalculator::usdSpot() const {
+    return usdSpot_ != Null<Real>() ? usdSpot_ : market_->fxRate("USD" + resultCcy_)->value();
+}
+
 void SimmCalculator::splitCrifByRegulationsAndPortfolios(const Crif& crif, const bool enforceIMRegulations) {
     for (const auto& crifRecord : crif) {
         for (const auto& side : {SimmSide::Call, SimmSide::Post}) {
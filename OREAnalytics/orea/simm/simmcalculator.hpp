@@ -44,6 +44,10 @@ public:
         \p calculationCcy is not USD then the \p usdSpot parameter must be used to
         give the FX spot rate between USD and the \p calculationCcy. This spot rate is
         interpreted as the number of USD per unit of \p calculationCcy.
+
+        If \p nThreads is greater than 1, the margins of the different side, netting set and regulation combinations
+        are calculated concurrently on up to \p nThreads threads. The results do not depend on the number of threads.
+        This requires a build with QL_ENABLE_SESSIONS, otherwise the calculation is always sequential.
     */
     SimmCalculator(const ore::analytics::Crif& crif,
                    const QuantLib::ext::shared_ptr<SimmConfiguration>& simmConfiguration,
@@ -56,7 +60,17 @@ public:
                    const std::map<SimmSide, std::set<NettingSetDetails>>& hasSEC =
                        std::map<SimmSide, std::set<NettingSetDetails>>(),
                    const std::map<SimmSide, std::set<NettingSetDetails>>& hasCFTC =
-                       std::map<SimmSide, std::set<NettingSetDetails>>());
+                       std::map<SimmSide, std::set<NettingSetDetails>>(),
+                   const QuantLib::Size nThreads = 1);
+
+    /*! Apply a CRIF delta, i.e. CRIF records \p added to and \p removed from the CRIF the calculator was constructed
+        with, and recalculate the SIMM results for the netting sets touched by the delta only. The records are
+        prepared exactly as in the constructor, removed records must match records that were added before. If the
+        calculator does not determine the winning regulations, the final results are repopulated using the winning
+        regulations last given to populateFinalResults(), if any.
+    */
+    void update(const ore::analytics::Crif& added,
+                const ore::analytics::Crif& removed = ore::analytics::Crif());
 
     //! Calculates SIMM for a given regulation under a given netting set
     const void calculateRegulationSimm(const ore::analytics::Crif& crif, const ore::data::NettingSetDetails& nsd,
@@ -108,8 +122,8 @@ public:
     void populateFinalResults(const std::map<SimmSide, std::map<ore::data::NettingSetDetails, std::string>>& winningRegulations);
 
 private:
-    //! All the net sensitivities passed in for the calculation
-    ore::analytics::Crif crif_;
+    //! All the net sensitivities passed in for the calculation, by netting set
+    std::map<ore::data::NettingSetDetails, ore::analytics::Crif> crifs_;
 
     //! Net sentivities at the regulation level within each netting set
     std::map<SimmSide, std::map<ore::data::NettingSetDetails, std::map<std::string, Crif>>> regSensitivities_;
@@ -117,6 +131,10 @@ private:
     //! Record of SIMM parameters that were used in the calculation
     ore::analytics::Crif simmParameters_;
 
+    //! SIMM parameters used in the calculation for each regulation under each netting set
+    std::map<SimmSide, std::map<ore::data::NettingSetDetails, std::map<std::string, std::vector<CrifRecord>>>>
+        regSimmParameters_;
+
     //! The SIMM configuration governing the calculation
     QuantLib::ext::shared_ptr<SimmConfiguration> simmConfiguration_;
 
@@ -134,6 +152,14 @@ private:
 
     std::map<SimmSide, std::set<NettingSetDetails>> hasSEC_, hasCFTC_;
 
+    //! Number of threads used to calculate the regulation level margins
+    QuantLib::Size nThreads_;
+
+    bool determineWinningRegulations_, enforceIMRegulations_;
+
+    //! USD to result currency FX spot, looked up once before the margin calculations
+    QuantLib::Real usdSpot_ = QuantLib::Null<QuantLib::Real>();
+
     //! For each netting set, whether all CRIF records' collect regulations are empty
     std::map<ore::data::NettingSetDetails, bool> collectRegsIsEmpty_;
 
@@ -195,8 +221,26 @@ private:
                     const CrifRecord::RiskType& rt, const SimmSide& side, const ore::analytics::Crif& netRecords,
                     bool rfLabels = true) const;
 
+    /*! Prepare a CRIF record for the calculation, i.e. populate its amount in the result currency. Returns false if
+        the record is not used in the SIMM calculation.
+    */
+    bool prepareCrifRecord(const CrifRecord& cr, CrifRecord& newCrifRecord) const;
+
+    /*! Split the CRIF records of the given netting sets by regulation, calculate SIMM for them and update the winning
+        regulations and final results
+    */
+    void calculate(const std::set<ore::data::NettingSetDetails>& nettingSets);
+
+    /*! Calculates SIMM for a given regulation under a given netting set, the SIMM parameter records used are appended
+        to \p simmParameters instead of being added to simmParameters_ directly
+    */
+    void calculateRegulationSimm(const ore::analytics::Crif& crif, const ore::data::NettingSetDetails& nsd,
+                                 const string& regulation, const SimmSide& side,
+                                 std::vector<CrifRecord>& simmParameters);
+
     //! Calculate the additional initial margin for the portfolio ID and regulation
-    void calcAddMargin(const SimmSide& side, const ore::data::NettingSetDetails& nsd, const string& regulation, const ore::analytics::Crif& netRecords);
+    void calcAddMargin(const SimmSide& side, const ore::data::NettingSetDetails& nsd, const string& regulation,
+                       const ore::analytics::Crif& netRecords, std::vector<CrifRecord>& simmParameters);
 
     /*! Populate the results structure with the higher level results after the IMs have been
         calculated at the (product class, risk class, margin type) level for the given
@@ -224,6 +268,15 @@ private:
              const SimmConfiguration::MarginType& mt, const std::map<std::string, QuantLib::Real>& margins, SimmSide side,
              const bool overwrite = true);
 
+    /*! Return the SIMM results container for the given side, netting set and regulation. The lookup only inserts into
+        simmResults_ if the container does not exist yet, so that it is safe to use concurrently on existing entries.
+    */
+    SimmResults& resultsContainer(const SimmSide& side, const ore::data::NettingSetDetails& nettingSetDetails,
+                                  const string& regulation);
+
+    //! USD to result currency FX spot
+    QuantLib::Real usdSpot() const;
+
     //! Add CRIF record to the CRIF records container that correspondsd to the given regulation/s and portfolio ID
     void splitCrifByRegulationsAndPortfolios(const Crif& crif, const bool enforceIMRegulations);
 
@@ -16,7 +16,9 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <boost/filesystem.hpp>
 #include <boost/test/unit_test.hpp>
+#include <orea/cube/cube_io.hpp>
 #include <orea/scenario/aggregationscenariodata.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <test/oreatoplevelfixture.hpp>
@@ -65,6 +67,42 @@ BOOST_AUTO_TEST_CASE(testInMemoryAggregationScenarioData) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testAggregationScenarioDataBinaryFileIO) {
+    InMemoryAggregationScenarioData data(3, 5);
+    for (Size i = 0; i < 3; ++i) {
+        for (Size j = 0; j < 5; ++j) {
+            data.set(i, j, 0.0001 * i + 0.01 * j, AggregationScenarioDataType::IndexFixing, "OIS_EUR");
+            data.set(i, j, i + 0.1 * j, AggregationScenarioDataType::FXSpot, "EURUSD");
+            data.set(i, j, 1.0 + i + j, AggregationScenarioDataType::Numeraire);
+        }
+    }
+
+    std::string filename = boost::filesystem::unique_path().string() + ".bin";
+    saveAggregationScenarioData(filename, data);
+    auto loaded = loadAggregationScenarioData(filename);
+
+    BOOST_CHECK_EQUAL(loaded->dimDates(), 3u);
+    BOOST_CHECK_EQUAL(loaded->dimSamples(), 5u);
+    BOOST_CHECK(loaded->keys() == data.keys());
+    BOOST_CHECK(loaded->has(AggregationScenarioDataType::FXSpot, "EURUSD"));
+    BOOST_CHECK(!loaded->has(AggregationScenarioDataType::FXSpot, "EURGBP"));
+
+    for (Size i = 0; i < 3; ++i) {
+        for (Size j = 0; j < 5; ++j) {
+            for (auto const& [type, qualifier] : data.keys())
+                BOOST_CHECK_EQUAL(loaded->get(i, j, type, qualifier), data.get(i, j, type, qualifier));
+        }
+    }
+
+    BOOST_CHECK_THROW(loaded->get(3, 0, AggregationScenarioDataType::Numeraire), std::exception);
+    BOOST_CHECK_THROW(loaded->get(0, 5, AggregationScenarioDataType::Numeraire), std::exception);
+    BOOST_CHECK_THROW(loaded->get(0, 0, AggregationScenarioDataType::Generic, "blabla"), std::exception);
+    BOOST_CHECK_THROW(loaded->set(0, 0, 1.0, AggregationScenarioDataType::Numeraire), std::exception);
+
+    loaded.reset();
+    boost::filesystem::remove(filename);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
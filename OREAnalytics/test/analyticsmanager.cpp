@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/app/analyticsmanager.hpp>
+#include <oret/toplevelfixture.hpp>
+
+using namespace ore::analytics;
+using namespace QuantLib;
+using namespace std;
+
+namespace {
+
+class TestAnalyticImpl : public Analytic::Impl {
+public:
+    TestAnalyticImpl(const QuantLib::ext::shared_ptr<InputParameters>& inputs, const string& label)
+        : Analytic::Impl(inputs) {
+        setLabel(label);
+    }
+    void runAnalytic(const QuantLib::ext::shared_ptr<ore::data::InMemoryLoader>&, const set<string>&) override {}
+};
+
+QuantLib::ext::shared_ptr<Analytic> testAnalytic(const QuantLib::ext::shared_ptr<InputParameters>& inputs,
+                                                 const string& label, const set<string>& types) {
+    return QuantLib::ext::make_shared<Analytic>(std::make_unique<TestAnalyticImpl>(inputs, label), types, inputs);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(AnalyticsManagerTest)
+
+BOOST_AUTO_TEST_CASE(testAnalyticDependencies) {
+
+    BOOST_TEST_MESSAGE("Testing the dependencies between analytics in a concurrent run...");
+
+    auto inputs = QuantLib::ext::make_shared<InputParameters>();
+
+    // like the xva sensitivity analytic, which runs its own instance of the xva analytic
+    auto pricing = testAnalytic(inputs, "PRICING", {"NPV", "CASHFLOW"});
+    auto xva = testAnalytic(inputs, "XVA", {"EXPOSURE", "XVA"});
+    auto xvaSensi = testAnalytic(inputs, "XVA_SENSITIVITY", {"XVA_SENSITIVITY"});
+    xvaSensi->impl()->addDependentAnalytic("XVA", testAnalytic(inputs, "XVA", {"EXPOSURE", "XVA"}));
+    // a nested dependent analytic that only shares a type with a requested analytic
+    auto stress = testAnalytic(inputs, "STRESS", {"STRESS"});
+    auto nested = testAnalytic(inputs, "NESTED", {"NESTED"});
+    nested->impl()->addDependentAnalytic("NPV", testAnalytic(inputs, "NPV_ONLY", {"NPV"}));
+    stress->impl()->addDependentAnalytic("NESTED", nested);
+
+    auto dependencies = analyticDependencies({pricing, xva, xvaSensi, stress});
+    BOOST_REQUIRE_EQUAL(dependencies.size(), 4u);
+    BOOST_CHECK(dependencies[0].empty());
+    BOOST_CHECK(dependencies[1].empty());
+    BOOST_CHECK(dependencies[2] == set<Size>({1}));
+    BOOST_CHECK(dependencies[3] == set<Size>({0}));
+
+    // without the requested xva analytic, the xva sensitivity analytic does not wait for anything
+    dependencies = analyticDependencies({pricing, xvaSensi});
+    BOOST_CHECK(dependencies[0].empty());
+    BOOST_CHECK(dependencies[1].empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
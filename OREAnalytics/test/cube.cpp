@@ -22,6 +22,7 @@
 #include <orea/cube/cube_io.hpp>
 #include <orea/cube/npvcube.hpp>
 #include <orea/cube/jaggedcube.hpp>
+#include <orea/cube/stridednpvcube.hpp>
 #include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/observationmode.hpp>
 #include <orea/engine/parametricvar.hpp>
@@ -461,6 +462,49 @@ BOOST_AUTO_TEST_CASE(testDoublePrecisionInMemoryCubeFileNIO) {
     testCubeFileIO<DoublePrecisionInMemoryCubeN>(c, "DoublePrecisionInMemoryCubeN", 1e-14, true);
 }
 
+BOOST_AUTO_TEST_CASE(testInMemoryCubeBinaryFileIO) {
+    std::set<string> ids{"id1", "id2", "id3"};
+    Date d(1, QuantLib::Jan, 2016);
+    vector<Date> dates(10, d);
+    Size samples = 100;
+    Size depth = 3;
+
+    for (bool doublePrecision : {true, false}) {
+        auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(d, ids, dates, samples, depth);
+        initCube(*cube);
+        for (Size i = 0; i < cube->numIds(); ++i)
+            for (Size k = 0; k < depth; ++k)
+                cube->setT0(i * 10.0 + k, i, k);
+
+        string filename = boost::filesystem::unique_path().string() + ".bin";
+        BOOST_TEST_MESSAGE("Saving binary cube to file " << filename << ", doublePrecision = " << doublePrecision);
+        saveCube(filename, NPVCubeWithMetaData{cube, nullptr, boost::optional<bool>(true), boost::optional<Size>(2)}, doublePrecision);
+
+        auto r = loadCube(filename);
+        BOOST_REQUIRE(r.cube);
+        BOOST_CHECK(r.storeFlows && *r.storeFlows);
+        BOOST_CHECK(r.storeCreditStateNPVs && *r.storeCreditStateNPVs == 2);
+        BOOST_CHECK(!r.scenarioGeneratorData);
+
+        BOOST_CHECK_EQUAL(r.cube->asof(), d);
+        BOOST_CHECK_EQUAL(r.cube->numIds(), cube->numIds());
+        BOOST_CHECK_EQUAL(r.cube->numDates(), cube->numDates());
+        BOOST_CHECK_EQUAL(r.cube->samples(), cube->samples());
+        BOOST_CHECK_EQUAL(r.cube->depth(), cube->depth());
+        BOOST_CHECK(r.cube->idsAndIndexes() == cube->idsAndIndexes());
+        for (Size i = 0; i < cube->numIds(); ++i)
+            for (Size k = 0; k < depth; ++k)
+                BOOST_CHECK_EQUAL(r.cube->getT0(i, k), i * 10.0 + k);
+        checkCube(*r.cube, doublePrecision ? 1e-14 : 1e-5);
+
+        // the loaded cube is read-only
+        BOOST_CHECK_THROW(r.cube->set(1.0, 0, 0, 0, 0), std::exception);
+
+        r.cube.reset();
+        boost::filesystem::remove(filename);
+    }
+}
+
 BOOST_AUTO_TEST_CASE(testInMemoryCubeGetSetbyDateID) {
     std::set<string> ids = {"id1", "id2", "id3"}; // the overlap doesn't matter
     Date today = Date::todaysDate();
@@ -471,6 +515,103 @@ BOOST_AUTO_TEST_CASE(testInMemoryCubeGetSetbyDateID) {
     testCubeGetSetbyDateID(cube, 1e-14);
 }
 
+BOOST_AUTO_TEST_CASE(testInMemoryCubeSampleRows) {
+    std::set<string> ids = {"id1", "id2", "id3"};
+    vector<Date> dates(20, Date());
+    Size samples = 100;
+    Size depth = 3;
+    DoublePrecisionInMemoryCubeN cube(Date(), ids, dates, samples, depth);
+    initCube(cube);
+
+    // read rows and compare with single value access
+    vector<Real> values;
+    for (Size i = 0; i < cube.numIds(); ++i) {
+        for (Size j = 0; j < cube.numDates(); ++j) {
+            for (Size d = 0; d < cube.depth(); ++d) {
+                cube.getSamples(values, i, j, d);
+                BOOST_REQUIRE_EQUAL(values.size(), samples);
+                for (Size k = 0; k < samples; ++k)
+                    BOOST_CHECK_EQUAL(values[k], cube.get(i, j, k, d));
+                const double* row = cube.row(i, j, d);
+                for (Size k = 0; k < samples; ++k)
+                    BOOST_CHECK_EQUAL(row[k], cube.get(i, j, k, d));
+            }
+        }
+    }
+
+    // write a row and check that neighbouring rows are untouched
+    vector<Real> row(samples);
+    for (Size k = 0; k < samples; ++k)
+        row[k] = -static_cast<Real>(k);
+    cube.setSamples(row, 1, 5, 2);
+    for (Size k = 0; k < samples; ++k) {
+        BOOST_CHECK_EQUAL(cube.get(1, 5, k, 2), -static_cast<Real>(k));
+        BOOST_CHECK_CLOSE(cube.get(1, 5, k, 1), 1000000.0 + 5 + k / 1000000.0 + 3, 1e-14);
+        BOOST_CHECK_CLOSE(cube.get(1, 6, k, 0), 1000000.0 + 6 + k / 1000000.0, 1e-14);
+    }
+
+    // check size and bounds
+    BOOST_CHECK_THROW(cube.setSamples(vector<Real>(samples + 1), 0, 0, 0), std::exception);
+    BOOST_CHECK_THROW(cube.getSamples(values, cube.numIds(), 0, 0), std::exception);
+    BOOST_CHECK_THROW(cube.getSamples(values, 0, cube.numDates(), 0), std::exception);
+    BOOST_CHECK_THROW(cube.getSamples(values, 0, 0, cube.depth()), std::exception);
+
+    // remove an id, the other ids must be untouched
+    cube.setT0(1.0, 1, 0);
+    cube.remove(1);
+    BOOST_CHECK_EQUAL(cube.getT0(1, 0), 0.0);
+    for (Size j = 0; j < cube.numDates(); ++j) {
+        for (Size d = 0; d < cube.depth(); ++d) {
+            cube.getSamples(values, 1, j, d);
+            for (Size k = 0; k < samples; ++k) {
+                BOOST_CHECK_EQUAL(values[k], 0.0);
+                BOOST_CHECK_CLOSE(cube.get(2, j, k, d), 2000000.0 + j + k / 1000000.0 + d * 3, 1e-14);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testStridedNpvCube) {
+    std::set<string> ids = {"id1", "id2", "id3"};
+    vector<Date> dates(5, Date());
+    Size samples = 12;
+    Size depth = 2;
+    auto cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCubeN>(Date(), ids, dates, samples, depth);
+    initCube(*cube);
+
+    // split the cube into three views, view g holds the samples g, g + 3, g + 6, ...
+    Size stride = 3;
+    for (Size g = 0; g < stride; ++g) {
+        StridedNpvCube view(cube, g, stride);
+        BOOST_REQUIRE_EQUAL(view.samples(), samples / stride);
+        BOOST_CHECK_EQUAL(view.numIds(), cube->numIds());
+        BOOST_CHECK_EQUAL(view.numDates(), cube->numDates());
+        BOOST_CHECK_EQUAL(view.depth(), cube->depth());
+        vector<Real> values;
+        for (Size i = 0; i < view.numIds(); ++i) {
+            for (Size d = 0; d < view.depth(); ++d) {
+                BOOST_CHECK_EQUAL(view.getT0(i, d), cube->getT0(i, d));
+                for (Size j = 0; j < view.numDates(); ++j) {
+                    view.getSamples(values, i, j, d);
+                    for (Size k = 0; k < view.samples(); ++k) {
+                        BOOST_CHECK_EQUAL(view.get(i, j, k, d), cube->get(i, j, g + k * stride, d));
+                        BOOST_CHECK_EQUAL(values[k], cube->get(i, j, g + k * stride, d));
+                    }
+                }
+            }
+        }
+        BOOST_CHECK_THROW(view.get(0, 0, view.samples(), 0), std::exception);
+    }
+
+    // writes go to the underlying cube
+    StridedNpvCube view(cube, 1, stride);
+    view.set(-1.0, 2, 3, 2, 1);
+    BOOST_CHECK_EQUAL(cube->get(2, 3, 7, 1), -1.0);
+
+    BOOST_CHECK_THROW(StridedNpvCube(cube, 3, 3), std::exception);
+    BOOST_CHECK_THROW(StridedNpvCube(cube, 0, 5), std::exception);
+}
+
 BOOST_AUTO_TEST_CASE(testSinglePrecisionJaggedCube) {
 
     SavedSettings backup;
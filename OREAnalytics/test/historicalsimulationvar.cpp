@@ -0,0 +1,65 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+*/
+
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics.hpp>
+#include <boost/accumulators/statistics/tail_quantile.hpp>
+#include <boost/test/unit_test.hpp>
+#include <orea/engine/historicalsimulationvar.hpp>
+#include <oret/toplevelfixture.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <cmath>
+
+using namespace ore::analytics;
+using namespace boost::unit_test_framework;
+using namespace QuantLib;
+
+namespace {
+
+// the quantile as calculated by the boost right tail quantile accumulator
+Real boostTailQuantile(const std::vector<Real>& pnls, Real confidence, bool isCall) {
+    using namespace boost::accumulators;
+    Size c = static_cast<Size>(std::floor(pnls.size() * (1.0 - confidence) + 0.5)) + 2;
+    typedef accumulator_set<double, stats<tag::tail_quantile<right>>> accumulator;
+    accumulator acc(tag::tail<right>::cache_size = c);
+    for (const auto& pnl : pnls)
+        acc(isCall ? pnl : -pnl);
+    return quantile(acc, quantile_probability = confidence);
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(HistoricalSimulationVarTest)
+
+BOOST_AUTO_TEST_CASE(testHistoricalSimulationVarQuantile) {
+
+    BOOST_TEST_MESSAGE("Testing historical simulation VaR quantile against boost tail quantile...");
+
+    MersenneTwisterUniformRng rng(42);
+    for (Size n : {10, 99, 250, 260, 1000}) {
+        std::vector<Real> pnls(n);
+        for (auto& p : pnls)
+            p = 2.0E6 * (rng.nextReal() - 0.5);
+        // a few ties
+        pnls[n / 2] = pnls[n / 3];
+        HistoricalSimulationVarCalculator calc(pnls);
+        for (Real confidence : {0.9, 0.95, 0.975, 0.99}) {
+            for (bool isCall : {true, false}) {
+                Real expected = boostTailQuantile(pnls, confidence, isCall);
+                BOOST_CHECK_MESSAGE(calc.var(confidence, isCall) == expected,
+                                    "n=" << n << ", confidence=" << confidence << ", isCall=" << std::boolalpha
+                                         << isCall << ": var=" << calc.var(confidence, isCall)
+                                         << ", expected=" << expected);
+            }
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -698,5 +698,82 @@ BOOST_AUTO_TEST_CASE(NettedExposureCalculatorTest) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(NettedExposureCalculatorThreadInvarianceTest) {
+
+    BOOST_TEST_MESSAGE("Testing that exposures do not depend on the number of threads...");
+
+    Date referenceDate = Date(14, April, 2016);
+    Settings::instance().evaluationDate() = referenceDate;
+    QuantLib::ext::shared_ptr<DateGrid> dateGrid = QuantLib::ext::make_shared<DateGrid>("13,1W");
+    TestData td(referenceDate, dateGrid, false, false, 20);
+
+    std::string nettingSetId = td.portfolio_->trades().begin()->second->envelope().nettingSetId();
+    std::vector<std::string> elgColls = {"EUR"};
+    QuantLib::ext::shared_ptr<NettingSetManager> nettingSetManager = QuantLib::ext::make_shared<NettingSetManager>();
+    nettingSetManager->add(QuantLib::ext::make_shared<NettingSetDefinition>(
+        NettingSetDetails(nettingSetId), "Bilateral", "EUR", "EUR-EONIA", 0.0, 0.0, 0.0, 0.0, 0.0, "FIXED", "1D", "1D",
+        "1W", 0.0, 0.0, elgColls));
+    QuantLib::ext::shared_ptr<CollateralBalances> collateralBalances = QuantLib::ext::make_shared<CollateralBalances>();
+
+    QuantLib::ext::shared_ptr<AggregationScenarioData> asd = td.simMarket_->aggregationScenarioData();
+    for (Size i = 0; i < td.cube_->dates().size(); i++)
+        for (Size j = 0; j < td.cube_->samples(); j++)
+            asd->set(i, j, 0, AggregationScenarioDataType::IndexFixing, "EUR-EONIA");
+    QuantLib::ext::shared_ptr<CubeInterpretation> cubeInterpreter =
+        QuantLib::ext::make_shared<CubeInterpretation>(true, false, Handle<AggregationScenarioData>(asd));
+
+    for (auto calcType : {CollateralExposureHelper::CalculationType::Symmetric,
+                          CollateralExposureHelper::CalculationType::AsymmetricCVA}) {
+        std::vector<QuantLib::ext::shared_ptr<ExposureCalculator>> exposureCalculators;
+        std::vector<QuantLib::ext::shared_ptr<NettedExposureCalculator>> nettedExposureCalculators;
+        for (Size nThreads : {1, 4}) {
+            auto exposureCalculator = QuantLib::ext::make_shared<ExposureCalculator>(
+                td.portfolio_, td.cube_, cubeInterpreter, td.initMarket_, false, "EUR", "Market", 0.99, calcType,
+                false, false, nThreads);
+            exposureCalculator->build();
+            auto nettedExposureCalculator = QuantLib::ext::make_shared<NettedExposureCalculator>(
+                td.portfolio_, td.initMarket_, td.cube_, "EUR", "Market", 0.99, calcType, false, nettingSetManager,
+                collateralBalances, exposureCalculator->nettingSetDefaultValue(),
+                exposureCalculator->nettingSetCloseOutValue(), exposureCalculator->nettingSetMporPositiveFlow(),
+                exposureCalculator->nettingSetMporNegativeFlow(), asd, cubeInterpreter, false, nullptr, false, true,
+                0.1, exposureCalculator->exposureCube(), ExposureCalculator::allocatedEPE,
+                ExposureCalculator::allocatedENE, false, false, MporCashFlowMode::Unspecified, nThreads);
+            nettedExposureCalculator->build();
+            exposureCalculators.push_back(exposureCalculator);
+            nettedExposureCalculators.push_back(nettedExposureCalculator);
+        }
+
+        // the results must be identical, not only close, since each job sums in a fixed order
+        auto const& c1 = exposureCalculators[0]->exposureCube();
+        auto const& c4 = exposureCalculators[1]->exposureCube();
+        for (Size i = 0; i < c1->numIds(); ++i)
+            for (Size d = 0; d < c1->numDates(); ++d)
+                for (Size s = 0; s < c1->samples(); ++s)
+                    for (Size k = 0; k < c1->depth(); ++k)
+                        BOOST_CHECK_EQUAL(c1->get(i, d, s, k), c4->get(i, d, s, k));
+        for (auto const& [tid, _] : td.portfolio_->trades()) {
+            BOOST_CHECK(exposureCalculators[0]->epe(tid) == exposureCalculators[1]->epe(tid));
+            BOOST_CHECK(exposureCalculators[0]->ene(tid) == exposureCalculators[1]->ene(tid));
+            BOOST_CHECK(exposureCalculators[0]->pfe(tid) == exposureCalculators[1]->pfe(tid));
+        }
+        BOOST_CHECK(exposureCalculators[0]->nettingSetDefaultValue() ==
+                    exposureCalculators[1]->nettingSetDefaultValue());
+
+        auto& n1 = nettedExposureCalculators[0];
+        auto& n4 = nettedExposureCalculators[1];
+        BOOST_CHECK(n1->epe(nettingSetId) == n4->epe(nettingSetId));
+        BOOST_CHECK(n1->ene(nettingSetId) == n4->ene(nettingSetId));
+        BOOST_CHECK(n1->pfe(nettingSetId) == n4->pfe(nettingSetId));
+        BOOST_CHECK(n1->expectedCollateral(nettingSetId) == n4->expectedCollateral(nettingSetId));
+        BOOST_CHECK(n1->colvaIncrements(nettingSetId) == n4->colvaIncrements(nettingSetId));
+        BOOST_CHECK(n1->exposureCube()->numIds() == n4->exposureCube()->numIds());
+        for (Size i = 0; i < n1->exposureCube()->numIds(); ++i)
+            for (Size d = 0; d < n1->exposureCube()->numDates(); ++d)
+                for (Size s = 0; s < n1->exposureCube()->samples(); ++s)
+                    for (Size k = 0; k < n1->exposureCube()->depth(); ++k)
+                        BOOST_CHECK_EQUAL(n1->exposureCube()->get(i, d, s, k), n4->exposureCube()->get(i, d, s, k));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,10 @@ All rights reserved.
 #include <orea/scenario/simplescenario.hpp>
 #include <orea/scenario/simplescenariofactory.hpp>
 #include <orea/scenario/csvscenariogenerator.hpp>
+#include <orea/scenario/multifilterscenariogenerator.hpp>
+#include <orea/scenario/scenariofilter.hpp>
+#include <set>
+#include <thread>
 
 using namespace boost::unit_test_framework;
 using namespace QuantLib;
@@ -89,4 +93,136 @@ BOOST_AUTO_TEST_CASE(testCSVScenarioGenerator) {
 
 BOOST_AUTO_TEST_SUITE_END()
 
+BOOST_AUTO_TEST_SUITE(MultiFilterScenarioGeneratorTest)
+
+BOOST_AUTO_TEST_CASE(testMultiFilterScenarioGenerator) {
+
+    BOOST_TEST_MESSAGE("Testing multi filter scenario generator...");
+
+    Date d(21, Dec, 2016);
+    vector<RiskFactorKey> rfks = {{RiskFactorKey::KeyType::DiscountCurve, "CHF", 0},
+                                  {RiskFactorKey::KeyType::DiscountCurve, "CHF", 1},
+                                  {RiskFactorKey::KeyType::FXSpot, "CHF"},
+                                  {RiskFactorKey::KeyType::FXVolatility, "CHFVol"}};
+
+    auto base = QuantLib::ext::make_shared<SimpleScenario>(d);
+    for (Size k = 0; k < rfks.size(); ++k)
+        base->add(rfks[k], 1.0 + k);
+
+    auto tsg = QuantLib::ext::make_shared<TestScenarioGenerator>();
+    for (Size i = 0; i < 3; ++i) {
+        auto s = QuantLib::ext::make_shared<SimpleScenario>(d);
+        for (Size k = 0; k < rfks.size(); ++k)
+            s->add(rfks[k], 10.0 * (i + 1) + k);
+        tsg->addScenario(s);
+    }
+
+    // filter 0 allows all keys, filter 1 only the discount curve, filter 2 only the fx keys
+    vector<QuantLib::ext::shared_ptr<ScenarioFilter>> filters = {
+        nullptr,
+        QuantLib::ext::make_shared<RiskFactorTypeScenarioFilter>(
+            vector<RiskFactorKey::KeyType>{RiskFactorKey::KeyType::DiscountCurve}),
+        QuantLib::ext::make_shared<RiskFactorTypeScenarioFilter>(
+            vector<RiskFactorKey::KeyType>{RiskFactorKey::KeyType::FXSpot, RiskFactorKey::KeyType::FXVolatility})};
+
+    MultiFilterScenarioGenerator gen(tsg, base, filters);
+    BOOST_CHECK_EQUAL(gen.numFilters(), filters.size());
+
+    for (Size run = 0; run < 2; ++run) {
+        gen.reset();
+        for (Size i = 0; i < tsg->scenarios.size(); ++i) {
+            for (Size g = 0; g < filters.size(); ++g) {
+                auto s = gen.next(d);
+                for (auto const& k : rfks) {
+                    bool allowed = !filters[g] || filters[g]->allow(k);
+                    BOOST_CHECK_EQUAL(s->get(k), allowed ? tsg->scenarios[i]->get(k) : base->get(k));
+                }
+            }
+            // the scenarios of the underlying generator are not modified
+            for (Size k = 0; k < rfks.size(); ++k)
+                BOOST_CHECK_EQUAL(tsg->scenarios[i]->get(rfks[k]), 10.0 * (i + 1) + k);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(RiskFactorKeyRegistryTest)
+
+BOOST_AUTO_TEST_CASE(testKeyIdsAndScenarioAccessById) {
+
+    auto& registry = RiskFactorKeyRegistry::instance();
+    RiskFactorKey k1(RiskFactorKey::KeyType::DiscountCurve, "RegistryTestCcy", 0);
+    RiskFactorKey k2(RiskFactorKey::KeyType::DiscountCurve, "RegistryTestCcy", 1);
+    RiskFactorKey k3(RiskFactorKey::KeyType::FXSpot, "RegistryTestCcyEUR");
+
+    BOOST_CHECK(registry.find(k3) == Null<Size>());
+    Size id1 = registry.id(k1), id2 = registry.id(k2);
+    BOOST_CHECK(id1 != id2);
+    BOOST_CHECK_EQUAL(registry.id(k1), id1);
+    BOOST_CHECK_EQUAL(registry.find(k2), id2);
+    BOOST_CHECK_EQUAL(registry.key(id1), k1);
+    BOOST_CHECK_EQUAL(registry.key(id2), k2);
+    BOOST_CHECK(registry.size() > std::max(id1, id2));
+
+    Date d(21, Dec, 2016);
+    SimpleScenario s(d);
+    s.add(k1, 1.0);
+    s.addById(id2, 2.0);
+    BOOST_CHECK(s.has(k2));
+    BOOST_CHECK(s.hasById(id1));
+    BOOST_CHECK(!s.has(k3));
+    BOOST_CHECK_EQUAL(s.getById(id1), 1.0);
+    BOOST_CHECK_EQUAL(s.get(k2), 2.0);
+    BOOST_REQUIRE_EQUAL(s.keyIds().size(), 2);
+    BOOST_CHECK_EQUAL(s.keyIds()[0], id1);
+    BOOST_CHECK_EQUAL(s.keyIds()[1], id2);
+}
+
+BOOST_AUTO_TEST_CASE(testConcurrentRegistration) {
+
+    BOOST_TEST_MESSAGE("Testing concurrent registration and lookup of risk factor keys...");
+
+    auto& registry = RiskFactorKeyRegistry::instance();
+    RiskFactorKey late(RiskFactorKey::KeyType::FXSpot, "RegistryThreadTestLate");
+    BOOST_CHECK(registry.find(late) == Null<Size>());
+
+    // the threads register overlapping sets of keys in different orders
+    Size nThreads = 4, nKeys = 500;
+    std::vector<std::vector<Size>> ids(nThreads, std::vector<Size>(nKeys));
+    std::vector<std::thread> threads;
+    std::vector<std::string> errors(nThreads);
+    for (Size t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            try {
+                for (Size j = 0; j < nKeys; ++j) {
+                    Size k = t % 2 == 0 ? j : nKeys - 1 - j;
+                    RiskFactorKey key(RiskFactorKey::KeyType::IndexCurve, "RegistryThreadTest", k);
+                    ids[t][k] = registry.id(key);
+                    QL_REQUIRE(registry.key(ids[t][k]) == key, "key " << key << " does not match its id");
+                    QL_REQUIRE(registry.find(key) == ids[t][k], "find() does not match id() for " << key);
+                }
+            } catch (const std::exception& e) {
+                errors[t] = e.what();
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    for (auto const& e : errors)
+        BOOST_CHECK_MESSAGE(e.empty(), e);
+
+    std::set<Size> distinct(ids[0].begin(), ids[0].end());
+    BOOST_CHECK_EQUAL(distinct.size(), nKeys);
+    for (Size t = 1; t < nThreads; ++t)
+        BOOST_CHECK(ids[t] == ids[0]);
+
+    // a key registered on another thread is found after an unsuccessful lookup on this thread
+    std::thread([&registry, &late]() { registry.id(late); }).join();
+    BOOST_CHECK(registry.find(late) != Null<Size>());
+    BOOST_CHECK_EQUAL(registry.key(registry.find(late)), late);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 BOOST_AUTO_TEST_SUITE_END()
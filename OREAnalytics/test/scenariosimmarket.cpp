@@ -306,6 +306,48 @@ BOOST_AUTO_TEST_CASE(testScenarioSimMarket) {
     testToXML(parameters);
 }
 
+BOOST_AUTO_TEST_CASE(testBatchedScenarioApplication) {
+    BOOST_TEST_MESSAGE("Testing batched scenario application in ScenarioSimMarket...");
+
+    SavedSettings backup;
+
+    Date today(20, Jan, 2015);
+    Settings::instance().evaluationDate() = today;
+    QuantLib::ext::shared_ptr<ore::data::Market> initMarket = QuantLib::ext::make_shared<TestMarket>(today);
+    QuantLib::ext::shared_ptr<analytics::ScenarioSimMarketParameters> parameters = scenarioParameters();
+    convs();
+    auto simMarket = QuantLib::ext::make_shared<analytics::ScenarioSimMarket>(initMarket, parameters);
+
+    Handle<YieldTermStructure> eur = simMarket->discountCurve("EUR");
+    Date d = today + 5 * Years;
+    Real df = eur->discount(d);
+
+    // bump the EUR discount factors
+    auto scenario = simMarket->baseScenario()->clone();
+    Size bumped = 0;
+    for (auto const& key : scenario->keys()) {
+        if (key.keytype == analytics::RiskFactorKey::KeyType::DiscountCurve && key.name == "EUR") {
+            scenario->add(key, scenario->get(key) * 0.99);
+            ++bumped;
+        }
+    }
+
+    simMarket->resetUpdateStatistics();
+    simMarket->applyScenario(scenario);
+    BOOST_CHECK(eur->discount(d) < df);
+
+    auto const& stats = simMarket->updateStatistics();
+    BOOST_CHECK_EQUAL(stats.scenarios, 1);
+    BOOST_CHECK_EQUAL(stats.batches, 1);
+    BOOST_CHECK_EQUAL(stats.quoteUpdates, scenario->keys().size());
+    BOOST_CHECK_EQUAL(stats.quoteNotifications, bumped);
+
+    simMarket->reset();
+    BOOST_CHECK_CLOSE(eur->discount(d), df, 1E-12);
+    BOOST_CHECK_EQUAL(stats.scenarios, 2);
+    BOOST_CHECK_EQUAL(stats.quoteNotifications, 2 * bumped);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
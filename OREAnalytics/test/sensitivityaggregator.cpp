@@ -17,6 +17,8 @@
 */
 
 #include <boost/test/unit_test.hpp>
+#include <orea/engine/bufferedsensitivitystream.hpp>
+#include <orea/engine/filteredsensitivitystream.hpp>
 #include <orea/engine/sensitivityaggregator.hpp>
 #include <orea/engine/sensitivityinmemorystream.hpp>
 #include <oret/toplevelfixture.hpp>
@@ -26,7 +28,10 @@
 using namespace boost::unit_test_framework;
 using namespace std;
 
+using ore::analytics::BufferedSensitivityStream;
+using ore::analytics::FilteredSensitivityStream;
 using ore::analytics::RiskFactorKey;
+using ore::analytics::SensitivityBatch;
 using ore::analytics::SensitivityAggregator;
 using ore::analytics::SensitivityInMemoryStream;
 using ore::analytics::SensitivityRecord;
@@ -240,6 +245,44 @@ BOOST_AUTO_TEST_CASE(testGeneralAggregationFunctionCategories) {
     check(expAggregationAll, res, "all_except_002");
 }
 
+BOOST_AUTO_TEST_CASE(testBatchStreaming) {
+
+    BOOST_TEST_MESSAGE("Testing streaming of sensitivity records in batches");
+
+    auto ss = QuantLib::ext::make_shared<SensitivityInMemoryStream>(records.begin(), records.end());
+
+    // the dictionary holds each trade id and risk factor once
+    BOOST_CHECK_EQUAL(ss->dictionary()->numberOfTradeIds(), 6);
+    BOOST_CHECK_EQUAL(ss->dictionary()->numberOfFactors(), 12);
+    BOOST_CHECK_EQUAL(ss->dictionary()->numberOfCurrencies(), 2);
+
+    // the batches contain the same records in the same order as next(), also for wrapped streams
+    auto buffered = QuantLib::ext::make_shared<BufferedSensitivityStream>(ss);
+    auto filtered = QuantLib::ext::make_shared<FilteredSensitivityStream>(buffered, 0.005);
+    for (auto const& stream : std::vector<QuantLib::ext::shared_ptr<ore::analytics::SensitivityStream>>{
+             ss, buffered, filtered, buffered}) {
+        vector<SensitivityRecord> exp, res;
+        stream->reset();
+        while (SensitivityRecord sr = stream->next())
+            exp.push_back(sr);
+        stream->reset();
+        SensitivityBatch batch;
+        while (stream->nextBatch(batch, 7)) {
+            BOOST_CHECK(batch.size() <= 7);
+            for (QuantLib::Size i = 0; i < batch.size(); ++i)
+                res.push_back(batch.record(i));
+        }
+        BOOST_REQUIRE_EQUAL(exp.size(), res.size());
+        for (QuantLib::Size i = 0; i < exp.size(); ++i) {
+            BOOST_CHECK_EQUAL(exp[i], res[i]);
+            BOOST_CHECK_EQUAL(exp[i].currency, res[i].currency);
+            BOOST_CHECK_EQUAL(exp[i].delta, res[i].delta);
+            BOOST_CHECK_EQUAL(exp[i].gamma, res[i].gamma);
+        }
+    }
+    BOOST_CHECK_EQUAL(filtered->dictionary(), ss->dictionary());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -211,8 +211,8 @@ void testPortfolioSensitivity(ObservationMode::Mode om) {
         "1,0W"); // TODO - extend the DateGrid interface so that it can actually take a vector of dates as input
     vector<QuantLib::ext::shared_ptr<ValuationCalculator>> calculators;
     calculators.push_back(QuantLib::ext::make_shared<NPVCalculator>(simMarketData->baseCcy()));
-    ValuationEngine engine(today, dg, simMarket,
-                           factory->modelBuilders()); // last argument required for model recalibration
+    ValuationEngine engine(today, dg, simMarket, factory->modelBuilders(),
+                           true); // model builders required for model recalibration, skip unaffected trades
     // run scenarios and fill the cube
     cpu_timer t;
     QuantLib::ext::shared_ptr<NPVCube> cube = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
@@ -220,6 +220,29 @@ void testPortfolioSensitivity(ObservationMode::Mode om) {
     engine.buildCube(portfolio, cube, calculators);
     t.stop();
 
+    // for the trades in this portfolio the cube does not depend on whether unaffected trades are skipped
+    ValuationEngine engineNoSkip(today, dg, simMarket, factory->modelBuilders());
+    QuantLib::ext::shared_ptr<NPVCube> cubeNoSkip = QuantLib::ext::make_shared<DoublePrecisionInMemoryCube>(
+        today, portfolio->ids(), vector<Date>(1, today), scenarioGenerator->samples());
+    engineNoSkip.buildCube(portfolio, cubeNoSkip, calculators);
+    BOOST_CHECK_EQUAL(engineNoSkip.skippedValuations(), Size(0));
+    if (om == ObservationMode::Mode::None || om == ObservationMode::Mode::Defer)
+        BOOST_CHECK(engine.skippedValuations() > 0);
+    else
+        BOOST_CHECK_EQUAL(engine.skippedValuations(), Size(0));
+    Size nDiff = 0;
+    for (Size i = 0; i < cube->numIds(); ++i) {
+        for (Size k = 0; k < cube->depth(); ++k) {
+            if (cube->getT0(i, k) != cubeNoSkip->getT0(i, k))
+                ++nDiff;
+            for (Size s = 0; s < cube->samples(); ++s) {
+                if (cube->get(i, 0, s, k) != cubeNoSkip->get(i, 0, s, k))
+                    ++nDiff;
+            }
+        }
+    }
+    BOOST_CHECK_MESSAGE(nDiff == 0, nDiff << " cube entries differ with and without skipping unaffected trades");
+
     struct Results {
         string id;
         string label;
@@ -0,0 +1,281 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <orea/simm/crif.hpp>
+#include <orea/simm/simmbucketmapperbase.hpp>
+#include <orea/simm/simmcalculator.hpp>
+#include <orea/simm/utilities.hpp>
+#include <oret/toplevelfixture.hpp>
+
+using namespace ore::analytics;
+using namespace ore::data;
+using namespace QuantLib;
+using namespace std;
+
+namespace {
+
+typedef CrifRecord::RiskType RiskType;
+typedef CrifRecord::ProductClass ProductClass;
+
+// IR and FX delta sensitivities for a few trades in three netting sets with different collect and post regulations
+Crif testCrif() {
+    Crif crif;
+    vector<NettingSetDetails> nettingSets = {NettingSetDetails("NS1"), NettingSetDetails("NS2"),
+                                             NettingSetDetails("NS3")};
+    vector<pair<string, string>> regulations = {{"SEC,CFTC", "ESA"}, {"ESA,USPR", "SEC"}, {"CFTC", "CFTC,ESA"}};
+    vector<string> tenors = {"2w", "1m", "3m", "6m", "1y", "2y", "3y", "5y", "10y", "15y", "20y", "30y"};
+    vector<pair<string, string>> ccys = {{"USD", "Libor3m"}, {"EUR", "Libor6m"}, {"GBP", "OIS"}};
+    for (Size n = 0; n < nettingSets.size(); ++n) {
+        for (Size t = 0; t < 4; ++t) {
+            string tradeId = "Trade_" + to_string(n) + "_" + to_string(t);
+            for (Size c = 0; c < ccys.size(); ++c) {
+                if ((n + t + c) % 3 == 0)
+                    continue;
+                for (Size j = 0; j < tenors.size(); ++j) {
+                    Real amount = 1000.0 * ((n + 1) * (j + 1) % 7 - 3.0) + 100.0 * t - 50.0 * c;
+                    crif.addRecord(CrifRecord(tradeId, "Swap", nettingSets[n], ProductClass::RatesFX,
+                                              RiskType::IRCurve, ccys[c].first, "1", tenors[j], ccys[c].second, "USD",
+                                              amount, amount, "SIMM", regulations[n].first, regulations[n].second));
+                }
+                if (ccys[c].first != "USD") {
+                    Real amount = 20000.0 * (t + 1) - 15000.0 * c;
+                    crif.addRecord(CrifRecord(tradeId, "Swap", nettingSets[n], ProductClass::RatesFX, RiskType::FX,
+                                              ccys[c].first, "", "", "", "USD", amount, amount, "SIMM",
+                                              regulations[n].first, regulations[n].second));
+                }
+            }
+        }
+    }
+    return crif;
+}
+
+QuantLib::ext::shared_ptr<SimmConfiguration> testSimmConfiguration(const Crif& crif) {
+    auto bucketMapper = QuantLib::ext::make_shared<SimmBucketMapperBase>();
+    bucketMapper->updateFromCrif(crif);
+    return buildSimmConfiguration("2.6", bucketMapper);
+}
+
+void checkSimmResults(const SimmResults& r1, const SimmResults& r2, const string& label) {
+    BOOST_REQUIRE_MESSAGE(r1.data().size() == r2.data().size(),
+                          label << ": results size " << r1.data().size() << " vs " << r2.data().size());
+    BOOST_CHECK_EQUAL(r1.resultCurrency(), r2.resultCurrency());
+    BOOST_CHECK_EQUAL(r1.calculationCurrency(), r2.calculationCurrency());
+    for (auto it1 = r1.data().begin(), it2 = r2.data().begin(); it1 != r1.data().end(); ++it1, ++it2) {
+        BOOST_CHECK_MESSAGE(it1->first == it2->first, label << ": key " << it1->first << " vs " << it2->first);
+        BOOST_CHECK_MESSAGE(it1->second == it2->second, label << ", " << it1->first << ": " << it1->second
+                                                              << " vs " << it2->second);
+    }
+}
+
+// compare the regulation level and final results of two calculators
+void checkSimmCalculators(const SimmCalculator& c1, const SimmCalculator& c2) {
+    const auto& res1 = c1.simmResults();
+    const auto& res2 = c2.simmResults();
+    BOOST_REQUIRE_EQUAL(res1.size(), res2.size());
+    for (const auto& [side, nettingSetResults] : res1) {
+        BOOST_REQUIRE(res2.count(side) == 1);
+        BOOST_REQUIRE_EQUAL(nettingSetResults.size(), res2.at(side).size());
+        for (const auto& [nsd, regulationResults] : nettingSetResults) {
+            BOOST_REQUIRE(res2.at(side).count(nsd) == 1);
+            const auto& regulationResults2 = res2.at(side).at(nsd);
+            BOOST_REQUIRE_EQUAL(regulationResults.size(), regulationResults2.size());
+            for (const auto& [regulation, results] : regulationResults) {
+                BOOST_REQUIRE(regulationResults2.count(regulation) == 1);
+                checkSimmResults(results, regulationResults2.at(regulation),
+                                 nsd.nettingSetId() + "/" + regulation);
+            }
+        }
+    }
+
+    const auto& final1 = c1.finalSimmResults();
+    const auto& final2 = c2.finalSimmResults();
+    BOOST_REQUIRE_EQUAL(final1.size(), final2.size());
+    for (const auto& [side, nettingSetResults] : final1) {
+        BOOST_REQUIRE(final2.count(side) == 1);
+        BOOST_REQUIRE_EQUAL(nettingSetResults.size(), final2.at(side).size());
+        for (const auto& [nsd, regulationResults] : nettingSetResults) {
+            BOOST_REQUIRE(final2.at(side).count(nsd) == 1);
+            BOOST_CHECK_EQUAL(regulationResults.first, final2.at(side).at(nsd).first);
+            checkSimmResults(regulationResults.second, final2.at(side).at(nsd).second,
+                             nsd.nettingSetId() + "/final");
+        }
+    }
+
+    BOOST_CHECK(c1.winningRegulations() == c2.winningRegulations());
+    BOOST_CHECK_EQUAL(c1.simmParameters().size(), c2.simmParameters().size());
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREAnalyticsTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(SimmCalculatorTest)
+
+BOOST_AUTO_TEST_CASE(testThreadInvariance) {
+
+    BOOST_TEST_MESSAGE("Testing that the SIMM results do not depend on the number of threads...");
+
+    Settings::instance().evaluationDate() = Date(14, Jun, 2024);
+
+    Crif crif = testCrif();
+    auto simmConfiguration = testSimmConfiguration(crif);
+
+    SimmCalculator single(crif, simmConfiguration, "USD", "USD", "USD", nullptr, true, false, true, {}, {}, 1);
+    SimmCalculator multi(crif, simmConfiguration, "USD", "USD", "USD", nullptr, true, false, true, {}, {}, 4);
+
+    // three netting sets with two or three regulations on each side
+    BOOST_REQUIRE_EQUAL(single.simmResults(SimmConfiguration::SimmSide::Call).size(), 3u);
+    BOOST_REQUIRE_EQUAL(single.simmResults(SimmConfiguration::SimmSide::Post).size(), 3u);
+
+    checkSimmCalculators(single, multi);
+}
+
+BOOST_AUTO_TEST_CASE(testUpdate) {
+
+    BOOST_TEST_MESSAGE("Testing that updating the SIMM with a CRIF delta gives the same results as a new calculation...");
+
+    Settings::instance().evaluationDate() = Date(14, Jun, 2024);
+
+    Crif crif = testCrif();
+    auto simmConfiguration = testSimmConfiguration(crif);
+
+    // the delta adds the records of one trade and removes the records of another trade, one in a netting set that is
+    // dropped completely
+    Crif initial, added, removed;
+    for (const auto& r : crif) {
+        if (r.tradeId == "Trade_1_2")
+            added.addRecord(r);
+        else
+            initial.addRecord(r);
+    }
+    for (const string& nettingSetId : {"NS1", "NS4"}) {
+        for (const string& tenor : {"1y", "5y"}) {
+            CrifRecord r("Trade_X", "Swap", NettingSetDetails(nettingSetId), ProductClass::RatesFX, RiskType::IRCurve,
+                         "USD", "1", tenor, "Libor3m", "USD", 5000.0, 5000.0, "SIMM", "SEC", "SEC");
+            initial.addRecord(r);
+            removed.addRecord(r);
+        }
+    }
+
+    // the calculator determines the winning regulations
+    SimmCalculator fresh(crif, simmConfiguration, "USD", "USD", "USD", nullptr, true, false, true);
+    SimmCalculator updated(initial, simmConfiguration, "USD", "USD", "USD", nullptr, true, false, true);
+    BOOST_REQUIRE_EQUAL(updated.simmResults(SimmConfiguration::SimmSide::Call).size(), 4u);
+    updated.update(added, removed);
+    checkSimmCalculators(fresh, updated);
+
+    // the winning regulations are given
+    auto winningRegulations = fresh.winningRegulations();
+    for (auto side : {SimmConfiguration::SimmSide::Call, SimmConfiguration::SimmSide::Post})
+        winningRegulations[side][NettingSetDetails("NS4")] = "SEC";
+    SimmCalculator freshGiven(crif, simmConfiguration, "USD", "USD", "USD", nullptr, false, false, true);
+    freshGiven.populateFinalResults(winningRegulations);
+    SimmCalculator updatedGiven(initial, simmConfiguration, "USD", "USD", "USD", nullptr, false, false, true);
+    updatedGiven.populateFinalResults(winningRegulations);
+    updatedGiven.update(added, removed);
+    checkSimmCalculators(freshGiven, updatedGiven);
+}
+
+BOOST_AUTO_TEST_CASE(testCrifRemoveRecord) {
+
+    BOOST_TEST_MESSAGE("Testing the removal of CRIF records...");
+
+    CrifRecord r1("Trade_1", "Swap", NettingSetDetails("NS1"), ProductClass::RatesFX, RiskType::IRCurve, "USD", "1",
+                  "1y", "Libor3m", "USD", 1000.0, 1000.0, "SIMM", "SEC", "SEC");
+    CrifRecord r2("Trade_2", "Swap", NettingSetDetails("NS2"), ProductClass::RatesFX, RiskType::IRCurve, "USD", "1",
+                  "1y", "Libor3m", "USD", 2000.0, 2000.0, "SIMM", "SEC", "SEC");
+    Crif crif;
+    crif.addRecord(r1);
+    crif.addRecord(r2);
+    crif.addRecord(r2);
+    BOOST_CHECK_EQUAL(crif.nettingSetDetails().size(), 2u);
+
+    // a record without any amount to subtract from the existing record is not removed
+    CrifRecord noMatch = r1;
+    noMatch.amount = Null<Real>();
+    noMatch.amountUsd = Null<Real>();
+    BOOST_CHECK_THROW(crif.removeRecord(noMatch), QuantLib::Error);
+    BOOST_REQUIRE(crif.find(r1) != crif.end());
+    BOOST_CHECK_EQUAL(crif.find(r1)->amount, 1000.0);
+
+    // a record is erased once its amounts are used up, together with its netting set
+    crif.removeRecord(r2);
+    BOOST_REQUIRE(crif.find(r2) != crif.end());
+    BOOST_CHECK_EQUAL(crif.find(r2)->amountUsd, 2000.0);
+    crif.removeRecord(r2);
+    BOOST_CHECK(crif.find(r2) == crif.end());
+    BOOST_CHECK_EQUAL(crif.size(), 1u);
+    BOOST_CHECK(crif.nettingSetDetails() == std::set<NettingSetDetails>({NettingSetDetails("NS1")}));
+}
+
+BOOST_AUTO_TEST_CASE(testCrifIndexInvalidation) {
+
+    BOOST_TEST_MESSAGE("Testing that the CRIF index is rebuilt after adding and removing records...");
+
+    NettingSetDetails ns1("NS1"), ns2("NS2");
+    auto record = [](const NettingSetDetails& nsd, const string& qualifier, const string& label1) {
+        return CrifRecord("Trade_1", "Swap", nsd, ProductClass::RatesFX, RiskType::IRCurve, qualifier, "1", label1,
+                          "Libor3m", "USD", 1000.0, 1000.0, "SIMM", "SEC", "SEC");
+    };
+
+    Crif crif;
+    crif.addRecord(record(ns1, "USD", "1y"));
+    crif.addRecord(record(ns1, "USD", "5y"));
+
+    // build the index
+    BOOST_CHECK_EQUAL(crif.filterBy(ns1, ProductClass::RatesFX, RiskType::IRCurve).size(), 2u);
+    BOOST_CHECK_EQUAL(crif.filterByQualifier(ns1, ProductClass::RatesFX, RiskType::IRCurve, "EUR").size(), 0u);
+    BOOST_CHECK(crif.ProductClassesByNettingSetDetails(ns2).empty());
+
+    // new records, including a new qualifier and a new netting set
+    crif.addRecord(record(ns1, "EUR", "1y"));
+    crif.addRecord(record(ns2, "USD", "1y"));
+    BOOST_CHECK_EQUAL(crif.filterBy(ns1, ProductClass::RatesFX, RiskType::IRCurve).size(), 3u);
+    auto eur = crif.filterByQualifier(ns1, ProductClass::RatesFX, RiskType::IRCurve, "EUR");
+    BOOST_REQUIRE_EQUAL(eur.size(), 1u);
+    BOOST_CHECK_EQUAL(eur.front().label1, "1y");
+    BOOST_CHECK(crif.qualifiersBy(ns1, ProductClass::RatesFX, RiskType::IRCurve) == std::set<string>({"EUR", "USD"}));
+    BOOST_CHECK(crif.ProductClassesByNettingSetDetails(ns2) == std::set<ProductClass>({ProductClass::RatesFX}));
+
+    // an amount update of an existing record is seen through the index
+    crif.addRecord(record(ns1, "EUR", "1y"));
+    BOOST_CHECK_EQUAL(crif.filterByQualifier(ns1, ProductClass::RatesFX, RiskType::IRCurve, "EUR").front().amount,
+                      2000.0);
+
+    // a copy has its own index
+    Crif copy = crif;
+    copy.addRecord(record(ns1, "GBP", "1y"));
+    BOOST_CHECK_EQUAL(copy.filterBy(ns1, ProductClass::RatesFX, RiskType::IRCurve).size(), 4u);
+    BOOST_CHECK_EQUAL(crif.filterBy(ns1, ProductClass::RatesFX, RiskType::IRCurve).size(), 3u);
+
+    // removed records
+    crif.removeRecord(record(ns1, "USD", "5y"));
+    crif.removeRecord(record(ns2, "USD", "1y"));
+    BOOST_CHECK_EQUAL(crif.filterBy(ns1, ProductClass::RatesFX, RiskType::IRCurve).size(), 2u);
+    BOOST_CHECK_EQUAL(crif.filterByQualifier(ns1, ProductClass::RatesFX, RiskType::IRCurve, "USD").size(), 1u);
+    BOOST_CHECK_EQUAL(crif.filterByBucket(ns1, ProductClass::RatesFX, RiskType::IRCurve, "1").size(), 2u);
+    BOOST_CHECK(crif.ProductClassesByNettingSetDetails(ns2).empty());
+
+    crif.clear();
+    BOOST_CHECK(crif.filterBy(ns1, ProductClass::RatesFX, RiskType::IRCurve).empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -151,19 +151,29 @@ void CurveConfigurations::add(const CurveSpec::CurveType& type, const string& cu
 }
 
 bool CurveConfigurations::has(const CurveSpec::CurveType& type, const string& curveId) const {
+    boost::shared_lock<boost::shared_mutex> lock(*mutex_);
     return (configs_.count(type) > 0 && configs_.at(type).count(curveId) > 0) ||
            (unparsed_.count(type) > 0 && unparsed_.at(type).count(curveId) > 0);
 }
 
 const QuantLib::ext::shared_ptr<CurveConfig>& CurveConfigurations::get(const CurveSpec::CurveType& type,
     const string& curveId) const {
-    const auto& it = configs_.find(type);
-    if (it != configs_.end()) {
-        const auto& itc = it->second.find(curveId);
-        if (itc != it->second.end()) {
-            return itc->second;
+    {
+        boost::shared_lock<boost::shared_mutex> lock(*mutex_);
+        const auto& it = configs_.find(type);
+        if (it != configs_.end()) {
+            const auto& itc = it->second.find(curveId);
+            if (itc != it->second.end()) {
+                return itc->second;
+            }
         }
     }
+    boost::unique_lock<boost::shared_mutex> lock(*mutex_);
+    // the config might have been parsed by another thread in the meantime
+    if (auto it = configs_.find(type); it != configs_.end()) {
+        if (auto itc = it->second.find(curveId); itc != it->second.end())
+            return itc->second;
+    }
     parseNode(type, curveId);
     return configs_.at(type).at(curveId);
 }
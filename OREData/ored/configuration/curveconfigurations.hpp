@@ -44,6 +44,9 @@
 #include <ored/marketdata/todaysmarketparameters.hpp>
 #include <ored/utilities/xmlutils.hpp>
 
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
 #include <typeindex>
 #include <typeinfo>
 
@@ -169,6 +172,8 @@ public:
 
     mutable std::map<CurveSpec::CurveType, std::map<std::string, QuantLib::ext::shared_ptr<CurveConfig>>> configs_;
     mutable std::map<CurveSpec::CurveType, std::map<std::string, std::string>> unparsed_;
+    // guards the lazy parsing in get() and has(), curves might be built concurrently
+    QuantLib::ext::shared_ptr<boost::shared_mutex> mutex_ = QuantLib::ext::make_shared<boost::shared_mutex>();
 
     // utility function for parsing a node of name "parentName" and storing the result in the map
     void parseNode(const CurveSpec::CurveType& type, const string& curveId) const;
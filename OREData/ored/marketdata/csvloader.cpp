@@ -22,12 +22,17 @@
 */
 
 #include <algorithm>
+#include <array>
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#include <cctype>
 #include <fstream>
 #include <map>
 #include <ored/marketdata/csvloader.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/parallelfor.hpp>
 #include <ored/utilities/parsers.hpp>
 
 using namespace std;
@@ -35,6 +40,82 @@ using namespace std;
 namespace ore {
 namespace data {
 
+namespace {
+
+// sorts v where [bounds[i], bounds[i + 1]) are consecutive runs, equal elements keep their order in v
+template <class T, class Compare>
+void parallelStableSort(vector<T>& v, vector<Size> bounds, Size nThreads, Compare comp) {
+    parallelFor(bounds.size() - 1, nThreads,
+                [&](Size i) { std::stable_sort(v.begin() + bounds[i], v.begin() + bounds[i + 1], comp); });
+    while (bounds.size() > 2) {
+        vector<Size> merged;
+        for (Size i = 0; i + 1 < bounds.size(); i += 2)
+            merged.push_back(bounds[i]);
+        merged.push_back(bounds.back());
+        parallelFor((bounds.size() - 1) / 2, nThreads, [&](Size i) {
+            std::inplace_merge(v.begin() + bounds[2 * i], v.begin() + bounds[2 * i + 1], v.begin() + bounds[2 * i + 2],
+                               comp);
+        });
+        bounds.swap(merged);
+    }
+}
+
+bool isSeparator(char c) { return c == ',' || c == ';' || c == '\t' || c == ' '; }
+
+// splits a trimmed line at any of ",;\t " with adjacent separators compressed, like boost::split with
+// token_compress_on, returns the number of tokens, at most tokens.size() + 1 (i.e. too many tokens)
+Size tokenize(const std::string_view& line, std::array<std::string_view, 4>& tokens) {
+    Size n = 0;
+    Size start = 0;
+    while (true) {
+        Size end = start;
+        while (end < line.size() && !isSeparator(line[end]))
+            ++end;
+        if (n == tokens.size())
+            return n + 1;
+        tokens[n++] = line.substr(start, end - start);
+        if (end == line.size())
+            return n;
+        while (end < line.size() && isSeparator(line[end]))
+            ++end;
+        start = end;
+    }
+}
+
+bool isDigits(const std::string_view& s) {
+    return std::all_of(s.begin(), s.end(), [](char c) { return c >= '0' && c <= '9'; });
+}
+
+int toInt(const std::string_view& s) {
+    int result = 0;
+    for (char c : s)
+        result = 10 * result + (c - '0');
+    return result;
+}
+
+// fast path for the yyyy-mm-dd and yyyymmdd formats, everything else is handed to parseDate()
+Date parseCsvDate(const std::string_view& s) {
+    if (s.size() == 10 && s[4] == '-' && s[7] == '-' && isDigits(s.substr(0, 4)) && isDigits(s.substr(5, 2)) &&
+        isDigits(s.substr(8, 2)))
+        return Date(toInt(s.substr(8, 2)), Month(toInt(s.substr(5, 2))), toInt(s.substr(0, 4)));
+    if (s.size() == 8 && isDigits(s))
+        return Date(toInt(s.substr(6, 2)), Month(toInt(s.substr(4, 2))), toInt(s.substr(0, 4)));
+    return parseDate(string(s));
+}
+
+bool isFxSpot(const QuantLib::ext::shared_ptr<MarketDatum>& md) {
+    return md->instrumentType() == MarketDatum::InstrumentType::FX_SPOT &&
+           md->quoteType() == MarketDatum::QuoteType::RATE;
+}
+
+// the position of md in the sorted vector data, or data.end() if it is not there
+template <class V> auto findDatum(V& data, const QuantLib::ext::shared_ptr<MarketDatum>& md) -> decltype(data.begin()) {
+    auto it = std::lower_bound(data.begin(), data.end(), md, SharedPtrMarketDatumComparator());
+    return it != data.end() && !SharedPtrMarketDatumComparator()(md, *it) ? it : data.end();
+}
+
+} // namespace
+
 CSVLoader::CSVLoader(const string& marketFilename, const string& fixingFilename, bool implyTodaysFixings,
 		     Date fixingCutOffDate)
     : CSVLoader(marketFilename, fixingFilename, "", implyTodaysFixings, fixingCutOffDate) {}
@@ -43,8 +124,12 @@ CSVLoader::CSVLoader(const vector<string>& marketFiles, const vector<string>& fi
     : CSVLoader(marketFiles, fixingFiles, {}, implyTodaysFixings, fixingCutOffDate) {}
 
 CSVLoader::CSVLoader(const string& marketFilename, const string& fixingFilename, const string& dividendFilename,
-                     bool implyTodaysFixings, Date fixingCutOffDate)
-    : implyTodaysFixings_(implyTodaysFixings), fixingCutOffDate_(fixingCutOffDate) {
+                     bool implyTodaysFixings, Date fixingCutOffDate, Size nThreads,
+                     const std::set<std::string>& quoteNames)
+    : implyTodaysFixings_(implyTodaysFixings), fixingCutOffDate_(fixingCutOffDate),
+      nThreads_(std::max<Size>(nThreads, 1)) {
+
+    setQuoteNames(quoteNames);
 
     // load market data
     loadFile(marketFilename, DataType::Market);
@@ -68,15 +153,18 @@ CSVLoader::CSVLoader(const string& marketFilename, const string& fixingFilename,
 
 CSVLoader::CSVLoader(const vector<string>& marketFiles, const vector<string>& fixingFiles,
                      const vector<string>& dividendFiles, bool implyTodaysFixings,
-		     Date fixingCutOffDate)
-    : implyTodaysFixings_(implyTodaysFixings), fixingCutOffDate_(fixingCutOffDate) {
+		     Date fixingCutOffDate, Size nThreads, const std::set<std::string>& quoteNames)
+    : implyTodaysFixings_(implyTodaysFixings), fixingCutOffDate_(fixingCutOffDate),
+      nThreads_(std::max<Size>(nThreads, 1)) {
+
+    setQuoteNames(quoteNames);
 
     for (auto marketFile : marketFiles)
         // load market data
         loadFile(marketFile, DataType::Market);
 
     // log
-    for (auto it : data_)
+    for (auto const& it : data_)
         LOG("CSVLoader loaded " << it.second.size() << " market data points for " << it.first);
 
     for (auto fixingFile : fixingFiles)
@@ -97,95 +185,238 @@ QuantLib::ext::shared_ptr<MarketDatum> makeDummyMarketDatum(const Date& d, const
                                            MarketDatum::InstrumentType::NONE);
 }
 
+void CSVLoader::setQuoteNames(const std::set<std::string>& quoteNames) {
+    for (auto const& q : quoteNames) {
+        Wildcard w(q);
+        if (w.hasWildcard()) {
+            // builds the regex, if any, so that matches() does not modify w when called from the parser threads
+            w.matches(string());
+            quoteWildcards_.push_back(w);
+        } else {
+            quoteNames_.insert(q);
+        }
+    }
+    if (!quoteNames.empty())
+        LOG("CSVLoader restricted to " << quoteNames_.size() << " quote names, " << quoteWildcards_.size()
+                                       << " wildcards and FX spot rates");
+}
+
+bool CSVLoader::isRequested(const std::string_view& name) const {
+    if (quoteNames_.empty() && quoteWildcards_.empty())
+        return true;
+    // FX spot rates are always kept, they are needed for the FX dominance check and FX triangulation
+    if (name.substr(0, 8) == "FX/RATE/" || quoteNames_.find(name) != quoteNames_.end())
+        return true;
+    if (quoteWildcards_.empty())
+        return false;
+    string s(name);
+    return std::any_of(quoteWildcards_.begin(), quoteWildcards_.end(),
+                       [&s](const Wildcard& w) { return w.matches(s); });
+}
+
+void CSVLoader::addFxSpot(const QuantLib::ext::shared_ptr<MarketDatum>& md) {
+    const Date& date = md->asofDate();
+    const string& key = md->name();
+    std::pair<bool, string> addFX = checkFxDuplicate(md, date);
+    vector<QuantLib::ext::shared_ptr<MarketDatum>>& data = data_[date];
+    if (!addFX.second.empty()) {
+        auto it2 = findDatum(data, makeDummyMarketDatum(date, addFX.second));
+        TLOG("Replacing MarketDatum " << addFX.second << " with " << key << " due to FX Dominance.");
+        if (it2 != data.end())
+            data.erase(it2);
+    }
+    auto it = std::lower_bound(data.begin(), data.end(), md, SharedPtrMarketDatumComparator());
+    bool present = it != data.end() && !SharedPtrMarketDatumComparator()(md, *it);
+    if (addFX.first && !present) {
+        data.insert(it, md);
+        LOG("Added MarketDatum " << key);
+    } else if (!addFX.first) {
+        LOG("Skipped MarketDatum " << key << " - dominant FX already present.")
+    } else {
+        LOG("Skipped MarketDatum " << key << " - this is already present.");
+    }
+}
+
 void CSVLoader::loadFile(const string& filename, DataType dataType) {
     LOG("CSVLoader loading from " << filename);
 
     Date today = QuantLib::Settings::instance().evaluationDate();
 
-    ifstream file;
-    file.open(filename.c_str());
+    boost::system::error_code ec;
+    QL_REQUIRE(boost::filesystem::is_regular_file(filename, ec), "error opening file " << filename);
+    if (boost::filesystem::file_size(filename, ec) == 0) {
+        LOG("CSVLoader completed processing " << filename << " (empty file)");
+        return;
+    }
+    boost::iostreams::mapped_file_source file;
+    try {
+        file.open(filename);
+    } catch (const std::exception& e) {
+        QL_FAIL("error opening file " << filename << ": " << e.what());
+    }
     QL_REQUIRE(file.is_open(), "error opening file " << filename);
+    const std::string_view content(file.data(), file.size());
+
+    // Split the file into chunks of whole lines. Each chunk is parsed independently, the results are merged below
+    // in file order.
+    Size nChunks = nThreads_ == 1 ? 1 : std::max<Size>(1, std::min<Size>(8 * nThreads_, content.size() >> 16));
+    vector<Size> chunkStart(nChunks + 1, content.size());
+    chunkStart[0] = 0;
+    for (Size c = 1; c < nChunks; ++c) {
+        Size pos = std::max(chunkStart[c - 1], content.size() / nChunks * c);
+        while (pos < content.size() && pos > 0 && content[pos - 1] != '\n')
+            ++pos;
+        chunkStart[c] = pos;
+    }
+
+    vector<vector<QuantLib::ext::shared_ptr<MarketDatum>>> data(nChunks);
+    vector<vector<Fixing>> fixings(nChunks);
+    vector<vector<QuantExt::Dividend>> dividends(nChunks);
+    vector<string> errors(nChunks);
 
-    while (!file.eof()) {
-        string line;
-        getline(file, line);
-        boost::trim(line);
-        // skip blank and comment lines
-        if (line.size() > 0 && line[0] != '#') {
-
-            vector<string> tokens;
-            boost::trim(line);
-            boost::split(tokens, line, boost::is_any_of(",;\t "), boost::token_compress_on);
-
-            // TODO: should we try, catch and log any invalid lines?
-            QL_REQUIRE(tokens.size() == 3 || tokens.size() == 4, "Invalid CSVLoader line, 3 tokens expected " << line);
-            if (tokens.size() == 4)
-                QL_REQUIRE(dataType == DataType::Dividend, "CSVLoader, dataType must be of type Dividend");
-            Date date = parseDate(tokens[0]);
-            const string& key = tokens[1];
-            Real value = parseReal(tokens[2]);
-
-            if (dataType == DataType::Market) {
-                // process market
-                // build market datum and add to map
-                try {
+    parallelFor(nChunks, nThreads_, [&](Size c) {
+        Size pos = chunkStart[c], lineStart = pos;
+        try {
+            std::array<std::string_view, 4> tokens;
+            while (pos < chunkStart[c + 1]) {
+                lineStart = pos;
+                Size eol = content.find('\n', pos);
+                if (eol == std::string_view::npos)
+                    eol = content.size();
+                std::string_view line = content.substr(pos, eol - pos);
+                pos = eol + 1;
+                while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front())))
+                    line.remove_prefix(1);
+                while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back())))
+                    line.remove_suffix(1);
+                // skip blank and comment lines
+                if (line.empty() || line[0] == '#')
+                    continue;
+
+                // an invalid line is an error and aborts the load, it is not skipped, see below
+                Size nTokens = tokenize(line, tokens);
+                QL_REQUIRE(nTokens == 3 || nTokens == 4, "Invalid CSVLoader line, 3 tokens expected " << line);
+                if (nTokens == 4)
+                    QL_REQUIRE(dataType == DataType::Dividend, "CSVLoader, dataType must be of type Dividend");
+                Date date = parseCsvDate(tokens[0]);
+                const std::string_view& key = tokens[1];
+
+                if (dataType == DataType::Market) {
+                    // process market, build market datum
+                    if (!isRequested(key))
+                        continue;
+                    Real value = parseReal(string(tokens[2]));
                     QuantLib::ext::shared_ptr<MarketDatum> md;
                     try {
-                        md = parseMarketDatum(date, key, value);
+                        md = parseMarketDatum(date, string(key), value);
                     } catch (std::exception& e) {
                         WLOG("Failed to parse MarketDatum " << key << ": " << e.what());
                     }
-                    if (md != nullptr) {
-                        std::pair<bool, string> addFX = {true, ""};
-                        if (md->instrumentType() == MarketDatum::InstrumentType::FX_SPOT &&
-                            md->quoteType() == MarketDatum::QuoteType::RATE) {
-                            addFX = checkFxDuplicate(md, date);
-                            if (!addFX.second.empty()) {
-                                auto it2 = data_[date].find(makeDummyMarketDatum(date, addFX.second));
-                                TLOG("Replacing MarketDatum " << addFX.second << " with " << key
-                                                                  << " due to FX Dominance.");
-                                if (it2 != data_[date].end())
-                                    data_[date].erase(it2);
-                            }
-                        }
-                        if (addFX.first && data_[date].insert(md).second) {
-                            LOG("Added MarketDatum " << key);
-                        } else if (!addFX.first) {
-                            LOG("Skipped MarketDatum " << key << " - dominant FX already present.")
-                        }
-						else {
-                            LOG("Skipped MarketDatum " << key << " - this is already present.");
-                        }
-                    }
-                } catch (std::exception& e) {
-                    WLOG("Failed to parse MarketDatum " << key << ": " << e.what());
+                    if (md != nullptr)
+                        data[c].push_back(md);
+                } else if (dataType == DataType::Fixing) {
+                    // process fixings
+                    Real value = parseReal(string(tokens[2]));
+                    if (date < today || (date == today && !implyTodaysFixings_) ||
+                        (fixingCutOffDate_ != Date() && date <= fixingCutOffDate_))
+                        fixings[c].push_back(Fixing(date, string(key), value));
+                } else if (dataType == DataType::Dividend) {
+                    Real value = parseReal(string(tokens[2]));
+                    Date payDate = date;
+                    if (nTokens == 4)
+                        payDate = parseCsvDate(tokens[3]);
+                    // process dividends
+                    if (date <= today)
+                        dividends[c].push_back(QuantExt::Dividend(date, string(key), value, payDate));
+                } else {
+                    QL_FAIL("unknown data type");
                 }
-            } else if (dataType == DataType::Fixing) {
-                // process fixings
-                if (date < today || (date == today && !implyTodaysFixings_)
-		    || (fixingCutOffDate_ != Date() && date <= fixingCutOffDate_)) {
-                    if(!fixings_.insert(Fixing(date, key, value)).second) {
-                        WLOG("Skipped Fixing " << key << "@" << QuantLib::io::iso_date(date)
-                                               << " - this is already present.");
-                    }
-                }
-            } else if (dataType == DataType::Dividend) {
-                Date payDate = date;
-                if (tokens.size() == 4)
-                    payDate = parseDate(tokens[3]);
-                // process dividends
-                if (date <= today) {
-                    if (!dividends_.insert(QuantExt::Dividend(date, key, value, payDate)).second) {
-                        WLOG("Skipped Dividend " << key << "@" << QuantLib::io::iso_date(date)
-                                                 << " - this is already present.");
-                    }
+            }
+        } catch (const std::exception& e) {
+            // the line number is not tracked while parsing, count the lines up to the invalid one here
+            Size lineNo = std::count(content.begin(), content.begin() + lineStart, '\n') + 1;
+            errors[c] = "error in " + filename + ", line " + std::to_string(lineNo) + ": " + e.what();
+        }
+    });
+
+    // report the first invalid line in the file, so that the error does not depend on the number of threads
+    for (auto const& e : errors)
+        QL_REQUIRE(e.empty(), "CSVLoader: " << e);
+
+    if (dataType == DataType::Market) {
+        // FX spot rates are subject to the FX dominance check against the rates loaded so far and are added one
+        // by one in file order. All other quotes are sorted by date and name (keeping the file order of duplicates)
+        // and merged into the flat store, the first occurrence of a quote wins.
+        vector<QuantLib::ext::shared_ptr<MarketDatum>> quotes;
+        vector<Size> bounds(1, 0);
+        for (auto& chunk : data) {
+            for (auto& md : chunk) {
+                if (isFxSpot(md))
+                    addFxSpot(md);
+                else
+                    quotes.push_back(std::move(md));
+            }
+            bounds.push_back(quotes.size());
+        }
+        parallelStableSort(quotes, bounds, nThreads_, SharedPtrMarketDatumComparator());
+        for (auto it = quotes.begin(); it != quotes.end();) {
+            const Date& date = (*it)->asofDate();
+            vector<QuantLib::ext::shared_ptr<MarketDatum>>& existing = data_[date];
+            Size nExisting = existing.size();
+            for (; it != quotes.end() && (*it)->asofDate() == date; ++it) {
+                if ((existing.size() > nExisting && !SharedPtrMarketDatumComparator()(existing.back(), *it)) ||
+                    std::binary_search(existing.begin(), existing.begin() + nExisting, *it,
+                                       SharedPtrMarketDatumComparator())) {
+                    LOG("Skipped MarketDatum " << (*it)->name() << " - this is already present.");
+                } else {
+                    LOG("Added MarketDatum " << (*it)->name());
+                    existing.push_back(*it);
                 }
+            }
+            std::inplace_merge(existing.begin(), existing.begin() + nExisting, existing.end(),
+                               SharedPtrMarketDatumComparator());
+        }
+    } else if (dataType == DataType::Fixing) {
+        // sort by name and date, keeping the file order of duplicates, the first occurrence wins
+        vector<Fixing> all;
+        vector<Size> bounds(1, 0);
+        for (auto& chunk : fixings) {
+            all.insert(all.end(), std::make_move_iterator(chunk.begin()), std::make_move_iterator(chunk.end()));
+            bounds.push_back(all.size());
+            vector<Fixing>().swap(chunk);
+        }
+        parallelStableSort(all, bounds, nThreads_, std::less<Fixing>());
+        vector<Fixing> unique;
+        unique.reserve(all.size());
+        for (auto& f : all) {
+            if (!unique.empty() && !(unique.back() < f)) {
+                WLOG("Skipped Fixing " << f.name << "@" << QuantLib::io::iso_date(f.date)
+                                       << " - this is already present.");
             } else {
-                QL_FAIL("unknown data type");
+                unique.push_back(std::move(f));
+            }
+        }
+        if (fixings_.empty()) {
+            // linear time construction from the sorted range
+            fixings_ = std::set<Fixing>(std::make_move_iterator(unique.begin()), std::make_move_iterator(unique.end()));
+        } else {
+            for (auto& f : unique) {
+                if (!fixings_.insert(f).second) {
+                    WLOG("Skipped Fixing " << f.name << "@" << QuantLib::io::iso_date(f.date)
+                                           << " - this is already present.");
+                }
+            }
+        }
+    } else if (dataType == DataType::Dividend) {
+        for (auto const& chunk : dividends) {
+            for (auto const& d : chunk) {
+                if (!dividends_.insert(d).second) {
+                    WLOG("Skipped Dividend " << d.name << "@" << QuantLib::io::iso_date(d.exDate)
+                                             << " - this is already present.");
+                }
             }
         }
     }
-    file.close();
     LOG("CSVLoader completed processing " << filename);
 }
 
@@ -193,13 +424,13 @@ vector<QuantLib::ext::shared_ptr<MarketDatum>> CSVLoader::loadQuotes(const Quant
     auto it = data_.find(d);
     if (it == data_.end())
         return {};
-    return std::vector<QuantLib::ext::shared_ptr<MarketDatum>>(it->second.begin(), it->second.end());
+    return it->second;
 }
 
 QuantLib::ext::shared_ptr<MarketDatum> CSVLoader::get(const string& name, const QuantLib::Date& d) const {
     auto it = data_.find(d);
     QL_REQUIRE(it != data_.end(), "No datum for " << name << " on date " << d);
-    auto it2 = it->second.find(makeDummyMarketDatum(d, name));
+    auto it2 = findDatum(it->second, makeDummyMarketDatum(d, name));
     QL_REQUIRE(it2 != it->second.end(), "No datum for " << name << " on date " << d);
     return *it2;
 }
@@ -211,7 +442,7 @@ std::set<QuantLib::ext::shared_ptr<MarketDatum>> CSVLoader::get(const std::set<s
         return {};
     std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
     for (auto const& n : names) {
-        auto it2 = it->second.find(makeDummyMarketDatum(asof, n));
+        auto it2 = findDatum(it->second, makeDummyMarketDatum(asof, n));
         if (it2 != it->second.end())
             result.insert(*it2);
     }
@@ -232,7 +463,7 @@ std::set<QuantLib::ext::shared_ptr<MarketDatum>> CSVLoader::get(const Wildcard&
     if (it == data_.end())
         return {};
     std::set<QuantLib::ext::shared_ptr<MarketDatum>> result;
-    std::set<QuantLib::ext::shared_ptr<MarketDatum>>::iterator it1, it2;
+    vector<QuantLib::ext::shared_ptr<MarketDatum>>::const_iterator it1, it2;
     if (wildcard.wildcardPos() == 0) {
         // wildcard at first position => we have to search all of the data
         it1 = it->second.begin();
@@ -240,8 +471,10 @@ std::set<QuantLib::ext::shared_ptr<MarketDatum>> CSVLoader::get(const Wildcard&
     } else {
         // search the range matching the substring of the pattern until the wildcard
         std::string prefix = wildcard.pattern().substr(0, wildcard.wildcardPos());
-        it1 = it->second.lower_bound(makeDummyMarketDatum(asof, prefix));
-        it2 = it->second.upper_bound(makeDummyMarketDatum(asof, prefix + "\xFF"));
+        it1 = std::lower_bound(it->second.begin(), it->second.end(), makeDummyMarketDatum(asof, prefix),
+                               SharedPtrMarketDatumComparator());
+        it2 = std::upper_bound(it->second.begin(), it->second.end(), makeDummyMarketDatum(asof, prefix + "\xFF"),
+                               SharedPtrMarketDatumComparator());
     }
     for (auto it = it1; it != it2; ++it) {
         if (wildcard.isPrefix() || wildcard.matches((*it)->name()))
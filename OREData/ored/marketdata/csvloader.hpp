@@ -25,6 +25,7 @@
 
 #include <map>
 #include <ored/marketdata/loader.hpp>
+#include <string_view>
 
 namespace ore {
 namespace data {
@@ -34,6 +35,11 @@ namespace data {
   Data is loaded with the call to the constructor.
   Inspectors can be called to then retrieve quotes and fixings.
 
+  The files are memory mapped and parsed in chunks on nThreads threads. The results are merged in file order, i.e.
+  the first occurrence of a quote, fixing or dividend wins as for a sequential read. A line with an invalid number of
+  tokens, date or value aborts the load with an error giving the file name and line number, while a quote that can not
+  be parsed into a market datum is logged and skipped.
+
   TODO implementation has large overlap with inmemoryloader.?pp, factor this out
 
   \ingroup marketdata
@@ -70,7 +76,11 @@ public:
         //! Enable/disable implying today's fixings
         bool implyTodaysFixings = false,
 	//! Load fixings up to this date
-	Date fixingCutOffDate = Date());
+	Date fixingCutOffDate = Date(),
+        //! Number of threads used to parse the files
+        QuantLib::Size nThreads = 1,
+        //! If not empty, only quotes matching one of these names or wildcards (and FX spot rates) are loaded
+        const std::set<std::string>& quoteNames = {});
 
     CSVLoader( //! Quote file name
         const vector<string>& marketFiles,
@@ -81,7 +91,11 @@ public:
         //! Enable/disable implying today's fixings
         bool implyTodaysFixings = false,
 	//! Load fixings up to this date
-	Date fixingCutOffDate = Date());
+	Date fixingCutOffDate = Date(),
+        //! Number of threads used to parse the files
+        QuantLib::Size nThreads = 1,
+        //! If not empty, only quotes matching one of these names or wildcards (and FX spot rates) are loaded
+        const std::set<std::string>& quoteNames = {});
 
     std::vector<QuantLib::ext::shared_ptr<MarketDatum>> loadQuotes(const QuantLib::Date&) const override;
 
@@ -100,12 +114,19 @@ public:
 private:
     enum class DataType { Market, Fixing, Dividend };
     void loadFile(const string&, DataType);
+    void setQuoteNames(const std::set<std::string>& quoteNames);
+    bool isRequested(const std::string_view& name) const;
+    void addFxSpot(const QuantLib::ext::shared_ptr<MarketDatum>& md);
 
     bool implyTodaysFixings_;
-    std::map<QuantLib::Date, std::set<QuantLib::ext::shared_ptr<MarketDatum>, SharedPtrMarketDatumComparator>> data_;
+    //! market data by date, sorted by name for each date
+    std::map<QuantLib::Date, std::vector<QuantLib::ext::shared_ptr<MarketDatum>>> data_;
     std::set<Fixing> fixings_;
     std::set<QuantExt::Dividend> dividends_;
     Date fixingCutOffDate_;
+    QuantLib::Size nThreads_ = 1;
+    std::set<std::string, std::less<>> quoteNames_;
+    std::vector<Wildcard> quoteWildcards_;
 };
 } // namespace data
 } // namespace ore
@@ -0,0 +1,187 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/marketdata/curvecache.hpp>
+#include <ored/utilities/log.hpp>
+
+#include <ql/errors.hpp>
+
+#include <boost/filesystem.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+using QuantLib::Date;
+using QuantLib::Real;
+using QuantLib::Size;
+
+namespace ore {
+namespace data {
+
+namespace {
+// 64 bit FNV-1a hash, unlike std::hash this is stable across platforms and runs
+std::uint64_t fnv1a(const std::string& s) {
+    std::uint64_t h = 14695981039346656037ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+} // namespace
+
+CurveCache::Key& CurveCache::Key::add(const std::string& s) {
+    // length prefix to keep the concatenation unambiguous
+    key_ += std::to_string(s.size()) + ":" + s + ";";
+    return *this;
+}
+
+CurveCache::Key& CurveCache::Key::add(Real x) {
+    std::ostringstream os;
+    os << std::setprecision(17) << x;
+    key_ += os.str() + ";";
+    return *this;
+}
+
+CurveCache::Key& CurveCache::Key::add(const Date& d) {
+    key_ += std::to_string(d.serialNumber()) + ";";
+    return *this;
+}
+
+CurveCache::Key& CurveCache::Key::add(const Key& key) { return add(key.str()); }
+
+CurveCache::CurveCache() { DLOG("CurveCache: keep entries in memory"); }
+
+CurveCache::CurveCache(const std::string& directory) : directory_(directory) {
+    QL_REQUIRE(!directory_.empty(), "CurveCache: no directory given");
+    boost::filesystem::create_directories(directory_);
+    LOG("CurveCache: using directory '" << directory_ << "'");
+}
+
+std::string CurveCache::fileName(const Key& key) const {
+    std::ostringstream os;
+    os << std::hex << std::setw(16) << std::setfill('0') << fnv1a(key.str()) << ".curve";
+    return (boost::filesystem::path(directory_) / os.str()).string();
+}
+
+bool CurveCache::get(const Key& key, std::vector<Date>& dates, std::vector<Real>& values) const {
+    if (inMemory()) {
+        std::lock_guard<std::mutex> lock(entriesMutex_);
+        auto it = entries_.find(key.str());
+        if (it == entries_.end()) {
+            ++misses_;
+            return false;
+        }
+        dates = it->second.first;
+        values = it->second.second;
+        ++hits_;
+        return true;
+    }
+    std::ifstream in(fileName(key));
+    if (!in.is_open()) {
+        ++misses_;
+        return false;
+    }
+    // the file holds the key length, the key, the number of pillars and one line per pillar with the date serial
+    // number and the value
+    Size keySize, n;
+    std::string storedKey;
+    if (in >> keySize && in.get() == '\n') {
+        storedKey.resize(keySize);
+        in.read(&storedKey[0], keySize);
+    }
+    if (!in || storedKey != key.str() || !(in >> n)) {
+        ++misses_;
+        return false;
+    }
+    std::vector<Date> d(n);
+    std::vector<Real> v(n);
+    for (Size i = 0; i < n; ++i) {
+        Date::serial_type serial;
+        if (!(in >> serial >> v[i])) {
+            WLOG("CurveCache: cache file '" << fileName(key) << "' is corrupt, ignore it.");
+            ++misses_;
+            return false;
+        }
+        d[i] = Date(serial);
+    }
+    dates.swap(d);
+    values.swap(v);
+    ++hits_;
+    return true;
+}
+
+void CurveCache::put(const Key& key, const std::vector<Date>& dates, const std::vector<Real>& values) {
+    QL_REQUIRE(dates.size() == values.size(), "CurveCache::put(): dates size (" << dates.size()
+                                                                               << ") does not match values size ("
+                                                                               << values.size() << ")");
+    if (inMemory()) {
+        std::lock_guard<std::mutex> lock(entriesMutex_);
+        entries_[key.str()] = std::make_pair(dates, values);
+        return;
+    }
+    std::string file = fileName(key);
+    // the temporary file name must be unique across threads and processes sharing the cache directory
+    std::string tmp = file + boost::filesystem::unique_path(".tmp.%%%%-%%%%-%%%%-%%%%").string();
+    try {
+        {
+            std::ofstream out(tmp);
+            QL_REQUIRE(out.is_open(), "can not open file '" << tmp << "'");
+            out << key.str().size() << "\n" << key.str() << "\n" << dates.size() << "\n";
+            out << std::setprecision(17);
+            for (Size i = 0; i < dates.size(); ++i)
+                out << dates[i].serialNumber() << " " << values[i] << "\n";
+            QL_REQUIRE(out.good(), "error writing file '" << tmp << "'");
+        }
+        boost::filesystem::rename(tmp, file);
+    } catch (const std::exception& e) {
+        WLOG("CurveCache: could not write cache file '" << file << "': " << e.what());
+        boost::system::error_code ec;
+        boost::filesystem::remove(tmp, ec);
+    }
+}
+
+void CurveCache::setCurveKey(const QuantLib::ext::shared_ptr<QuantLib::TermStructure>& curve, const Key& key) {
+    if (curve == nullptr)
+        return;
+    std::lock_guard<std::mutex> lock(curveKeysMutex_);
+    // drop the registrations of expired curves, their addresses might be reused
+    for (auto it = curveKeys_.begin(); it != curveKeys_.end();) {
+        if (it->second.first.expired())
+            it = curveKeys_.erase(it);
+        else
+            ++it;
+    }
+    curveKeys_[curve.get()] = std::make_pair(QuantLib::ext::weak_ptr<QuantLib::TermStructure>(curve), key);
+}
+
+bool CurveCache::curveKey(const QuantLib::ext::shared_ptr<QuantLib::TermStructure>& curve, Key& key) const {
+    if (curve == nullptr)
+        return false;
+    std::lock_guard<std::mutex> lock(curveKeysMutex_);
+    auto it = curveKeys_.find(curve.get());
+    if (it == curveKeys_.end() || it->second.first.lock() != curve)
+        return false;
+    key = it->second.second;
+    return true;
+}
+
+} // namespace data
+} // namespace ore
@@ -0,0 +1,118 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/marketdata/curvecache.hpp
+    \brief Persistent cache of bootstrapped curve pillars
+    \ingroup curves
+*/
+
+#pragma once
+
+#include <ql/shared_ptr.hpp>
+#include <ql/termstructure.hpp>
+#include <ql/time/date.hpp>
+#include <ql/types.hpp>
+
+#include <atomic>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ore {
+namespace data {
+
+//! Persistent cache of bootstrapped curve pillars
+/*! The cache stores the pillar dates and values of a bootstrapped curve in a file in the given directory, so that a
+    later run can skip the bootstrap if the inputs of the curve did not change. A cache entry is identified by a key
+    that collects everything the bootstrap depends on, i.e. the curve spec, the curve configuration, the quote values
+    and the values of the curves it depends on, see Key. The file name is a hash of the key, the full key is stored in
+    the file and compared on lookup, so a hash collision results in a cache miss.
+
+    A curve that depends on another curve, e.g. a projection curve bootstrapped against a discount curve, adds the key
+    of that curve to its own key. To this end the key of each curve built via the cache is registered with the curve's
+    term structure, see setCurveKey(). A curve depending on a curve without a registered key can not be cached.
+
+    Lookups and insertions can be done concurrently, also by several processes sharing the directory. An entry is
+    written to a temporary file with a unique name first and then renamed, so that a concurrent reader never sees a
+    partially written entry.
+
+    A cache constructed without a directory keeps its entries in memory. This is used to hand curves bootstrapped on
+    worker threads to the thread building the market, see TodaysMarket.
+
+    \ingroup curves
+ */
+class CurveCache {
+public:
+    //! Cache key, the concatenation of all inputs of a curve bootstrap
+    class Key {
+    public:
+        Key& add(const std::string& s);
+        Key& add(QuantLib::Real x);
+        Key& add(const QuantLib::Date& d);
+        Key& add(const Key& key);
+        bool empty() const { return key_.empty(); }
+        const std::string& str() const { return key_; }
+
+    private:
+        std::string key_;
+    };
+
+    //! In memory cache
+    CurveCache();
+
+    //! The directory is created if it does not exist
+    explicit CurveCache(const std::string& directory);
+
+    //! Return true and set the dates and values if there is an entry for the key
+    bool get(const Key& key, std::vector<QuantLib::Date>& dates, std::vector<QuantLib::Real>& values) const;
+
+    //! Store the dates and values for the key, errors are logged and otherwise ignored
+    void put(const Key& key, const std::vector<QuantLib::Date>& dates, const std::vector<QuantLib::Real>& values);
+
+    //! Register the key of a curve built via the cache, the registration expires with the curve
+    void setCurveKey(const QuantLib::ext::shared_ptr<QuantLib::TermStructure>& curve, const Key& key);
+
+    //! Return true and set the key if a key is registered for the curve
+    bool curveKey(const QuantLib::ext::shared_ptr<QuantLib::TermStructure>& curve, Key& key) const;
+
+    const std::string& directory() const { return directory_; }
+
+    //! true if the entries are kept in memory
+    bool inMemory() const { return directory_.empty(); }
+
+    //! \name Statistics
+    //@{
+    QuantLib::Size hits() const { return hits_; }
+    QuantLib::Size misses() const { return misses_; }
+    //@}
+
+private:
+    std::string fileName(const Key& key) const;
+
+    std::string directory_;
+    mutable std::atomic<QuantLib::Size> hits_{0}, misses_{0};
+    mutable std::mutex entriesMutex_;
+    std::map<std::string, std::pair<std::vector<QuantLib::Date>, std::vector<QuantLib::Real>>> entries_;
+    mutable std::mutex curveKeysMutex_;
+    std::map<const QuantLib::TermStructure*, std::pair<QuantLib::ext::weak_ptr<QuantLib::TermStructure>, Key>>
+        curveKeys_;
+};
+
+} // namespace data
+} // namespace ore
@@ -19,6 +19,7 @@
 #include <ored/marketdata/defaultcurve.hpp>
 #include <ored/marketdata/yieldcurve.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/to_string.hpp>
 #include <ored/utilities/wildcard.hpp>
 
 #include <qle/termstructures/generatordefaulttermstructure.hpp>
@@ -226,7 +227,9 @@ namespace data {
 DefaultCurve::DefaultCurve(Date asof, DefaultCurveSpec spec, const Loader& loader,
                            const CurveConfigurations& curveConfigs,
                            map<string, QuantLib::ext::shared_ptr<YieldCurve>>& yieldCurves,
-                           map<string, QuantLib::ext::shared_ptr<DefaultCurve>>& defaultCurves) {
+                           map<string, QuantLib::ext::shared_ptr<DefaultCurve>>& defaultCurves,
+                           const QuantLib::ext::shared_ptr<CurveCache>& curveCache)
+    : curveCache_(curveCache) {
     const QuantLib::ext::shared_ptr<DefaultCurveConfig>& configs = curveConfigs.defaultCurveConfig(spec.curveConfigID());
     bool built = false;
     std::string errors;
@@ -485,42 +488,76 @@ void DefaultCurve::buildCdsCurve(const std::string& curveID, const DefaultCurveC
 
         // build single name curve
 
-        QuantLib::ext::shared_ptr<DefaultProbabilityTermStructure> tmp = QuantLib::ext::make_shared<SpCurve>(
-            asof, helpers, config.dayCounter(), LogLinear(),
-            QuantExt::IterativeBootstrap<SpCurve>(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
-                                                  minFactor, dontThrowSteps));
-
-        // As for yield curves we need to copy the piecewise curve because on eval date changes the relative date
-        // helpers with trigger a bootstrap.
         vector<Date> dates;
         vector<Real> survivalProbs;
-        dates.push_back(asof);
-        survivalProbs.push_back(1.0);
-
-        for (Size i = 0; i < helpers.size(); ++i) {
-            if (helpers[i]->latestDate() > asof) {
-                Date pillarDate = helpers[i]->pillarDate();
-                Probability sp = tmp->survivalProbability(pillarDate);
-
-                // In some cases the bootstrapped survival probability at one tenor will be `close` to that at a
-                // previous tenor. Here we don't add that survival probability and date to avoid issues when creating
-                // the InterpolatedSurvivalProbabilityCurve below.
-                if (!survivalProbs.empty() && close(survivalProbs.back(), sp)) {
-                    DLOG("Survival probability for curve " << spec.name() << " at date " << io::iso_date(pillarDate)
-                                                           << " is the same as that at previous date "
-                                                           << io::iso_date(dates.back()) << " so skipping it.");
-                    continue;
-                }
 
-                dates.push_back(pillarDate);
-                survivalProbs.push_back(sp);
-                TLOG(io::iso_date(pillarDate) << "," << fixed << setprecision(9) << sp);
-            }
+        // If the survival probabilities of a curve with identical inputs were cached, use them instead of
+        // bootstrapping the curve. The CDS helpers discount at all premium dates, so the key of the discount curve
+        // is part of the key. If the discount curve was not built via the cache, the curve is not cached either.
+        CurveCache::Key cacheKey, discountCurveKey;
+        bool useCache = curveCache_ && curveCache_->curveKey(discountCurve.currentLink(), discountCurveKey);
+        if (curveCache_ && !useCache) {
+            DLOG("Default curve " << spec.name() << " not cached, discount curve " << config.discountCurveID()
+                                  << " was not built via the curve cache");
         }
-        if (dates.size() == 1) {
-            // We might have removed points above. To make the interpolation work, we need at least two points though.
-            dates.push_back(dates.back() + 1);
-            survivalProbs.push_back(survivalProbs.back());
+        if (useCache) {
+            cacheKey.add("DefaultCurve")
+                .add(asof)
+                .add(spec.name())
+                .add(config.toXMLString())
+                .add(cdsConv->toXMLString())
+                .add(recoveryRate_);
+            for (auto const& q : quotes)
+                cacheKey.add(ore::data::to_string(q.term)).add(q.value).add(q.runningSpread);
+            for (auto const& h : helpers)
+                cacheKey.add(h->pillarDate());
+            cacheKey.add(config.discountCurveID()).add(discountCurveKey);
+        }
+
+        if (useCache && curveCache_->get(cacheKey, dates, survivalProbs)) {
+            DLOG("Default curve " << spec.name() << " built from curve cache");
+        } else {
+
+            QuantLib::ext::shared_ptr<DefaultProbabilityTermStructure> tmp = QuantLib::ext::make_shared<SpCurve>(
+                asof, helpers, config.dayCounter(), LogLinear(),
+                QuantExt::IterativeBootstrap<SpCurve>(accuracy, globalAccuracy, dontThrow, maxAttempts, maxFactor,
+                                                      minFactor, dontThrowSteps));
+
+            // As for yield curves we need to copy the piecewise curve because on eval date changes the relative date
+            // helpers with trigger a bootstrap.
+            dates.push_back(asof);
+            survivalProbs.push_back(1.0);
+
+            for (Size i = 0; i < helpers.size(); ++i) {
+                if (helpers[i]->latestDate() > asof) {
+                    Date pillarDate = helpers[i]->pillarDate();
+                    Probability sp = tmp->survivalProbability(pillarDate);
+
+                    // In some cases the bootstrapped survival probability at one tenor will be `close` to that at a
+                    // previous tenor. Here we don't add that survival probability and date to avoid issues when
+                    // creating the InterpolatedSurvivalProbabilityCurve below.
+                    if (!survivalProbs.empty() && close(survivalProbs.back(), sp)) {
+                        DLOG("Survival probability for curve " << spec.name() << " at date "
+                                                               << io::iso_date(pillarDate)
+                                                               << " is the same as that at previous date "
+                                                               << io::iso_date(dates.back()) << " so skipping it.");
+                        continue;
+                    }
+
+                    dates.push_back(pillarDate);
+                    survivalProbs.push_back(sp);
+                    TLOG(io::iso_date(pillarDate) << "," << fixed << setprecision(9) << sp);
+                }
+            }
+            if (dates.size() == 1) {
+                // We might have removed points above. To make the interpolation work, we need at least two points
+                // though.
+                dates.push_back(dates.back() + 1);
+                survivalProbs.push_back(survivalProbs.back());
+            }
+
+            if (useCache)
+                curveCache_->put(cacheKey, dates, survivalProbs);
         }
         qlCurve = QuantLib::ext::make_shared<QuantExt::InterpolatedSurvivalProbabilityCurve<LogLinear>>(
             dates, survivalProbs, config.dayCounter(), Calendar(), std::vector<Handle<Quote>>(), std::vector<Date>(),
@@ -25,6 +25,7 @@
 
 #include <ored/configuration/conventions.hpp>
 #include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/curvecache.hpp>
 #include <ored/marketdata/curvespec.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ql/termstructures/credit/interpolatedhazardratecurve.hpp>
@@ -50,10 +51,11 @@ public:
     //! Default constructor
     DefaultCurve() : recoveryRate_(QuantLib::Null<QuantLib::Real>()) {}
 
-    //! Detailed constructor
+    //! Detailed constructor, the optional curve cache is used for single name CDS curves
     DefaultCurve(Date asof, DefaultCurveSpec spec, const Loader& loader, const CurveConfigurations& curveConfigs,
                  map<string, QuantLib::ext::shared_ptr<YieldCurve>>& yieldCurves,
-                 map<string, QuantLib::ext::shared_ptr<DefaultCurve>>& defaultCurves);
+                 map<string, QuantLib::ext::shared_ptr<DefaultCurve>>& defaultCurves,
+                 const QuantLib::ext::shared_ptr<CurveCache>& curveCache = nullptr);
     //@}
     //! \name Inspectors
     //@{
@@ -65,6 +67,7 @@ private:
     DefaultCurveSpec spec_;
     QuantLib::ext::shared_ptr<QuantExt::CreditCurve> curve_;
     Real recoveryRate_;
+    QuantLib::ext::shared_ptr<CurveCache> curveCache_;
 
     //! Build a default curve from CDS spread quotes
     void buildCdsCurve(const std::string& curveID, const DefaultCurveConfig::Config& config, const QuantLib::Date& asof,
@@ -116,8 +116,11 @@ Handle<Quote> FXTriangulation::getQuote(const std::string& pair) const {
 
     // do we have a cached result?
 
-    if (auto it = quoteCache_.find(pair); it != quoteCache_.end())
-        return it->second;
+    {
+        boost::shared_lock<boost::shared_mutex> lock(*mutex_);
+        if (auto it = quoteCache_.find(pair); it != quoteCache_.end())
+            return it->second;
+    }
 
     // we need to construct the quote from the input quotes
 
@@ -161,8 +164,8 @@ Handle<Quote> FXTriangulation::getQuote(const std::string& pair) const {
 
     // add the result to the lookup cache and return it
 
-    quoteCache_[pair] = result;
-    return result;
+    boost::unique_lock<boost::shared_mutex> lock(*mutex_);
+    return quoteCache_.insert(std::make_pair(pair, result)).first->second;
 }
 
 Handle<FxIndex> FXTriangulation::getIndex(const std::string& indexOrPair, const Market* market,
@@ -170,8 +173,11 @@ Handle<FxIndex> FXTriangulation::getIndex(const std::string& indexOrPair, const
 
     // do we have a cached result?
 
-    if (auto it = indexCache_.find(std::make_pair(indexOrPair, configuration)); it != indexCache_.end()) {
-        return it->second;
+    {
+        boost::shared_lock<boost::shared_mutex> lock(*mutex_);
+        if (auto it = indexCache_.find(std::make_pair(indexOrPair, configuration)); it != indexCache_.end()) {
+            return it->second;
+        }
     }
 
     // otherwise we need to construct the index
@@ -255,8 +261,8 @@ Handle<FxIndex> FXTriangulation::getIndex(const std::string& indexOrPair, const
 
     // add the result to the lookup cache and return it
 
-    indexCache_[std::make_pair(indexOrPair, configuration)] = result;
-    return result;
+    boost::unique_lock<boost::shared_mutex> lock(*mutex_);
+    return indexCache_.insert(std::make_pair(std::make_pair(indexOrPair, configuration), result)).first->second;
 }
 
 std::vector<std::string> FXTriangulation::getPath(const std::string& forCcy, const std::string& domCcy) const {
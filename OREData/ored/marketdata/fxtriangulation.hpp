@@ -31,6 +31,9 @@
 #include <ql/quote.hpp>
 #include <ql/types.hpp>
 
+#include <boost/thread/lock_types.hpp>
+#include <boost/thread/shared_mutex.hpp>
+
 #include <vector>
 
 namespace ore {
@@ -72,9 +75,10 @@ private:
     // the input quotes
     std::map<std::string, QuantLib::Handle<QuantLib::Quote>> quotes_;
 
-    // caches to improve perfomance
+    // caches to improve perfomance, guarded by mutex_ since curves might be built concurrently
     mutable std::map<std::string, QuantLib::Handle<QuantLib::Quote>> quoteCache_;
     mutable std::map<std::pair<std::string, std::string>, QuantLib::Handle<QuantExt::FxIndex>> indexCache_;
+    QuantLib::ext::shared_ptr<boost::shared_mutex> mutex_ = QuantLib::ext::make_shared<boost::shared_mutex>();
 
     // internal data structure to represent the undirected graph of currencies
     std::vector<std::string> nodeToCcy_;
@@ -24,6 +24,7 @@
 #include <ored/marketdata/basecorrelationcurve.hpp>
 #include <ored/marketdata/capfloorvolcurve.hpp>
 #include <ored/marketdata/cdsvolcurve.hpp>
+#include <ored/marketdata/clonedloader.hpp>
 #include <ored/marketdata/commoditycurve.hpp>
 #include <ored/marketdata/commodityvolcurve.hpp>
 #include <ored/marketdata/correlationcurve.hpp>
@@ -43,6 +44,7 @@
 #include <ored/utilities/indexparser.hpp>
 #include <ored/utilities/indexnametranslator.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/parallelfor.hpp>
 #include <ored/utilities/to_string.hpp>
 #include <qle/indexes/dividendmanager.hpp>
 #include <qle/indexes/equityindex.hpp>
@@ -53,6 +55,8 @@
 #include <qle/termstructures/blackvolsurfacewithatm.hpp>
 #include <qle/termstructures/pricetermstructureadapter.hpp>
 
+#include <ql/indexes/indexmanager.hpp>
+#include <ql/settings.hpp>
 #include <ql/tuple.hpp>
 
 #include <boost/graph/topological_sort.hpp>
@@ -60,6 +64,10 @@
 #include <boost/range/adaptor/reversed.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
 using namespace std;
 using namespace QuantLib;
 
@@ -79,11 +87,13 @@ TodaysMarket::TodaysMarket(const Date& asof, const QuantLib::ext::shared_ptr<Tod
                            const bool loadFixings, const bool lazyBuild,
                            const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                            const bool preserveQuoteLinkage, const IborFallbackConfig& iborFallbackConfig,
-                           const bool buildCalibrationInfo, const bool handlePseudoCurrencies)
+                           const bool buildCalibrationInfo, const bool handlePseudoCurrencies, const Size nThreads,
+                           const QuantLib::ext::shared_ptr<CurveCache>& curveCache)
     : MarketImpl(handlePseudoCurrencies), params_(params), loader_(loader), curveConfigs_(curveConfigs),
       continueOnError_(continueOnError), loadFixings_(loadFixings), lazyBuild_(lazyBuild),
       preserveQuoteLinkage_(preserveQuoteLinkage), referenceData_(referenceData),
-      iborFallbackConfig_(iborFallbackConfig), buildCalibrationInfo_(buildCalibrationInfo) {
+      iborFallbackConfig_(iborFallbackConfig), buildCalibrationInfo_(buildCalibrationInfo), nThreads_(nThreads),
+      curveCache_(curveCache) {
     QL_REQUIRE(params_, "TodaysMarket: TodaysMarketParameters are null");
     QL_REQUIRE(loader_, "TodaysMarket: Loader is null");
     QL_REQUIRE(curveConfigs_, "TodaysMarket: CurveConfigurations are null");
@@ -159,6 +169,15 @@ void TodaysMarket::initialise(const Date& asof) {
 
     if (!lazyBuild_) {
 
+        // Bootstrap the yield and default curves on worker threads, the curves are then built from the cache below
+
+        QuantLib::ext::shared_ptr<CurveCache> curveCache = curveCache_;
+        if (nThreads_ > 1) {
+            timer.start();
+            bootstrapCurvesConcurrently();
+            timings["5 bootstrap curves concurrently"] = timer.elapsed().wall;
+        }
+
         // We need to build all discount curves first, since some curve builds ask for discount
         // curves from specific configurations
         timer.start();
@@ -225,6 +244,8 @@ void TodaysMarket::initialise(const Date& asof) {
             LOG("Loaded CurvesSpecs: success: " << countSuccess << ", error: " << countError);
         }
 
+        curveCache_ = curveCache;
+
     } else {
         LOG("Build objects in TodaysMarket lazily, i.e. when requested.");
     }
@@ -298,7 +319,8 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
                 DLOG("Building YieldCurve for asof " << asof_);
                 QuantLib::ext::shared_ptr<YieldCurve> yieldCurve = QuantLib::ext::make_shared<YieldCurve>(
                     asof_, *ycspec, *curveConfigs_, *loader_, requiredYieldCurves_, requiredDefaultCurves_, *fx_,
-                    referenceData_, iborFallbackConfig_, preserveQuoteLinkage_, buildCalibrationInfo_, this);
+                    referenceData_, iborFallbackConfig_, preserveQuoteLinkage_, buildCalibrationInfo_, this,
+                    curveCache_);
                 calibrationInfo_->yieldCurveCalibrationInfo[ycspec->name()] = yieldCurve->calibrationInfo();
                 itr = requiredYieldCurves_.insert(make_pair(ycspec->name(), yieldCurve)).first;
                 DLOG("Added YieldCurve \"" << ycspec->name() << "\" to requiredYieldCurves map");
@@ -510,7 +532,8 @@ void TodaysMarket::buildNode(const std::string& configuration, Node& node) const
                 // build the curve
                 DLOG("Building DefaultCurve for asof " << asof_);
                 QuantLib::ext::shared_ptr<DefaultCurve> defaultCurve = QuantLib::ext::make_shared<DefaultCurve>(
-                    asof_, *defaultspec, *loader_, *curveConfigs_, requiredYieldCurves_, requiredDefaultCurves_);
+                    asof_, *defaultspec, *loader_, *curveConfigs_, requiredYieldCurves_, requiredDefaultCurves_,
+                    curveCache_);
                 itr = requiredDefaultCurves_.insert(make_pair(defaultspec->name(), defaultCurve)).first;
             }
             DLOG("Adding DefaultCurve (" << node.name << ") with spec " << *defaultspec << " to configuration "
@@ -922,7 +945,13 @@ void TodaysMarket::require(const MarketObject o, const string& name, const strin
             else
                 buildErrors[g[m].name] = e.what();
             ++countError;
-            ALOG("error while building node " << g[m] << " in configuration " << configuration << ": " << e.what());
+            if (reportBuildErrors_) {
+                ALOG("error while building node " << g[m] << " in configuration " << configuration << ": "
+                                                  << e.what());
+            } else {
+                DLOG("error while building node " << g[m] << " in configuration " << configuration << ": "
+                                                  << e.what());
+            }
         }
     }
 
@@ -932,7 +961,7 @@ void TodaysMarket::require(const MarketObject o, const string& name, const strin
 
     // output errors
 
-    if (!buildErrors.empty()) {
+    if (!buildErrors.empty() && reportBuildErrors_) {
         for (auto const& error : buildErrors) {
             StructuredCurveErrorMessage(error.first, "Failed to Build Curve", error.second).log();
         }
@@ -946,6 +975,154 @@ void TodaysMarket::require(const MarketObject o, const string& name, const strin
     }
 } // TodaysMarket::require()
 
+void TodaysMarket::bootstrapCurvesConcurrently() {
+
+#ifndef QL_ENABLE_SESSIONS
+    WLOG("TodaysMarket: nThreads = " << nThreads_
+                                     << " requires a build with QL_ENABLE_SESSIONS = ON, build market objects "
+                                        "sequentially.");
+#else
+    if (preserveQuoteLinkage_) {
+        DLOG("TodaysMarket: quote linkage is preserved, curves are not cached and built sequentially.");
+        return;
+    }
+
+    // Collect the yield and default curves in topological order together with the curves they depend on, possibly
+    // via other market objects like swap indices. Several nodes can share one curve spec, e.g. a discount and an index
+    // curve, we bootstrap each spec once.
+
+    struct Job {
+        std::string configuration;
+        MarketObject obj;
+        std::string name;
+        std::string specName;
+        std::set<Size> dependencies;
+    };
+    std::vector<Job> jobs;
+    std::map<std::string, Size> jobIndex;
+
+    for (auto& [configuration, g] : dependencies_) {
+        std::vector<Vertex> order;
+        try {
+            boost::topological_sort(g, std::back_inserter(order));
+        } catch (const std::exception&) {
+            // the cycle is reported by the sequential build
+            continue;
+        }
+        for (auto const& m : order) {
+            auto const& spec = g[m].curveSpec;
+            if (spec == nullptr || jobIndex.count(spec->name()) > 0 ||
+                (spec->baseType() != CurveSpec::CurveType::Yield && spec->baseType() != CurveSpec::CurveType::Default))
+                continue;
+            Job job{configuration, g[m].obj, g[m].name, spec->name(), {}};
+            std::set<Vertex> visited;
+            std::vector<Vertex> stack(1, m);
+            while (!stack.empty()) {
+                Vertex v = stack.back();
+                stack.pop_back();
+                boost::graph_traits<Graph>::adjacency_iterator a, aend;
+                for (std::tie(a, aend) = boost::adjacent_vertices(v, g); a != aend; ++a) {
+                    if (!visited.insert(*a).second)
+                        continue;
+                    auto j = g[*a].curveSpec ? jobIndex.find(g[*a].curveSpec->name()) : jobIndex.end();
+                    if (j != jobIndex.end())
+                        job.dependencies.insert(j->second);
+                    else
+                        stack.push_back(*a);
+                }
+            }
+            jobIndex[spec->name()] = jobs.size();
+            jobs.push_back(job);
+        }
+    }
+
+    if (jobs.size() <= 1) {
+        // nothing to gain
+        return;
+    }
+
+    Size nWorkers = std::min(nThreads_, jobs.size());
+    DLOG("Bootstrap " << jobs.size() << " yield and default curves on " << nWorkers << " threads");
+
+    if (!curveCache_)
+        curveCache_ = QuantLib::ext::make_shared<CurveCache>();
+
+    // the worker sessions get the evaluation date, the fixings and a copy of the market data of the calling thread
+
+    Date evaluationDate = Settings::instance().evaluationDate();
+    bool includeReferenceDateEvents = Settings::instance().includeReferenceDateEvents();
+    auto includeTodaysCashFlows = Settings::instance().includeTodaysCashFlows();
+    bool enforcesTodaysHistoricFixings = Settings::instance().enforcesTodaysHistoricFixings();
+    std::vector<std::pair<std::string, TimeSeries<Real>>> histories;
+    for (auto const& name : IndexManager::instance().histories())
+        histories.push_back(std::make_pair(name, IndexManager::instance().getHistory(name)));
+    std::vector<QuantLib::ext::shared_ptr<Loader>> loaders;
+    for (Size w = 0; w < nWorkers; ++w)
+        loaders.push_back(QuantLib::ext::make_shared<ClonedLoader>(asof_, loader_));
+
+    auto initWorker = [&evaluationDate, &includeReferenceDateEvents, &includeTodaysCashFlows,
+                       &enforcesTodaysHistoricFixings, &histories]() {
+        Settings::instance().evaluationDate() = evaluationDate;
+        Settings::instance().includeReferenceDateEvents() = includeReferenceDateEvents;
+        Settings::instance().includeTodaysCashFlows() = includeTodaysCashFlows;
+        Settings::instance().enforcesTodaysHistoricFixings() = enforcesTodaysHistoricFixings;
+        for (auto const& [name, history] : histories)
+            IndexManager::instance().setHistory(name, history);
+    };
+
+    // Each worker takes the next job and waits until the curves it depends on are done. Jobs are taken in topological
+    // order, so that the oldest pending job can always run. The private market of a worker must be destroyed on the
+    // worker thread, since its objects are registered with the worker's session.
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::vector<bool> isDone(jobs.size(), false);
+    std::atomic<Size> next(0), built(0);
+
+    parallelFor(
+        nWorkers, nWorkers,
+        [this, &jobs, &loaders, &mutex, &done, &isDone, &next, &built](Size w) {
+            QuantLib::ext::shared_ptr<TodaysMarket> market;
+            for (Size k = next++; k < jobs.size(); k = next++) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    done.wait(lock, [&jobs, &isDone, k]() {
+                        for (auto const& d : jobs[k].dependencies)
+                            if (!isDone[d])
+                                return false;
+                        return true;
+                    });
+                }
+                try {
+                    if (!market) {
+                        // reference data is not thread safe, curves that need it are built on the calling thread
+                        market = QuantLib::ext::make_shared<TodaysMarket>(
+                            asof_, params_, loaders[w], curveConfigs_, true, false, true, nullptr, false,
+                            iborFallbackConfig_, false, false, 1, curveCache_);
+                        market->reportBuildErrors_ = false;
+                    }
+                    market->require(jobs[k].obj, jobs[k].name, jobs[k].configuration);
+                    if (market->requiredYieldCurves_.count(jobs[k].specName) > 0 ||
+                        market->requiredDefaultCurves_.count(jobs[k].specName) > 0)
+                        ++built;
+                } catch (const std::exception& e) {
+                    DLOG("concurrent bootstrap of " << jobs[k].specName << " failed (" << e.what()
+                                                    << "), will retry sequentially");
+                }
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    isDone[k] = true;
+                }
+                done.notify_all();
+            }
+        },
+        initWorker);
+
+    curvesBuiltConcurrently_ = built;
+    DLOG("Bootstrapped " << curvesBuiltConcurrently_ << " curves concurrently");
+#endif
+}
+
 std::ostream& operator<<(std::ostream& o, const DependencyGraph::Node& n) {
     return o << n.obj << "(" << n.name << "," << n.mapping << ")";
 }
@@ -25,6 +25,7 @@
 
 #include <ored/configuration/conventions.hpp>
 #include <ored/configuration/curveconfigurations.hpp>
+#include <ored/marketdata/curvecache.hpp>
 #include <ored/marketdata/curvespec.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/marketimpl.hpp>
@@ -75,6 +76,19 @@ class CorrelationCurve;
   Today's market's purpose is t0 pricing, the Simulation Market's purpose is
   pricing under future scenarios.
 
+  If nThreads > 1 and the market is not built lazily, the yield and default curves are bootstrapped on worker threads
+  first. Each worker thread runs in its own session with the evaluation date and the fixings of the calling thread and
+  builds the curves in a private, lazily built market from a copy of the market data. A curve is bootstrapped once the
+  curves it depends on are done. The bootstrapped curves are stored in the curve cache, an in memory cache is used if
+  none is given, and the market is then built from the cache on the calling thread, so that all market objects,
+  indices and observer registrations belong to the session of the calling thread. Curves that can not be cached, see
+  below, and the remaining market objects are built on the calling thread. This requires a QuantLib build with
+  QL_ENABLE_SESSIONS = ON, otherwise the market is built sequentially.
+
+  If a curve cache is given, bootstrapped yield curves and single name CDS curves are read from the cache if it
+  contains an entry with identical inputs, otherwise they are bootstrapped and stored in the cache, see CurveCache.
+  Yield curves do not use the cache if quote linkage is preserved.
+
   \ingroup marketdata
  */
 class TodaysMarket : public MarketImpl {
@@ -103,10 +117,20 @@ public:
         //! build calibration info?
         const bool buildCalibrationInfo = true,
         //! support pseudo currencies
-        const bool handlePseudoCurrencies = true);
+        const bool handlePseudoCurrencies = true,
+        //! number of threads used to build independent market objects concurrently, see below
+        const QuantLib::Size nThreads = 1,
+        //! optional persistent cache of bootstrapped curves, see below
+        const QuantLib::ext::shared_ptr<CurveCache>& curveCache = nullptr);
 
     QuantLib::ext::shared_ptr<TodaysMarketCalibrationInfo> calibrationInfo() const { return calibrationInfo_; }
 
+    //! true if market objects are built on request
+    bool lazyBuild() const { return lazyBuild_; }
+
+    //! number of curves that were bootstrapped on worker threads, see above
+    QuantLib::Size curvesBuiltConcurrently() const { return curvesBuiltConcurrently_; }
+
 private:
     // MarketImpl interface
     void require(const MarketObject o, const string& name, const string& configuration,
@@ -125,6 +149,12 @@ private:
     const QuantLib::ext::shared_ptr<ReferenceDataManager> referenceData_;
     const IborFallbackConfig iborFallbackConfig_;
     const bool buildCalibrationInfo_;
+    const QuantLib::Size nThreads_;
+    // the given curve cache, replaced by an in memory cache while curves are bootstrapped concurrently
+    QuantLib::ext::shared_ptr<CurveCache> curveCache_;
+    QuantLib::Size curvesBuiltConcurrently_ = 0;
+    // false for the private markets of the worker threads, the calling thread reports the build errors
+    bool reportBuildErrors_ = true;
 
     // initialise market
     void initialise(const Date& asof);
@@ -142,6 +172,9 @@ private:
     // build a single market object
     void buildNode(const std::string& configuration, Node& node) const;
 
+    // bootstrap the yield and default curves on worker threads and store them in the curve cache
+    void bootstrapCurvesConcurrently();
+
     // calibration results
     QuantLib::ext::shared_ptr<TodaysMarketCalibrationInfo> calibrationInfo_;
 
@@ -73,6 +73,8 @@
 #include <ored/utilities/parsers.hpp>
 #include <ored/utilities/to_string.hpp>
 
+#include <algorithm>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace std;
@@ -280,11 +282,12 @@ YieldCurve::YieldCurve(Date asof, YieldCurveSpec curveSpec, const CurveConfigura
                        const FXTriangulation& fxTriangulation,
                        const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                        const IborFallbackConfig& iborFallbackConfig, const bool preserveQuoteLinkage,
-                       const bool buildCalibrationInfo, const Market* market)
+                       const bool buildCalibrationInfo, const Market* market,
+                       const QuantLib::ext::shared_ptr<CurveCache>& curveCache)
     : asofDate_(asof), curveSpec_(curveSpec), loader_(loader), requiredYieldCurves_(requiredYieldCurves),
       requiredDefaultCurves_(requiredDefaultCurves), fxTriangulation_(fxTriangulation), referenceData_(referenceData),
       iborFallbackConfig_(iborFallbackConfig), preserveQuoteLinkage_(preserveQuoteLinkage),
-      buildCalibrationInfo_(buildCalibrationInfo), market_(market) {
+      buildCalibrationInfo_(buildCalibrationInfo), market_(market), curveCache_(curveCache) {
 
     try {
 
@@ -393,6 +396,42 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
     // a sorted instruments vector in the code here as well.
     std::sort(instruments.begin(), instruments.end(), QuantLib::detail::BootstrapHelperSorter());
 
+    auto setCalibrationInfo = [this, &instruments]() {
+        if (buildCalibrationInfo_) {
+            calibrationInfo_ = QuantLib::ext::make_shared<PiecewiseYieldCurveCalibrationInfo>();
+            for (Size i = 0; i < instruments.size(); ++i) {
+                calibrationInfo_->pillarDates.push_back(instruments[i]->pillarDate());
+            }
+        }
+    };
+
+    auto fixedCurve = [this](const vector<Date>& dates, const vector<Real>& values) {
+        if (interpolationVariable_ == InterpolationVariable::Zero)
+            return zerocurve(dates, values, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
+        else if (interpolationVariable_ == InterpolationVariable::Discount)
+            return discountcurve(dates, values, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
+        else if (interpolationVariable_ == InterpolationVariable::Forward)
+            return forwardcurve(dates, values, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
+        else
+            QL_FAIL("Interpolation variable not recognised.");
+    };
+
+    // If the pillars of a curve with identical inputs were cached, use them instead of bootstrapping the curve. This
+    // only applies to curves that are detached from the quotes, see below.
+    CurveCache::Key cacheKey;
+    bool useCache = curveCache_ && !preserveQuoteLinkage_ && curveCacheKey(instruments, cacheKey);
+    if (useCache) {
+        vector<Date> dates;
+        vector<Real> values;
+        if (curveCache_->get(cacheKey, dates, values)) {
+            DLOG("Yield curve " << curveSpec_.name() << " built from curve cache");
+            p_ = fixedCurve(dates, values);
+            curveCache_->setCurveKey(p_, cacheKey);
+            setCalibrationInfo();
+            return p_;
+        }
+    }
+
     // Get configuration values for bootstrap
     Real accuracy = curveConfig_->bootstrapConfig().accuracy();
     Real globalAccuracy = curveConfig_->bootstrapConfig().globalAccuracy();
@@ -821,25 +860,116 @@ YieldCurve::piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instrum
         }
         zeros[0] = zeros[1];
         forwards[0] = forwards[1];
-        if (interpolationVariable_ == InterpolationVariable::Zero)
-            p_ = zerocurve(dates, zeros, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
-        else if (interpolationVariable_ == InterpolationVariable::Discount)
-            p_ = discountcurve(dates, discounts, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
-        else if (interpolationVariable_ == InterpolationVariable::Forward)
-            p_ = forwardcurve(dates, forwards, zeroDayCounter_, interpolationMethod_, mixedInterpolationSize_);
-        else
-            QL_FAIL("Interpolation variable not recognised.");
+        const vector<Real>& values = interpolationVariable_ == InterpolationVariable::Zero       ? zeros
+                                     : interpolationVariable_ == InterpolationVariable::Discount ? discounts
+                                                                                                 : forwards;
+        p_ = fixedCurve(dates, values);
+        if (useCache) {
+            curveCache_->put(cacheKey, dates, values);
+            curveCache_->setCurveKey(p_, cacheKey);
+        }
     }
 
     // set calibration info
-    if (buildCalibrationInfo_) {
-        calibrationInfo_ = QuantLib::ext::make_shared<PiecewiseYieldCurveCalibrationInfo>();
-        for (Size i = 0; i < instruments.size(); ++i) {
-            calibrationInfo_->pillarDates.push_back(instruments[i]->pillarDate());
+    setCalibrationInfo();
+
+    return p_;
+}
+
+bool YieldCurve::curveCacheKey(const vector<QuantLib::ext::shared_ptr<RateHelper>>& instruments,
+                               CurveCache::Key& key) const {
+    key = CurveCache::Key();
+    key.add("YieldCurve").add(asofDate_).add(curveSpec_.name()).add(curveConfig_->toXMLString());
+    const QuantLib::ext::shared_ptr<Conventions>& conventions = InstrumentConventions::instance().conventions();
+    for (auto const& s : curveSegments_) {
+        if (conventions->has(s->conventionsID()))
+            key.add(conventions->get(s->conventionsID())->toXMLString());
+    }
+    // the helper quotes and pillars capture the market quotes and the conventions used to build the helpers
+    for (auto const& h : instruments)
+        key.add(h->pillarDate()).add(h->quote()->value());
+    // FX spot rates used by cross currency helpers are not helper quotes
+    for (auto const& q : curveConfig_->quotes()) {
+        if (loader_.has(q, asofDate_))
+            key.add(q).add(loader_.get(q, asofDate_)->quote()->value());
+    }
+    // the discount and projection curves the helpers depend on, the helpers use these curves at all cash flow dates,
+    // so we add their keys rather than their values at the pillars
+    CurveCache::Key curveKey;
+    std::set<string> requiredIds = curveConfig_->requiredCurveIds(CurveSpec::CurveType::Yield);
+    for (auto const& [name, curve] : requiredYieldCurves_) {
+        if (requiredIds.count(curve->curveSpec().curveConfigID()) == 0)
+            continue;
+        if (!curveCache_->curveKey(curve->handle().currentLink(), curveKey)) {
+            DLOG("Yield curve " << curveSpec_.name() << " not cached, required curve " << name
+                                << " was not built via the curve cache");
+            return false;
+        }
+        key.add(name).add(curveKey);
+    }
+    // the in currency discount curves from the market used by FX forward and cross currency segments
+    for (auto const& [ccy, curve] : inCcyDiscountCurves_) {
+        if (!curveCache_->curveKey(curve.currentLink(), curveKey)) {
+            DLOG("Yield curve " << curveSpec_.name() << " not cached, in currency discount curve for " << ccy
+                                << " was not built via the curve cache");
+            return false;
+        }
+        key.add("inCcy").add(ccy).add(curveKey);
+    }
+    // the past fixings of the indices the helpers depend on
+    for (auto const& index : helperIndices()) {
+        key.add(index->name());
+        for (auto const& [d, v] : index->timeSeries()) {
+            if (d > asofDate_)
+                break;
+            key.add(d).add(v);
         }
     }
+    return true;
+}
 
-    return p_;
+vector<QuantLib::ext::shared_ptr<Index>> YieldCurve::helperIndices() const {
+    vector<QuantLib::ext::shared_ptr<Index>> indices;
+    const QuantLib::ext::shared_ptr<Conventions>& conventions = InstrumentConventions::instance().conventions();
+    for (auto const& s : curveSegments_) {
+        if (!conventions->has(s->conventionsID()))
+            continue;
+        auto c = conventions->get(s->conventionsID());
+        try {
+            // deposit helpers do not use fixings
+            if (auto f = QuantLib::ext::dynamic_pointer_cast<FutureConvention>(c)) {
+                indices.push_back(f->index());
+            } else if (auto f = QuantLib::ext::dynamic_pointer_cast<FraConvention>(c)) {
+                indices.push_back(f->index());
+            } else if (auto o = QuantLib::ext::dynamic_pointer_cast<OisConvention>(c)) {
+                indices.push_back(o->index());
+            } else if (auto o = QuantLib::ext::dynamic_pointer_cast<IRSwapConvention>(c)) {
+                indices.push_back(o->index());
+            } else if (auto o = QuantLib::ext::dynamic_pointer_cast<AverageOisConvention>(c)) {
+                indices.push_back(o->index());
+            } else if (auto b = QuantLib::ext::dynamic_pointer_cast<TenorBasisSwapConvention>(c)) {
+                indices.push_back(b->payIndex());
+                indices.push_back(b->receiveIndex());
+            } else if (auto b = QuantLib::ext::dynamic_pointer_cast<TenorBasisTwoSwapConvention>(c)) {
+                indices.push_back(b->longIndex());
+                indices.push_back(b->shortIndex());
+            } else if (auto b = QuantLib::ext::dynamic_pointer_cast<BMABasisSwapConvention>(c)) {
+                indices.push_back(b->liborIndex());
+                indices.push_back(b->bmaIndex());
+            } else if (auto b = QuantLib::ext::dynamic_pointer_cast<CrossCcyBasisSwapConvention>(c)) {
+                indices.push_back(b->flatIndex());
+                indices.push_back(b->spreadIndex());
+            } else if (auto x = QuantLib::ext::dynamic_pointer_cast<CrossCcyFixFloatSwapConvention>(c)) {
+                indices.push_back(x->index());
+            }
+        } catch (const std::exception& e) {
+            // the helpers can not be built either in this case, so the key is not used
+            DLOG("YieldCurve::helperIndices(): could not get index for conventions '" << s->conventionsID()
+                                                                                      << "': " << e.what());
+        }
+    }
+    indices.erase(std::remove(indices.begin(), indices.end(), nullptr), indices.end());
+    return indices;
 }
 
 void YieldCurve::buildZeroCurve() {
@@ -2436,6 +2566,7 @@ void YieldCurve::addFXForwards(const QuantLib::ext::shared_ptr<YieldCurveSegment
         DLOG("YieldCurve::addFXForwards No discount curve provided for building curve " << 
             curveSpec_.name() << ", looking up the inccy curve in the market.")
         knownDiscountCurve = market_->discountCurve(knownCurrency.code(), Market::inCcyConfiguration);
+        inCcyDiscountCurves_[knownCurrency.code()] = knownDiscountCurve;
     }
 
 
@@ -2602,6 +2733,7 @@ void YieldCurve::addCrossCcyBasisSwaps(const QuantLib::ext::shared_ptr<YieldCurv
         DLOG("YieldCurve::addCrossCcyBasisSwaps No discount curve provided for building curve "
              << curveSpec_.name() << ", looking up the inccy curve in the market.")
         foreignDiscountCurve = market_->discountCurve(foreignCcy.code(), Market::inCcyConfiguration);
+        inCcyDiscountCurves_[foreignCcy.code()] = foreignDiscountCurve;
     }
 
     /* Need to retrieve the foreign projection curve in the other currency. If its ID is empty,
@@ -2782,6 +2914,7 @@ void YieldCurve::addCrossCcyFixFloatSwaps(const QuantLib::ext::shared_ptr<YieldC
         DLOG("YieldCurve::addCrossCcyFixFloatSwaps No discount curve provided for building curve "
              << curveSpec_.name() << ", looking up the inccy curve in the market.")
         floatLegDisc = market_->discountCurve(floatLegCcy.code(), Market::inCcyConfiguration);
+        inCcyDiscountCurves_[floatLegCcy.code()] = floatLegDisc;
     }
 
     // Retrieve the projection curve on the float leg. If empty, use discount curve.
@@ -29,6 +29,7 @@
 #include <ored/configuration/curveconfigurations.hpp>
 #include <ored/configuration/iborfallbackconfig.hpp>
 #include <ored/configuration/yieldcurveconfig.hpp>
+#include <ored/marketdata/curvecache.hpp>
 #include <ored/marketdata/curvespec.hpp>
 #include <ored/marketdata/fxtriangulation.hpp>
 #include <ored/marketdata/loader.hpp>
@@ -113,7 +114,9 @@ public:
         //! build calibration info
         const bool buildCalibrationInfo = true,
 	//! market object to look up external discount curves
-        const Market* market = nullptr);
+        const Market* market = nullptr,
+        //! optional cache of bootstrapped curves, only used if quote linkage is not preserved
+        const QuantLib::ext::shared_ptr<CurveCache>& curveCache = nullptr);
 
     //! \name Inspectors
     //@{
@@ -172,8 +175,16 @@ private:
     const bool preserveQuoteLinkage_;
     bool buildCalibrationInfo_;
     const Market* market_;
+    QuantLib::ext::shared_ptr<CurveCache> curveCache_;
+    //! In currency discount curves looked up in market_ by FX forward and cross currency segments
+    map<string, Handle<YieldTermStructure>> inCcyDiscountCurves_;
 
     QuantLib::ext::shared_ptr<YieldTermStructure> piecewisecurve(vector<QuantLib::ext::shared_ptr<RateHelper>> instruments);
+    /*! Key of a piecewise curve in the curve cache, the \p instruments must be sorted. Returns false if the curve can
+        not be cached, because a curve it depends on has no key in the cache. */
+    bool curveCacheKey(const vector<QuantLib::ext::shared_ptr<RateHelper>>& instruments, CurveCache::Key& key) const;
+    //! The indices of the segment conventions, their past fixings are part of the cache key
+    vector<QuantLib::ext::shared_ptr<Index>> helperIndices() const;
 
     /* Functions to build RateHelpers from yield curve segments */
     void addDeposits(const QuantLib::ext::shared_ptr<YieldCurveSegment>& segment,
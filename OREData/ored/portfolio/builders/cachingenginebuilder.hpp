@@ -46,6 +46,9 @@ namespace data {
  *  The remaining variable arguments are to be passed to engine() and
  *  engineImpl(), these are the specific parameters required to build
  *  an engine or coupon pricer for this trade type.
+ *  The cache lookup and the engine creation are guarded by the builder's mutex, and use the parameters passed to
+ *  init() on the calling thread. Engines are cached per key and parameter set, so that trade types sharing a builder
+ *  but configured with different parameters do not share engines.
     \ingroup builders
  */
 template <class T, class U, typename... Args> class CachingEngineBuilder : public EngineBuilder {
@@ -60,7 +63,9 @@ public:
 
     //! Return a PricingEngine or a FloatingRateCouponPricer
     QuantLib::ext::shared_ptr<U> engine(Args... params) {
-        T key = keyImpl(params...);
+        // engines are built once per key, also if several threads build trades concurrently
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        std::pair<QuantLib::Size, T> key(activateThreadParameters(), keyImpl(params...));
         if (engines_.find(key) == engines_.end()) {
             // build first (in case it throws)
             QuantLib::ext::shared_ptr<U> engine = engineImpl(params...);
@@ -70,13 +75,16 @@ public:
         return engines_[key];
     }
 
-    void reset() override { engines_.clear(); }
+    void reset() override {
+        std::lock_guard<std::recursive_mutex> lock(mutex_);
+        engines_.clear();
+    }
 
 protected:
     virtual T keyImpl(Args...) = 0;
     virtual QuantLib::ext::shared_ptr<U> engineImpl(Args...) = 0;
 
-    map<T, QuantLib::ext::shared_ptr<U>> engines_;
+    map<std::pair<QuantLib::Size, T>, QuantLib::ext::shared_ptr<U>> engines_;
 };
 
 template <class T, typename... Args>
@@ -39,6 +39,9 @@ static DefaultProbKey dummyDefaultProbKey() {
 
 QuantLib::ext::shared_ptr<PricingEngine> CboMCEngineBuilder::engine(const QuantLib::ext::shared_ptr<Pool>& pool) {
 
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    activateThreadParameters();
+
     // get parameter
     Size samples = parseInteger(engineParameter("Samples"));
     Size bins = parseInteger(engineParameter("Bins"));
@@ -79,6 +79,9 @@ ScriptedTradeEngineBuilder::engine(const std::string& id, const ScriptedTrade& s
                                    const QuantLib::ext::shared_ptr<ReferenceDataManager>& referenceData,
                                    const IborFallbackConfig& iborFallbackConfig) {
 
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    activateThreadParameters();
+
     const std::vector<ScriptedTradeEventData>& events = scriptedTrade.events();
     const std::vector<ScriptedTradeValueTypeData>& numbers = scriptedTrade.numbers();
     const std::vector<ScriptedTradeValueTypeData>& indices = scriptedTrade.indices();
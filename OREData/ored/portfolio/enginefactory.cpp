@@ -52,14 +52,71 @@ std::string getParameter(const std::map<std::string, std::string>& m, const std:
 }
 } // namespace
 
+void EngineBuilder::init(const QuantLib::ext::shared_ptr<Market> market, const map<MarketContext, string>& configurations,
+                         const map<string, string>& modelParameters, const map<string, string>& engineParameters,
+                         const std::map<std::string, std::string>& globalParameters) {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    // parameter sets for another market are not needed anymore, we do not reuse their ids though, since the engine
+    // cache of a CachingEngineBuilder might still hold engines for them
+    if (!parameterSets_.empty() && parameterSets_.front()->market != market) {
+        parameterSets_.clear();
+        threadParameters_.clear();
+    }
+    QuantLib::ext::shared_ptr<const Parameters> parameters;
+    for (auto const& p : parameterSets_) {
+        if (p->configurations == configurations && p->modelParameters == modelParameters &&
+            p->engineParameters == engineParameters && p->globalParameters == globalParameters) {
+            parameters = p;
+            break;
+        }
+    }
+    if (!parameters) {
+        parameters = QuantLib::ext::make_shared<const Parameters>(Parameters{
+            nextParametersId_++, market, configurations, modelParameters, engineParameters, globalParameters});
+        parameterSets_.push_back(parameters);
+    }
+    threadParameters_[std::this_thread::get_id()] = parameters;
+    activateThreadParameters();
+}
+
+QuantLib::ext::shared_ptr<const EngineBuilder::Parameters> EngineBuilder::threadParameters() const {
+    auto p = threadParameters_.find(std::this_thread::get_id());
+    return p == threadParameters_.end() ? nullptr : p->second;
+}
+
+QuantLib::Size EngineBuilder::activateThreadParameters() {
+    auto p = threadParameters();
+    if (p && p->id != activeParameters_) {
+        market_ = p->market;
+        configurations_ = p->configurations;
+        modelParameters_ = p->modelParameters;
+        engineParameters_ = p->engineParameters;
+        globalParameters_ = p->globalParameters;
+        activeParameters_ = p->id;
+    }
+    return activeParameters_;
+}
+
+string EngineBuilder::configuration(const MarketContext& key) const {
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto p = threadParameters();
+    const map<MarketContext, string>& configurations = p ? p->configurations : configurations_;
+    auto c = configurations.find(key);
+    return c == configurations.end() ? Market::defaultConfiguration : c->second;
+}
+
 std::string EngineBuilder::engineParameter(const std::string& p, const std::vector<std::string>& qualifiers,
                                            const bool mandatory, const std::string& defaultValue) const {
-    return getParameter(engineParameters_, p, qualifiers, mandatory, defaultValue);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto tp = threadParameters();
+    return getParameter(tp ? tp->engineParameters : engineParameters_, p, qualifiers, mandatory, defaultValue);
 }
 
 std::string EngineBuilder::modelParameter(const std::string& p, const std::vector<std::string>& qualifiers,
                                           const bool mandatory, const std::string& defaultValue) const {
-    return getParameter(modelParameters_, p, qualifiers, mandatory, defaultValue);
+    std::lock_guard<std::recursive_mutex> lock(mutex_);
+    auto tp = threadParameters();
+    return getParameter(tp ? tp->modelParameters : modelParameters_, p, qualifiers, mandatory, defaultValue);
 }
 
 void EngineBuilderFactory::addEngineBuilder(const std::function<QuantLib::ext::shared_ptr<EngineBuilder>()>& builder,
@@ -200,6 +257,9 @@ void EngineFactory::registerBuilder(const QuantLib::ext::shared_ptr<EngineBuilde
 }
 
 QuantLib::ext::shared_ptr<EngineBuilder> EngineFactory::builder(const string& tradeType) {
+    // trades might be built concurrently, the engine data accessors below are not thread safe
+    std::unique_lock<std::mutex> lock(mutex_);
+
     // Check that we have a model/engine for tradetype
     QL_REQUIRE(engineData_->hasProduct(tradeType),
                "No Pricing Engine configuration was provided for trade type " << tradeType);
@@ -223,8 +283,12 @@ QuantLib::ext::shared_ptr<EngineBuilder> EngineFactory::builder(const string& tr
     if(auto db = QuantLib::ext::dynamic_pointer_cast<DelegatingEngineBuilder>(builder))
 	effectiveTradeType = db->effectiveTradeType();
 
-    builder->init(market_, configurations_, engineData_->modelParameters(effectiveTradeType),
-                  engineData_->engineParameters(effectiveTradeType), engineData_->globalParameters());
+    // release the lock before we init the builder, which locks the builder's mutex
+    map<string, string> modelParameters = engineData_->modelParameters(effectiveTradeType);
+    map<string, string> engineParameters = engineData_->engineParameters(effectiveTradeType);
+    lock.unlock();
+
+    builder->init(market_, configurations_, modelParameters, engineParameters, engineData_->globalParameters());
 
     return builder;
 }
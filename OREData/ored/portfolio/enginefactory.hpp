@@ -36,7 +36,9 @@
 #include <ql/shared_ptr.hpp>
 
 #include <map>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <vector>
 
 namespace ore {
@@ -113,13 +115,7 @@ public:
     const set<string>& tradeTypes() const { return tradeTypes_; }
 
     //! Return a configuration (or the default one if key not found)
-    const string& configuration(const MarketContext& key) {
-        if (configurations_.count(key) > 0) {
-            return configurations_.at(key);
-        } else {
-            return Market::defaultConfiguration;
-        }
-    }
+    string configuration(const MarketContext& key) const;
 
     //! reset the builder (e.g. clear cache)
     virtual void reset() {}
@@ -127,20 +123,22 @@ public:
     //! Initialise this Builder with the market and parameters to use
     /*! This method should not be called directly, it is called by the EngineFactory
      *  before it is returned.
+     *
+     *  The parameters are remembered for the calling thread. A builder can be shared by several trade types with
+     *  different parameters, and trades of these types might be built concurrently. The parameters passed to the
+     *  last init() call on a thread are used by the engine(), configuration(), engineParameter() and modelParameter()
+     *  calls on that thread, also if another thread initialised the builder in between.
      */
     void init(const QuantLib::ext::shared_ptr<Market> market, const map<MarketContext, string>& configurations,
               const map<string, string>& modelParameters, const map<string, string>& engineParameters,
-              const std::map<std::string, std::string>& globalParameters = {}) {
-        market_ = market;
-        configurations_ = configurations;
-        modelParameters_ = modelParameters;
-        engineParameters_ = engineParameters;
-        globalParameters_ = globalParameters;
-    }
+              const std::map<std::string, std::string>& globalParameters = {});
 
     //! return model builders
     const set<std::pair<string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>>& modelBuilders() const { return modelBuilders_; }
 
+    //! guards the state of the builder, which might be used by several threads building trades concurrently
+    std::recursive_mutex& mutex() const { return mutex_; }
+
     /*! retrieve engine parameter p, first look for p_qualifier, if this does not exist fall back to p */
     std::string engineParameter(const std::string& p, const std::vector<std::string>& qualifiers = {},
                                 const bool mandatory = true, const std::string& defaultValue = "") const;
@@ -149,6 +147,10 @@ public:
                                const bool mandatory = true, const std::string& defaultValue = "") const;
 
 protected:
+    /*! Set the market and parameters below to the ones passed to init() on the calling thread and return the id of
+        this parameter set. The caller must hold the builder's mutex. */
+    QuantLib::Size activateThreadParameters();
+
     string model_;
     string engine_;
     set<string> tradeTypes_;
@@ -158,6 +160,24 @@ protected:
     map<string, string> engineParameters_;
     std::map<std::string, std::string> globalParameters_;
     set<std::pair<string, QuantLib::ext::shared_ptr<QuantExt::ModelBuilder>>> modelBuilders_;
+    mutable std::recursive_mutex mutex_;
+
+private:
+    struct Parameters {
+        QuantLib::Size id;
+        QuantLib::ext::shared_ptr<Market> market;
+        map<MarketContext, string> configurations;
+        map<string, string> modelParameters;
+        map<string, string> engineParameters;
+        std::map<std::string, std::string> globalParameters;
+    };
+    // the distinct parameter sets passed to init(), the parameter set last passed on each thread and the active one
+    std::vector<QuantLib::ext::shared_ptr<const Parameters>> parameterSets_;
+    std::map<std::thread::id, QuantLib::ext::shared_ptr<const Parameters>> threadParameters_;
+    QuantLib::Size activeParameters_ = 0;
+    QuantLib::Size nextParametersId_ = 1;
+    // the parameters passed to init() on the calling thread, or null if there are none
+    QuantLib::ext::shared_ptr<const Parameters> threadParameters() const;
 };
 
 //! Delegating Engine Builder
@@ -298,6 +318,7 @@ private:
     map<string, QuantLib::ext::shared_ptr<LegBuilder>> legBuilders_;
     QuantLib::ext::shared_ptr<ReferenceDataManager> referenceData_;
     IborFallbackConfig iborFallbackConfig_;
+    std::mutex mutex_;
 };
 
 //! Leg builder
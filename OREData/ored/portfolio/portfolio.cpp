@@ -16,6 +16,7 @@
  FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
 */
 
+#include <ored/marketdata/todaysmarket.hpp>
 #include <ored/portfolio/failedtrade.hpp>
 #include <ored/portfolio/fxforward.hpp>
 #include <ored/portfolio/portfolio.hpp>
@@ -24,6 +25,7 @@
 #include <ored/portfolio/swap.hpp>
 #include <ored/portfolio/swaption.hpp>
 #include <ored/utilities/log.hpp>
+#include <ored/utilities/parallelfor.hpp>
 #include <ored/utilities/xmlutils.hpp>
 #include <ql/errors.hpp>
 #include <ql/time/date.hpp>
@@ -120,14 +122,65 @@ void Portfolio::removeMatured(const Date& asof) {
 }
 
 void Portfolio::build(const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory, const std::string& context,
-                      const bool emitStructuredError) {
+                      const bool emitStructuredError, const Size nThreads) {
     LOG("Building Portfolio of size " << trades_.size() << " for context = '" << context << "'");
+
+    // check whether we can build the trades concurrently
+
+    bool parallel = nThreads > 1 && trades_.size() > 1;
+#if defined(QL_ENABLE_SESSIONS) || !defined(QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN)
+    QL_REQUIRE(nThreads <= 1, "Portfolio::build(): nThreads = "
+                                  << nThreads
+                                  << " requires a build with QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN = ON and "
+                                     "QL_ENABLE_SESSIONS = OFF, context is '"
+                                  << context << "'");
+#endif
+    if (auto tm = QuantLib::ext::dynamic_pointer_cast<TodaysMarket>(engineFactory->market()); parallel && tm) {
+        QL_REQUIRE(!tm->lazyBuild(), "Portfolio::build(): nThreads = "
+                                         << nThreads << " requires a market that is not built lazily, context is '"
+                                         << context << "'");
+    }
+
+    // build the trades on the worker threads, the errors are handled below in the order of the trade ids
+
+    std::vector<std::string> errors;
+    std::vector<char> failed;
+    if (parallel) {
+        std::vector<QuantLib::ext::shared_ptr<Trade>> trades;
+        for (auto const& [_, t] : trades_)
+            trades.push_back(t);
+        errors.resize(trades.size());
+        failed.resize(trades.size(), 0);
+        parallelFor(trades.size(), nThreads, [&engineFactory, &trades, &errors, &failed](Size k) {
+            try {
+                trades[k]->reset();
+                trades[k]->build(engineFactory);
+            } catch (std::exception& e) {
+                errors[k] = e.what();
+                failed[k] = 1;
+            }
+        });
+    }
+
     auto trade = trades_.begin();
     Size initialSize = trades_.size();
     Size failedTrades = 0;
+    Size k = 0;
     while (trade != trades_.end()) {
-        auto [ft, success] = buildTrade((*trade).second, engineFactory, context, ignoreTradeBuildFail(),
-                                        buildFailedTrades(), emitStructuredError);
+        std::pair<QuantLib::ext::shared_ptr<Trade>, bool> result;
+        if (!parallel) {
+            result = buildTrade((*trade).second, engineFactory, context, ignoreTradeBuildFail(), buildFailedTrades(),
+                                emitStructuredError);
+        } else if (!failed[k]) {
+            TLOG("Required Fixings for trade " << (*trade).second->id() << ":");
+            TLOGGERSTREAM((*trade).second->requiredFixings());
+            result = std::make_pair(nullptr, true);
+        } else {
+            result = handleTradeBuildError((*trade).second, engineFactory, context, errors[k], ignoreTradeBuildFail(),
+                                           buildFailedTrades(), emitStructuredError);
+        }
+        ++k;
+        auto [ft, success] = result;
         if (success) {
             ++trade;
         } else if (ft) {
@@ -277,25 +330,34 @@ std::pair<QuantLib::ext::shared_ptr<Trade>, bool> buildTrade(QuantLib::ext::shar
         TLOGGERSTREAM(trade->requiredFixings());
         return std::make_pair(nullptr, true);
     } catch (std::exception& e) {
-        if (emitStructuredError) {
-            StructuredTradeErrorMessage(trade, "Error building trade for context '" + context + "'", e.what()).log();
-        } else {
-            ALOG("Error building trade '" << trade->id() << "' for context '" + context + "': " + e.what());
-        }
-        if (ignoreTradeBuildFail) {
-            return std::make_pair(trade, false);
-        } else if (buildFailedTrades) {
-            QuantLib::ext::shared_ptr<FailedTrade> failed = QuantLib::ext::make_shared<FailedTrade>();
-            failed->id() = trade->id();
-            failed->setUnderlyingTradeType(trade->tradeType());
-            failed->setEnvelope(trade->envelope());
-            failed->build(engineFactory);
-            failed->resetPricingStats(trade->getNumberOfPricings(), trade->getCumulativePricingTime());
-            LOG("Built failed trade with id " << failed->id());
-            return std::make_pair(failed, false);
-        } else {
-            return std::make_pair(nullptr, false);
-        }
+        return handleTradeBuildError(trade, engineFactory, context, e.what(), ignoreTradeBuildFail, buildFailedTrades,
+                                     emitStructuredError);
+    }
+}
+
+std::pair<QuantLib::ext::shared_ptr<Trade>, bool>
+handleTradeBuildError(const QuantLib::ext::shared_ptr<Trade>& trade,
+                      const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory, const std::string& context,
+                      const std::string& error, const bool ignoreTradeBuildFail, const bool buildFailedTrades,
+                      const bool emitStructuredError) {
+    if (emitStructuredError) {
+        StructuredTradeErrorMessage(trade, "Error building trade for context '" + context + "'", error).log();
+    } else {
+        ALOG("Error building trade '" << trade->id() << "' for context '" + context + "': " + error);
+    }
+    if (ignoreTradeBuildFail) {
+        return std::make_pair(trade, false);
+    } else if (buildFailedTrades) {
+        QuantLib::ext::shared_ptr<FailedTrade> failed = QuantLib::ext::make_shared<FailedTrade>();
+        failed->id() = trade->id();
+        failed->setUnderlyingTradeType(trade->tradeType());
+        failed->setEnvelope(trade->envelope());
+        failed->build(engineFactory);
+        failed->resetPricingStats(trade->getNumberOfPricings(), trade->getCumulativePricingTime());
+        LOG("Built failed trade with id " << failed->id());
+        return std::make_pair(failed, false);
+    } else {
+        return std::make_pair(nullptr, false);
     }
 }
 
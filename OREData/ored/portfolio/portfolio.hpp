@@ -79,9 +79,15 @@ public:
     //! Remove matured trades from portfolio for a given date, each removal is logged with an Alert
     void removeMatured(const QuantLib::Date& asof);
 
-    //! Call build on all trades in the portfolio, the context is included in error messages
+    /*! Call build on all trades in the portfolio, the context is included in error messages
+
+        If nThreads > 1, the trades are built concurrently on nThreads worker threads sharing the engine factory.
+        Errors are reported and failed trades are handled in the order of the trade ids, as in a sequential build.
+        Since the trades register with the market objects and are used on the calling thread, this requires a
+        QuantLib build with QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN = ON and QL_ENABLE_SESSIONS = OFF and a market
+        that is not built lazily, otherwise an exception is thrown. */
     void build(const QuantLib::ext::shared_ptr<EngineFactory>&, const std::string& context = "unspecified",
-               const bool emitStructuredError = true);
+               const bool emitStructuredError = true, const QuantLib::Size nThreads = 1);
 
     //! Calculates the maturity of the portfolio
     QuantLib::Date maturity() const;
@@ -140,5 +146,13 @@ std::pair<QuantLib::ext::shared_ptr<Trade>, bool> buildTrade(
     const std::string& context, const bool ignoreTradeBuildFail,
     const bool buildFailedTrades, const bool emitStructuredError);
 
+/*! Report the error from building a trade and return the trade to replace it in the portfolio (if any) and false,
+    in the same way as buildTrade() does */
+std::pair<QuantLib::ext::shared_ptr<Trade>, bool>
+handleTradeBuildError(const QuantLib::ext::shared_ptr<Trade>& trade,
+                      const QuantLib::ext::shared_ptr<EngineFactory>& engineFactory, const std::string& context,
+                      const std::string& error, const bool ignoreTradeBuildFail, const bool buildFailedTrades,
+                      const bool emitStructuredError);
+
 } // namespace data
 } // namespace ore
@@ -44,6 +44,9 @@ void ScriptedTrade::build(const QuantLib::ext::shared_ptr<EngineFactory>& engine
     auto builder = QuantLib::ext::dynamic_pointer_cast<ScriptedTradeEngineBuilder>(engineFactory->builder("ScriptedTrade"));
 
     QL_REQUIRE(builder, "no builder found for ScriptedTrade");
+
+    // the builder holds the results of the engine() call, keep other threads from using it until we are done
+    std::lock_guard<std::recursive_mutex> lock(builder->mutex());
     auto engine = builder->engine(id(), *this, engineFactory->referenceData(), engineFactory->iborFallbackConfig());
 
     simmProductClass_ = builder->simmProductClass();
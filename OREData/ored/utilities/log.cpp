@@ -31,6 +31,7 @@
 #include <boost/log/support/date_time.hpp>
 #include <boost/log/sources/severity_feature.hpp>
 #include <boost/phoenix/bind/bind_function.hpp>
+#include <algorithm>
 #include <iomanip>
 #include <ored/utilities/log.hpp>
 #include <ored/utilities/to_string.hpp>
@@ -268,6 +269,49 @@ void EventLogger::setFormatter(
         fileSink_->set_formatter(formatter);
 }
 
+// -- Asynchronous logging
+
+//! Lock-free single producer / single consumer ring buffer holding the pending log records of one thread
+class AsyncLogBuffer {
+public:
+    struct Record {
+        unsigned mask = 0;
+        const char* filename = nullptr;
+        int lineNo = 0;
+        ptime time;
+        string msg;
+    };
+
+    explicit AsyncLogBuffer(const Size capacity) : records_(capacity) {}
+
+    //! called by the owning thread only, returns false if the buffer is full
+    bool push(Record& record) {
+        Size head = head_.load(std::memory_order_relaxed);
+        Size next = (head + 1) % records_.size();
+        if (next == tail_.load(std::memory_order_acquire))
+            return false;
+        records_[head] = std::move(record);
+        head_.store(next, std::memory_order_release);
+        return true;
+    }
+
+    //! called by the consumer only, i.e. under Log::writeAsyncBuffersMutex_, returns false if the buffer is empty
+    bool pop(Record& record) {
+        Size tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+            return false;
+        record = std::move(records_[tail]);
+        tail_.store((tail + 1) % records_.size(), std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const { return tail_.load(std::memory_order_acquire) == head_.load(std::memory_order_acquire); }
+
+private:
+    std::vector<Record> records_;
+    std::atomic<Size> head_{0}, tail_{0};
+};
+
 // The Log itself
 Log::Log() : loggers_(), enabled_(false), mask_(255), ls_() {
 
@@ -275,6 +319,98 @@ Log::Log() : loggers_(), enabled_(false), mask_(255), ls_() {
     ls_.setf(ios::showpoint);
 }
 
+Log::~Log() { setAsynchronous(false); }
+
+void Log::logMessage(unsigned m, const char* filename, int lineNo, std::string msg) {
+    if (!async_) {
+        boost::unique_lock<boost::shared_mutex> lock(mutex_);
+        header(m, filename, lineNo);
+        ls_ << msg;
+        log(m);
+        return;
+    }
+
+    // the buffer of this thread is created on first use and kept alive by the Log until it is drained
+    static thread_local QuantLib::ext::shared_ptr<AsyncLogBuffer> buffer;
+    if (buffer == nullptr) {
+        buffer = QuantLib::ext::make_shared<AsyncLogBuffer>(8192);
+        std::lock_guard<std::mutex> lock(asyncBuffersMutex_);
+        asyncBuffers_.push_back(buffer);
+    }
+
+    AsyncLogBuffer::Record record{m, filename, lineNo, microsec_clock::local_time(), std::move(msg)};
+    while (!buffer->push(record)) {
+        // the buffer is full, write the pending messages from this thread instead of waiting for the writer
+        writeAsyncBuffers();
+    }
+    // wake up the writer if it might be waiting, i.e. if there were no pending messages
+    if (pendingMessages_.fetch_add(1) == 0) {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        writerCondition_.notify_one();
+    }
+}
+
+void Log::setAsynchronous(const bool async) {
+    if (async) {
+        async_ = true;
+        if (!writer_.joinable()) {
+            stopWriter_ = false;
+            writer_ = std::thread([this]() {
+                while (true) {
+                    writeAsyncBuffers();
+                    std::unique_lock<std::mutex> lock(writerMutex_);
+                    writerCondition_.wait(lock, [this]() { return stopWriter_ || pendingMessages_ > 0; });
+                    if (stopWriter_)
+                        break;
+                }
+            });
+        }
+    } else {
+        async_ = false;
+        if (writer_.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(writerMutex_);
+                stopWriter_ = true;
+            }
+            writerCondition_.notify_one();
+            writer_.join();
+        }
+        writeAsyncBuffers();
+    }
+}
+
+void Log::flush() { writeAsyncBuffers(); }
+
+Size Log::writeAsyncBuffers() {
+    std::lock_guard<std::mutex> writeLock(writeAsyncBuffersMutex_);
+    std::vector<QuantLib::ext::shared_ptr<AsyncLogBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(asyncBuffersMutex_);
+        // buffers only referenced here belong to finished threads, they can be dropped once they are drained
+        asyncBuffers_.erase(std::remove_if(asyncBuffers_.begin(), asyncBuffers_.end(),
+                                           [](const QuantLib::ext::shared_ptr<AsyncLogBuffer>& b) {
+                                               return b.use_count() == 1 && b->empty();
+                                           }),
+                            asyncBuffers_.end());
+        buffers = asyncBuffers_;
+    }
+    Size count = 0;
+    AsyncLogBuffer::Record record;
+    for (auto const& b : buffers) {
+        if (b->empty())
+            continue;
+        boost::unique_lock<boost::shared_mutex> lock(mutex_);
+        while (b->pop(record)) {
+            header(record.mask, record.filename, record.lineNo, record.time);
+            ls_ << record.msg;
+            log(record.mask);
+            ++count;
+        }
+    }
+    pendingMessages_ -= static_cast<std::ptrdiff_t>(count);
+    return count;
+}
+
 void Log::registerLogger(const QuantLib::ext::shared_ptr<Logger>& logger) {
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     QL_REQUIRE(loggers_.find(logger->name()) == loggers_.end(),
@@ -318,6 +454,7 @@ QuantLib::ext::shared_ptr<IndependentLogger>& Log::independentLogger(const strin
 }
 
 void Log::removeLogger(const string& name) {
+    flush();
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     map<string, QuantLib::ext::shared_ptr<Logger>>::iterator it = loggers_.find(name);
     if (it != loggers_.end()) {
@@ -339,6 +476,7 @@ void Log::removeIndependentLogger(const string& name) {
 }
 
 void Log::removeAllLoggers() {
+    flush();
     boost::unique_lock<boost::shared_mutex> lock(mutex_);
     loggers_.clear();
     logging::core::get()->remove_all_sinks();
@@ -370,17 +508,17 @@ string Log::source(const char* filename, int lineNo) const {
 }
 
 void Log::addExcludeFilter(const string& key, const std::function<bool(const std::string&)> func) {
-    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    boost::unique_lock<boost::shared_mutex> lock(excludeFiltersMutex_);
     excludeFilters_[key] = func;
 }
 
 void Log::removeExcludeFilter(const string& key) {
-    boost::unique_lock<boost::shared_mutex> lock(mutex_);
+    boost::unique_lock<boost::shared_mutex> lock(excludeFiltersMutex_);
     excludeFilters_.erase(key);
 }
 
 bool Log::checkExcludeFilters(const std::string& msg) {
-    boost::shared_lock<boost::shared_mutex> lock(mutex_);
+    boost::shared_lock<boost::shared_mutex> lock(excludeFiltersMutex_);
     for (const auto& f : excludeFilters_) {
         if (f.second(msg))
             return true;
@@ -389,6 +527,10 @@ bool Log::checkExcludeFilters(const std::string& msg) {
 }
 
 void Log::header(unsigned m, const char* filename, int lineNo) {
+    header(m, filename, lineNo, microsec_clock::local_time());
+}
+
+void Log::header(unsigned m, const char* filename, int lineNo, const ptime& time) {
     // 1. Reset stringstream
     ls_.str(string());
     ls_.clear();
@@ -425,7 +567,7 @@ void Log::header(unsigned m, const char* filename, int lineNo) {
     // Timestamp
     // Use boost::posix_time microsecond clock to get better precision (when available).
     // format is "2014-Apr-04 11:10:16.179347"
-    ls_ << '[' << to_simple_string(microsec_clock::local_time()) << ']';
+    ls_ << '[' << to_simple_string(time) << ']';
 
     // Filename & line no
     // format is " (file:line)"
@@ -480,10 +622,7 @@ LoggerStream::~LoggerStream() {
     while (getline(ss_, text)) {
         // we expand the MLOG macro here so we can overwrite __FILE__ and __LINE__
         if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(mask_)) {
-            boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());
-            ore::data::Log::instance().header(mask_, filename_, lineNo_);
-            ore::data::Log::instance().logStream() << text;
-            ore::data::Log::instance().log(mask_);
+            ore::data::Log::instance().logMessage(mask_, filename_, lineNo_, text);
         }
     }
 }
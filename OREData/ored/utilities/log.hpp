@@ -64,9 +64,16 @@
 #include <sstream>
 
 #include <boost/any.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <boost/thread/shared_mutex.hpp>
 #include <boost/thread/lock_types.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+
 enum oreSeverity {
     alert = ORE_ALERT,
     critical = ORE_CRITICAL,
@@ -352,13 +359,22 @@ private:
     QuantLib::ext::shared_ptr<file_sink> fileSink_;
 };
 
+class AsyncLogBuffer;
+
 //! Global static Log class
 /*!
   The Global Log class gets registered with individual loggers and receives application log messages.
   Once a message is received, it is immediately dispatched to each of the registered loggers, the order in which
   the loggers are called is not guaranteed.
 
-  Logging is done by the calling thread and the LOG call blocks until all the loggers have returned.
+  By default logging is done by the calling thread and the LOG call blocks until all the loggers have returned.
+  If asynchronous logging is switched on, the LOG call only copies the message into a lock-free buffer owned by
+  the calling thread and a background writer thread dispatches the messages to the loggers. The messages of one
+  thread are written in the order they were logged, messages from different threads may be interleaved. Pending
+  messages are written on flush(), removeLogger(), removeAllLoggers(), setAsynchronous(false) and when the Log is
+  destroyed, i.e. on a normal exit of the process. If the process terminates abnormally (e.g. on a crash, a signal or
+  std::terminate()), the messages not yet written by the writer thread are lost, so that asynchronous logging should
+  be switched off to investigate such a failure.
 
   At start up, the Log class has no loggers and so will ignore any LOG() messages until it is configured.
 
@@ -435,6 +451,8 @@ public:
 
     bool checkExcludeFilters(const std::string&);
 
+    //! macro utility function - do not use directly, thread safe
+    void logMessage(unsigned m, const char* filename, int lineNo, std::string msg);
     //! macro utility function - do not use directly, not thread safe
     void header(unsigned m, const char* filename, int lineNo);
     //! macro utility function - do not use directly, not thread safe
@@ -446,14 +464,8 @@ public:
     boost::shared_mutex& mutex() { return mutex_; }
 
     // Avoid a large number of warnings in VS by adding 0 !=
-    bool filter(unsigned mask) {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return 0 != (mask & mask_);
-    }
-    unsigned mask() {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return mask_;
-    }
+    bool filter(unsigned mask) { return 0 != (mask & mask_); }
+    unsigned mask() { return mask_; }
     void setMask(unsigned mask) {
         boost::unique_lock<boost::shared_mutex> lock(mutex());
         mask_ = mask;
@@ -475,10 +487,7 @@ public:
         maxLen_ = n;
     }
 
-    bool enabled() {
-        boost::shared_lock<boost::shared_mutex> lock(mutex());
-        return enabled_;
-    }
+    bool enabled() { return enabled_; }
     void switchOn() {
         boost::unique_lock<boost::shared_mutex> lock(mutex());
         enabled_ = true;
@@ -496,16 +505,28 @@ public:
     //! if a PID is set for the logger, messages are tagged with [1234] if pid = 1234
     void setPid(const int pid) { pid_ = pid; }
 
+    //! switch asynchronous logging on or off, switching it off writes all pending messages
+    void setAsynchronous(const bool async);
+    bool asynchronous() const { return async_; }
+    //! write all pending messages of the asynchronous logging to the loggers
+    void flush();
+
+    ~Log();
+
 private:
     Log();
 
     // not thread safe
+    void header(unsigned m, const char* filename, int lineNo, const boost::posix_time::ptime& time);
     std::string source(const char* filename, int lineNo) const;
 
+    // write the pending messages of all asynchronous buffers, returns the number of messages written
+    std::size_t writeAsyncBuffers();
+
     std::map<std::string, QuantLib::ext::shared_ptr<Logger>> loggers_;
     std::map<std::string, QuantLib::ext::shared_ptr<IndependentLogger>> independentLoggers_;
-    bool enabled_;
-    unsigned mask_;
+    std::atomic<bool> enabled_;
+    std::atomic<unsigned> mask_;
     boost::filesystem::path rootPath_;
     std::ostringstream ls_;
 
@@ -520,7 +541,21 @@ private:
 
     mutable boost::shared_mutex mutex_;
 
+    // the exclude filters are checked on the logging thread, they have their own mutex
+    mutable boost::shared_mutex excludeFiltersMutex_;
     std::map<std::string, std::function<bool(const std::string&)>> excludeFilters_;
+
+    // asynchronous logging: one buffer per producing thread, drained by the writer thread or by flush()
+    std::atomic<bool> async_{false};
+    std::atomic<bool> stopWriter_{false};
+    std::thread writer_;
+    // the writer waits for messages on the condition, it is notified when the number of pending messages becomes
+    // positive, the number can be negative temporarily since it is increased after the message is pushed
+    std::mutex writerMutex_;
+    std::condition_variable writerCondition_;
+    std::atomic<std::ptrdiff_t> pendingMessages_{0};
+    std::mutex asyncBuffersMutex_, writeAsyncBuffersMutex_;
+    std::vector<QuantLib::ext::shared_ptr<AsyncLogBuffer>> asyncBuffers_;
 };
 
 /*!
@@ -532,10 +567,7 @@ private:
             std::ostringstream __ore_mlog_tmp_stringstream__;                                                          \
             __ore_mlog_tmp_stringstream__ << text;                                                                     \
             if (!ore::data::Log::instance().checkExcludeFilters(__ore_mlog_tmp_stringstream__.str())) {                \
-                boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());                      \
-                ore::data::Log::instance().header(mask, __FILE__, __LINE__);                                           \
-                ore::data::Log::instance().logStream() << __ore_mlog_tmp_stringstream__.str();                         \
-                ore::data::Log::instance().log(mask);                                                                  \
+                ore::data::Log::instance().logMessage(mask, __FILE__, __LINE__, __ore_mlog_tmp_stringstream__.str());  \
             }                                                                                                          \
         }                                                                                                              \
     }
@@ -561,11 +593,9 @@ private:
 #define MEM_LOG_USING_LEVEL(LEVEL)                                                                                      \
     {                                                                                                                   \
         if (ore::data::Log::instance().enabled() && ore::data::Log::instance().filter(LEVEL)) {                         \
-            boost::unique_lock<boost::shared_mutex> lock(ore::data::Log::instance().mutex());                           \
-            ore::data::Log::instance().header(LEVEL, __FILE__, __LINE__);                                               \
-            ore::data::Log::instance().logStream() << std::to_string(ore::data::os::getPeakMemoryUsageBytes()) << "|";  \
-            ore::data::Log::instance().logStream() << std::to_string(ore::data::os::getMemoryUsageBytes());             \
-            ore::data::Log::instance().log(LEVEL);                                                                      \
+            ore::data::Log::instance().logMessage(LEVEL, __FILE__, __LINE__,                                            \
+                                                  std::to_string(ore::data::os::getPeakMemoryUsageBytes()) + "|" +      \
+                                                      std::to_string(ore::data::os::getMemoryUsageBytes()));            \
         }                                                                                                               \
     }
 
@@ -0,0 +1,73 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <ored/utilities/parallelfor.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using QuantLib::Size;
+
+namespace ore {
+namespace data {
+
+void parallelFor(Size n, Size nThreads, const std::function<void(Size, Size)>& job,
+                 const std::function<void()>& initWorker) {
+    nThreads = std::min(nThreads, n);
+    if (nThreads <= 1) {
+        for (Size k = 0; k < n; ++k)
+            job(0, k);
+        return;
+    }
+    std::atomic<Size> next(0);
+    std::mutex mutex;
+    std::exception_ptr error;
+    std::vector<std::thread> threads;
+    for (Size w = 0; w < nThreads; ++w) {
+        threads.emplace_back([&, w]() {
+            try {
+                if (initWorker)
+                    initWorker();
+                for (Size k = next++; k < n; k = next++)
+                    job(w, k);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error)
+                    error = std::current_exception();
+                // do not start any further jobs
+                next = n;
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void parallelFor(Size n, Size nThreads, const std::function<void(Size)>& job, const std::function<void()>& initWorker) {
+    parallelFor(
+        n, nThreads, [&job](Size, Size k) { job(k); }, initWorker);
+}
+
+} // namespace data
+} // namespace ore
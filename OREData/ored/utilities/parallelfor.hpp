@@ -0,0 +1,54 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file ored/utilities/parallelfor.hpp
+    \brief Run independent jobs on a pool of worker threads
+    \ingroup utilities
+*/
+
+#pragma once
+
+#include <ql/types.hpp>
+
+#include <functional>
+
+namespace ore {
+namespace data {
+
+//! Call job(worker, k) for k = 0, ..., n - 1 on min(nThreads, n) worker threads
+/*! The indices k are handed out to the workers in increasing order as they become idle, worker is the index of the
+    thread running the job in 0, ..., min(nThreads, n) - 1. If initWorker is given, it is called on each worker thread
+    before the first job, e.g. to set up the session of the thread.
+
+    If a job throws, no further jobs are started, and the first exception is rethrown on the calling thread after all
+    workers have finished.
+
+    If min(nThreads, n) <= 1 the jobs are run on the calling thread with worker = 0, and initWorker is not called.
+
+    \ingroup utilities
+*/
+void parallelFor(QuantLib::Size n, QuantLib::Size nThreads,
+                 const std::function<void(QuantLib::Size worker, QuantLib::Size k)>& job,
+                 const std::function<void()>& initWorker = std::function<void()>());
+
+//! Call job(k) for k = 0, ..., n - 1 on min(nThreads, n) worker threads, see above
+void parallelFor(QuantLib::Size n, QuantLib::Size nThreads, const std::function<void(QuantLib::Size k)>& job,
+                 const std::function<void()>& initWorker = std::function<void()>());
+
+} // namespace data
+} // namespace ore
@@ -38,6 +38,8 @@
 #include <oret/datapaths.hpp>
 #include <oret/toplevelfixture.hpp>
 #include <ql/time/calendars/weekendsonly.hpp>
+#include <fstream>
+#include <sstream>
 #include <tuple>
 
 using namespace QuantLib;
@@ -437,6 +439,112 @@ BOOST_FIXTURE_TEST_CASE(testDividends, F) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testCsvLoaderThreads) {
+
+    BOOST_TEST_MESSAGE("Testing that the csv loader gives the same results when parsing on several threads");
+
+    Date today(12, Feb, 2019);
+    Settings::instance().evaluationDate() = today;
+
+    // large enough to be split into several chunks, with duplicates across the chunks
+    string marketFile = TEST_OUTPUT_FILE("csvloader_market.txt");
+    string fixingsFile = TEST_OUTPUT_FILE("csvloader_fixings.txt");
+    {
+        std::ofstream market(marketFile), fixings(fixingsFile);
+        market << "# comment line\n";
+        for (Size i = 0; i < 20000; ++i) {
+            market << "2019-02-12 ZERO/RATE/USD/USD-LIBOR-3M/A365/" << (i % 5000 + 1) << "D " << i << "\n";
+            fixings << "20190101,USD-LIBOR-" << (i % 7 + 1) << "M;" << 0.01 * (i % 300) << "\t\n";
+            if (i % 1000 == 0)
+                fixings << "\n" << QuantLib::io::iso_date(today - (i % 50)) << " USD-LIBOR-3M  " << i << "\n";
+        }
+        market << "2019-02-12 FX/RATE/EUR/USD 1.1\n2019-02-12 FX/RATE/USD/EUR 0.9\n";
+    }
+
+    CSVLoader sequential(marketFile, fixingsFile, "", false, Date(), 1);
+    CSVLoader parallel(marketFile, fixingsFile, "", false, Date(), 4);
+
+    auto quotes1 = sequential.loadQuotes(today);
+    auto quotes2 = parallel.loadQuotes(today);
+    BOOST_REQUIRE_EQUAL(quotes1.size(), Size(5001));
+    BOOST_REQUIRE_EQUAL(quotes1.size(), quotes2.size());
+    for (Size i = 0; i < quotes1.size(); ++i) {
+        BOOST_CHECK_EQUAL(quotes1[i]->name(), quotes2[i]->name());
+        BOOST_CHECK_EQUAL(quotes1[i]->quote()->value(), quotes2[i]->quote()->value());
+    }
+    // first occurrence wins
+    BOOST_CHECK_EQUAL(parallel.get("ZERO/RATE/USD/USD-LIBOR-3M/A365/7D", today)->quote()->value(), 6.0);
+    BOOST_CHECK(parallel.has("FX/RATE/EUR/USD", today) != parallel.has("FX/RATE/USD/EUR", today));
+
+    auto fixings1 = sequential.loadFixings();
+    auto fixings2 = parallel.loadFixings();
+    BOOST_REQUIRE_EQUAL(fixings1.size(), fixings2.size());
+    for (auto f1 = fixings1.begin(), f2 = fixings2.begin(); f1 != fixings1.end(); ++f1, ++f2) {
+        BOOST_CHECK_EQUAL(f1->name, f2->name);
+        BOOST_CHECK_EQUAL(f1->date, f2->date);
+        BOOST_CHECK_EQUAL(f1->fixing, f2->fixing);
+    }
+
+    // restrict the loaded quotes
+    CSVLoader filtered(marketFile, fixingsFile, "", false, Date(), 4,
+                       {"ZERO/RATE/USD/USD-LIBOR-3M/A365/1D", "ZERO/RATE/USD/USD-LIBOR-3M/A365/2*"});
+    BOOST_CHECK_EQUAL(filtered.loadQuotes(today).size(), Size(1 + 1 + 10 + 100 + 1000 + 1));
+    BOOST_CHECK(filtered.has("ZERO/RATE/USD/USD-LIBOR-3M/A365/1D", today));
+    BOOST_CHECK(!filtered.has("ZERO/RATE/USD/USD-LIBOR-3M/A365/3D", today));
+}
+
+BOOST_AUTO_TEST_CASE(testCsvLoaderChunkBoundaries) {
+
+    BOOST_TEST_MESSAGE("Testing the csv loader with lines across chunk boundaries and without a final newline");
+
+    Date today(12, Feb, 2019);
+    Settings::instance().evaluationDate() = today;
+
+    // the padded line is longer than several chunks (at least 64k each), so that it spans several nominal chunk
+    // boundaries, and the last line is not terminated by a newline
+    Size nLines = 20000, paddedLine = 7000;
+    string fixingsFile = TEST_OUTPUT_FILE("csvloader_boundaries.txt");
+    string invalidFile = TEST_OUTPUT_FILE("csvloader_invalid.txt");
+    {
+        std::ofstream fixings(fixingsFile, std::ios::binary), invalid(invalidFile, std::ios::binary);
+        for (Size i = 0; i < nLines; ++i) {
+            std::ostringstream line;
+            line << "20190101,INDEX-" << i << (i == paddedLine ? string(300000, ' ') : string(",")) << i;
+            fixings << line.str();
+            invalid << (i == nLines - 2 ? string("20190101 INDEX") : line.str());
+            if (i + 1 < nLines) {
+                fixings << (i % 2 == 0 ? "\n" : "\r\n");
+                invalid << "\n";
+            }
+        }
+    }
+
+    for (Size nThreads : {1, 2, 4, 7}) {
+        BOOST_TEST_MESSAGE("Threads: " << nThreads);
+        CSVLoader loader(vector<string>(), {fixingsFile}, vector<string>(), false, Date(), nThreads);
+        auto fixings = loader.loadFixings();
+        BOOST_REQUIRE_EQUAL(fixings.size(), nLines);
+        map<string, Real> values;
+        for (auto const& f : fixings) {
+            BOOST_CHECK_EQUAL(f.date, Date(1, Jan, 2019));
+            values[f.name] = f.fixing;
+        }
+        for (Size i : {Size(0), paddedLine - 1, paddedLine, paddedLine + 1, nLines - 1}) {
+            BOOST_REQUIRE(values.count("INDEX-" + std::to_string(i)) == 1);
+            BOOST_CHECK_EQUAL(values["INDEX-" + std::to_string(i)], static_cast<Real>(i));
+        }
+
+        // the invalid line is reported with its line number
+        try {
+            CSVLoader(vector<string>(), {invalidFile}, vector<string>(), false, Date(), nThreads);
+            BOOST_ERROR("invalid line not detected");
+        } catch (const std::exception& e) {
+            BOOST_CHECK_MESSAGE(string(e.what()).find("line " + std::to_string(nLines - 1) + ":") != string::npos,
+                                "unexpected error: " << e.what());
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,156 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <boost/test/unit_test.hpp>
+#include <ored/utilities/log.hpp>
+#include <oret/toplevelfixture.hpp>
+
+#include <chrono>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+using namespace ore::data;
+using QuantLib::Size;
+using std::string;
+using std::vector;
+
+namespace {
+
+// collects the messages logged by the test threads
+class TestLogger : public Logger {
+public:
+    TestLogger() : Logger("AsyncTestLogger") {}
+    void log(unsigned, const string& msg) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (msg.find("async log test") != string::npos)
+            messages_.push_back(msg);
+    }
+    vector<string> messages() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return messages_;
+    }
+
+private:
+    std::mutex mutex_;
+    vector<string> messages_;
+};
+
+// registers the test logger and switches on asynchronous logging, restores the previous state on destruction
+class AsyncLogSetup {
+public:
+    AsyncLogSetup() : enabled_(Log::instance().enabled()), mask_(Log::instance().mask()) {
+        logger = QuantLib::ext::make_shared<TestLogger>();
+        Log::instance().registerLogger(logger);
+        Log::instance().setMask(mask_ | ORE_NOTICE);
+        Log::instance().switchOn();
+        Log::instance().setAsynchronous(true);
+    }
+    ~AsyncLogSetup() {
+        Log::instance().setAsynchronous(false);
+        Log::instance().removeLogger(logger->name());
+        Log::instance().setMask(mask_);
+        if (!enabled_)
+            Log::instance().switchOff();
+    }
+    QuantLib::ext::shared_ptr<TestLogger> logger;
+
+private:
+    bool enabled_;
+    unsigned mask_;
+};
+
+// alternate between two source locations, so that no messages are suppressed by the same source location cutoff
+void logMessage(Size thread, Size i) {
+    if (i % 2 == 0) {
+        LOG("async log test " << thread << " " << i);
+    } else {
+        LOG("async log test " << thread << " " << i);
+    }
+}
+
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
+
+BOOST_AUTO_TEST_SUITE(LogTest)
+
+BOOST_AUTO_TEST_CASE(testAsynchronousLogOrder) {
+
+    BOOST_TEST_MESSAGE("Testing that asynchronous logging keeps the order of the messages of each thread...");
+
+    // more messages per thread than fit into the buffer of a thread
+    Size nThreads = 4, nMessages = 20000;
+    AsyncLogSetup setup;
+    vector<std::thread> threads;
+    for (Size t = 0; t < nThreads; ++t)
+        threads.emplace_back([t, nMessages]() {
+            for (Size i = 0; i < nMessages; ++i)
+                logMessage(t, i);
+        });
+    for (auto& t : threads)
+        t.join();
+
+    // switching off asynchronous logging delivers all pending messages
+    Log::instance().setAsynchronous(false);
+
+    vector<Size> next(nThreads, 0);
+    auto messages = setup.logger->messages();
+    BOOST_REQUIRE_EQUAL(messages.size(), nThreads * nMessages);
+    for (auto const& m : messages) {
+        std::istringstream is(m.substr(m.find("async log test") + 14));
+        Size t, i;
+        is >> t >> i;
+        BOOST_REQUIRE(t < nThreads);
+        BOOST_REQUIRE_MESSAGE(i == next[t], "thread " << t << ": expected message " << next[t] << ", got " << i);
+        ++next[t];
+    }
+}
+
+BOOST_AUTO_TEST_CASE(testAsynchronousLogDelivery) {
+
+    BOOST_TEST_MESSAGE("Testing that the asynchronous log writer delivers messages without a flush...");
+
+    AsyncLogSetup setup;
+
+    // the writer waits for messages, it must be woken up by each new message after it has become idle
+    for (Size round = 0; round < 3; ++round) {
+        logMessage(0, round);
+        auto start = std::chrono::steady_clock::now();
+        while (setup.logger->messages().size() < round + 1 &&
+               std::chrono::steady_clock::now() - start < std::chrono::seconds(10))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        BOOST_REQUIRE_EQUAL(setup.logger->messages().size(), round + 1);
+    }
+
+    // pending messages are delivered by flush() and by removing the logger
+    for (Size i = 3; i < 100; ++i)
+        logMessage(0, i);
+    Log::instance().flush();
+    BOOST_CHECK_EQUAL(setup.logger->messages().size(), 100u);
+    logMessage(0, 100);
+    auto logger = setup.logger;
+    Log::instance().removeLogger(logger->name());
+    BOOST_CHECK_EQUAL(logger->messages().size(), 101u);
+    Log::instance().registerLogger(logger);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -18,15 +18,55 @@
 
 #include <boost/make_shared.hpp>
 #include <boost/test/unit_test.hpp>
+#include <ored/portfolio/builders/cachingenginebuilder.hpp>
+#include <ored/portfolio/enginedata.hpp>
+#include <ored/portfolio/failedtrade.hpp>
 #include <ored/portfolio/fxforward.hpp>
 #include <ored/portfolio/portfolio.hpp>
+#include <ored/utilities/parallelfor.hpp>
 #include <oret/toplevelfixture.hpp>
+#include "oredtestmarket.hpp"
+
+#include <atomic>
+#include <thread>
 
 using namespace QuantLib;
 using namespace boost::unit_test_framework;
 using namespace std;
 using namespace ore::data;
 
+namespace {
+
+// an engine that only remembers the engine parameter it was built with
+class ParameterEngine : public PricingEngine {
+public:
+    explicit ParameterEngine(const string& parameter) : parameter_(parameter) {}
+    PricingEngine::arguments* getArguments() const override { return nullptr; }
+    const PricingEngine::results* getResults() const override { return nullptr; }
+    void reset() override {}
+    void calculate() const override {}
+    const string& parameter() const { return parameter_; }
+
+private:
+    string parameter_;
+};
+
+// a builder shared by two trade types, the cache key does not depend on the trade type
+class ParameterEngineBuilder : public CachingPricingEngineBuilder<string> {
+public:
+    ParameterEngineBuilder() : CachingEngineBuilder("TestModel", "TestEngine", {"TestTypeA", "TestTypeB"}) {}
+
+protected:
+    string keyImpl() override { return "key"; }
+    QuantLib::ext::shared_ptr<PricingEngine> engineImpl() override {
+        // give other threads a chance to initialise the builder while we build the engine
+        std::this_thread::yield();
+        return QuantLib::ext::make_shared<ParameterEngine>(engineParameter("Parameter"));
+    }
+};
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(OREDataTestSuite, ore::test::TopLevelFixture)
 
 BOOST_AUTO_TEST_SUITE(PortfolioTests)
@@ -119,6 +159,97 @@ BOOST_AUTO_TEST_CASE(testIds) {
     BOOST_CHECK(portfolio->ids() == trade_ids);
 }
 
+BOOST_AUTO_TEST_CASE(testBuildConcurrently) {
+
+    BOOST_TEST_MESSAGE("Testing concurrent portfolio build...");
+
+    Date asof(3, Feb, 2016);
+    Settings::instance().evaluationDate() = asof;
+    auto market = QuantLib::ext::make_shared<OredTestMarket>(asof);
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    engineData->model("FxForward") = "DiscountedCashflows";
+    engineData->engine("FxForward") = "DiscountingFxForwardEngine";
+    auto engineFactory = QuantLib::ext::make_shared<EngineFactory>(engineData, market);
+
+    // every fifth trade has an unknown currency and fails to build
+    auto portfolio = [](const bool buildFailedTrades) {
+        auto p = QuantLib::ext::make_shared<Portfolio>(buildFailedTrades);
+        for (Size i = 0; i < 50; ++i) {
+            p->add(QuantLib::ext::make_shared<FxForward>(Envelope("FxForward_" + std::to_string(i)), "2017-02-03",
+                                                         i % 5 == 0 ? "ZZZ" : "EUR", 1.0E6 + i, "USD", 1.2E6));
+        }
+        return p;
+    };
+
+    auto sequential = portfolio(true);
+    sequential->build(engineFactory, "test");
+    auto concurrent = portfolio(true);
+
+#if defined(QL_ENABLE_SESSIONS) || !defined(QL_ENABLE_THREAD_SAFE_OBSERVER_PATTERN)
+    // the trades can not be built on worker threads, the concurrent build is rejected
+    BOOST_CHECK_THROW(concurrent->build(engineFactory, "test", true, 4), QuantLib::Error);
+    BOOST_CHECK_NO_THROW(concurrent->build(engineFactory, "test", true, 1));
+    BOOST_CHECK_EQUAL(concurrent->size(), sequential->size());
+#else
+    concurrent->build(engineFactory, "test", true, 4);
+
+    BOOST_REQUIRE_EQUAL(sequential->size(), concurrent->size());
+    for (auto const& [id, t] : sequential->trades()) {
+        auto c = concurrent->get(id);
+        BOOST_REQUIRE(c);
+        BOOST_CHECK_EQUAL(t->tradeType(), c->tradeType());
+        BOOST_CHECK_CLOSE(t->instrument()->NPV(), c->instrument()->NPV(), 1.0E-10);
+    }
+
+    auto removed = portfolio(false);
+    removed->build(engineFactory, "test", true, 4);
+    BOOST_CHECK_EQUAL(removed->size(), 40);
+#endif
+}
+
+BOOST_AUTO_TEST_CASE(testSharedEngineBuilder) {
+
+    BOOST_TEST_MESSAGE("Testing engine builder shared by trade types with different engine parameters...");
+
+    Date asof(3, Feb, 2016);
+    Settings::instance().evaluationDate() = asof;
+    auto market = QuantLib::ext::make_shared<OredTestMarket>(asof);
+    auto engineData = QuantLib::ext::make_shared<EngineData>();
+    for (auto const& t : {"TestTypeA", "TestTypeB"}) {
+        engineData->model(t) = "TestModel";
+        engineData->engine(t) = "TestEngine";
+        engineData->engineParameters(t)["Parameter"] = t;
+    }
+    auto engineFactory = QuantLib::ext::make_shared<EngineFactory>(engineData, market);
+    engineFactory->registerBuilder(QuantLib::ext::make_shared<ParameterEngineBuilder>());
+
+    // each trade type gets an engine built with its own parameters
+    auto engine = [&engineFactory](const string& tradeType) {
+        auto builder = QuantLib::ext::dynamic_pointer_cast<ParameterEngineBuilder>(engineFactory->builder(tradeType));
+        QL_REQUIRE(builder, "expected ParameterEngineBuilder");
+        // another thread might initialise the builder for the other trade type here
+        std::this_thread::yield();
+        string parameter = builder->engineParameter("Parameter");
+        auto e = QuantLib::ext::dynamic_pointer_cast<ParameterEngine>(builder->engine());
+        QL_REQUIRE(e, "expected ParameterEngine");
+        return std::make_pair(parameter, e->parameter());
+    };
+
+    BOOST_CHECK_EQUAL(engine("TestTypeA").second, "TestTypeA");
+    BOOST_CHECK_EQUAL(engine("TestTypeB").second, "TestTypeB");
+    BOOST_CHECK_EQUAL(engine("TestTypeA").second, "TestTypeA");
+
+    // the same when the trade types are used concurrently
+    std::atomic<Size> mismatches(0);
+    ore::data::parallelFor(1000, 4, [&engine, &mismatches](Size k) {
+        string tradeType = k % 2 == 0 ? "TestTypeA" : "TestTypeB";
+        auto [parameter, engineParameter] = engine(tradeType);
+        if (parameter != tradeType || engineParameter != tradeType)
+            ++mismatches;
+    });
+    BOOST_CHECK_EQUAL(mismatches.load(), 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
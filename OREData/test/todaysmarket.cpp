@@ -18,6 +18,7 @@
 
 #include <boost/test/unit_test.hpp>
 #include <ored/configuration/volatilityconfig.hpp>
+#include <ored/marketdata/curvecache.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
@@ -35,6 +36,7 @@
 
 #include <boost/algorithm/string.hpp>
 #include <boost/assign/list_of.hpp>
+#include <boost/filesystem.hpp>
 #include <map>
 
 using namespace QuantLib;
@@ -397,6 +399,13 @@ MarketDataLoader::MarketDataLoader() {
         ("20160226 COMMODITY_FWD/PRICE/GOLD/USD/2017-12-29 1165.3")
         ("20160226 COMMODITY_FWD/PRICE/GOLD/USD/2018-12-31 1172.9")
         ("20160226 COMMODITY_FWD/PRICE/GOLD/USD/2021-12-31 1223")
+        // hazard rate quotes
+        ("20160226 HAZARD_RATE/RATE/CPTY_A/SR/USD/1Y 0.01")
+        ("20160226 HAZARD_RATE/RATE/CPTY_A/SR/USD/5Y 0.015")
+        ("20160226 RECOVERY_RATE/RATE/CPTY_A/SR/USD 0.4")
+        ("20160226 HAZARD_RATE/RATE/CPTY_B/SR/USD/1Y 0.02")
+        ("20160226 HAZARD_RATE/RATE/CPTY_B/SR/USD/5Y 0.025")
+        ("20160226 RECOVERY_RATE/RATE/CPTY_B/SR/USD 0.3")
         // correlation quotes
         ("20160226 CORRELATION/RATE/EUR-CMS-10Y/EUR-CMS-2Y/1Y/ATM 0.1")
         ("20160226 CORRELATION/RATE/EUR-CMS-10Y/EUR-CMS-2Y/2Y/ATM 0.2")
@@ -458,7 +467,8 @@ QuantLib::ext::shared_ptr<TodaysMarketParameters> marketParameters() {
     map<string, string> emptyMap;
     parameters->addMarketObject(MarketObject::FXSpot, "ois", emptyMap);
     parameters->addMarketObject(MarketObject::FXVol, "ois", emptyMap);
-    parameters->addMarketObject(MarketObject::DefaultCurve, "ois", emptyMap);
+    parameters->addMarketObject(MarketObject::DefaultCurve, "ois",
+                                {{"CPTY_A", "Default/USD/CPTY_A_SR_USD"}, {"CPTY_B", "Default/USD/CPTY_B_SR_USD"}});
 
     // store this set of curves as "default" configuration
     MarketConfiguration config;
@@ -514,6 +524,11 @@ QuantLib::ext::shared_ptr<Conventions> conventions() {
     conventions->add(QuantLib::ext::make_shared<SwapIndexConvention>("USD-CMS-2Y", "USD-3M-SWAP-CONVENTIONS", "US"));
     conventions->add(QuantLib::ext::make_shared<SwapIndexConvention>("USD-CMS-10Y", "USD-3M-SWAP-CONVENTIONS", "US"));
 
+    // CDS conventions
+    conventions->add(QuantLib::ext::make_shared<CdsConvention>("CDS-STANDARD-CONVENTIONS", "0", "WeekendsOnly",
+                                                               "Quarterly", "Following", "CDS2015", "A360", "true",
+                                                               "true"));
+
     // USD CMS spread option conventions
 
     conventions->add(QuantLib::ext::make_shared<CmsSpreadOptionConvention>("USD-CMS-10Y-2Y-CONVENTION", "0M", "2D", "3M", "2",
@@ -768,6 +783,16 @@ QuantLib::ext::shared_ptr<CurveConfigurations> curveConfigurations() {
     configs->add(CurveSpec::CurveType::Commodity, "GOLD_USD",
         QuantLib::ext::make_shared<CommodityCurveConfig>("GOLD_USD", "", "USD", commodityQuotes, "COMMODITY/PRICE/GOLD/USD"));
 
+    // hazard rate curves, the discount curve is not used, but makes them depend on a yield curve
+    for (auto const& name : {"CPTY_A", "CPTY_B"}) {
+        string hr = string("HAZARD_RATE/RATE/") + name + "/SR/USD/";
+        DefaultCurveConfig::Config config(DefaultCurveConfig::Config::Type::HazardRate, "Yield/USD/USD1D",
+                                          string("RECOVERY_RATE/RATE/") + name + "/SR/USD", Actual360(),
+                                          "CDS-STANDARD-CONVENTIONS", {{hr + "1Y", true}, {hr + "5Y", true}});
+        configs->add(CurveSpec::CurveType::Default, string(name) + "_SR_USD",
+                     QuantLib::ext::make_shared<DefaultCurveConfig>(string(name) + "_SR_USD", "", "USD", config));
+    }
+
     return configs;
 }
 
@@ -1038,6 +1063,75 @@ BOOST_AUTO_TEST_CASE(testCorrelationCurve) {
     BOOST_CHECK_SMALL(npvCash - expectedNpv2Y, 0.000001);
 }
 
+BOOST_AUTO_TEST_CASE(testConcurrentBuild) {
+
+    BOOST_TEST_MESSAGE("Testing concurrent build of todays market curves...");
+
+    Date asof(26, February, 2016);
+    auto cache = QuantLib::ext::make_shared<CurveCache>();
+    auto concurrentMarket = QuantLib::ext::make_shared<TodaysMarket>(
+        asof, marketParameters(), QuantLib::ext::make_shared<MarketDataLoader>(), curveConfigurations(), false, true,
+        false, nullptr, false, IborFallbackConfig::defaultConfig(), true, true, 4, cache);
+
+    Date d = asof + 5 * Years;
+    for (auto const& ccy : {"EUR", "USD"}) {
+        BOOST_CHECK_CLOSE(concurrentMarket->discountCurve(ccy)->discount(d), market->discountCurve(ccy)->discount(d),
+                          1.0E-10);
+    }
+    BOOST_CHECK_CLOSE(concurrentMarket->yieldCurve("EUR_LEND")->discount(d), market->yieldCurve("EUR_LEND")->discount(d),
+                      1.0E-10);
+    BOOST_CHECK_CLOSE(concurrentMarket->iborIndex("USD-LIBOR-3M")->forwardingTermStructure()->discount(d),
+                      market->iborIndex("USD-LIBOR-3M")->forwardingTermStructure()->discount(d), 1.0E-10);
+    BOOST_CHECK_CLOSE(concurrentMarket->swaptionVol("USD")->volatility(5 * Years, 10 * Years, 0.02),
+                      market->swaptionVol("USD")->volatility(5 * Years, 10 * Years, 0.02), 1.0E-10);
+    BOOST_CHECK_CLOSE(concurrentMarket->capFloorVol("USD")->volatility(5 * Years, 0.02),
+                      market->capFloorVol("USD")->volatility(5 * Years, 0.02), 1.0E-10);
+    for (auto const& name : {"CPTY_A", "CPTY_B"}) {
+        BOOST_CHECK_CLOSE(concurrentMarket->defaultCurve(name)->curve()->survivalProbability(d),
+                          market->defaultCurve(name)->curve()->survivalProbability(d), 1.0E-10);
+    }
+
+    // the yield and default curves are bootstrapped on worker threads and read from the cache on the calling thread,
+    // this fails in a QuantLib build without QL_ENABLE_SESSIONS
+    BOOST_CHECK(concurrentMarket->curvesBuiltConcurrently() > 0);
+    BOOST_CHECK(cache->hits() > 0);
+}
+
+BOOST_AUTO_TEST_CASE(testCurveCache) {
+
+    BOOST_TEST_MESSAGE("Testing todays market build with curve cache...");
+
+    Date asof(26, February, 2016);
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+
+    // the first build bootstraps the curves and populates the cache, the second build reads all curves from it
+    std::vector<QuantLib::ext::shared_ptr<TodaysMarket>> markets;
+    std::vector<QuantLib::ext::shared_ptr<CurveCache>> caches;
+    for (Size i = 0; i < 2; ++i) {
+        caches.push_back(QuantLib::ext::make_shared<CurveCache>(dir.string()));
+        markets.push_back(QuantLib::ext::make_shared<TodaysMarket>(
+            asof, marketParameters(), QuantLib::ext::make_shared<MarketDataLoader>(), curveConfigurations(), false,
+            true, false, nullptr, false, IborFallbackConfig::defaultConfig(), true, true, 1, caches.back()));
+    }
+
+    BOOST_CHECK(caches[0]->misses() > 0);
+    BOOST_CHECK(caches[1]->hits() > 0);
+    BOOST_CHECK_EQUAL(caches[1]->misses(), Size(0));
+
+    Date d = asof + 5 * Years;
+    for (auto const& m : markets) {
+        for (auto const& ccy : {"EUR", "USD"}) {
+            BOOST_CHECK_CLOSE(m->discountCurve(ccy)->discount(d), market->discountCurve(ccy)->discount(d), 1.0E-10);
+        }
+        BOOST_CHECK_CLOSE(m->yieldCurve("EUR_LEND")->discount(d), market->yieldCurve("EUR_LEND")->discount(d),
+                          1.0E-10);
+        BOOST_CHECK_CLOSE(m->iborIndex("USD-LIBOR-3M")->forwardingTermStructure()->discount(d),
+                          market->iborIndex("USD-LIBOR-3M")->forwardingTermStructure()->discount(d), 1.0E-10);
+    }
+
+    boost::filesystem::remove_all(dir);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
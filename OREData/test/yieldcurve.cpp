@@ -22,8 +22,10 @@
 #include <boost/test/data/test_case.hpp>
 // clang-format on
 #include <ored/marketdata/csvloader.hpp>
+#include <ored/marketdata/curvecache.hpp>
 #include <ored/marketdata/loader.hpp>
 #include <ored/marketdata/marketdatumparser.hpp>
+#include <ored/marketdata/marketimpl.hpp>
 #include <ored/marketdata/todaysmarket.hpp>
 #include <ored/marketdata/yieldcurve.hpp>
 #include <ored/utilities/to_string.hpp>
@@ -32,8 +34,11 @@
 #include <oret/toplevelfixture.hpp>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 #include <boost/make_shared.hpp>
 
+#include <ql/termstructures/yield/flatforward.hpp>
+
 using namespace QuantLib;
 using namespace QuantExt;
 using namespace boost::unit_test_framework;
@@ -205,6 +210,15 @@ vector<FutureCase> mmFutureCases{{Date(18, Aug, 2020), "before_ibor_start"},
 ostream& operator<<(ostream& os, const FutureCase& c) {
     return os << "Date is " << io::iso_date(c.date) << " and case is " << c.desc << ".";
 }
+
+// market holding a flat discount curve in the default configuration, used as the in currency discount curve
+class FlatDiscountMarket : public MarketImpl {
+public:
+    FlatDiscountMarket(const Date& asof, const string& ccy, Real rate) : MarketImpl(false) {
+        yieldCurves_[make_tuple(Market::defaultConfiguration, YieldCurveType::Discount, ccy)] =
+            Handle<YieldTermStructure>(QuantLib::ext::make_shared<FlatForward>(asof, rate, Actual365Fixed()));
+    }
+};
     
 } // namespace
 
@@ -559,6 +573,81 @@ BOOST_AUTO_TEST_CASE(testQuadraticInterpolation) {
     BOOST_CHECK_EQUAL(chfYieldCurve.handle()->discount(asof), 1);
 }
 
+BOOST_AUTO_TEST_CASE(testCurveCacheKey) {
+
+    BOOST_TEST_MESSAGE("Testing that the curve cache key covers quotes and the keys of in currency discount curves...");
+
+    Date asof(26, February, 2016);
+    Settings::instance().evaluationDate() = asof;
+
+    QuantLib::ext::shared_ptr<Conventions> conventions = QuantLib::ext::make_shared<Conventions>();
+    conventions->add(QuantLib::ext::make_shared<FXConvention>("EUR-USD-FX", "2", "EUR", "USD", "10000", "TARGET,US"));
+    InstrumentConventions::instance().setConventions(conventions);
+
+    // USD curve from EUR-USD forwards, the EUR discount curve is the in currency curve from the market
+    vector<string> quotes = {"FXFWD/RATE/EUR/USD/1Y", "FXFWD/RATE/EUR/USD/2Y", "FXFWD/RATE/EUR/USD/5Y"};
+    CurveConfigurations curveConfigs;
+    vector<QuantLib::ext::shared_ptr<YieldCurveSegment>> segments{
+        QuantLib::ext::make_shared<CrossCcyYieldCurveSegment>("FX Forward", "EUR-USD-FX", quotes, "FX/RATE/EUR/USD", "")};
+    curveConfigs.add(CurveSpec::CurveType::Yield, "USD_FX",
+                     QuantLib::ext::make_shared<YieldCurveConfig>("USD_FX", "USD from FX forwards", "USD", "", segments));
+    YieldCurveSpec spec("USD", "USD_FX");
+
+    MarketDataLoader loader({"20160226 FX/RATE/EUR/USD 1.1000", "20160226 FXFWD/RATE/EUR/USD/1Y 150",
+                             "20160226 FXFWD/RATE/EUR/USD/2Y 320", "20160226 FXFWD/RATE/EUR/USD/5Y 900"});
+    MarketDataLoader changedLoader({"20160226 FX/RATE/EUR/USD 1.1000", "20160226 FXFWD/RATE/EUR/USD/1Y 150",
+                                    "20160226 FXFWD/RATE/EUR/USD/2Y 330", "20160226 FXFWD/RATE/EUR/USD/5Y 900"});
+    FlatDiscountMarket market(asof, "EUR", 0.01), changedMarket(asof, "EUR", 0.015),
+        sameValuesMarket(asof, "EUR", 0.01), unknownMarket(asof, "EUR", 0.01);
+
+    boost::filesystem::path dir = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path();
+    auto cache = QuantLib::ext::make_shared<CurveCache>(dir.string());
+
+    // the in currency discount curves enter the key via their own keys, not via their values
+    cache->setCurveKey(market.discountCurve("EUR").currentLink(), CurveCache::Key().add("EUR-1"));
+    cache->setCurveKey(changedMarket.discountCurve("EUR").currentLink(), CurveCache::Key().add("EUR-2"));
+    cache->setCurveKey(sameValuesMarket.discountCurve("EUR").currentLink(), CurveCache::Key().add("EUR-3"));
+
+    auto build = [&](const Loader& l, const Market& m) {
+        return QuantLib::ext::make_shared<YieldCurve>(asof, spec, curveConfigs, l,
+                                                      map<string, QuantLib::ext::shared_ptr<YieldCurve>>(),
+                                                      map<string, QuantLib::ext::shared_ptr<DefaultCurve>>(),
+                                                      FXTriangulation(), nullptr, IborFallbackConfig::defaultConfig(),
+                                                      false, false, &m, cache);
+    };
+
+    Date d = asof + 3 * Years;
+    Real base = build(loader, market)->handle()->discount(d);
+    BOOST_CHECK_EQUAL(cache->misses(), Size(1));
+
+    // same inputs, read from the cache
+    BOOST_CHECK_CLOSE(build(loader, market)->handle()->discount(d), base, 1.0E-10);
+    BOOST_CHECK_EQUAL(cache->hits(), Size(1));
+    BOOST_CHECK_EQUAL(cache->misses(), Size(1));
+
+    // one changed quote
+    Real changedQuote = build(changedLoader, market)->handle()->discount(d);
+    BOOST_CHECK_EQUAL(cache->misses(), Size(2));
+    BOOST_CHECK(std::fabs(changedQuote - base) > 1.0E-6);
+
+    // changed in currency discount curve
+    Real changedCurve = build(loader, changedMarket)->handle()->discount(d);
+    BOOST_CHECK_EQUAL(cache->misses(), Size(3));
+    BOOST_CHECK(std::fabs(changedCurve - base) > 1.0E-6);
+
+    // in currency discount curve with a different key, but the same values
+    BOOST_CHECK_CLOSE(build(loader, sameValuesMarket)->handle()->discount(d), base, 1.0E-10);
+    BOOST_CHECK_EQUAL(cache->misses(), Size(4));
+
+    // in currency discount curve without a key, the cache is not used
+    BOOST_CHECK_CLOSE(build(loader, unknownMarket)->handle()->discount(d), base, 1.0E-10);
+    BOOST_CHECK_EQUAL(cache->misses(), Size(4));
+
+    BOOST_CHECK_EQUAL(cache->hits(), Size(1));
+
+    boost::filesystem::remove_all(dir);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -46,6 +46,10 @@ void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std:
 
     std::size_t redBlockId = 0;
 
+    // buffer reused for all nodes
+
+    std::vector<const T*> args;
+
     // loop over the nodes in the graph in reverse order
 
     for (std::size_t node = g.size() - 1; node > 0; --node) {
@@ -79,13 +83,15 @@ void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std:
             redBlockId = g.redBlockId(node);
         }
 
-        if (!g.predecessors(node).empty() && !isDeterministicAndZero(derivatives[node])) {
+        auto predecessors = g.predecessors(node);
+
+        if (!predecessors.empty() && !isDeterministicAndZero(derivatives[node])) {
 
             // propagate the derivative at a node to its predecessors
 
-            std::vector<const T*> args(g.predecessors(node).size());
-            for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                args[arg] = &values[g.predecessors(node)[arg]];
+            args.resize(predecessors.size());
+            for (std::size_t arg = 0; arg < predecessors.size(); ++arg) {
+                args[arg] = &values[predecessors[arg]];
             }
 
             QL_REQUIRE(derivatives[node].initialised(),
@@ -95,22 +101,22 @@ void backwardDerivatives(const ComputationGraph& g, std::vector<T>& values, std:
 
                 // expected stochastic automatic differentiaion, Fries, 2017
                 args[0] = &derivatives[node];
-                derivatives[g.predecessors(node)[0]] += conditionalExpectation(args);
+                derivatives[predecessors[0]] += conditionalExpectation(args);
 
             } else {
 
                 auto gr = grad[g.opId(node)](args, &values[node]);
 
-                for (std::size_t p = 0; p < g.predecessors(node).size(); ++p) {
-                    QL_REQUIRE(derivatives[g.predecessors(node)[p]].initialised(),
+                for (std::size_t p = 0; p < predecessors.size(); ++p) {
+                    QL_REQUIRE(derivatives[predecessors[p]].initialised(),
                                "backwardDerivatives: derivative at node "
-                                   << g.predecessors(node)[p] << " not initialized, which is an active predecessor of "
+                                   << predecessors[p] << " not initialized, which is an active predecessor of "
                                    << node);
                     QL_REQUIRE(gr[p].initialised(),
                                "backwardDerivatives: gradient at node "
                                    << node << " (opId " << g.opId(node) << ") not initialized at component " << p
-                                   << " but required to push to predecessor " << g.predecessors(node)[p]);
-                    derivatives[g.predecessors(node)[p]] += derivatives[node] * gr[p];
+                                   << " but required to push to predecessor " << predecessors[p]);
+                    derivatives[predecessors[p]] += derivatives[node] * gr[p];
                 }
             }
         }
@@ -31,6 +31,7 @@ std::size_t ComputationGraph::nan = std::numeric_limits<std::size_t>::max();
 
 void ComputationGraph::clear() {
     predecessors_.clear();
+    predecessorsStart_.assign(1, 0);
     opId_.clear();
     maxNodeRequiringArg_.clear();
     redBlockId_.clear();
@@ -42,11 +43,11 @@ void ComputationGraph::clear() {
     labels_.clear();
 }
 
-std::size_t ComputationGraph::size() const { return predecessors_.size(); }
+std::size_t ComputationGraph::size() const { return opId_.size(); }
 
 std::size_t ComputationGraph::insert(const std::string& label) {
-    std::size_t node = predecessors_.size();
-    predecessors_.push_back(std::vector<std::size_t>());
+    std::size_t node = opId_.size();
+    predecessorsStart_.push_back(predecessors_.size());
     opId_.push_back(0);
     maxNodeRequiringArg_.push_back(0);
     redBlockId_.push_back(currentRedBlockId_);
@@ -59,8 +60,9 @@ std::size_t ComputationGraph::insert(const std::string& label) {
 
 std::size_t ComputationGraph::insert(const std::vector<std::size_t>& predecessors, const std::size_t opId,
                                      const std::string& label) {
-    std::size_t node = predecessors_.size();
-    predecessors_.push_back(predecessors);
+    std::size_t node = opId_.size();
+    predecessors_.insert(predecessors_.end(), predecessors.begin(), predecessors.end());
+    predecessorsStart_.push_back(predecessors_.size());
     opId_.push_back(opId);
     for (auto const& p : predecessors) {
         maxNodeRequiringArg_[p] = node;
@@ -81,8 +83,9 @@ std::size_t ComputationGraph::insert(const std::vector<std::size_t>& predecessor
     return node;
 }
 
-const std::vector<std::size_t>& ComputationGraph::predecessors(const std::size_t node) const {
-    return predecessors_[node];
+ComputationGraph::Predecessors ComputationGraph::predecessors(const std::size_t node) const {
+    return Predecessors(predecessors_.data() + predecessorsStart_[node],
+                        predecessors_.data() + predecessorsStart_[node + 1]);
 }
 
 std::size_t ComputationGraph::opId(const std::size_t node) const { return opId_[node]; }
@@ -94,9 +97,9 @@ std::size_t ComputationGraph::constant(const double x) {
     if (c != constants_.end())
         return c->second;
     else {
-        std::size_t node = predecessors_.size();
+        std::size_t node = opId_.size();
         constants_.insert(std::make_pair(x, node));
-        predecessors_.push_back(std::vector<std::size_t>());
+        predecessorsStart_.push_back(predecessors_.size());
         opId_.push_back(0);
         maxNodeRequiringArg_.push_back(0);
         redBlockId_.push_back(currentRedBlockId_);
@@ -115,12 +118,12 @@ std::size_t ComputationGraph::variable(const std::string& name, const VarDoesntE
     if (c != variables_.end())
         return c->second;
     else if (v == VarDoesntExist::Create) {
-        std::size_t node = predecessors_.size();
+        std::size_t node = opId_.size();
         variables_.insert(std::make_pair(name, node));
         variableVersion_[name] = 0;
         if (enableLabels_)
             labels_[node].insert(name + "(v" + std::to_string(++variableVersion_[name]) + ")");
-        predecessors_.push_back(std::vector<std::size_t>());
+        predecessorsStart_.push_back(predecessors_.size());
         opId_.push_back(0);
         maxNodeRequiringArg_.push_back(0);
         redBlockId_.push_back(currentRedBlockId_);
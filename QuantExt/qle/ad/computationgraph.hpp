@@ -31,19 +31,35 @@
 
 namespace QuantExt {
 
-/*! - opId = 0 should refer to "no operation" */
+/*! - opId = 0 should refer to "no operation"
+    - the predecessors of all nodes are stored in one flat array with an offset per node (csr layout), so that the
+      evaluation and derivative routines can run over the graph without allocations per node */
 class ComputationGraph {
 public:
     enum class VarDoesntExist { Nan, Create, Throw };
     static std::size_t nan;
 
+    //! read-only view on the predecessors of a node, valid until the next node is inserted into the graph
+    class Predecessors {
+    public:
+        Predecessors(const std::size_t* begin, const std::size_t* end) : begin_(begin), end_(end) {}
+        const std::size_t* begin() const { return begin_; }
+        const std::size_t* end() const { return end_; }
+        std::size_t size() const { return end_ - begin_; }
+        bool empty() const { return begin_ == end_; }
+        std::size_t operator[](const std::size_t i) const { return begin_[i]; }
+
+    private:
+        const std::size_t *begin_, *end_;
+    };
+
     void clear();
 
     std::size_t size() const;
     std::size_t insert(const std::string& label = std::string());
     std::size_t insert(const std::vector<std::size_t>& predecessors, const std::size_t opId,
                        const std::string& label = std::string());
-    const std::vector<std::size_t>& predecessors(const std::size_t node) const;
+    Predecessors predecessors(const std::size_t node) const;
     std::size_t opId(const std::size_t node) const;
 
     std::size_t maxNodeRequiringArg(const std::size_t node) const;
@@ -67,7 +83,8 @@ public:
     const std::set<std::size_t>& redBlockDependencies() const;
 
 private:
-    std::vector<std::vector<std::size_t>> predecessors_;
+    std::vector<std::size_t> predecessors_;
+    std::vector<std::size_t> predecessorsStart_ = std::vector<std::size_t>(1, 0);
     std::vector<std::size_t> opId_;
     std::vector<bool> isConstant_;
     std::vector<double> constantValue_;
@@ -41,37 +41,42 @@ void forwardDerivatives(const ComputationGraph& g, const std::vector<T>& values,
     if (g.size() == 0)
         return;
 
+    // buffer reused for all nodes
+
+    std::vector<const T*> args;
+
     // loop over the nodes in the graph in forward order
 
     for (std::size_t node = 0; node < g.size(); ++node) {
-        if (!g.predecessors(node).empty()) {
+        auto predecessors = g.predecessors(node);
+        if (!predecessors.empty()) {
 
             // propagate the derivatives from predecessors of a node to the node
 
-            std::vector<const T*> args(g.predecessors(node).size());
-            for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                args[arg] = &values[g.predecessors(node)[arg]];
+            args.resize(predecessors.size());
+            for (std::size_t arg = 0; arg < predecessors.size(); ++arg) {
+                args[arg] = &values[predecessors[arg]];
             }
 
             if (g.opId(node) == conditionalExpectationOpId && conditionalExpectation) {
 
-                args[0] = &derivatives[g.predecessors(node)[0]];
+                args[0] = &derivatives[predecessors[0]];
                 derivatives[node] = conditionalExpectation(args);
 
             } else {
 
                 auto gr = grad[g.opId(node)](args, &values[node]);
 
-                for (std::size_t p = 0; p < g.predecessors(node).size(); ++p) {
-                    derivatives[node] += derivatives[g.predecessors(node)[p]] * gr[p];
+                for (std::size_t p = 0; p < predecessors.size(); ++p) {
+                    derivatives[node] += derivatives[predecessors[p]] * gr[p];
                 }
             }
 
             // the check if we can delete the predecessors
 
             if (deleter) {
-                for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                    std::size_t p = g.predecessors(node)[arg];
+                for (std::size_t arg = 0; arg < predecessors.size(); ++arg) {
+                    std::size_t p = predecessors[arg];
 
                     // is the node no longer needed for other target nodes?
 
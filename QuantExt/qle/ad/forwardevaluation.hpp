@@ -24,8 +24,12 @@
 
 #include <qle/ad/computationgraph.hpp>
 
+#include <ql/errors.hpp>
 #include <ql/shared_ptr.hpp>
 
+#include <algorithm>
+#include <functional>
+
 namespace QuantExt {
 
 template <class T>
@@ -42,32 +46,54 @@ void forwardEvaluation(const ComputationGraph& g, std::vector<T>& values,
     if (deleter && keepValuesForDerivatives)
         keepNodesDerivatives = std::vector<bool>(g.size(), false);
 
+    // the requirements of an op only depend on the number of args, we cache them by op id and number of args
+
+    std::vector<std::vector<std::pair<std::vector<bool>, bool>>> opRequirements;
+    auto requirements = [&opRequirements, &opRequiresNodesForDerivatives](
+                            const std::size_t opId, const std::size_t nArgs) -> const std::pair<std::vector<bool>, bool>& {
+        if (opRequirements.size() <= opId)
+            opRequirements.resize(opId + 1);
+        if (opRequirements[opId].size() <= nArgs)
+            opRequirements[opId].resize(nArgs + 1);
+        auto& r = opRequirements[opId][nArgs];
+        if (r.first.size() != nArgs)
+            r = opRequiresNodesForDerivatives[opId](nArgs);
+        return r;
+    };
+
+    // buffers reused for all nodes
+
+    std::vector<const T*> args;
+    std::vector<std::size_t> nodesToDelete;
+
     // loop over the nodes in the graph in ascending order
 
     for (std::size_t node = startNode; node < (endNode == ComputationGraph::nan ? g.size() : endNode); ++node) {
 
         // if a node is computed by an op applied to predecessors ...
 
-        if (!g.predecessors(node).empty()) {
+        auto predecessors = g.predecessors(node);
+
+        if (!predecessors.empty()) {
 
             // evaluate the node
 
-            std::vector<const T*> args(g.predecessors(node).size());
-            for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                args[arg] = &values[g.predecessors(node)[arg]];
+            args.resize(predecessors.size());
+            for (std::size_t arg = 0; arg < predecessors.size(); ++arg) {
+                args[arg] = &values[predecessors[arg]];
             }
 
-            std::set<std::size_t> nodesToDelete;
+            nodesToDelete.clear();
             if (deleter) {
-                for (std::size_t arg = 0; arg < g.predecessors(node).size(); ++arg) {
-                    std::size_t p = g.predecessors(node)[arg];
+                for (std::size_t arg = 0; arg < predecessors.size(); ++arg) {
+                    std::size_t p = predecessors[arg];
 
                     if (!keepNodesDerivatives.empty()) {
 
                         // is the node required to compute derivatives, then add it to the keep nodes vector
 
-                        if (opRequiresNodesForDerivatives[g.opId(p)](args.size()).second ||
-                            opRequiresNodesForDerivatives[g.opId(node)](args.size()).first[arg])
+                        if (requirements(g.opId(p), args.size()).second ||
+                            requirements(g.opId(node), args.size()).first[arg])
                             keepNodesDerivatives[p] = true;
                     }
 
@@ -85,9 +111,16 @@ void forwardEvaluation(const ComputationGraph& g, std::vector<T>& values,
 
                     // apply the deleter
 
-                    nodesToDelete.insert(p);
+                    nodesToDelete.push_back(p);
 
                 } // for arg over g.predecessors
+
+                // a node can appear more than once as an argument, but must be deleted only once
+
+                if (nodesToDelete.size() > 1) {
+                    std::sort(nodesToDelete.begin(), nodesToDelete.end());
+                    nodesToDelete.erase(std::unique(nodesToDelete.begin(), nodesToDelete.end()), nodesToDelete.end());
+                }
             }
 
             if (preDeleter && !opAllowsPredeletion.empty() && opAllowsPredeletion[g.opId(node)]) {
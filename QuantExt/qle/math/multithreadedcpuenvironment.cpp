@@ -0,0 +1,725 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/math/multithreadedcpuenvironment.hpp>
+#include <qle/math/randomvariable.hpp>
+#include <qle/math/randomvariable_opcodes.hpp>
+#include <qle/math/randomvariable_ops.hpp>
+
+#include <ql/errors.hpp>
+#include <ql/math/comparison.hpp>
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/mt19937uniformrng.hpp>
+
+#include <boost/math/distributions/normal.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace QuantExt {
+
+namespace {
+
+// number of samples processed by one task, the data of a block stays in the cache while a program segment runs on it
+constexpr std::size_t blockSize = 1024;
+
+// worker threads processing the blocks of a calculation together with the calling thread
+class WorkerPool {
+public:
+    explicit WorkerPool(const std::size_t nThreads) {
+        for (std::size_t i = 0; i < nThreads; ++i)
+            threads_.emplace_back([this]() { work(); });
+    }
+
+    ~WorkerPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (auto& t : threads_)
+            t.join();
+    }
+
+    std::size_t size() const { return threads_.size() + 1; }
+
+    // calls f(i) for i = 0, ..., n - 1 and returns when all calls are finished
+    void run(const std::size_t n, const std::function<void(std::size_t)>& f) {
+        if (threads_.empty() || n <= 1) {
+            for (std::size_t i = 0; i < n; ++i)
+                f(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = &f;
+            n_ = n;
+            next_ = 0;
+            active_ = threads_.size();
+            error_ = nullptr;
+            ++generation_;
+        }
+        start_.notify_all();
+        process();
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return active_ == 0; });
+        task_ = nullptr;
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+
+private:
+    void process() {
+        for (std::size_t i = next_++; i < n_; i = next_++) {
+            try {
+                (*task_)(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (!error_)
+                    error_ = std::current_exception();
+            }
+        }
+    }
+
+    void work() {
+        std::size_t generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(lock, [this, generation]() { return stop_ || generation_ != generation; });
+                if (stop_)
+                    return;
+                generation = generation_;
+            }
+            process();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --active_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::mutex mutex_;
+    std::condition_variable start_, done_;
+    const std::function<void(std::size_t)>* task_ = nullptr;
+    std::size_t n_ = 0, active_ = 0, generation_ = 0;
+    std::atomic<std::size_t> next_{0};
+    std::exception_ptr error_;
+    bool stop_ = false;
+};
+
+// r = op(a[0], ..., a[nArgs-1]) on m samples, the element-wise semantics follow the random variable ops
+void applyKernel(const std::size_t op, double* r, const double* const* a, const std::size_t nArgs,
+                 const std::size_t m) {
+    static const boost::math::normal_distribution<double> normal;
+    switch (op) {
+    case RandomVariableOpCode::Add:
+        if (nArgs == 2) {
+            const double *x = a[0], *y = a[1];
+            for (std::size_t i = 0; i < m; ++i)
+                r[i] = x[i] + y[i];
+        } else {
+            for (std::size_t i = 0; i < m; ++i) {
+                double s = 0.0;
+                for (std::size_t k = 0; k < nArgs; ++k)
+                    s += a[k][i];
+                r[i] = s;
+            }
+        }
+        break;
+    case RandomVariableOpCode::Subtract: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = x[i] - y[i];
+        break;
+    }
+    case RandomVariableOpCode::Negative: {
+        const double* x = a[0];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = -x[i];
+        break;
+    }
+    case RandomVariableOpCode::Mult: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = x[i] * y[i];
+        break;
+    }
+    case RandomVariableOpCode::Div: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = x[i] / y[i];
+        break;
+    }
+    case RandomVariableOpCode::IndicatorEq: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = QuantLib::close_enough(x[i], y[i]) ? 1.0 : 0.0;
+        break;
+    }
+    case RandomVariableOpCode::IndicatorGt: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = (x[i] > y[i] && !QuantLib::close_enough(x[i], y[i])) ? 1.0 : 0.0;
+        break;
+    }
+    case RandomVariableOpCode::IndicatorGeq: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = (x[i] > y[i] || QuantLib::close_enough(x[i], y[i])) ? 1.0 : 0.0;
+        break;
+    }
+    case RandomVariableOpCode::Min: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = std::min(x[i], y[i]);
+        break;
+    }
+    case RandomVariableOpCode::Max: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = std::max(x[i], y[i]);
+        break;
+    }
+    case RandomVariableOpCode::Abs: {
+        const double* x = a[0];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = std::abs(x[i]);
+        break;
+    }
+    case RandomVariableOpCode::Exp: {
+        const double* x = a[0];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = std::exp(x[i]);
+        break;
+    }
+    case RandomVariableOpCode::Sqrt: {
+        const double* x = a[0];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = std::sqrt(x[i]);
+        break;
+    }
+    case RandomVariableOpCode::Log: {
+        const double* x = a[0];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = std::log(x[i]);
+        break;
+    }
+    case RandomVariableOpCode::Pow: {
+        const double *x = a[0], *y = a[1];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = std::pow(x[i], y[i]);
+        break;
+    }
+    case RandomVariableOpCode::NormalCdf: {
+        const double* x = a[0];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = boost::math::cdf(normal, x[i]);
+        break;
+    }
+    case RandomVariableOpCode::NormalPdf: {
+        const double* x = a[0];
+        for (std::size_t i = 0; i < m; ++i)
+            r[i] = boost::math::pdf(normal, x[i]);
+        break;
+    }
+    default:
+        QL_FAIL("MultiThreadedCpuContext: op code " << op << " can not be applied element-wise");
+    }
+}
+
+// minimum number of arguments per op code, ops are validated when they are recorded
+std::size_t minNumberOfArgs(const std::size_t op) {
+    switch (op) {
+    case RandomVariableOpCode::Add:
+    case RandomVariableOpCode::Negative:
+    case RandomVariableOpCode::Abs:
+    case RandomVariableOpCode::Exp:
+    case RandomVariableOpCode::Sqrt:
+    case RandomVariableOpCode::Log:
+    case RandomVariableOpCode::NormalCdf:
+    case RandomVariableOpCode::NormalPdf:
+        return 1;
+    case RandomVariableOpCode::ConditionalExpectation:
+    case RandomVariableOpCode::Subtract:
+    case RandomVariableOpCode::Mult:
+    case RandomVariableOpCode::Div:
+    case RandomVariableOpCode::IndicatorEq:
+    case RandomVariableOpCode::IndicatorGt:
+    case RandomVariableOpCode::IndicatorGeq:
+    case RandomVariableOpCode::Min:
+    case RandomVariableOpCode::Max:
+    case RandomVariableOpCode::Pow:
+        return 2;
+    default:
+        QL_FAIL("MultiThreadedCpuContext::applyOperation(): op code " << op << " not supported.");
+    }
+}
+
+} // namespace
+
+class MultiThreadedCpuContext : public ComputeContext {
+public:
+    MultiThreadedCpuContext();
+    ~MultiThreadedCpuContext() override final;
+    void init() override final;
+
+    std::pair<std::size_t, bool> initiateCalculation(const std::size_t n, const std::size_t id = 0,
+                                                     const std::size_t version = 0,
+                                                     const Settings settings = {}) override final;
+    void disposeCalculation(const std::size_t id) override final;
+    std::size_t createInputVariable(double v) override final;
+    std::size_t createInputVariable(double* v) override final;
+    std::vector<std::vector<std::size_t>> createInputVariates(const std::size_t dim,
+                                                              const std::size_t steps) override final;
+    std::size_t applyOperation(const std::size_t randomVariableOpCode,
+                               const std::vector<std::size_t>& args) override final;
+    void freeVariable(const std::size_t id) override final;
+    void declareOutputVariable(const std::size_t id) override final;
+    void finalizeCalculation(std::vector<double*>& output) override final;
+
+    std::vector<std::pair<std::string, std::string>> deviceInfo() const override;
+    bool supportsDoublePrecision() const override { return true; }
+
+    const DebugInfo& debugInfo() const override final;
+
+private:
+    enum class ComputeState { idle, createInput, createVariates, calc };
+
+    // the program as a flat instruction stream, the args of op i are args_[argsStart_[i]], ..., args_[argsStart_[i+1]-1]
+    class program {
+    public:
+        program() : argsStart_(1, 0) {}
+        void clear() {
+            op_.clear();
+            resultId_.clear();
+            args_.clear();
+            argsStart_.assign(1, 0);
+        }
+        std::size_t size() const { return op_.size(); }
+        std::size_t numberOfArgs() const { return args_.size(); }
+        void add(std::size_t resultId, std::size_t op, const std::vector<std::size_t>& args) {
+            op_.push_back(op);
+            resultId_.push_back(resultId);
+            args_.insert(args_.end(), args.begin(), args.end());
+            argsStart_.push_back(args_.size());
+        }
+        std::size_t op(std::size_t i) const { return op_[i]; }
+        std::size_t resultId(std::size_t i) const { return resultId_[i]; }
+        std::size_t argsStart(std::size_t i) const { return argsStart_[i]; }
+        std::size_t numberOfArgs(std::size_t i) const { return argsStart_[i + 1] - argsStart_[i]; }
+        std::size_t arg(std::size_t j) const { return args_[j]; }
+
+    private:
+        std::vector<std::size_t> op_;
+        std::vector<std::size_t> resultId_;
+        std::vector<std::size_t> args_;
+        std::vector<std::size_t> argsStart_;
+    };
+
+    bool initialized_ = false;
+    std::unique_ptr<WorkerPool> pool_;
+
+    // will be accumulated over all calcs
+    ComputeContext::DebugInfo debugInfo_;
+
+    // 1a vectors per current calc id
+
+    std::vector<std::size_t> size_;
+    std::vector<std::size_t> version_;
+    std::vector<bool> disposed_;
+    std::vector<program> program_;
+    std::vector<std::size_t> numberOfInputVars_;
+    std::vector<std::size_t> numberOfVariates_;
+    std::vector<std::size_t> numberOfVars_;
+    std::vector<std::vector<std::size_t>> outputVars_;
+
+    // 2 curent calc
+
+    std::size_t currentId_ = 0;
+    ComputeState currentState_ = ComputeState::idle;
+    Settings settings_;
+    bool newCalc_;
+
+    // values of the input vars followed by the values of the vars, each occupying size_ consecutive entries
+    std::vector<double> values_;
+    std::vector<std::size_t> freedVariables_;
+
+    // shared random variates for all calcs, each occupying size_ consecutive entries
+
+    std::unique_ptr<QuantLib::MersenneTwisterUniformRng> rng_;
+    QuantLib::InverseCumulativeNormal icn_;
+    std::vector<double> variates_;
+};
+
+MultiThreadedCpuFramework::MultiThreadedCpuFramework() {
+    contexts_["MultiThreadedCpu/Default/Default"] = new MultiThreadedCpuContext();
+}
+
+MultiThreadedCpuFramework::~MultiThreadedCpuFramework() {
+    for (auto& [_, c] : contexts_) {
+        delete c;
+    }
+}
+
+MultiThreadedCpuContext::MultiThreadedCpuContext() : initialized_(false) {}
+
+MultiThreadedCpuContext::~MultiThreadedCpuContext() {}
+
+void MultiThreadedCpuContext::init() {
+
+    if (initialized_) {
+        return;
+    }
+
+    debugInfo_.numberOfOperations = 0;
+    debugInfo_.nanoSecondsDataCopy = 0;
+    debugInfo_.nanoSecondsProgramBuild = 0;
+    debugInfo_.nanoSecondsCalculation = 0;
+
+    // the calling thread processes blocks, too
+
+    std::size_t nThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+    pool_ = std::make_unique<WorkerPool>(nThreads - 1);
+
+    initialized_ = true;
+}
+
+std::vector<std::pair<std::string, std::string>> MultiThreadedCpuContext::deviceInfo() const {
+    return {{"threads", pool_ ? std::to_string(pool_->size()) : "n/a"}, {"blockSize", std::to_string(blockSize)}};
+}
+
+void MultiThreadedCpuContext::disposeCalculation(const std::size_t id) {
+    QL_REQUIRE(!disposed_[id - 1],
+               "MultiThreadedCpuContext::disposeCalculation(): id " << id << " was already disposed.");
+    program_[id - 1].clear();
+    disposed_[id - 1] = true;
+}
+
+std::pair<std::size_t, bool> MultiThreadedCpuContext::initiateCalculation(const std::size_t n, const std::size_t id,
+                                                                          const std::size_t version,
+                                                                          const Settings settings) {
+
+    QL_REQUIRE(n > 0, "MultiThreadedCpuContext::initiateCalculation(): n must not be zero");
+
+    newCalc_ = false;
+    settings_ = settings;
+
+    if (id == 0) {
+
+        // initiate new calcaultion
+
+        size_.push_back(n);
+        version_.push_back(version);
+        disposed_.push_back(false);
+        program_.push_back(program());
+        numberOfInputVars_.push_back(0);
+        numberOfVariates_.push_back(0);
+        numberOfVars_.push_back(0);
+        outputVars_.push_back({});
+
+        currentId_ = size_.size();
+        newCalc_ = true;
+
+    } else {
+
+        // initiate calculation on existing id
+
+        QL_REQUIRE(id <= size_.size(), "MultiThreadedCpuContext::initiateCalculation(): id ("
+                                           << id << ") invalid, got 1..." << size_.size());
+        QL_REQUIRE(size_[id - 1] == n, "MultiThreadedCpuContext::initiateCalculation(): size ("
+                                           << size_[id - 1] << ") for id " << id << " does not match current size ("
+                                           << n << ")");
+        QL_REQUIRE(!disposed_[id - 1], "MultiThreadedCpuContext::initiateCalculation(): id ("
+                                           << id << ") was already disposed, it can not be used any more.");
+
+        if (version != version_[id - 1]) {
+            version_[id - 1] = version;
+            program_[id - 1].clear();
+            numberOfInputVars_[id - 1] = 0;
+            numberOfVariates_[id - 1] = 0;
+            numberOfVars_[id - 1] = 0;
+            outputVars_[id - 1].clear();
+            newCalc_ = true;
+        }
+
+        currentId_ = id;
+    }
+
+    // reset variables
+
+    numberOfInputVars_[currentId_ - 1] = 0;
+
+    values_.clear();
+    if (newCalc_)
+        freedVariables_.clear();
+
+    // set state
+
+    currentState_ = ComputeState::createInput;
+
+    // return calc id
+
+    return std::make_pair(currentId_, newCalc_);
+}
+
+std::size_t MultiThreadedCpuContext::createInputVariable(double v) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput,
+               "MultiThreadedCpuContext::createInputVariable(): not in state createInput ("
+                   << static_cast<int>(currentState_) << ")");
+    values_.insert(values_.end(), size_[currentId_ - 1], v);
+    return numberOfInputVars_[currentId_ - 1]++;
+}
+
+std::size_t MultiThreadedCpuContext::createInputVariable(double* v) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput,
+               "MultiThreadedCpuContext::createInputVariable(): not in state createInput ("
+                   << static_cast<int>(currentState_) << ")");
+    values_.insert(values_.end(), v, v + size_[currentId_ - 1]);
+    return numberOfInputVars_[currentId_ - 1]++;
+}
+
+std::vector<std::vector<std::size_t>> MultiThreadedCpuContext::createInputVariates(const std::size_t dim,
+                                                                                   const std::size_t steps) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput || currentState_ == ComputeState::createVariates,
+               "MultiThreadedCpuContext::createInputVariates(): not in state createInput or createVariates ("
+                   << static_cast<int>(currentState_) << ")");
+    QL_REQUIRE(currentId_ > 0, "MultiThreadedCpuContext::createInputVariates(): current id is not set");
+    QL_REQUIRE(newCalc_, "MultiThreadedCpuContext::createInputVariates(): id ("
+                             << currentId_ << ") in version " << version_[currentId_ - 1] << " is replayed.");
+    currentState_ = ComputeState::createVariates;
+
+    if (rng_ == nullptr) {
+        rng_ = std::make_unique<MersenneTwisterUniformRng>(settings_.rngSeed);
+    }
+
+    // same sequence of variates as in the BasicCpu framework
+
+    std::size_t requiredSize = (numberOfVariates_[currentId_ - 1] + dim * steps) * size_[currentId_ - 1];
+    if (variates_.size() < requiredSize) {
+        variates_.reserve(requiredSize);
+        while (variates_.size() < requiredSize)
+            variates_.push_back(icn_(rng_->nextReal()));
+    }
+
+    std::vector<std::vector<std::size_t>> resultIds(dim, std::vector<std::size_t>(steps));
+    for (std::size_t i = 0; i < dim; ++i) {
+        for (std::size_t j = 0; j < steps; ++j) {
+            resultIds[i][j] = numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1] + j * dim + i;
+        }
+    }
+
+    numberOfVariates_[currentId_ - 1] += dim * steps;
+
+    return resultIds;
+}
+
+std::size_t MultiThreadedCpuContext::applyOperation(const std::size_t randomVariableOpCode,
+                                                    const std::vector<std::size_t>& args) {
+    QL_REQUIRE(currentState_ == ComputeState::createInput || currentState_ == ComputeState::createVariates ||
+                   currentState_ == ComputeState::calc,
+               "MultiThreadedCpuContext::applyOperation(): not in state createInput or calc ("
+                   << static_cast<int>(currentState_) << ")");
+    currentState_ = ComputeState::calc;
+    QL_REQUIRE(currentId_ > 0, "MultiThreadedCpuContext::applyOperation(): current id is not set");
+    QL_REQUIRE(newCalc_, "MultiThreadedCpuContext::applyOperation(): id ("
+                             << currentId_ << ") in version " << version_[currentId_ - 1] << " is replayed.");
+    QL_REQUIRE(args.size() >= minNumberOfArgs(randomVariableOpCode),
+               "MultiThreadedCpuContext::applyOperation(): op code " << randomVariableOpCode << " requires at least "
+                                                                     << minNumberOfArgs(randomVariableOpCode)
+                                                                     << " args, got " << args.size());
+
+    // determine variable id to use for result
+
+    std::size_t resultId;
+    if (!freedVariables_.empty()) {
+        resultId = freedVariables_.back();
+        freedVariables_.pop_back();
+    } else {
+        resultId =
+            numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1] + numberOfVars_[currentId_ - 1]++;
+    }
+
+    // store operation
+
+    program_[currentId_ - 1].add(resultId, randomVariableOpCode, args);
+
+    // update num of ops in debug info
+
+    if (settings_.debug)
+        debugInfo_.numberOfOperations += 1 * size_[currentId_ - 1];
+
+    // return result id
+
+    return resultId;
+}
+
+void MultiThreadedCpuContext::freeVariable(const std::size_t id) {
+    QL_REQUIRE(currentState_ == ComputeState::calc,
+               "MultiThreadedCpuContext::free(): not in state calc (" << static_cast<int>(currentState_) << ")");
+    QL_REQUIRE(currentId_ > 0, "MultiThreadedCpuContext::freeVariable(): current id is not set");
+    QL_REQUIRE(newCalc_, "MultiThreadedCpuContext::freeVariable(): id ("
+                             << currentId_ << ") in version " << version_[currentId_ - 1] << " is replayed.");
+
+    // we do not free variates, since they are shared
+
+    if (id >= numberOfInputVars_[currentId_ - 1] &&
+        id < numberOfInputVars_[currentId_ - 1] + numberOfVariates_[currentId_ - 1])
+        return;
+
+    freedVariables_.push_back(id);
+}
+
+void MultiThreadedCpuContext::declareOutputVariable(const std::size_t id) {
+    QL_REQUIRE(currentState_ != ComputeState::idle, "MultiThreadedCpuContext::declareOutputVariable(): state is idle");
+    QL_REQUIRE(currentId_ > 0, "MultiThreadedCpuContext::declareOutputVariable(): current id not set");
+    QL_REQUIRE(newCalc_, "MultiThreadedCpuContext::declareOutputVariable(): id ("
+                             << currentId_ << ") in version " << version_[currentId_ - 1] << " is replayed.");
+    outputVars_[currentId_ - 1].push_back(id);
+}
+
+void MultiThreadedCpuContext::finalizeCalculation(std::vector<double*>& output) {
+    struct exitGuard {
+        exitGuard() {}
+        ~exitGuard() { *currentState = ComputeState::idle; }
+        ComputeState* currentState;
+    } guard;
+
+    guard.currentState = &currentState_;
+
+    QL_REQUIRE(currentId_ > 0, "MultiThreadedCpuContext::finalizeCalculation(): current id is not set");
+    QL_REQUIRE(output.size() == outputVars_[currentId_ - 1].size(),
+               "MultiThreadedCpuContext::finalizeCalculation(): output size ("
+                   << output.size() << ") inconsistent to kernel output size (" << outputVars_[currentId_ - 1].size()
+                   << ")");
+
+    if (!initialized_)
+        init();
+
+    boost::timer::cpu_timer timer;
+
+    const auto& p = program_[currentId_ - 1];
+    const std::size_t n = size_[currentId_ - 1];
+    const std::size_t nInputVars = numberOfInputVars_[currentId_ - 1];
+    const std::size_t nVariates = numberOfVariates_[currentId_ - 1];
+
+    // resize values vector to required size
+
+    values_.resize((nInputVars + numberOfVars_[currentId_ - 1]) * n);
+
+    // resolve the variable ids of the program to the data of the variables
+
+    auto data = [this, n, nInputVars, nVariates](const std::size_t id) -> double* {
+        if (id < nInputVars)
+            return &values_[id * n];
+        else if (id < nInputVars + nVariates)
+            return &variates_[(id - nInputVars) * n];
+        else
+            return &values_[(id - nVariates) * n];
+    };
+
+    std::vector<double*> result(p.size());
+    std::vector<const double*> args(p.numberOfArgs());
+    for (std::size_t i = 0; i < p.size(); ++i) {
+        QL_REQUIRE(p.resultId(i) < nInputVars || p.resultId(i) >= nInputVars + nVariates,
+                   "MultiThreadedCpuContext::finalizeCalculation(): internal error, result id "
+                       << p.resultId(i) << " does not fall into values array.");
+        result[i] = data(p.resultId(i));
+        for (std::size_t j = p.argsStart(i); j < p.argsStart(i + 1); ++j)
+            args[j] = data(p.arg(j));
+    }
+
+    if (settings_.debug)
+        debugInfo_.nanoSecondsProgramBuild += timer.elapsed().wall;
+    timer.start();
+
+    // execute calculation: the program is split into segments of element-wise ops which are processed block by block
+    // in parallel, conditional expectations require all samples and are evaluated in between on the calling thread
+
+    const std::size_t nBlocks = (n + blockSize - 1) / blockSize;
+
+    std::size_t i = 0;
+    while (i < p.size()) {
+        if (p.op(i) == RandomVariableOpCode::ConditionalExpectation) {
+            std::vector<RandomVariable> tmp;
+            tmp.reserve(p.numberOfArgs(i));
+            for (std::size_t j = p.argsStart(i); j < p.argsStart(i + 1); ++j) {
+                tmp.push_back(RandomVariable(n, args[j]));
+                tmp.back().updateDeterministic();
+            }
+            std::vector<const RandomVariable*> tmpPtr;
+            for (auto const& r : tmp)
+                tmpPtr.push_back(&r);
+            auto ops = getRandomVariableOps(n, settings_.regressionOrder);
+            RandomVariable res = ops[RandomVariableOpCode::ConditionalExpectation](tmpPtr);
+            for (std::size_t k = 0; k < n; ++k)
+                result[i][k] = res[k];
+            ++i;
+        } else {
+            std::size_t end = i;
+            while (end < p.size() && p.op(end) != RandomVariableOpCode::ConditionalExpectation)
+                ++end;
+            pool_->run(nBlocks, [&p, &result, &args, i, end, n](const std::size_t b) {
+                const std::size_t offset = b * blockSize;
+                const std::size_t m = std::min(blockSize, n - offset);
+                std::vector<const double*> blockArgs;
+                for (std::size_t k = i; k < end; ++k) {
+                    blockArgs.resize(p.numberOfArgs(k));
+                    for (std::size_t j = 0; j < blockArgs.size(); ++j)
+                        blockArgs[j] = args[p.argsStart(k) + j] + offset;
+                    applyKernel(p.op(k), result[k] + offset, blockArgs.data(), blockArgs.size(), m);
+                }
+            });
+            i = end;
+        }
+    }
+
+    if (settings_.debug)
+        debugInfo_.nanoSecondsCalculation += timer.elapsed().wall;
+
+    // fill output
+
+    for (std::size_t i = 0; i < outputVars_[currentId_ - 1].size(); ++i) {
+        const double* v = data(outputVars_[currentId_ - 1][i]);
+        std::copy(v, v + n, output[i]);
+    }
+}
+
+const ComputeContext::DebugInfo& MultiThreadedCpuContext::debugInfo() const { return debugInfo_; }
+
+std::set<std::string> MultiThreadedCpuFramework::getAvailableDevices() const {
+    return {"MultiThreadedCpu/Default/Default"};
+}
+
+ComputeContext* MultiThreadedCpuFramework::getContext(const std::string& deviceName) {
+    QL_REQUIRE(deviceName == "MultiThreadedCpu/Default/Default",
+               "MultiThreadedCpuFramework::getContext(): device '"
+                   << deviceName << "' not supported. Available device is 'MultiThreadedCpu/Default/Default'.");
+    return contexts_[deviceName];
+}
+
+} // namespace QuantExt
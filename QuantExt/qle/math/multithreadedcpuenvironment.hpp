@@ -0,0 +1,47 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file qle/math/multithreadedcpuenvironment.hpp
+    \brief compute env implementation using all cpu cores
+
+    The recorded program is executed in blocks of samples that are distributed over a pool of worker threads, the
+    operations are applied by tight loops over contiguous data which the compiler can vectorise. Conditional
+    expectations are evaluated on the full sample set in the calling thread. The results coincide with those of
+    the BasicCpu framework up to floating point reordering.
+*/
+
+#pragma once
+
+#include <qle/math/computeenvironment.hpp>
+
+#include <map>
+
+namespace QuantExt {
+
+class MultiThreadedCpuFramework : public ComputeFramework {
+public:
+    MultiThreadedCpuFramework();
+    ~MultiThreadedCpuFramework() override final;
+    std::set<std::string> getAvailableDevices() const override final;
+    ComputeContext* getContext(const std::string& deviceName) override final;
+
+private:
+    std::map<std::string, ComputeContext*> contexts_;
+};
+
+} // namespace QuantExt
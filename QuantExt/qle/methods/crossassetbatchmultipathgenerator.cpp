@@ -0,0 +1,146 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/methods/crossassetbatchmultipathgenerator.hpp>
+
+namespace QuantExt {
+
+CrossAssetBatchMultiPathGenerator::CrossAssetBatchMultiPathGenerator(
+    const QuantLib::ext::shared_ptr<CrossAssetStateProcess>& process, const TimeGrid& grid,
+    const SequenceType sequenceType, const BigNatural seed, const SobolBrownianGenerator::Ordering ordering,
+    const SobolRsg::DirectionIntegers directionIntegers, const Size batchSize)
+    : process_(process), grid_(grid), batchSize_(batchSize), next_(MultiPath(), 1.0) {
+
+    QL_REQUIRE(process_, "CrossAssetBatchMultiPathGenerator: no process given (null)");
+    QL_REQUIRE(process_->hasAffineTransition(),
+               "CrossAssetBatchMultiPathGenerator: process does not have affine transitions, use "
+               "makeMultiPathGenerator() instead");
+    QL_REQUIRE(batchSize_ > 0, "CrossAssetBatchMultiPathGenerator: batch size must be positive");
+    QL_REQUIRE(grid_.size() > 1, "CrossAssetBatchMultiPathGenerator: time grid must contain at least one step");
+
+    size_ = process_->size();
+    factors_ = process_->factors();
+    steps_ = grid_.size() - 1;
+
+    variateGenerator_ =
+        makeMultiPathVariateGenerator(sequenceType, factors_, steps_, seed, ordering, directionIntegers);
+
+    paths_.resize((steps_ + 1) * size_ * batchSize_);
+    variates_.resize(steps_ * factors_ * batchSize_);
+    weights_.resize(batchSize_);
+    next_.value = MultiPath(size_, grid_);
+
+    currentSample_ = batchSize_;
+}
+
+void CrossAssetBatchMultiPathGenerator::reset() {
+    variateGenerator_->reset();
+    transitionsReady_ = false;
+    currentSample_ = batchSize_;
+}
+
+void CrossAssetBatchMultiPathGenerator::skipTo(const Size sample) {
+    // the transitions do not depend on the sample, so we keep them
+    variateGenerator_->skipTo(sample);
+    currentSample_ = batchSize_;
+}
+
+void CrossAssetBatchMultiPathGenerator::computeTransitions() const {
+    m_.resize(steps_);
+    a_.resize(steps_);
+    d_.resize(steps_);
+    for (Size k = 0; k < steps_; ++k) {
+        process_->affineTransition(grid_[k], grid_.dt(k), m_[k], a_[k], d_[k]);
+        QL_REQUIRE(d_[k].columns() == factors_, "CrossAssetBatchMultiPathGenerator: diffusion matrix has "
+                                                    << d_[k].columns() << " columns, expected " << factors_);
+    }
+    transitionsReady_ = true;
+}
+
+void CrossAssetBatchMultiPathGenerator::generateBatch() const {
+
+    if (!transitionsReady_)
+        computeTransitions();
+
+    // draw the variates for all samples of the batch
+
+    for (Size s = 0; s < batchSize_; ++s) {
+        Sample<std::vector<Array>> v = variateGenerator_->next();
+        weights_[s] = v.weight;
+        for (Size k = 0; k < steps_; ++k) {
+            for (Size j = 0; j < factors_; ++j) {
+                variates_[(k * factors_ + j) * batchSize_ + s] = v.value[k][j];
+            }
+        }
+    }
+
+    // initial values
+
+    Array x0 = process_->initialValues();
+    for (Size i = 0; i < size_; ++i) {
+        std::fill(paths_.begin() + i * batchSize_, paths_.begin() + (i + 1) * batchSize_, x0[i]);
+    }
+
+    // evolve all samples of a time step together, x_{k+1} = m + A x_k + D dw
+
+    for (Size k = 0; k < steps_; ++k) {
+        const Real* x = &paths_[k * size_ * batchSize_];
+        const Real* dw = &variates_[k * factors_ * batchSize_];
+        Real* y = &paths_[(k + 1) * size_ * batchSize_];
+        const Matrix& a = a_[k];
+        const Matrix& d = d_[k];
+        for (Size i = 0; i < size_; ++i) {
+            Real* yi = y + i * batchSize_;
+            std::fill(yi, yi + batchSize_, m_[k][i]);
+            for (Size j = 0; j < size_; ++j) {
+                Real c = a[i][j];
+                if (c == 0.0)
+                    continue;
+                const Real* xj = x + j * batchSize_;
+                for (Size s = 0; s < batchSize_; ++s)
+                    yi[s] += c * xj[s];
+            }
+            for (Size j = 0; j < factors_; ++j) {
+                Real c = d[i][j];
+                if (c == 0.0)
+                    continue;
+                const Real* dwj = dw + j * batchSize_;
+                for (Size s = 0; s < batchSize_; ++s)
+                    yi[s] += c * dwj[s];
+            }
+        }
+    }
+
+    currentSample_ = 0;
+}
+
+const Sample<MultiPath>& CrossAssetBatchMultiPathGenerator::next() const {
+    if (currentSample_ == batchSize_)
+        generateBatch();
+    for (Size i = 0; i < size_; ++i) {
+        Path& p = next_.value[i];
+        for (Size k = 0; k <= steps_; ++k) {
+            p[k] = paths_[(k * size_ + i) * batchSize_ + currentSample_];
+        }
+    }
+    next_.weight = weights_[currentSample_];
+    ++currentSample_;
+    return next_;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,81 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file crossassetbatchmultipathgenerator.hpp
+    \brief multi path generator evolving batches of cross asset state process paths
+    \ingroup methods
+*/
+
+#pragma once
+
+#include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/methods/multipathvariategenerator.hpp>
+#include <qle/processes/crossassetstateprocess.hpp>
+
+namespace QuantExt {
+
+//! Multi path generator for cross asset state processes with affine transitions
+/*! The paths are generated in batches of batchSize samples. The transitions x(t+dt) = m + A x(t) + D dw of the
+    process are computed once per time step and then applied to all samples of a batch at once, which are stored in
+    structure-of-arrays form, i.e. the values of one state variable at one time step are contiguous in memory over the
+    samples. The variates are taken from makeMultiPathVariateGenerator(), so the generated paths coincide with those
+    from makeMultiPathGenerator() up to rounding differences.
+
+    The process must have affine transitions, see CrossAssetStateProcess::hasAffineTransition(). The transitions are
+    computed on the first call to next() after construction or reset().
+
+    \ingroup methods
+*/
+class CrossAssetBatchMultiPathGenerator : public MultiPathGeneratorBase {
+public:
+    CrossAssetBatchMultiPathGenerator(const QuantLib::ext::shared_ptr<CrossAssetStateProcess>& process,
+                                      const TimeGrid& grid, const SequenceType sequenceType, const BigNatural seed,
+                                      const SobolBrownianGenerator::Ordering ordering = SobolBrownianGenerator::Steps,
+                                      const SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7,
+                                      const Size batchSize = 256);
+    const Sample<MultiPath>& next() const override;
+    void reset() override;
+    void skipTo(const Size sample) override;
+
+private:
+    void computeTransitions() const;
+    void generateBatch() const;
+
+    const QuantLib::ext::shared_ptr<CrossAssetStateProcess> process_;
+    TimeGrid grid_;
+    Size batchSize_;
+    Size size_, factors_, steps_;
+
+    QuantLib::ext::shared_ptr<MultiPathVariateGeneratorBase> variateGenerator_;
+
+    // transitions per time step
+    mutable bool transitionsReady_ = false;
+    mutable std::vector<Array> m_;
+    mutable std::vector<Matrix> a_, d_;
+
+    // paths_[(k * size_ + i) * batchSize_ + s] is the state i at time index k of sample s
+    mutable std::vector<Real> paths_;
+    // variates_[(k * factors_ + j) * batchSize_ + s] is the variate j at time step k + 1 of sample s
+    mutable std::vector<Real> variates_;
+    mutable std::vector<Real> weights_;
+    mutable Size currentSample_;
+
+    mutable Sample<MultiPath> next_;
+};
+
+} // namespace QuantExt
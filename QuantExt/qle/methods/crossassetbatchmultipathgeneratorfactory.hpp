@@ -0,0 +1,53 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file crossassetbatchmultipathgeneratorfactory.hpp
+    \brief path generator factory that builds a batch path generator for cross asset state processes
+    \ingroup methods
+*/
+
+#pragma once
+
+#include <qle/methods/crossassetbatchmultipathgenerator.hpp>
+#include <qle/methods/pathgeneratorfactory.hpp>
+
+namespace QuantExt {
+
+/*! Builds a CrossAssetBatchMultiPathGenerator for cross asset state processes with affine transitions and falls back
+    to makeMultiPathGenerator() for all other processes */
+class CrossAssetBatchMultiPathGeneratorFactory : public PathGeneratorFactory {
+public:
+    explicit CrossAssetBatchMultiPathGeneratorFactory(const Size batchSize = 256) : batchSize_(batchSize) {}
+    QuantLib::ext::shared_ptr<MultiPathGeneratorBase> build(const SequenceType s,
+                                                    const QuantLib::ext::shared_ptr<StochasticProcess>& process,
+                                                    const TimeGrid& timeGrid, const BigNatural seed,
+                                                    const SobolBrownianGenerator::Ordering ordering,
+                                                    const SobolRsg::DirectionIntegers directionIntegers) override {
+        if (auto cam = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(process)) {
+            if (cam->hasAffineTransition())
+                return QuantLib::ext::make_shared<CrossAssetBatchMultiPathGenerator>(
+                    cam, timeGrid, s, seed, ordering, directionIntegers, batchSize_);
+        }
+        return makeMultiPathGenerator(s, process, timeGrid, seed, ordering, directionIntegers);
+    }
+
+private:
+    const Size batchSize_;
+};
+
+} // namespace QuantExt
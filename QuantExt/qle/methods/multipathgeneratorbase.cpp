@@ -17,6 +17,7 @@
 */
 
 #include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/methods/skippablesobolbrowniangenerator.hpp>
 
 #include <boost/make_shared.hpp>
 
@@ -24,6 +25,12 @@ using namespace QuantLib;
 
 namespace QuantExt {
 
+void MultiPathGeneratorBase::skipTo(const Size sample) {
+    reset();
+    for (Size i = 0; i < sample; ++i)
+        next();
+}
+
 MultiPathGeneratorMersenneTwister::MultiPathGeneratorMersenneTwister(
     const QuantLib::ext::shared_ptr<StochasticProcess>& process, const TimeGrid& grid, BigNatural seed, bool antitheticSampling)
     : process_(process), grid_(grid), seed_(seed), antitheticSampling_(antitheticSampling), antitheticVariate_(true),
@@ -31,14 +38,25 @@ MultiPathGeneratorMersenneTwister::MultiPathGeneratorMersenneTwister(
     MultiPathGeneratorMersenneTwister::reset();
 }
 
-void MultiPathGeneratorMersenneTwister::reset() {
-    PseudoRandom::rsg_type rsg = PseudoRandom::make_sequence_generator(process_->factors() * (grid_.size() - 1), seed_);
+void MultiPathGeneratorMersenneTwister::reset() { MultiPathGeneratorMersenneTwister::skipTo(0); }
+
+void MultiPathGeneratorMersenneTwister::skipTo(const Size sample) {
+    // with antithetic sampling two consecutive samples are generated from the same sequence
+    Size skip = antitheticSampling_ ? sample / 2 : sample;
+    // the uniform generator draws one 32 bit integer per variate, so we can skip without generating the normal variates
+    PseudoRandom::ursg_type usg(process_->factors() * (grid_.size() - 1), seed_);
+    for (Size i = 0; i < skip; ++i)
+        usg.nextInt32Sequence();
+    PseudoRandom::rsg_type rsg(usg);
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<PseudoRandom::rsg_type>>(tmp, grid_, rsg, false);
     } else {
         pg_ = QuantLib::ext::make_shared<MultiPathGenerator<PseudoRandom::rsg_type>>(process_, grid_, rsg, false);
     }
     antitheticVariate_ = true;
+    // generate the original sample, so that the next call returns its antithetic
+    if (antitheticSampling_ && sample % 2 == 1)
+        next();
 }
 
 const Sample<MultiPath>& MultiPathGeneratorMersenneTwister::next() const {
@@ -68,19 +86,18 @@ MultiPathGeneratorSobol::MultiPathGeneratorSobol(const QuantLib::ext::shared_ptr
     MultiPathGeneratorSobol::reset();
 }
 
-void MultiPathGeneratorSobol::reset() {
+void MultiPathGeneratorSobol::reset() { MultiPathGeneratorSobol::skipTo(0); }
+
+void MultiPathGeneratorSobol::skipTo(const Size sample) {
+    InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal> rsg(
+        makeSkippedSobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, sample));
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>>(
-            tmp, grid_,
-            InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(
-                SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_)),
-            false);
+            tmp, grid_, rsg, false);
 
     } else {
         pg_ = QuantLib::ext::make_shared<MultiPathGenerator<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>>(
-            process_, grid_,
-            InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>(
-                SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_)));
+            process_, grid_, rsg);
     }
 }
 
@@ -102,19 +119,18 @@ MultiPathGeneratorBurley2020Sobol::MultiPathGeneratorBurley2020Sobol(const Quant
     MultiPathGeneratorBurley2020Sobol::reset();
 }
 
-void MultiPathGeneratorBurley2020Sobol::reset() {
+void MultiPathGeneratorBurley2020Sobol::reset() { MultiPathGeneratorBurley2020Sobol::skipTo(0); }
+
+void MultiPathGeneratorBurley2020Sobol::skipTo(const Size sample) {
+    InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal> rsg(makeSkippedBurley2020SobolRsg(
+        process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_, sample));
     if (auto tmp = QuantLib::ext::dynamic_pointer_cast<StochasticProcess1D>(process_)) {
         pg1D_ = QuantLib::ext::make_shared<PathGenerator<InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>>>(
-            tmp, grid_,
-            InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(
-                Burley2020SobolRsg(process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_)),
-            false);
+            tmp, grid_, rsg, false);
 
     } else {
         pg_ = QuantLib::ext::make_shared<MultiPathGenerator<InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>>>(
-            process_, grid_,
-            InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>(Burley2020SobolRsg(
-                process_->factors() * (grid_.size() - 1), seed_, directionIntegers_, scrambleSeed_)));
+            process_, grid_, rsg);
     }
 }
 
@@ -167,9 +183,13 @@ MultiPathGeneratorSobolBrownianBridge::MultiPathGeneratorSobolBrownianBridge(
     MultiPathGeneratorSobolBrownianBridge::reset();
 }
 
-void MultiPathGeneratorSobolBrownianBridge::reset() {
-    gen_ = QuantLib::ext::make_shared<SobolBrownianGenerator>(process_->factors(), grid_.size() - 1, ordering_, seed_,
-                                                      directionIntegers_);
+void MultiPathGeneratorSobolBrownianBridge::reset() { MultiPathGeneratorSobolBrownianBridge::skipTo(0); }
+
+void MultiPathGeneratorSobolBrownianBridge::skipTo(const Size sample) {
+    auto gen = QuantLib::ext::make_shared<SkippableSobolBrownianGenerator>(process_->factors(), grid_.size() - 1,
+                                                                           ordering_, seed_, directionIntegers_);
+    gen->skipTo(sample);
+    gen_ = gen;
 }
 
 MultiPathGeneratorBurley2020SobolBrownianBridge::MultiPathGeneratorBurley2020SobolBrownianBridge(
@@ -182,8 +202,14 @@ MultiPathGeneratorBurley2020SobolBrownianBridge::MultiPathGeneratorBurley2020Sob
 }
 
 void MultiPathGeneratorBurley2020SobolBrownianBridge::reset() {
-    gen_ = QuantLib::ext::make_shared<Burley2020SobolBrownianGenerator>(process_->factors(), grid_.size() - 1, ordering_, seed_,
-                                                                directionIntegers_, scrambleSeed_);
+    MultiPathGeneratorBurley2020SobolBrownianBridge::skipTo(0);
+}
+
+void MultiPathGeneratorBurley2020SobolBrownianBridge::skipTo(const Size sample) {
+    auto gen = QuantLib::ext::make_shared<SkippableBurley2020SobolBrownianGenerator>(
+        process_->factors(), grid_.size() - 1, ordering_, seed_, directionIntegers_, scrambleSeed_);
+    gen->skipTo(sample);
+    gen_ = gen;
 }
 
 QuantLib::ext::shared_ptr<MultiPathGeneratorBase>
@@ -51,6 +51,11 @@ public:
     virtual ~MultiPathGeneratorBase() {}
     virtual const Sample<MultiPath>& next() const = 0;
     virtual void reset() = 0;
+    /*! Positions the generator such that the next call to next() returns the sample with the given (zero based)
+        index, with the same result as calling reset() and then next() sample times. This allows to generate a
+        range of samples [a, b) on a separate generator instance. The default implementation does exactly this,
+        derived classes override it with a skip-ahead on the underlying random sequence. */
+    virtual void skipTo(const Size sample);
 };
 
 //! Instantiation of MultiPathGenerator with standard PseudoRandom traits
@@ -62,6 +67,7 @@ public:
                                       bool antitheticSampling = false);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size sample) override;
 
 private:
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
@@ -94,6 +100,7 @@ public:
                             SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size sample) override;
 
 private:
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
@@ -120,6 +127,7 @@ public:
                                       BigNatural scrambleSeed = 43);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size sample) override;
 
 private:
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
@@ -165,6 +173,7 @@ public:
                                           BigNatural seed = 0,
                                           SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7);
     void reset() override final;
+    void skipTo(const Size sample) override final;
 };
 
 //! Instantiation using Burley2020SobolBrownianGenerator from  models/marketmodels/browniangenerators
@@ -177,6 +186,7 @@ public:
         SobolBrownianGenerator::Ordering ordering = SobolBrownianGenerator::Steps, BigNatural seed = 42,
         SobolRsg::DirectionIntegers directionIntegers = SobolRsg::JoeKuoD7, BigNatural scrambleSeed = 43);
     void reset() override final;
+    void skipTo(const Size sample) override final;
 
 protected:
     BigNatural scrambleSeed_;
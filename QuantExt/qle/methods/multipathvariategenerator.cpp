@@ -17,6 +17,7 @@
 */
 
 #include <qle/methods/multipathvariategenerator.hpp>
+#include <qle/methods/skippablesobolbrowniangenerator.hpp>
 
 #include <boost/make_shared.hpp>
 
@@ -41,6 +42,12 @@ Sample<std::vector<Array>> MultiPathVariateGeneratorBase::next() const {
     return result;
 }
 
+void MultiPathVariateGeneratorBase::skipTo(const Size sample) {
+    reset();
+    for (Size i = 0; i < sample; ++i)
+        next();
+}
+
 MultiPathVariateGeneratorMersenneTwister::MultiPathVariateGeneratorMersenneTwister(const Size dimension,
                                                                                    const Size timeSteps,
                                                                                    BigNatural seed,
@@ -50,12 +57,19 @@ MultiPathVariateGeneratorMersenneTwister::MultiPathVariateGeneratorMersenneTwist
     MultiPathVariateGeneratorMersenneTwister::reset();
 }
 
-void MultiPathVariateGeneratorMersenneTwister::reset() {
+void MultiPathVariateGeneratorMersenneTwister::reset() { MultiPathVariateGeneratorMersenneTwister::skipTo(0); }
+
+void MultiPathVariateGeneratorMersenneTwister::skipTo(const Size sample) {
+    RandomSequenceGenerator<MersenneTwisterUniformRng> usg(dimension_ * timeSteps_, MersenneTwisterUniformRng(seed_));
+    Size skip = antitheticSampling_ ? sample / 2 : sample;
+    for (Size i = 0; i < skip; ++i)
+        usg.nextInt32Sequence();
     rsg_ = QuantLib::ext::make_shared<
         InverseCumulativeRsg<RandomSequenceGenerator<MersenneTwisterUniformRng>, InverseCumulativeNormal>>(
-        RandomSequenceGenerator<MersenneTwisterUniformRng>(dimension_ * timeSteps_, MersenneTwisterUniformRng(seed_)),
-        InverseCumulativeNormal());
+        usg, InverseCumulativeNormal());
     antitheticVariate_ = true;
+    if (antitheticSampling_ && sample % 2 == 1)
+        nextSequence();
 }
 
 Sample<std::vector<Real>> MultiPathVariateGeneratorMersenneTwister::nextSequence() const {
@@ -79,9 +93,11 @@ MultiPathVariateGeneratorSobol::MultiPathVariateGeneratorSobol(const Size dimens
     MultiPathVariateGeneratorSobol::reset();
 }
 
-void MultiPathVariateGeneratorSobol::reset() {
+void MultiPathVariateGeneratorSobol::reset() { MultiPathVariateGeneratorSobol::skipTo(0); }
+
+void MultiPathVariateGeneratorSobol::skipTo(const Size sample) {
     rsg_ = QuantLib::ext::make_shared<InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>>(
-        SobolRsg(dimension_ * timeSteps_, seed_, directionIntegers_), InverseCumulativeNormal());
+        makeSkippedSobolRsg(dimension_ * timeSteps_, seed_, directionIntegers_, sample), InverseCumulativeNormal());
 }
 
 Sample<std::vector<Real>> MultiPathVariateGeneratorSobol::nextSequence() const { return rsg_->nextSequence(); }
@@ -94,9 +110,12 @@ MultiPathVariateGeneratorBurley2020Sobol::MultiPathVariateGeneratorBurley2020Sob
     MultiPathVariateGeneratorBurley2020Sobol::reset();
 }
 
-void MultiPathVariateGeneratorBurley2020Sobol::reset() {
+void MultiPathVariateGeneratorBurley2020Sobol::reset() { MultiPathVariateGeneratorBurley2020Sobol::skipTo(0); }
+
+void MultiPathVariateGeneratorBurley2020Sobol::skipTo(const Size sample) {
     rsg_ = QuantLib::ext::make_shared<InverseCumulativeRsg<Burley2020SobolRsg, InverseCumulativeNormal>>(
-        Burley2020SobolRsg(dimension_ * timeSteps_, seed_, directionIntegers_, scrambleSeed_), InverseCumulativeNormal());
+        makeSkippedBurley2020SobolRsg(dimension_ * timeSteps_, seed_, directionIntegers_, scrambleSeed_, sample),
+        InverseCumulativeNormal());
 }
 
 Sample<std::vector<Real>> MultiPathVariateGeneratorBurley2020Sobol::nextSequence() const {
@@ -132,8 +151,13 @@ MultiPathVariateGeneratorSobolBrownianBridge::MultiPathVariateGeneratorSobolBrow
     MultiPathVariateGeneratorSobolBrownianBridge::reset();
 }
 
-void MultiPathVariateGeneratorSobolBrownianBridge::reset() {
-    gen_ = QuantLib::ext::make_shared<SobolBrownianGenerator>(dimension_, timeSteps_, ordering_, seed_, directionIntegers_);
+void MultiPathVariateGeneratorSobolBrownianBridge::reset() { MultiPathVariateGeneratorSobolBrownianBridge::skipTo(0); }
+
+void MultiPathVariateGeneratorSobolBrownianBridge::skipTo(const Size sample) {
+    auto gen = QuantLib::ext::make_shared<SkippableSobolBrownianGenerator>(dimension_, timeSteps_, ordering_, seed_,
+                                                                           directionIntegers_);
+    gen->skipTo(sample);
+    gen_ = gen;
 }
 
 MultiPathVariateGeneratorBurley2020SobolBrownianBridge::MultiPathVariateGeneratorBurley2020SobolBrownianBridge(
@@ -145,8 +169,14 @@ MultiPathVariateGeneratorBurley2020SobolBrownianBridge::MultiPathVariateGenerato
 }
 
 void MultiPathVariateGeneratorBurley2020SobolBrownianBridge::reset() {
-    gen_ = QuantLib::ext::make_shared<Burley2020SobolBrownianGenerator>(dimension_, timeSteps_, ordering_, seed_,
-                                                                directionIntegers_, scrambleSeed_);
+    MultiPathVariateGeneratorBurley2020SobolBrownianBridge::skipTo(0);
+}
+
+void MultiPathVariateGeneratorBurley2020SobolBrownianBridge::skipTo(const Size sample) {
+    auto gen = QuantLib::ext::make_shared<SkippableBurley2020SobolBrownianGenerator>(
+        dimension_, timeSteps_, ordering_, seed_, directionIntegers_, scrambleSeed_);
+    gen->skipTo(sample);
+    gen_ = gen;
 }
 
 QuantLib::ext::shared_ptr<MultiPathVariateGeneratorBase>
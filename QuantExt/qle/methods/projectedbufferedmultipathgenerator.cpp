@@ -57,4 +57,6 @@ const Sample<MultiPath>& ProjectedBufferedMultiPathGenerator::next() const {
 
 void ProjectedBufferedMultiPathGenerator::reset() { currentPath_ = 0; }
 
+void ProjectedBufferedMultiPathGenerator::skipTo(const Size sample) { currentPath_ = sample; }
+
 } // namespace QuantExt
@@ -40,6 +40,7 @@ public:
         const QuantLib::ext::shared_ptr<std::vector<std::vector<QuantLib::Path>>>& bufferedPaths);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size sample) override;
 
 private:
     const std::vector<Size> stateProcessProjection_;
@@ -39,6 +39,7 @@ public:
                                        const QuantLib::ext::shared_ptr<MultiPathVariateGeneratorBase>& variateGenerator);
     const Sample<MultiPath>& next() const override;
     void reset() override;
+    void skipTo(const Size sample) override;
 
 private:
     const QuantLib::ext::shared_ptr<StochasticProcess> process_;
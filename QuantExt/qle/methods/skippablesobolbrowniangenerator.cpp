@@ -0,0 +1,83 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+#include <qle/methods/skippablesobolbrowniangenerator.hpp>
+
+namespace QuantExt {
+
+SobolRsg makeSkippedSobolRsg(Size dimension, unsigned long seed, SobolRsg::DirectionIntegers directionIntegers,
+                             Size sample) {
+    SobolRsg rsg(dimension, seed, directionIntegers);
+    if (sample > 0) {
+        QL_REQUIRE(sample <= QL_MAX_INTEGER, "makeSkippedSobolRsg(): sample " << sample << " out of range");
+        // consume the precomputed first draw, then set the state to draw number sample - 1
+        rsg.nextInt32Sequence();
+        rsg.skipTo(static_cast<std::uint32_t>(sample - 1));
+    }
+    return rsg;
+}
+
+Burley2020SobolRsg makeSkippedBurley2020SobolRsg(Size dimension, unsigned long seed,
+                                                 SobolRsg::DirectionIntegers directionIntegers,
+                                                 unsigned long scrambleSeed, Size sample) {
+    Burley2020SobolRsg rsg(dimension, seed, directionIntegers, scrambleSeed);
+    for (Size i = 0; i < sample; ++i)
+        rsg.nextInt32Sequence();
+    return rsg;
+}
+
+SkippableSobolBrownianGenerator::SkippableSobolBrownianGenerator(Size factors, Size steps, Ordering ordering,
+                                                                 unsigned long seed,
+                                                                 SobolRsg::DirectionIntegers directionIntegers)
+    : SobolBrownianGeneratorBase(factors, steps, ordering), dimension_(factors * steps), seed_(seed),
+      directionIntegers_(directionIntegers), rsg_(dimension_, seed_, directionIntegers_),
+      sequence_(std::vector<Real>(dimension_), 1.0) {}
+
+void SkippableSobolBrownianGenerator::skipTo(Size sample) {
+    rsg_ = makeSkippedSobolRsg(dimension_, seed_, directionIntegers_, sample);
+}
+
+const SobolRsg::sample_type& SkippableSobolBrownianGenerator::nextSequence() {
+    // same as InverseCumulativeRsg<SobolRsg, InverseCumulativeNormal>
+    const SobolRsg::sample_type& u = rsg_.nextSequence();
+    sequence_.weight = u.weight;
+    for (Size i = 0; i < dimension_; ++i)
+        sequence_.value[i] = icn_(u.value[i]);
+    return sequence_;
+}
+
+SkippableBurley2020SobolBrownianGenerator::SkippableBurley2020SobolBrownianGenerator(
+    Size factors, Size steps, Ordering ordering, unsigned long seed, SobolRsg::DirectionIntegers directionIntegers,
+    unsigned long scrambleSeed)
+    : SobolBrownianGeneratorBase(factors, steps, ordering), dimension_(factors * steps), seed_(seed),
+      directionIntegers_(directionIntegers), scrambleSeed_(scrambleSeed),
+      rsg_(dimension_, seed_, directionIntegers_, scrambleSeed_), sequence_(std::vector<Real>(dimension_), 1.0) {}
+
+void SkippableBurley2020SobolBrownianGenerator::skipTo(Size sample) {
+    rsg_ = makeSkippedBurley2020SobolRsg(dimension_, seed_, directionIntegers_, scrambleSeed_, sample);
+}
+
+const SobolRsg::sample_type& SkippableBurley2020SobolBrownianGenerator::nextSequence() {
+    const SobolRsg::sample_type& u = rsg_.nextSequence();
+    sequence_.weight = u.weight;
+    for (Size i = 0; i < dimension_; ++i)
+        sequence_.value[i] = icn_(u.value[i]);
+    return sequence_;
+}
+
+} // namespace QuantExt
@@ -0,0 +1,92 @@
+/*
+ Copyright (C) 2024 Quaternion Risk Management Ltd
+ All rights reserved.
+
+ This file is part of ORE, a free-software/open-source library
+ for transparent pricing and risk analysis - http://opensourcerisk.org
+
+ ORE is free software: you can redistribute it and/or modify it
+ under the terms of the Modified BSD License.  You should have received a
+ copy of the license along with this program.
+ The license is also available online at <http://opensourcerisk.org>
+
+ This program is distributed on the basis that it will form a useful
+ contribution to risk analytics and model standardisation, but WITHOUT
+ ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ FITNESS FOR A PARTICULAR PURPOSE. See the license for more details.
+*/
+
+/*! \file skippablesobolbrowniangenerator.hpp
+    \brief sobol brownian generators which can be positioned at an arbitrary sample
+    \ingroup methods
+*/
+
+#pragma once
+
+#include <ql/math/distributions/normaldistribution.hpp>
+#include <ql/math/randomnumbers/burley2020sobolrsg.hpp>
+#include <ql/math/randomnumbers/sobolrsg.hpp>
+#include <ql/models/marketmodels/browniangenerators/sobolbrowniangenerator.hpp>
+
+namespace QuantExt {
+using namespace QuantLib;
+
+//! Sobol brownian generator with skip-ahead
+/*! Generates the same samples as QuantLib::SobolBrownianGenerator. In addition the generator can be positioned at
+    an arbitrary sample in logarithmic time using the Gray code of the Sobol sequence, see SobolRsg::skipTo().
+
+    \ingroup methods
+*/
+class SkippableSobolBrownianGenerator : public SobolBrownianGeneratorBase {
+public:
+    SkippableSobolBrownianGenerator(Size factors, Size steps, Ordering ordering, unsigned long seed = 0,
+                                    SobolRsg::DirectionIntegers directionIntegers = SobolRsg::Jaeckel);
+    //! the next call to nextPath() generates the given (zero based) sample
+    void skipTo(Size sample);
+
+private:
+    const SobolRsg::sample_type& nextSequence() override;
+    Size dimension_;
+    unsigned long seed_;
+    SobolRsg::DirectionIntegers directionIntegers_;
+    SobolRsg rsg_;
+    InverseCumulativeNormal icn_;
+    SobolRsg::sample_type sequence_;
+};
+
+//! Burley 2020 scrambled Sobol brownian generator with skip-ahead
+/*! Generates the same samples as QuantLib::Burley2020SobolBrownianGenerator. Skipping to a sample discards the
+    integer sequences up to that sample, i.e. the inverse cumulative normal and the brownian bridge are not evaluated
+    for the skipped samples.
+
+    \ingroup methods
+*/
+class SkippableBurley2020SobolBrownianGenerator : public SobolBrownianGeneratorBase {
+public:
+    SkippableBurley2020SobolBrownianGenerator(Size factors, Size steps, Ordering ordering, unsigned long seed = 42,
+                                              SobolRsg::DirectionIntegers directionIntegers = SobolRsg::Jaeckel,
+                                              unsigned long scrambleSeed = 43);
+    //! the next call to nextPath() generates the given (zero based) sample
+    void skipTo(Size sample);
+
+private:
+    const SobolRsg::sample_type& nextSequence() override;
+    Size dimension_;
+    unsigned long seed_;
+    SobolRsg::DirectionIntegers directionIntegers_;
+    unsigned long scrambleSeed_;
+    Burley2020SobolRsg rsg_;
+    InverseCumulativeNormal icn_;
+    SobolRsg::sample_type sequence_;
+};
+
+//! Sobol sequence generator positioned such that the next draw is the given (zero based) sample
+SobolRsg makeSkippedSobolRsg(Size dimension, unsigned long seed, SobolRsg::DirectionIntegers directionIntegers,
+                             Size sample);
+
+//! Burley 2020 sequence generator positioned such that the next draw is the given (zero based) sample
+Burley2020SobolRsg makeSkippedBurley2020SobolRsg(Size dimension, unsigned long seed,
+                                                 SobolRsg::DirectionIntegers directionIntegers,
+                                                 unsigned long scrambleSeed, Size sample);
+
+} // namespace QuantExt
@@ -90,6 +90,18 @@ void CrossAssetStateProcess::resetCache(const Size timeSteps) const {
     updateSqrtCorrelation();
 }
 
+bool CrossAssetStateProcess::hasAffineTransition() const {
+    return cirppCount_ == 0 &&
+           QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_) != nullptr;
+}
+
+void CrossAssetStateProcess::affineTransition(Time t0, Time dt, Array& m, Matrix& a, Matrix& d) const {
+    QL_REQUIRE(hasAffineTransition(), "CrossAssetStateProcess::affineTransition(): requires exact discretization "
+                                      "without CR CIR++ components");
+    QuantLib::ext::static_pointer_cast<CrossAssetStateProcess::ExactDiscretization>(discretization_)
+        ->affineTransition(*this, t0, dt, m, a, d);
+}
+
 void CrossAssetStateProcess::updateSqrtCorrelation() const {
     if (model_->discretization() != CrossAssetModel::Discretization::Euler)
         return;
@@ -988,4 +1000,22 @@ void CrossAssetStateProcess::ExactDiscretization::resetCache(const Size timeStep
     cache_d_.clear();
 }
 
+void CrossAssetStateProcess::ExactDiscretization::affineTransition(const StochasticProcess& p, Time t0, Time dt,
+                                                                   Array& m, Matrix& a, Matrix& d) const {
+    Size n = model_->dimension();
+    Array zero(n, 0.0);
+    m = driftImpl1(p, t0, zero, dt);
+    // driftImpl2 is linear in x0, so its columns are the images of the unit vectors
+    a = Matrix(n, n, 0.0);
+    Array e(n, 0.0);
+    for (Size j = 0; j < n; ++j) {
+        e[j] = 1.0;
+        Array col = driftImpl2(p, t0, e, dt);
+        for (Size i = 0; i < n; ++i)
+            a[i][j] = col[i];
+        e[j] = 0.0;
+    }
+    d = pseudoSqrt(covarianceImpl(p, t0, zero, dt), salvaging_);
+}
+
 } // namespace QuantExt
@@ -54,6 +54,14 @@ public:
     // enables and resets the cache, once enabled the simulated times must stay the stame
     void resetCache(const Size timeSteps) const;
 
+    /*! true if the evolution over a time step is an affine function of the state and the brownian increments, i.e.
+        x(t0 + dt) = m + A x(t0) + D dw, this is the case for the exact discretization without CR CIR++ components */
+    bool hasAffineTransition() const;
+
+    /*! the state-independent vector m and matrices A, D of the affine transition, see hasAffineTransition(), the
+        cache is not used or changed by this method */
+    void affineTransition(Time t0, Time dt, Array& m, Matrix& a, Matrix& d) const;
+
 protected:
     virtual Matrix diffusionOnCorrelatedBrownians(Time t, const Array& x) const;
     virtual Matrix diffusionOnCorrelatedBrowniansImpl(Time t, const Array& x) const;
@@ -74,6 +82,7 @@ protected:
         virtual Matrix diffusion(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         virtual Matrix covariance(const StochasticProcess&, Time t0, const Array& x0, Time dt) const override;
         void resetCache(const Size timeSteps) const;
+        void affineTransition(const StochasticProcess&, Time t0, Time dt, Array& m, Matrix& a, Matrix& d) const;
 
     protected:
         virtual Array driftImpl1(const StochasticProcess&, Time t0, const Array& x0, Time dt) const;
@@ -237,6 +237,7 @@
 #include <qle/math/logquadraticinterpolation.hpp>
 #include <qle/math/matrixfunctions.hpp>
 #include <qle/math/method_mt.hpp>
+#include <qle/math/multithreadedcpuenvironment.hpp>
 #include <qle/math/nadarayawatson.hpp>
 #include <qle/math/openclenvironment.hpp>
 #include <qle/math/problem_mt.hpp>
@@ -250,6 +251,8 @@
 #include <qle/math/stoplightbounds.hpp>
 #include <qle/math/trace.hpp>
 #include <qle/methods/brownianbridgepathinterpolator.hpp>
+#include <qle/methods/crossassetbatchmultipathgenerator.hpp>
+#include <qle/methods/crossassetbatchmultipathgeneratorfactory.hpp>
 #include <qle/methods/fdmblackscholesmesher.hpp>
 #include <qle/methods/fdmblackscholesop.hpp>
 #include <qle/methods/fdmdefaultableequityjumpdiffusionfokkerplanckop.hpp>
@@ -263,6 +266,7 @@
 #include <qle/methods/projectedbufferedmultipathgeneratorfactory.hpp>
 #include <qle/methods/projectedvariatemultipathgenerator.hpp>
 #include <qle/methods/projectedvariatepathgeneratorfactory.hpp>
+#include <qle/methods/skippablesobolbrowniangenerator.hpp>
 #include <qle/models/annuitymapping.hpp>
 #include <qle/models/basket.hpp>
 #include <qle/models/blackscholesmodelwrapper.hpp>
@@ -190,6 +190,54 @@ BOOST_AUTO_TEST_CASE(testIndicatorDerivative) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(testPredecessorsAndRepeatedArgs) {
+
+    constexpr Real tol = 1E-14;
+
+    // u = x+y, z = u*u, w = z+x
+    ComputationGraph g;
+    auto x = cg_var(g, "x", ComputationGraph::VarDoesntExist::Create);
+    auto y = cg_var(g, "y", ComputationGraph::VarDoesntExist::Create);
+    auto u = cg_add(g, x, y, "u");
+    auto z = cg_mult(g, u, u, "z");
+    auto w = cg_add(g, z, x, "w");
+
+    BOOST_CHECK(g.predecessors(x).empty());
+    BOOST_CHECK(g.predecessors(y).empty());
+    BOOST_REQUIRE_EQUAL(g.predecessors(u).size(), 2);
+    BOOST_CHECK_EQUAL(g.predecessors(u)[0], x);
+    BOOST_CHECK_EQUAL(g.predecessors(u)[1], y);
+    BOOST_REQUIRE_EQUAL(g.predecessors(z).size(), 2);
+    BOOST_CHECK_EQUAL(g.predecessors(z)[0], u);
+    BOOST_CHECK_EQUAL(g.predecessors(z)[1], u);
+    std::vector<std::size_t> wPredecessors(g.predecessors(w).begin(), g.predecessors(w).end());
+    BOOST_CHECK(wPredecessors == std::vector<std::size_t>({z, x}));
+
+    // u is an argument of z twice, but must be deleted once only
+
+    std::vector<RandomVariable> values(g.size(), RandomVariable(1, 0.0));
+    values[x] = RandomVariable(1, 2.0);
+    values[y] = RandomVariable(1, 3.0);
+
+    std::size_t deleted = 0;
+    std::function<void(RandomVariable&)> deleter = [&deleted](RandomVariable& v) {
+        ++deleted;
+        v.clear();
+    };
+    std::vector<bool> keep(g.size(), false);
+    keep[x] = true;
+    keep[y] = true;
+    keep[w] = true;
+
+    forwardEvaluation(g, values, getRandomVariableOps(1), deleter, false, {}, keep);
+
+    // w = (x+y)^2 + x
+    BOOST_CHECK_CLOSE(values[w][0], 27.0, tol);
+    BOOST_CHECK_EQUAL(deleted, 2);
+    BOOST_CHECK(!values[u].initialised());
+    BOOST_CHECK(!values[z].initialised());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
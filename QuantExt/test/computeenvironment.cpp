@@ -18,6 +18,7 @@
 
 #include <qle/math/basiccpuenvironment.hpp>
 #include <qle/math/computeenvironment.hpp>
+#include <qle/math/multithreadedcpuenvironment.hpp>
 #include <qle/math/openclenvironment.hpp>
 #include <qle/math/randomvariable.hpp>
 #include <qle/math/randomvariable_io.hpp>
@@ -44,6 +45,8 @@ struct ComputeEnvironmentFixture {
             "OpenCL", &QuantExt::createComputeFrameworkCreator<QuantExt::OpenClFramework>, true);
         QuantExt::ComputeFrameworkRegistry::instance().add(
             "BasicCpu", &QuantExt::createComputeFrameworkCreator<QuantExt::BasicCpuFramework>, true);
+        QuantExt::ComputeFrameworkRegistry::instance().add(
+            "MultiThreadedCpu", &QuantExt::createComputeFrameworkCreator<QuantExt::MultiThreadedCpuFramework>, true);
     }
     ~ComputeEnvironmentFixture() { ComputeEnvironment::instance().reset(); }
 };
@@ -406,6 +409,75 @@ BOOST_AUTO_TEST_CASE(testConditionalExpectation) {
     BOOST_CHECK(true);
 }
 
+BOOST_AUTO_TEST_CASE(testMultiThreadedCpuAgainstBasicCpu) {
+    ComputeEnvironmentFixture fixture;
+    BOOST_TEST_MESSAGE("testing multi-threaded cpu context against basic cpu context");
+
+    // n is not a multiple of the block size, so that the last block is a partial one
+    const std::size_t n = 5000;
+    std::vector<double> rx(n);
+    for (std::size_t i = 0; i < n; ++i)
+        rx[i] = 0.5 + static_cast<double>(i) / static_cast<double>(n);
+
+    auto calc = [&rx, n](const std::string& device) {
+        ComputeEnvironment::instance().selectContext(device);
+        auto& c = ComputeEnvironment::instance().context();
+        ComputeContext::Settings settings;
+        settings.useDoublePrecision = true;
+        c.initiateCalculation(n, 0, 0, settings);
+        auto x = c.createInputVariable(&rx[0]);
+        auto one = c.createInputVariable(1.0);
+        auto vs = c.createInputVariates(1, 2);
+        auto z = vs[0][0];
+        std::vector<std::size_t> out;
+        out.push_back(c.applyOperation(RandomVariableOpCode::Add, {x, z, one}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Subtract, {x, z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Negative, {z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Mult, {x, z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Div, {z, x}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::IndicatorEq, {x, one}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::IndicatorGt, {x, one}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::IndicatorGeq, {x, one}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Min, {x, z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Max, {x, z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Abs, {z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Exp, {z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Sqrt, {x}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Log, {x}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::Pow, {x, z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::NormalCdf, {z}));
+        out.push_back(c.applyOperation(RandomVariableOpCode::NormalPdf, {z}));
+        auto payoff = c.applyOperation(RandomVariableOpCode::Max, {out[3], out[2]});
+        auto ce = c.applyOperation(RandomVariableOpCode::ConditionalExpectation, {payoff, one, vs[0][1]});
+        out.push_back(ce);
+        out.push_back(c.applyOperation(RandomVariableOpCode::Mult, {ce, x}));
+        for (auto const& o : out)
+            c.declareOutputVariable(o);
+        std::vector<std::vector<double>> output(out.size(), std::vector<double>(n));
+        c.finalizeCalculation(output);
+        return output;
+    };
+
+    auto ref = calc("BasicCpu/Default/Default");
+    auto res = calc("MultiThreadedCpu/Default/Default");
+
+    BOOST_REQUIRE_EQUAL(ref.size(), res.size());
+    Size noErrors = 0, errorThreshold = 10;
+    for (Size j = 0; j < ref.size(); ++j) {
+        for (Size i = 0; i < n; ++i) {
+            Real err = std::abs(res[j][i] - ref[j][i]);
+            if (std::abs(ref[j][i]) > 1E-10)
+                err /= std::abs(ref[j][i]);
+            if (err > 1E-10 && noErrors < errorThreshold) {
+                BOOST_ERROR("multi-threaded cpu value (" << res[j][i] << ") for output " << j << " at i=" << i
+                                                         << " does not match basic cpu value (" << ref[j][i]
+                                                         << "), error " << err);
+                noErrors++;
+            }
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
@@ -22,7 +22,10 @@
 #include <boost/test/unit_test.hpp>
 #include <boost/test/data/test_case.hpp>
 // clang-format on
+#include <qle/methods/crossassetbatchmultipathgenerator.hpp>
 #include <qle/methods/multipathgeneratorbase.hpp>
+#include <qle/methods/multipathvariategenerator.hpp>
+#include <qle/methods/skippablesobolbrowniangenerator.hpp>
 #include <qle/models/cdsoptionhelper.hpp>
 #include <qle/models/cirppconstantfellerparametrization.hpp>
 #include <qle/models/commodityschwartzmodel.hpp>
@@ -3292,6 +3295,172 @@ BOOST_AUTO_TEST_CASE(testIrFxInfCrEqMoments) {
 
 } // testIrFxInfCrEqMoments
 
+BOOST_AUTO_TEST_CASE(testIrFxInfCrEqBatchPathGeneration) {
+
+    BOOST_TEST_MESSAGE("Testing batch path generation vs. single path generation "
+                       "in ir-fx-inf-cr-eq model...");
+
+    IrFxInfCrEqModelTestData d;
+
+    auto p_exact = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(d.modelExact->stateProcess());
+    auto p_euler = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(d.modelEuler->stateProcess());
+    BOOST_REQUIRE(p_exact && p_euler);
+    BOOST_CHECK(p_exact->hasAffineTransition());
+    BOOST_CHECK(!p_euler->hasAffineTransition());
+
+    TimeGrid grid(5.0, 20);
+    Size seed = 42, paths = 50, batchSize = 16;
+
+    for (auto s : {MersenneTwister, MersenneTwisterAntithetic, SobolBrownianBridge}) {
+        BOOST_TEST_MESSAGE("sequence type " << s);
+        p_exact->resetCache(grid.size() - 1);
+        auto pgen = makeMultiPathGenerator(s, p_exact, grid, seed);
+        CrossAssetBatchMultiPathGenerator bgen(p_exact, grid, s, seed, SobolBrownianGenerator::Steps,
+                                               SobolRsg::JoeKuoD7, batchSize);
+        // the second round checks the reset, the batch size does not divide the number of paths
+        for (Size r = 0; r < 2; ++r) {
+            for (Size i = 0; i < paths; ++i) {
+                const Sample<MultiPath>& path = pgen->next();
+                const Sample<MultiPath>& bpath = bgen.next();
+                BOOST_CHECK_CLOSE(path.weight, bpath.weight, 1.0E-12);
+                for (Size j = 0; j < p_exact->size(); ++j) {
+                    for (Size k = 0; k < grid.size(); ++k) {
+                        BOOST_CHECK_SMALL(path.value[j][k] - bpath.value[j][k], 1.0E-10);
+                    }
+                }
+            }
+            pgen->reset();
+            bgen.reset();
+        }
+    }
+
+    BOOST_CHECK_THROW(CrossAssetBatchMultiPathGenerator(p_euler, grid, MersenneTwister, seed), QuantLib::Error);
+
+} // testIrFxInfCrEqBatchPathGeneration
+
+namespace {
+
+// the skippable brownian generator must reproduce the reference generator, also after skipping to a sample
+template <class ReferenceGenerator, class SkippableGenerator>
+void checkSkippableBrownianGenerator(ReferenceGenerator& ref, SkippableGenerator& gen, Size factors, Size steps,
+                                     Size paths, const std::vector<std::pair<Size, Size>>& ranges) {
+    std::vector<Real> refWeights, genWeights;
+    std::vector<std::vector<std::vector<Real>>> refSteps(paths, std::vector<std::vector<Real>>(steps)), genSteps;
+    for (Size i = 0; i < paths; ++i) {
+        refWeights.push_back(ref.nextPath());
+        for (Size k = 0; k < steps; ++k) {
+            refSteps[i][k].resize(factors);
+            ref.nextStep(refSteps[i][k]);
+        }
+    }
+    std::vector<Real> output(factors);
+    for (Size i = 0; i < paths; ++i) {
+        BOOST_CHECK_EQUAL(gen.nextPath(), refWeights[i]);
+        for (Size k = 0; k < steps; ++k) {
+            gen.nextStep(output);
+            for (Size j = 0; j < factors; ++j)
+                BOOST_CHECK_EQUAL(output[j], refSteps[i][k][j]);
+        }
+    }
+    for (auto r = ranges.rbegin(); r != ranges.rend(); ++r) {
+        gen.skipTo(r->first);
+        for (Size i = r->first; i < r->second; ++i) {
+            BOOST_CHECK_EQUAL(gen.nextPath(), refWeights[i]);
+            for (Size k = 0; k < steps; ++k) {
+                gen.nextStep(output);
+                for (Size j = 0; j < factors; ++j)
+                    BOOST_CHECK_EQUAL(output[j], refSteps[i][k][j]);
+            }
+        }
+    }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(testIrFxInfCrEqSkipToSample) {
+
+    BOOST_TEST_MESSAGE("Testing skip-ahead of path generators in ir-fx-inf-cr-eq model...");
+
+    IrFxInfCrEqModelTestData d;
+
+    auto process = QuantLib::ext::dynamic_pointer_cast<CrossAssetStateProcess>(d.modelExact->stateProcess());
+    BOOST_REQUIRE(process);
+
+    TimeGrid grid(3.0, 12);
+    process->resetCache(grid.size() - 1);
+    Size seed = 42, paths = 40;
+
+    // the sample range [a, b) generated after skipTo(a) must be identical to the one from a sequential run
+    std::vector<std::pair<Size, Size>> ranges = {{0, 5}, {5, 17}, {17, 18}, {18, 40}};
+
+    for (auto s : {MersenneTwister, MersenneTwisterAntithetic, Sobol, Burley2020Sobol, SobolBrownianBridge,
+                   Burley2020SobolBrownianBridge}) {
+        BOOST_TEST_MESSAGE("sequence type " << s);
+        auto pgen = makeMultiPathGenerator(s, process, grid, seed, SobolBrownianGenerator::Diagonal);
+        std::vector<Sample<MultiPath>> reference;
+        for (Size i = 0; i < paths; ++i)
+            reference.push_back(pgen->next());
+        auto pgen2 = makeMultiPathGenerator(s, process, grid, seed, SobolBrownianGenerator::Diagonal);
+        auto vgen = makeMultiPathVariateGenerator(s, process->factors(), grid.size() - 1, seed,
+                                                  SobolBrownianGenerator::Diagonal);
+        std::vector<Sample<std::vector<Array>>> variates;
+        for (Size i = 0; i < paths; ++i)
+            variates.push_back(vgen->next());
+        // process the ranges in reverse order to check that skipping backwards works as well
+        for (auto r = ranges.rbegin(); r != ranges.rend(); ++r) {
+            pgen2->skipTo(r->first);
+            vgen->skipTo(r->first);
+            for (Size i = r->first; i < r->second; ++i) {
+                const Sample<MultiPath>& path = pgen2->next();
+                BOOST_CHECK_EQUAL(path.weight, reference[i].weight);
+                for (Size j = 0; j < process->size(); ++j) {
+                    for (Size k = 0; k < grid.size(); ++k) {
+                        BOOST_CHECK_EQUAL(path.value[j][k], reference[i].value[j][k]);
+                    }
+                }
+                Sample<std::vector<Array>> v = vgen->next();
+                for (Size k = 0; k < grid.size() - 1; ++k) {
+                    for (Size j = 0; j < process->factors(); ++j) {
+                        BOOST_CHECK_EQUAL(v.value[k][j], variates[i].value[k][j]);
+                    }
+                }
+            }
+        }
+        CrossAssetBatchMultiPathGenerator bgen(process, grid, s, seed, SobolBrownianGenerator::Diagonal,
+                                               SobolRsg::JoeKuoD7, 8);
+        std::vector<Sample<MultiPath>> batchReference;
+        for (Size i = 0; i < paths; ++i)
+            batchReference.push_back(bgen.next());
+        for (auto r = ranges.rbegin(); r != ranges.rend(); ++r) {
+            bgen.skipTo(r->first);
+            for (Size i = r->first; i < r->second; ++i) {
+                const Sample<MultiPath>& path = bgen.next();
+                for (Size j = 0; j < process->size(); ++j) {
+                    for (Size k = 0; k < grid.size(); ++k) {
+                        BOOST_CHECK_EQUAL(path.value[j][k], batchReference[i].value[j][k]);
+                    }
+                }
+            }
+        }
+    }
+
+    // compare the skippable generators directly against the QuantLib generators for all orderings
+    for (auto ordering : {SobolBrownianGenerator::Factors, SobolBrownianGenerator::Steps,
+                          SobolBrownianGenerator::Diagonal}) {
+        BOOST_TEST_MESSAGE("ordering " << ordering);
+        SobolBrownianGenerator sobolRef(process->factors(), grid.size() - 1, ordering, seed, SobolRsg::JoeKuoD7);
+        SkippableSobolBrownianGenerator sobolGen(process->factors(), grid.size() - 1, ordering, seed,
+                                                 SobolRsg::JoeKuoD7);
+        checkSkippableBrownianGenerator(sobolRef, sobolGen, process->factors(), grid.size() - 1, paths, ranges);
+        Burley2020SobolBrownianGenerator burleyRef(process->factors(), grid.size() - 1, ordering, seed,
+                                                   SobolRsg::JoeKuoD7, seed + 1);
+        SkippableBurley2020SobolBrownianGenerator burleyGen(process->factors(), grid.size() - 1, ordering, seed,
+                                                            SobolRsg::JoeKuoD7, seed + 1);
+        checkSkippableBrownianGenerator(burleyRef, burleyGen, process->factors(), grid.size() - 1, paths, ranges);
+    }
+
+} // testIrFxInfCrEqSkipToSample
+
 namespace {
 
 struct IrFxEqModelTestData {